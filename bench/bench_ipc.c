@@ -0,0 +1,351 @@
+// 同主机跨进程IPC基准：共享内存传输 vs UDP回环
+//
+// 用法: bench_ipc [iterations] [payload_bytes]
+//
+// 延迟测试为单条消息往返（ping-pong），取RTT/2；
+// 吞吐测试为单向连续发送，最后一条消息触发确认。
+// 两条路径条件对齐：客户端都在发送线程里接收应答；发送方在途消息都不超过SHM_RING_SLOTS条，
+// 共享内存靠收件环满时的SOFTBUS_BUSY，UDP靠接收方每UDP_ACK_EVERY条返回的累计确认，
+// 不会因为接收缓冲区溢出而丢包。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sched.h>
+#include "softbus_shm.h"
+#include "softbus_socket.h"
+
+#define DEFAULT_ITERATIONS 20000
+#define DEFAULT_PAYLOAD 64
+#define ECHO_DEVICE "bench_echo"
+#define CLIENT_DEVICE "bench_client"
+#define UDP_TIMEOUT_MS 20       // UDP回环也可能丢包，等不到应答时重发
+#define UDP_RETRIES 50
+#define UDP_WINDOW 128          // 在途数据报上限，小负载时约占默认接收缓冲区的一半
+#define UDP_ACK_EVERY 32
+#define UDP_RCVBUF (1 << 20)
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static void report(const char* name, uint64_t* samples, int count, uint64_t msgs, uint64_t elapsed_ns) {
+    qsort(samples, count, sizeof(uint64_t), cmp_u64);
+    printf("%-6s  p50=%7.2fus  p99=%7.2fus  p999=%7.2fus  throughput=%10.0f msgs/s\n",
+           name,
+           samples[count / 2] / 1000.0,
+           samples[(int)(count * 0.99)] / 1000.0,
+           samples[(int)(count * 0.999)] / 1000.0,
+           elapsed_ns ? msgs * 1e9 / elapsed_ns : 0.0);
+}
+
+#if ENABLE_SHM_TRANSPORT
+
+static _Atomic uint64_t g_replies;
+static _Atomic uint64_t g_received;
+
+// 回显端：COMMAND原样返回，DATA只计数，STATUS表示吞吐测试结束
+static void echo_handler(const char* target, message_type_t type, softbus_priority_t priority,
+                         const void* data, size_t len, void* user_data) {
+    (void)target;
+    (void)user_data;
+    if (type == MESSAGE_TYPE_DATA) {
+        atomic_fetch_add(&g_received, 1);
+        return;
+    }
+    while (shm_transport_send(CLIENT_DEVICE, type, priority, data, len) == SOFTBUS_BUSY) {
+        sched_yield();
+    }
+}
+
+static void client_handler(const char* target, message_type_t type, softbus_priority_t priority,
+                           const void* data, size_t len, void* user_data) {
+    (void)target;
+    (void)type;
+    (void)priority;
+    (void)data;
+    (void)len;
+    (void)user_data;
+    atomic_fetch_add_explicit(&g_replies, 1, memory_order_release);
+}
+
+// 客户端不启动接收线程，在发送线程中轮询收件环，与UDP客户端直接recv对齐
+static void wait_replies(uint64_t expected) {
+    while (atomic_load_explicit(&g_replies, memory_order_acquire) < expected) {
+        if (shm_transport_poll(SHM_RING_SLOTS) == 0) {
+            sched_yield();
+        }
+    }
+}
+
+static int bench_shm(int iterations, size_t payload) {
+    char bus_name[64];
+    snprintf(bus_name, sizeof(bus_name), "/softbus_bench_%d", (int)getpid());
+    shm_transport_unlink(bus_name);
+
+    int ready[2];
+    if (pipe(ready) < 0) {
+        return -1;
+    }
+
+    pid_t child = fork();
+    if (child == 0) {
+        close(ready[0]);
+        if (shm_transport_init(bus_name) != SOFTBUS_OK) {
+            _exit(1);
+        }
+        shm_transport_set_receive_handler(echo_handler, NULL);
+        shm_transport_register_device(ECHO_DEVICE);
+        shm_transport_start();
+        char c = 1;
+        if (write(ready[1], &c, 1) != 1) {
+            _exit(1);
+        }
+        pause();
+        _exit(0);
+    }
+
+    close(ready[1]);
+    char c;
+    if (read(ready[0], &c, 1) != 1 || shm_transport_init(bus_name) != SOFTBUS_OK) {
+        kill(child, SIGKILL);
+        waitpid(child, NULL, 0);
+        return -1;
+    }
+    close(ready[0]);
+    shm_transport_set_receive_handler(client_handler, NULL);
+    shm_transport_register_device(CLIENT_DEVICE);
+
+    char* buf = calloc(1, payload);
+    uint64_t* samples = calloc(iterations, sizeof(uint64_t));
+
+    // 延迟
+    for (int i = 0; i < iterations; i++) {
+        uint64_t t0 = now_ns();
+        while (shm_transport_send(ECHO_DEVICE, MESSAGE_TYPE_COMMAND, PRIORITY_NORMAL, buf, payload) == SOFTBUS_BUSY) {
+            sched_yield();
+        }
+        wait_replies((uint64_t)i + 1);
+        samples[i] = (now_ns() - t0) / 2;
+    }
+
+    // 吞吐
+    uint64_t base = atomic_load(&g_replies);
+    uint64_t start = now_ns();
+    for (int i = 0; i < iterations; i++) {
+        while (shm_transport_send(ECHO_DEVICE, MESSAGE_TYPE_DATA, PRIORITY_NORMAL, buf, payload) == SOFTBUS_BUSY) {
+            sched_yield();
+        }
+    }
+    while (shm_transport_send(ECHO_DEVICE, MESSAGE_TYPE_STATUS, PRIORITY_NORMAL, buf, payload) == SOFTBUS_BUSY) {
+        sched_yield();
+    }
+    wait_replies(base + 1);
+    uint64_t elapsed = now_ns() - start;
+
+    report("shm", samples, iterations, (uint64_t)iterations, elapsed);
+
+    kill(child, SIGTERM);
+    waitpid(child, NULL, 0);
+    shm_transport_deinit();
+    shm_transport_unlink(bus_name);
+    free(samples);
+    free(buf);
+    return 0;
+}
+
+#endif // ENABLE_SHM_TRANSPORT
+
+// 发送一个请求并等待类型相同的应答，COMMAND还要求应答带回同一个编号，丢弃迟到的旧应答
+static int udp_request(int fd, const struct sockaddr_in* peer, uint8_t* buf, size_t len, uint64_t tag) {
+    uint8_t type = buf[0];
+    if (type == MESSAGE_TYPE_COMMAND) {
+        memcpy(buf + 1, &tag, sizeof(tag));
+    }
+    for (int attempt = 0; attempt < UDP_RETRIES; attempt++) {
+        sendto(fd, buf, len, 0, (const struct sockaddr*)peer, sizeof(*peer));
+        for (;;) {
+            ssize_t n = recv(fd, buf, len, 0);
+            if (n < 0) {
+                break;  // 超时，重发
+            }
+            uint64_t reply_tag;
+            memcpy(&reply_tag, buf + 1, sizeof(reply_tag));
+            if ((size_t)n == len && buf[0] == type && (type != MESSAGE_TYPE_COMMAND || reply_tag == tag)) {
+                return 0;
+            }
+        }
+        buf[0] = type;
+        if (type == MESSAGE_TYPE_COMMAND) {
+            memcpy(buf + 1, &tag, sizeof(tag));
+        }
+    }
+    return -1;
+}
+
+// 等待累计确认直到在途数据报少于窗口；确认丢失时用STATUS查询接收方的累计数
+static int udp_wait_window(int fd, const struct sockaddr_in* peer, uint8_t* buf, size_t len,
+                           uint64_t sent, uint64_t* acked) {
+    while (sent - *acked >= UDP_WINDOW) {
+        ssize_t n = recv(fd, buf, len, 0);
+        if (n < 0) {
+            buf[0] = MESSAGE_TYPE_STATUS;
+            if (udp_request(fd, peer, buf, len, 0) != 0) {
+                return -1;
+            }
+        } else if (buf[0] != MESSAGE_TYPE_RESPONSE && buf[0] != MESSAGE_TYPE_STATUS) {
+            continue;
+        }
+        uint64_t count;
+        memcpy(&count, buf + 1, sizeof(count));
+        if (count > *acked) {
+            *acked = count;
+        }
+    }
+    return 0;
+}
+
+// UDP路径：与总线socket层相同的回环数据报收发
+static int bench_udp(int iterations, size_t payload) {
+    int ready[2];
+    if (pipe(ready) < 0) {
+        return -1;
+    }
+
+    pid_t child = fork();
+    if (child == 0) {
+        close(ready[0]);
+        int fd = socket(AF_INET, SOCK_DGRAM, 0);
+        int rcvbuf = UDP_RCVBUF;
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+        struct sockaddr_in addr = {0};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(fd, (struct sockaddr*)&addr, sizeof(addr));
+        socklen_t addr_len = sizeof(addr);
+        getsockname(fd, (struct sockaddr*)&addr, &addr_len);
+        if (write(ready[1], &addr.sin_port, sizeof(addr.sin_port)) != sizeof(addr.sin_port)) {
+            _exit(1);
+        }
+
+        uint8_t buf[SOCKET_MAX_DATAGRAM];
+        uint64_t received = 0;
+        for (;;) {
+            struct sockaddr_in from;
+            socklen_t from_len = sizeof(from);
+            ssize_t n = recvfrom(fd, buf, sizeof(buf), 0, (struct sockaddr*)&from, &from_len);
+            if (n <= 0) {
+                continue;
+            }
+            if (buf[0] == MESSAGE_TYPE_DATA) {
+                // 累计确认，发送方据此推进窗口
+                if (++received % UDP_ACK_EVERY == 0) {
+                    buf[0] = MESSAGE_TYPE_RESPONSE;
+                    memcpy(buf + 1, &received, sizeof(received));
+                    sendto(fd, buf, n, 0, (struct sockaddr*)&from, from_len);
+                }
+                continue;
+            }
+            // 应答可能丢失被重发，计数不清零，重复的STATUS得到相同结果
+            if (buf[0] == MESSAGE_TYPE_STATUS) {
+                memcpy(buf + 1, &received, sizeof(received));
+            }
+            sendto(fd, buf, n, 0, (struct sockaddr*)&from, from_len);
+        }
+    }
+
+    close(ready[1]);
+    struct sockaddr_in peer = {0};
+    peer.sin_family = AF_INET;
+    peer.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (read(ready[0], &peer.sin_port, sizeof(peer.sin_port)) != sizeof(peer.sin_port)) {
+        kill(child, SIGKILL);
+        waitpid(child, NULL, 0);
+        return -1;
+    }
+    close(ready[0]);
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct timeval timeout = {0, UDP_TIMEOUT_MS * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    size_t len = payload < sizeof(uint64_t) + 1 ? sizeof(uint64_t) + 1 : payload;
+    uint8_t* buf = calloc(1, len);
+    uint64_t* samples = calloc(iterations, sizeof(uint64_t));
+    int ret = 0;
+
+    for (int i = 0; i < iterations && ret == 0; i++) {
+        uint64_t t0 = now_ns();
+        buf[0] = MESSAGE_TYPE_COMMAND;
+        ret = udp_request(fd, &peer, buf, len, (uint64_t)i);
+        samples[i] = (now_ns() - t0) / 2;
+    }
+
+    uint64_t start = now_ns();
+    uint64_t acked = 0;
+    for (int i = 0; i < iterations && ret == 0; i++) {
+        ret = udp_wait_window(fd, &peer, buf, len, (uint64_t)i, &acked);
+        buf[0] = MESSAGE_TYPE_DATA;
+        sendto(fd, buf, len, 0, (struct sockaddr*)&peer, sizeof(peer));
+    }
+    buf[0] = MESSAGE_TYPE_STATUS;
+    if (ret == 0) {
+        ret = udp_request(fd, &peer, buf, len, 0);
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    if (ret == 0) {
+        // 窗口内不应丢包；仍有丢失时按实际送达数计算吞吐并报告
+        uint64_t delivered;
+        memcpy(&delivered, buf + 1, sizeof(delivered));
+        report("udp", samples, iterations, delivered, elapsed);
+        if (delivered < (uint64_t)iterations) {
+            printf("        udp dropped %llu of %d messages\n", (unsigned long long)(iterations - delivered), iterations);
+        }
+    } else {
+        fprintf(stderr, "UDP echo did not answer after %d retries\n", UDP_RETRIES);
+    }
+
+    kill(child, SIGTERM);
+    waitpid(child, NULL, 0);
+    close(fd);
+    free(samples);
+    free(buf);
+    return ret;
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? atoi(argv[1]) : DEFAULT_ITERATIONS;
+    size_t payload = argc > 2 ? (size_t)atoi(argv[2]) : DEFAULT_PAYLOAD;
+    if (iterations <= 0 || payload == 0 || payload > MAX_MSG_SIZE) {
+        printf("usage: %s [iterations] [payload_bytes <= %d]\n", argv[0], MAX_MSG_SIZE);
+        return 1;
+    }
+
+    printf("IPC benchmark: %d iterations, %zu byte payload\n", iterations, payload);
+#if ENABLE_SHM_TRANSPORT
+    if (bench_shm(iterations, payload) != 0) {
+        printf("shm benchmark failed\n");
+    }
+#endif
+    if (bench_udp(iterations, payload) != 0) {
+        printf("udp benchmark failed\n");
+    }
+    return 0;
+}
@@ -0,0 +1,275 @@
+// 多节点组播扩展性基准：在进程内网络仿真器上运行上百个节点
+//
+// 用法: bench_netem [nodes] [messages] [latency_us]
+//
+// 每个节点有独立的可靠组播实例，全部加入同一个组播地址；节点0向组发送消息，
+// 在不同丢包率下分别测试开启和关闭可靠组播时的投递率、端到端时延和修复开销。
+// 修复开销按每条需要修复的消息平均重传几次统计，理想值略大于1（重传本身也可能丢失）。
+// 可靠组播必须把每条消息投递到每个节点，否则以非0退出。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <time.h>
+#include "softbus_netem.h"
+#include "softbus_rmcast.h"
+#include "softbus_io.h"
+#include "softbus_wire.h"
+
+#define DEFAULT_NODES 128
+#define DEFAULT_MESSAGES 2000
+#define DEFAULT_LATENCY_US 200
+#define BENCH_GROUP "239.1.0.1"
+#define PAYLOAD_SIZE 64
+#define SEND_BATCH 20           // 每批消息之间暂停，模拟有间隔的实际流量
+#define SEND_PAUSE_US 2000
+#define SETTLE_MS 600           // 非可靠模式发送结束后等待在途数据报
+#define RECOVERY_TIMEOUT_MS 10000   // 可靠模式发送结束后等待全部投递的上限
+
+typedef struct {
+    netem_node_t* node;
+    rmcast_t* rm;
+    uint8_t* seen;              // 已投递的消息编号
+    _Atomic uint64_t delivered;
+    _Atomic uint64_t latency_sum_ns;
+} bench_node_t;
+
+static bench_node_t* g_nodes;
+static int g_node_count;
+static int g_messages;
+static bool g_reliable;
+static uint32_t* g_tx_count;    // 节点0发出每条消息的次数，大于1表示被重传过；rmcast的发送和重传都在其发送锁内
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// 从带记录的数据报中取出消息编号，不是本基准的消息返回-1
+static int64_t message_id(const uint8_t* buf, size_t len, const softbus_wire_hdr_t* hdr) {
+    if (len < (size_t)hdr->hdr_len + SOFTBUS_WIRE_REC_SIZE + 12) {
+        return -1;
+    }
+    softbus_wire_rec_t rec;
+    softbus_wire_decode_rec(buf + hdr->hdr_len, &rec);
+    uint32_t id = softbus_wire_get_u32(buf + hdr->hdr_len + softbus_wire_rec_hdr_size(&rec));
+    return id < (uint32_t)g_messages ? (int64_t)id : -1;
+}
+
+static int netem_output(void* ctx, const struct sockaddr_in* dest, const uint8_t* buf, size_t len) {
+    bench_node_t* bn = ctx;
+    softbus_wire_hdr_t hdr;
+    if (bn == &g_nodes[0] && softbus_wire_decode_hdr(buf, len, &hdr) == 0 && !(hdr.flags & SOFTBUS_WIRE_FLAG_CONTROL)) {
+        int64_t id = message_id(buf, len, &hdr);
+        if (id >= 0) {
+            g_tx_count[id]++;
+        }
+    }
+    return netem_send(bn->node, dest, buf, len);
+}
+
+// 节点接收回调：与socket层相同的帧处理顺序（控制帧、序号去重、记录）
+static void node_receive(netem_node_t* node, const struct sockaddr_in* from,
+                         const uint8_t* buf, size_t len, void* ctx) {
+    (void)node;
+    bench_node_t* bn = ctx;
+    softbus_wire_hdr_t hdr;
+    if (softbus_wire_decode_hdr(buf, len, &hdr) != 0) {
+        return;
+    }
+    if (hdr.flags & SOFTBUS_WIRE_FLAG_CONTROL) {
+        rmcast_handle_control(bn->rm, &hdr, buf + hdr.hdr_len, len - hdr.hdr_len, from);
+        return;
+    }
+    if ((hdr.flags & SOFTBUS_WIRE_FLAG_SEQ) && !rmcast_accept(bn->rm, &hdr, from)) {
+        return;
+    }
+    int64_t id = message_id(buf, len, &hdr);
+    if (id < 0 || bn->seen[id]) {
+        return;
+    }
+
+    softbus_wire_rec_t rec;
+    softbus_wire_decode_rec(buf + hdr.hdr_len, &rec);
+    const uint8_t* payload = buf + hdr.hdr_len + softbus_wire_rec_hdr_size(&rec);
+    uint64_t sent_ns;
+    memcpy(&sent_ns, payload + 4, sizeof(sent_ns));
+    bn->seen[id] = 1;
+    atomic_fetch_add_explicit(&bn->delivered, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&bn->latency_sum_ns, now_ns() - sent_ns, memory_order_relaxed);
+}
+
+static uint64_t total_delivered(void) {
+    uint64_t delivered = 0;
+    for (int i = 1; i < g_node_count; i++) {
+        delivered += atomic_load(&g_nodes[i].delivered);
+    }
+    return delivered;
+}
+
+static void send_message(bench_node_t* sender, const struct sockaddr_in* group, uint32_t id) {
+    uint8_t frame[SOFTBUS_WIRE_HDR_SIZE + SOFTBUS_WIRE_REC_SIZE + PAYLOAD_SIZE];
+    softbus_wire_hdr_t hdr = {.magic = SOFTBUS_WIRE_MAGIC, .version = SOFTBUS_WIRE_VERSION,
+                              .count = 1, .node_id = (uint32_t)netem_node_index(sender->node) + 1};
+    softbus_wire_rec_t rec = {PAYLOAD_SIZE, 0, 0, 0};
+    softbus_wire_encode_hdr(frame, &hdr);
+    softbus_wire_encode_rec(frame + SOFTBUS_WIRE_HDR_SIZE, &rec);
+
+    uint8_t* payload = frame + SOFTBUS_WIRE_HDR_SIZE + SOFTBUS_WIRE_REC_SIZE;
+    memset(payload, 0, PAYLOAD_SIZE);
+    softbus_wire_put_u32(payload, id);
+    uint64_t ts = now_ns();
+    memcpy(payload + 4, &ts, sizeof(ts));
+
+    if (g_reliable) {
+        rmcast_send(sender->rm, group, frame, sizeof(frame));
+    } else {
+        netem_send(sender->node, group, frame, sizeof(frame));
+    }
+}
+
+// 返回false表示可靠模式下有消息未投递
+static bool run_case(netem_t* net, const netem_config_t* cfg, bool reliable) {
+    netem_set_config(net, cfg);
+    netem_reset_stats(net);
+    g_reliable = reliable;
+    for (int i = 0; i < g_node_count; i++) {
+        memset(g_nodes[i].seen, 0, (size_t)g_messages);
+        atomic_store(&g_nodes[i].delivered, 0);
+        atomic_store(&g_nodes[i].latency_sum_ns, 0);
+        rmcast_reset_stats(g_nodes[i].rm);
+    }
+    memset(g_tx_count, 0, (size_t)g_messages * sizeof(*g_tx_count));
+
+    struct sockaddr_in group;
+    memset(&group, 0, sizeof(group));
+    group.sin_family = AF_INET;
+    group.sin_addr.s_addr = inet_addr(BENCH_GROUP);
+    group.sin_port = htons(NETEM_NODE_PORT);
+
+    uint64_t expected = (uint64_t)g_messages * (uint64_t)(g_node_count - 1);
+    uint64_t start = now_ns();
+    for (int i = 0; i < g_messages; i++) {
+        send_message(&g_nodes[0], &group, (uint32_t)i);
+        if ((i + 1) % SEND_BATCH == 0) {
+            usleep(SEND_PAUSE_US);
+        }
+    }
+    if (reliable) {
+        // 等到全部修复完成，elapsed即包含修复时间
+        for (int waited = 0; total_delivered() < expected && waited < RECOVERY_TIMEOUT_MS; waited++) {
+            usleep(1000);
+        }
+    } else {
+        usleep(SETTLE_MS * 1000);
+    }
+    double elapsed = (double)(now_ns() - start) / 1e9;
+    // 在途的重传和心跳不计入下一轮
+    netem_drain(net, 1000);
+
+    uint64_t delivered = 0;
+    uint64_t latency_sum = 0;
+    uint64_t worst = (uint64_t)g_messages;
+    rmcast_stats_t total = {0};
+    for (int i = 1; i < g_node_count; i++) {
+        uint64_t d = atomic_load(&g_nodes[i].delivered);
+        delivered += d;
+        latency_sum += atomic_load(&g_nodes[i].latency_sum_ns);
+        if (d < worst) {
+            worst = d;
+        }
+    }
+    for (int i = 0; i < g_node_count; i++) {
+        rmcast_stats_t st;
+        rmcast_get_stats(g_nodes[i].rm, &st);
+        total.retransmits += st.retransmits;
+        total.nacks_sent += st.nacks_sent;
+        total.nacks_suppressed += st.nacks_suppressed;
+        total.rx_lost += st.rx_lost;
+    }
+    uint64_t repaired = 0;
+    for (int i = 0; i < g_messages; i++) {
+        repaired += g_tx_count[i] > 1;
+    }
+    netem_stats_t ns;
+    netem_get_stats(net, &ns);
+
+    printf("  loss %5.1f%%  %-10s delivered %7.3f%%  worst node %5.1f%%  avg latency %8.1f us  "
+           "retx %6llu  repaired %5llu (%.2f/msg)  nacks %6llu  suppressed %6llu  lost %6llu  copies %8llu  (%.1fs)\n",
+           cfg->loss * 100.0, reliable ? "reliable" : "raw",
+           expected ? 100.0 * (double)delivered / (double)expected : 0.0,
+           100.0 * (double)worst / (double)g_messages,
+           delivered ? (double)latency_sum / (double)delivered / 1000.0 : 0.0,
+           (unsigned long long)total.retransmits, (unsigned long long)repaired,
+           repaired ? (double)total.retransmits / (double)repaired : 0.0,
+           (unsigned long long)total.nacks_sent, (unsigned long long)total.nacks_suppressed,
+           (unsigned long long)total.rx_lost, (unsigned long long)ns.delivered, elapsed);
+
+    if (reliable && (delivered != expected || total.rx_lost != 0)) {
+        fprintf(stderr, "FAIL: reliable multicast delivered %llu of %llu messages at %.1f%% loss\n",
+                (unsigned long long)delivered, (unsigned long long)expected, cfg->loss * 100.0);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    g_node_count = argc > 1 ? atoi(argv[1]) : DEFAULT_NODES;
+    g_messages = argc > 2 ? atoi(argv[2]) : DEFAULT_MESSAGES;
+    uint32_t latency_us = argc > 3 ? (uint32_t)atoi(argv[3]) : DEFAULT_LATENCY_US;
+    if (g_node_count < 2 || g_node_count > NETEM_MAX_NODES || g_messages <= 0) {
+        fprintf(stderr, "usage: %s [nodes 2..%d] [messages] [latency_us]\n", argv[0], NETEM_MAX_NODES);
+        return 1;
+    }
+
+    // rmcast的NACK和心跳定时器运行在IO线程
+    if (softbus_io_init() != SOFTBUS_OK || softbus_io_start() != SOFTBUS_OK) {
+        fprintf(stderr, "Failed to start IO engine\n");
+        return 1;
+    }
+
+    netem_config_t cfg = {.latency_us = latency_us, .jitter_us = latency_us / 4,
+                          .reorder = 0.01, .reorder_delay_us = latency_us, .seed = 1};
+    netem_t* net = netem_create(&cfg);
+    g_nodes = calloc((size_t)g_node_count, sizeof(*g_nodes));
+    g_tx_count = calloc((size_t)g_messages, sizeof(*g_tx_count));
+    if (!net || !g_nodes || !g_tx_count) {
+        fprintf(stderr, "Failed to create emulated network\n");
+        return 1;
+    }
+    for (int i = 0; i < g_node_count; i++) {
+        g_nodes[i].node = netem_node_add(net, node_receive, &g_nodes[i]);
+        g_nodes[i].rm = rmcast_create((uint32_t)i + 1, NETEM_NODE_PORT, netem_output, &g_nodes[i]);
+        g_nodes[i].seen = calloc((size_t)g_messages, 1);
+        if (!g_nodes[i].node || !g_nodes[i].rm || !g_nodes[i].seen) {
+            fprintf(stderr, "Failed to create node %d\n", i);
+            return 1;
+        }
+        netem_join(g_nodes[i].node, inet_addr(BENCH_GROUP));
+    }
+
+    printf("Multicast fan-out: %d nodes, %d messages, latency %u us\n", g_node_count, g_messages, latency_us);
+    const double losses[] = {0.0, 0.01, 0.05};
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(losses) / sizeof(losses[0]); i++) {
+        cfg.loss = losses[i];
+        run_case(net, &cfg, false);
+        ok = run_case(net, &cfg, true) && ok;
+    }
+
+    // 先停止定时器和投递线程，再释放节点
+    softbus_io_stop();
+    netem_destroy(net);
+    for (int i = 0; i < g_node_count; i++) {
+        rmcast_destroy(g_nodes[i].rm);
+        free(g_nodes[i].seen);
+    }
+    free(g_nodes);
+    free(g_tx_count);
+    softbus_io_deinit();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,290 @@
+// 消息队列后端对比基准：红黑树、4叉堆、优先级桶
+//
+// 用法: bench_queue [output.json] [ops]
+//
+// 对每种后端、队列深度和优先级分布组合：
+//   fill  从空队列入队depth条消息，每条的平均耗时
+//   hold  保持深度不变，交替出队一条、入队一条新消息（设备处理线程的稳态），每对操作的平均耗时
+//   drain 取空队列，每条的平均耗时；同时检查出队顺序（优先级不升，同优先级先进先出）
+// 优先级分布：single全部NORMAL；uniform四档均匀；skewed 90% NORMAL、9% HIGH、1% URGENT；
+// bursty 大部分LOW，每64条中连续8条URGENT。
+// 直接调用prio_queue接口，不经过设备查找和加锁，结果只反映数据结构本身。
+// 最后检查RB_DEFINE_TYPED_MIN：ops次随机插入/删除，每步把全树最小值与参照计数比较。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "prio_queue.h"
+#include "rbtree_typed.h"
+
+#define DEFAULT_OPS 200000
+
+static const int g_depths[] = {16, 1024, 16384, 65536};
+#define DEPTH_COUNT ((int)(sizeof(g_depths) / sizeof(g_depths[0])))
+#define MAX_DEPTH 65536
+#define AUG_POOL 4096               // 增强树检查的元素池，约一半在树中
+#define AUG_KEYS 1024               // 排序键取值范围，制造大量相等元素
+#define AUG_DEADLINES 4096          // 被维护最小值的字段取值范围
+
+typedef enum {
+    DIST_SINGLE,
+    DIST_UNIFORM,
+    DIST_SKEWED,
+    DIST_BURSTY,
+    DIST_COUNT
+} dist_t;
+
+static const char* g_dist_names[DIST_COUNT] = {"single", "uniform", "skewed", "bursty"};
+
+typedef struct {
+    softbus_queue_backend_t backend;
+    int depth;
+    dist_t dist;
+    double fill_ns;
+    double hold_ns;
+    double drain_ns;
+    int order_ok;
+} queue_result_t;
+
+static uint64_t g_rng = 0x9e3779b97f4a7c15ULL;
+static uint64_t g_seq;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t next_rand(void) {
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    return (uint32_t)(g_rng >> 32);
+}
+
+static softbus_priority_t pick_priority(dist_t dist) {
+    uint32_t r;
+    switch (dist) {
+    case DIST_UNIFORM:
+        return (softbus_priority_t)(next_rand() & 3);
+    case DIST_SKEWED:
+        r = next_rand() % 100;
+        return r < 90 ? PRIORITY_NORMAL : (r < 99 ? PRIORITY_HIGH : PRIORITY_URGENT);
+    case DIST_BURSTY:
+        return (g_seq & 63) < 8 ? PRIORITY_URGENT : PRIORITY_LOW;
+    default:
+        return PRIORITY_NORMAL;
+    }
+}
+
+// 按入队顺序生成时间戳和序号，与message_queue_send在入队前取时间一致
+static void prepare(message_t* msg, dist_t dist) {
+    msg->priority = pick_priority(dist);
+    msg->msg_id = g_seq;
+    msg->timestamp.tv_sec = (time_t)(g_seq / 1000000000ULL);
+    msg->timestamp.tv_nsec = (long)(g_seq % 1000000000ULL);
+    g_seq++;
+}
+
+static queue_result_t run_case(softbus_queue_backend_t backend, int depth, dist_t dist, int ops,
+                               message_t* pool) {
+    queue_result_t res = {backend, depth, dist, 0, 0, 0, 1};
+    prio_queue_t* q = prio_queue_create(backend);
+    if (!q) {
+        res.order_ok = 0;
+        return res;
+    }
+    g_rng = 0x9e3779b97f4a7c15ULL;
+    g_seq = 0;
+
+    // 池中多留一条，hold阶段先出队再复用出队的消息
+    for (int i = 0; i < depth; i++) {
+        prepare(&pool[i], dist);
+    }
+    uint64_t start = now_ns();
+    for (int i = 0; i < depth; i++) {
+        prio_queue_push(q, &pool[i]);
+    }
+    res.fill_ns = (double)(now_ns() - start) / depth;
+
+    start = now_ns();
+    for (int i = 0; i < ops; i++) {
+        message_t* msg = prio_queue_pop(q);
+        prepare(msg, dist);
+        prio_queue_push(q, msg);
+    }
+    res.hold_ns = (double)(now_ns() - start) / ops;
+
+    int prev_prio = PRIORITY_URGENT + 1;
+    uint64_t prev_id = 0;
+    start = now_ns();
+    for (int i = 0; i < depth; i++) {
+        message_t* msg = prio_queue_pop(q);
+        if (!msg) {
+            res.order_ok = 0;
+            break;
+        }
+        if ((int)msg->priority > prev_prio || ((int)msg->priority == prev_prio && msg->msg_id < prev_id)) {
+            res.order_ok = 0;
+        }
+        prev_prio = (int)msg->priority;
+        prev_id = msg->msg_id;
+    }
+    res.drain_ns = (double)(now_ns() - start) / depth;
+    if (prio_queue_size(q) != 0) {
+        res.order_ok = 0;
+    }
+
+    prio_queue_destroy(q);
+    return res;
+}
+
+// ---- 增强最小值：元素按key排序，同时维护子树中最早的deadline ----
+
+typedef struct {
+    struct rb_node node;
+    uint32_t key;
+    uint32_t deadline;
+    uint32_t min_deadline;
+    bool linked;
+} aug_item_t;
+
+static inline int aug_cmp(const aug_item_t* a, const aug_item_t* b) {
+    return a->key < b->key ? -1 : (a->key > b->key ? 1 : 0);
+}
+
+static inline uint32_t aug_deadline(const aug_item_t* item) {
+    return item->deadline;
+}
+
+RB_DEFINE_TYPED_MIN(augt, aug_item_t, node, aug_cmp, uint32_t, min_deadline, aug_deadline)
+
+// 中序遍历检查每个节点的子树最小值，以及min_node是中序第一个取得最小值的元素
+static bool aug_check_tree(const struct rb_root_cached* root) {
+    uint32_t min;
+    if (!augt_subtree_min(root, &min)) {
+        return augt_first(root) == NULL && augt_min_node(root) == NULL;
+    }
+    aug_item_t* first_min = NULL;
+    for (aug_item_t* it = augt_first(root); it; it = augt_next(it)) {
+        if (it->min_deadline != augt_aug_compute_(it)) {
+            return false;
+        }
+        if (!first_min && it->deadline == min) {
+            first_min = it;
+        }
+    }
+    return first_min && first_min == augt_min_node(root);
+}
+
+// 随机插入/删除ops次，每步把subtree_min和min_node与按deadline计数的参照比较，每1024步检查整棵树
+static bool run_aug_case(int ops) {
+    aug_item_t* pool = calloc(AUG_POOL, sizeof(aug_item_t));
+    int* counts = calloc(AUG_DEADLINES, sizeof(int));
+    struct rb_root_cached root = RB_ROOT_CACHED;
+    bool ok = pool && counts && aug_check_tree(&root);
+    g_rng = 0x9e3779b97f4a7c15ULL;
+
+    for (int i = 0; i < ops && ok; i++) {
+        aug_item_t* item = &pool[next_rand() % AUG_POOL];
+        if (item->linked) {
+            augt_erase(&root, item);
+            counts[item->deadline]--;
+            item->linked = false;
+        } else {
+            item->key = next_rand() % AUG_KEYS;
+            item->deadline = next_rand() % AUG_DEADLINES;
+            augt_insert(&root, item);
+            counts[item->deadline]++;
+            item->linked = true;
+        }
+
+        uint32_t expect = 0;
+        while (expect < AUG_DEADLINES && counts[expect] == 0) {
+            expect++;
+        }
+        uint32_t min;
+        bool has = augt_subtree_min(&root, &min);
+        aug_item_t* node = augt_min_node(&root);
+        if (expect == AUG_DEADLINES) {
+            ok = !has && !node;
+        } else {
+            ok = has && min == expect && node && node->deadline == expect;
+        }
+        if (ok && (i & 1023) == 0) {
+            ok = aug_check_tree(&root);
+        }
+    }
+    ok = ok && aug_check_tree(&root);
+
+    free(counts);
+    free(pool);
+    return ok;
+}
+
+static void write_json(const char* path, const queue_result_t* results, int count, int ops) {
+    FILE* fp = fopen(path, "w");
+    if (!fp) {
+        perror("fopen");
+        return;
+    }
+    fprintf(fp, "{\n  \"ops\": %d,\n  \"results\": [\n", ops);
+    for (int i = 0; i < count; i++) {
+        const queue_result_t* r = &results[i];
+        fprintf(fp,
+                "    {\"backend\": \"%s\", \"depth\": %d, \"dist\": \"%s\", \"fill_ns\": %.1f, "
+                "\"hold_ns\": %.1f, \"drain_ns\": %.1f, \"order_ok\": %s}%s\n",
+                prio_queue_backend_name(r->backend), r->depth, g_dist_names[r->dist], r->fill_ns, r->hold_ns,
+                r->drain_ns, r->order_ok ? "true" : "false", i + 1 < count ? "," : "");
+    }
+    fprintf(fp, "  ]\n}\n");
+    fclose(fp);
+    printf("results written to %s\n", path);
+}
+
+int main(int argc, char* argv[]) {
+    const char* output = argc > 1 ? argv[1] : NULL;
+    int ops = argc > 2 ? atoi(argv[2]) : DEFAULT_OPS;
+    if (ops <= 0) {
+        fprintf(stderr, "usage: %s [output.json] [ops]\n", argv[0]);
+        return 1;
+    }
+
+    message_t* pool = calloc(MAX_DEPTH, sizeof(message_t));
+    queue_result_t* results = calloc(SOFTBUS_QUEUE_BACKEND_COUNT * DEPTH_COUNT * DIST_COUNT, sizeof(queue_result_t));
+    if (!pool || !results) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    int count = 0;
+    int failed = 0;
+    printf("%-8s %-8s %7s %10s %10s %10s  %s\n", "dist", "backend", "depth", "fill ns", "hold ns", "drain ns",
+           "order");
+    for (int d = 0; d < DIST_COUNT; d++) {
+        for (int i = 0; i < DEPTH_COUNT; i++) {
+            for (int b = 0; b < SOFTBUS_QUEUE_BACKEND_COUNT; b++) {
+                queue_result_t r = run_case((softbus_queue_backend_t)b, g_depths[i], (dist_t)d, ops, pool);
+                results[count++] = r;
+                failed += !r.order_ok;
+                printf("%-8s %-8s %7d %10.1f %10.1f %10.1f  %s\n", g_dist_names[d],
+                       prio_queue_backend_name(r.backend), r.depth, r.fill_ns, r.hold_ns, r.drain_ns,
+                       r.order_ok ? "ok" : "WRONG");
+            }
+        }
+    }
+
+    bool aug_ok = run_aug_case(ops);
+    failed += !aug_ok;
+    printf("augmented min: %d random inserts/erases  %s\n", ops, aug_ok ? "ok" : "WRONG");
+
+    if (output) {
+        write_json(output, results, count, ops);
+    }
+    free(results);
+    free(pool);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,681 @@
+// 总线吞吐与时延基准套件
+//
+// 用法: bench_suite [output.json] [scale]
+//
+// 覆盖单播异步、单播同步往返、组扇出、多生产者竞争、设备查找、设备表布局对比、大组、深队列取队头和组播回环，
+// 分别扫描负载大小、设备数、线程数和队列深度。大组用例按MAX_DEVICES注册设备，
+// 测量成员加入、扇出和注销（从所在组移除）的开销；make bench按BENCH_MAX_DEVICES（默认4096）编译，达到数千个设备。每个用例在终端打印一行摘要，
+// 并把p50/p99/p999时延和消息速率写入JSON文件，便于对比不同版本发现性能回退。
+// scale按比例调整每个用例的迭代次数（默认1.0）。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/wait.h>
+#include <time.h>
+#include "softbus.h"
+#include "softbus_internal.h"
+#include "softbus_socket.h"
+#include "message_queue.h"
+#include "device_manager.h"
+#include "softbus_log.h"
+
+#define DEFAULT_OUTPUT "build/bench_results.json"
+#define MC_GROUP "bench_mc"
+#define MC_REPLY_GROUP "bench_mc_reply"
+#define MC_REPLY_TIMEOUT_NS 100000000ULL
+
+static double g_scale = 1.0;
+static FILE* g_json;
+static int g_results;
+
+static _Atomic uint64_t g_handled;
+static _Atomic uint64_t g_mc_replies;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int iterations(int base) {
+    int n = (int)(base * g_scale);
+    return n > 10 ? n : 10;
+}
+
+static int cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+// 输出一个用例的结果；params为JSON对象的成员列表，如 "\"payload\": 64"
+static void report(const char* bench, const char* params, uint64_t* samples, int count,
+                   uint64_t msgs, uint64_t elapsed_ns) {
+    if (count <= 0) {
+        return;
+    }
+    qsort(samples, (size_t)count, sizeof(uint64_t), cmp_u64);
+    uint64_t p50 = samples[count / 2];
+    uint64_t p99 = samples[(int)(count * 0.99)];
+    uint64_t p999 = samples[(int)(count * 0.999)];
+    double rate = elapsed_ns ? (double)msgs * 1e9 / (double)elapsed_ns : 0.0;
+
+    printf("%-18s %-28s p50=%9.2fus  p99=%9.2fus  p999=%9.2fus  %12.0f msgs/s\n",
+           bench, params, p50 / 1000.0, p99 / 1000.0, p999 / 1000.0, rate);
+    fprintf(g_json,
+            "%s    {\"bench\": \"%s\", \"params\": {%s}, \"iterations\": %d, "
+            "\"p50_ns\": %llu, \"p99_ns\": %llu, \"p999_ns\": %llu, \"msgs_per_sec\": %.1f}",
+            g_results ? ",\n" : "", bench, params, count,
+            (unsigned long long)p50, (unsigned long long)p99, (unsigned long long)p999, rate);
+    g_results++;
+}
+
+static int count_handler(const void* data, size_t len, message_type_t type) {
+    (void)data;
+    (void)len;
+    (void)type;
+    atomic_fetch_add_explicit(&g_handled, 1, memory_order_relaxed);
+    return SOFTBUS_OK;
+}
+
+static int text_handler(const char* msg, message_type_t type) {
+    (void)msg;
+    (void)type;
+    atomic_fetch_add_explicit(&g_handled, 1, memory_order_relaxed);
+    return SOFTBUS_OK;
+}
+
+static char* make_text(size_t len) {
+    char* text = malloc(len);
+    if (text) {
+        memset(text, 'x', len - 1);
+        text[len - 1] = '\0';
+    }
+    return text;
+}
+
+// ---- 单播异步：进程内入队并立即分发 ----
+
+static void bench_unicast_async(void) {
+    static const size_t payloads[] = {16, 256, 4096, 65536};
+    softbus_api_register_device_raw(DEVICE_TYPE_OTHER, "ua_sink", count_handler);
+
+    for (size_t p = 0; p < sizeof(payloads) / sizeof(payloads[0]); p++) {
+        int n = iterations(20000);
+        uint8_t* data = calloc(1, payloads[p]);
+        uint64_t* samples = calloc((size_t)n, sizeof(uint64_t));
+
+        uint64_t start = now_ns();
+        for (int i = 0; i < n; i++) {
+            uint64_t t0 = now_ns();
+            softbus_api_send_data_ex("ua_sink", MESSAGE_TYPE_DATA, data, payloads[p], PRIORITY_NORMAL);
+            samples[i] = now_ns() - t0;
+        }
+        uint64_t elapsed = now_ns() - start;
+
+        char params[64];
+        snprintf(params, sizeof(params), "\"payload\": %zu", payloads[p]);
+        report("unicast_async", params, samples, n, (uint64_t)n, elapsed);
+        free(samples);
+        free(data);
+    }
+    softbus_api_unregister_device("ua_sink");
+}
+
+// ---- 单播同步往返：等待完成回调 ----
+
+static void bench_unicast_sync(void) {
+    static const size_t payloads[] = {16, 256, 1000};
+    softbus_api_register_device(DEVICE_TYPE_OTHER, "us_sink", text_handler);
+
+    for (size_t p = 0; p < sizeof(payloads) / sizeof(payloads[0]); p++) {
+        int n = iterations(5000);
+        char* text = make_text(payloads[p]);
+        uint64_t* samples = calloc((size_t)n, sizeof(uint64_t));
+
+        uint64_t start = now_ns();
+        for (int i = 0; i < n; i++) {
+            uint64_t t0 = now_ns();
+            softbus_api_send_message_ex("us_sink", MESSAGE_TYPE_DATA, text, PRIORITY_NORMAL,
+                                        SOFTBUS_MODE_SYNC, 1000);
+            samples[i] = now_ns() - t0;
+        }
+        uint64_t elapsed = now_ns() - start;
+
+        char params[64];
+        snprintf(params, sizeof(params), "\"payload\": %zu", payloads[p]);
+        report("unicast_sync", params, samples, n, (uint64_t)n, elapsed);
+        free(samples);
+        free(text);
+    }
+    softbus_api_unregister_device("us_sink");
+}
+
+// ---- 组扇出：一条组消息投递给所有本地成员 ----
+
+static void bench_group_fanout(void) {
+    static const int member_counts[] = {1, 4, 16};
+    char* text = make_text(64);
+
+    for (size_t m = 0; m < sizeof(member_counts) / sizeof(member_counts[0]); m++) {
+        int members = member_counts[m];
+        softbus_api_create_group("fanout");
+        for (int i = 0; i < members; i++) {
+            char name[MAX_NAME_LENGTH];
+            snprintf(name, sizeof(name), "fan_%d", i);
+            softbus_api_register_device(DEVICE_TYPE_OTHER, name, text_handler);
+            softbus_api_add_to_group("fanout", name);
+        }
+
+        int n = iterations(5000);
+        uint64_t* samples = calloc((size_t)n, sizeof(uint64_t));
+        atomic_store(&g_handled, 0);
+        uint64_t start = now_ns();
+        for (int i = 0; i < n; i++) {
+            uint64_t t0 = now_ns();
+            softbus_api_send_group_message("fanout", MESSAGE_TYPE_DATA, text, PRIORITY_NORMAL);
+            samples[i] = now_ns() - t0;
+        }
+        uint64_t elapsed = now_ns() - start;
+
+        char params[64];
+        snprintf(params, sizeof(params), "\"members\": %d, \"payload\": 64", members);
+        report("group_fanout", params, samples, n, atomic_load(&g_handled), elapsed);
+        free(samples);
+
+        softbus_api_delete_group("fanout");
+        for (int i = 0; i < members; i++) {
+            char name[MAX_NAME_LENGTH];
+            snprintf(name, sizeof(name), "fan_%d", i);
+            softbus_api_unregister_device(name);
+        }
+    }
+    free(text);
+}
+
+// ---- 多生产者竞争：每个线程向自己的设备发送，竞争设备表、回调表和分配器 ----
+
+typedef struct {
+    pthread_barrier_t* barrier;
+    char device[MAX_NAME_LENGTH];
+    uint64_t* samples;
+    int count;
+    uint64_t start_ns;      // 本线程开始和结束发送的时间，总耗时取最早开始到最晚结束
+    uint64_t end_ns;
+} producer_t;
+
+static void* producer_thread(void* arg) {
+    producer_t* p = arg;
+    uint8_t data[64] = {0};
+    pthread_barrier_wait(p->barrier);
+    p->start_ns = now_ns();
+    for (int i = 0; i < p->count; i++) {
+        uint64_t t0 = now_ns();
+        softbus_api_send_data_ex(p->device, MESSAGE_TYPE_DATA, data, sizeof(data), PRIORITY_NORMAL);
+        p->samples[i] = now_ns() - t0;
+    }
+    p->end_ns = now_ns();
+    return NULL;
+}
+
+static void bench_multi_producer(void) {
+    static const int thread_counts[] = {1, 2, 4, 8};
+
+    for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+        int threads = thread_counts[t];
+        int per_thread = iterations(10000);
+        uint64_t* samples = calloc((size_t)threads * (size_t)per_thread, sizeof(uint64_t));
+        producer_t producers[8];
+        pthread_t tids[8];
+        pthread_barrier_t barrier;
+        pthread_barrier_init(&barrier, NULL, (unsigned)threads + 1);
+
+        for (int i = 0; i < threads; i++) {
+            producers[i].barrier = &barrier;
+            snprintf(producers[i].device, sizeof(producers[i].device), "mp_%d", i);
+            producers[i].samples = samples + (size_t)i * (size_t)per_thread;
+            producers[i].count = per_thread;
+            softbus_api_register_device_raw(DEVICE_TYPE_OTHER, producers[i].device, count_handler);
+            pthread_create(&tids[i], NULL, producer_thread, &producers[i]);
+        }
+
+        // 主线程越过屏障后可能晚于生产者被调度，由各线程自己计时
+        pthread_barrier_wait(&barrier);
+        uint64_t start = UINT64_MAX;
+        uint64_t end = 0;
+        for (int i = 0; i < threads; i++) {
+            pthread_join(tids[i], NULL);
+            start = producers[i].start_ns < start ? producers[i].start_ns : start;
+            end = producers[i].end_ns > end ? producers[i].end_ns : end;
+        }
+        uint64_t elapsed = end - start;
+
+        char params[64];
+        snprintf(params, sizeof(params), "\"threads\": %d, \"payload\": 64", threads);
+        int total = threads * per_thread;
+        report("multi_producer", params, samples, total, (uint64_t)total, elapsed);
+
+        for (int i = 0; i < threads; i++) {
+            softbus_api_unregister_device(producers[i].device);
+        }
+        pthread_barrier_destroy(&barrier);
+        free(samples);
+    }
+}
+
+// ---- 设备查找：注册N个设备后按名称查找，N从4倍增到设备表容量 ----
+
+static void bench_registry_lookup(void) {
+    int max_devices = MAX_DEVICES > 20 ? MAX_DEVICES - 16 : 4;  // 留出其他用例和总线自身的设备
+    char (*names)[MAX_NAME_LENGTH] = malloc((size_t)max_devices * MAX_NAME_LENGTH);
+
+    for (int devices = 4; ; devices *= 2) {
+        if (devices > max_devices) {
+            devices = max_devices;
+        }
+        int registered = 0;
+        for (int i = 0; i < devices; i++) {
+            snprintf(names[registered], MAX_NAME_LENGTH, "reg_%d", i);
+            if (softbus_api_register_device_raw(DEVICE_TYPE_OTHER, names[registered], count_handler) == SOFTBUS_OK) {
+                registered++;
+            }
+        }
+        if (registered == 0) {
+            break;
+        }
+
+        int n = iterations(100000);
+        uint64_t* samples = calloc((size_t)n, sizeof(uint64_t));
+        uint64_t start = now_ns();
+        for (int i = 0; i < n; i++) {
+            uint64_t t0 = now_ns();
+            softbus_api_is_device_registered(names[i % registered]);
+            samples[i] = now_ns() - t0;
+        }
+        uint64_t elapsed = now_ns() - start;
+
+        char params[64];
+        snprintf(params, sizeof(params), "\"devices\": %d", registered);
+        report("registry_lookup", params, samples, n, (uint64_t)n, elapsed);
+        free(samples);
+
+        for (int i = 0; i < registered; i++) {
+            softbus_api_unregister_device(names[i]);
+        }
+        if (devices == max_devices) {
+            break;
+        }
+    }
+    free(names);
+}
+
+// ---- 设备表布局：按名称查找设备并取得队列指针（分发前的第一步），对比拆分前后的内存布局 ----
+// 两种布局都在这里按原样复刻、不加锁，只比较访问的缓存行：
+// 旧布局是拆分前的设备记录数组（约136字节一条），逐条比较名称；
+// 新布局与device_manager.c相同：紧凑的哈希数组扫描，命中后比较冷记录中的名称，再读独占缓存行的热槽。
+
+typedef struct {
+    char name[MAX_NAME_LENGTH];
+    device_type_t type;
+    device_ops_t ops;
+    void* private_data;
+    void* msg_tree;  // 拆分前队列根节点嵌在记录中
+    void (*msg_callback)(void* msg);
+} old_record_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    void* queue;
+    atomic_int refs;
+    atomic_bool live;
+} __attribute__((aligned(64))) hot_slot_t;
+
+static uint32_t layout_hash(const char* name) {
+    uint32_t h = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        h = (h ^ *p) * 16777619u;
+    }
+    return h;
+}
+
+static void* old_layout_lookup(const old_record_t* records, int count, const char* name) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(records[i].name, name) == 0) {
+            return records[i].msg_tree;
+        }
+    }
+    return NULL;
+}
+
+static void* new_layout_lookup(const uint32_t* hash, const uint16_t* slot, int count,
+                               const device_manager_t* records, hot_slot_t* hot, const char* name) {
+    uint32_t h = layout_hash(name);
+    for (int i = 0; i < count; i++) {
+        if (hash[i] == h && strcmp(records[slot[i]].name, name) == 0) {
+            hot_slot_t* s = &hot[slot[i]];
+            return atomic_load_explicit(&s->live, memory_order_relaxed) ? s->queue : NULL;
+        }
+    }
+    return NULL;
+}
+
+static void bench_registry_layout(void) {
+    static const int device_counts[] = {4, 32, 256, 1024, 4096};
+    const int batch = 64;  // 单次查找只有几十纳秒，按批计时取平均
+
+    for (size_t d = 0; d < sizeof(device_counts) / sizeof(device_counts[0]); d++) {
+        int devices = device_counts[d];
+        old_record_t* old_records = calloc((size_t)devices, sizeof(old_record_t));
+        device_manager_t* records = calloc((size_t)devices, sizeof(device_manager_t));
+        hot_slot_t* hot = aligned_alloc(64, (size_t)devices * sizeof(hot_slot_t));
+        uint32_t* hash = malloc((size_t)devices * sizeof(uint32_t));
+        uint16_t* slot = malloc((size_t)devices * sizeof(uint16_t));
+        memset(hot, 0, (size_t)devices * sizeof(hot_slot_t));
+        for (int i = 0; i < devices; i++) {
+            snprintf(old_records[i].name, MAX_NAME_LENGTH, "layout_%d", i);
+            old_records[i].msg_tree = &old_records[i];
+            memcpy(records[i].name, old_records[i].name, MAX_NAME_LENGTH);
+            hot[i].queue = &records[i];
+            atomic_init(&hot[i].live, true);
+            hash[i] = layout_hash(records[i].name);
+            slot[i] = (uint16_t)i;
+        }
+
+        int n = iterations(2000);
+        uint64_t* samples = calloc((size_t)n, sizeof(uint64_t));
+        uint32_t seed = 1;
+        void* volatile sink = NULL;
+        for (int layout = 0; layout < 2; layout++) {
+            uint64_t start = now_ns();
+            for (int i = 0; i < n; i++) {
+                uint64_t t0 = now_ns();
+                for (int j = 0; j < batch; j++) {
+                    seed = seed * 1103515245u + 12345u;
+                    const char* name = old_records[(seed >> 8) % (uint32_t)devices].name;
+                    sink = layout ? new_layout_lookup(hash, slot, devices, records, hot, name)
+                                  : old_layout_lookup(old_records, devices, name);
+                }
+                samples[i] = (now_ns() - t0) / (uint64_t)batch;
+            }
+            uint64_t elapsed = now_ns() - start;
+
+            char params[64];
+            snprintf(params, sizeof(params), "\"layout\": \"%s\", \"devices\": %d", layout ? "split" : "aos", devices);
+            report("registry_layout", params, samples, n, (uint64_t)n * (uint64_t)batch, elapsed);
+        }
+        (void)sink;
+
+        free(samples);
+        free(slot);
+        free(hash);
+        free(hot);
+        free(records);
+        free(old_records);
+    }
+}
+
+// ---- 大组：MAX_DEVICES规模的本地设备加入同一个组，注销时经反向索引从组中移除 ----
+
+static void bench_large_group(void) {
+    int devices = MAX_DEVICES - 16;     // 留出其他用例和总线自身的设备
+    char (*names)[MAX_NAME_LENGTH] = malloc((size_t)devices * MAX_NAME_LENGTH);
+    uint64_t* samples = calloc((size_t)devices, sizeof(uint64_t));
+    char* text = make_text(64);
+    softbus_api_create_group("large");
+
+    int members = 0;
+    uint64_t start = now_ns();
+    for (int i = 0; i < devices; i++) {
+        snprintf(names[i], MAX_NAME_LENGTH, "big_%d", i);
+        if (softbus_api_register_device(DEVICE_TYPE_OTHER, names[i], text_handler) != SOFTBUS_OK) {
+            break;
+        }
+        uint64_t t0 = now_ns();
+        softbus_api_add_to_group("large", names[i]);
+        samples[members++] = now_ns() - t0;
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    char params[64];
+    snprintf(params, sizeof(params), "\"members\": %d", members);
+    report("large_group_add", params, samples, members, (uint64_t)members, elapsed);
+
+    int n = iterations(200);
+    uint64_t* fanout = calloc((size_t)n, sizeof(uint64_t));
+    atomic_store(&g_handled, 0);
+    start = now_ns();
+    for (int i = 0; i < n; i++) {
+        uint64_t t0 = now_ns();
+        softbus_api_send_group_message("large", MESSAGE_TYPE_DATA, text, PRIORITY_NORMAL);
+        fanout[i] = now_ns() - t0;
+    }
+    elapsed = now_ns() - start;
+    snprintf(params, sizeof(params), "\"members\": %d, \"payload\": 64", members);
+    report("large_group_fanout", params, fanout, n, atomic_load(&g_handled), elapsed);
+    free(fanout);
+
+    start = now_ns();
+    for (int i = 0; i < members; i++) {
+        uint64_t t0 = now_ns();
+        softbus_api_unregister_device(names[i]);
+        samples[i] = now_ns() - t0;
+    }
+    elapsed = now_ns() - start;
+    snprintf(params, sizeof(params), "\"members\": %d", members);
+    report("large_group_unreg", params, samples, members, (uint64_t)members, elapsed);
+
+    softbus_api_delete_group("large");
+    free(text);
+    free(samples);
+    free(names);
+}
+
+// ---- 深队列：队列保持D条积压时取出队头，测量队头访问和删除的开销 ----
+
+static void bench_deep_queue(void) {
+    static const int depths[] = {16, 1024, 16384, 65536};
+    softbus_api_register_device_raw(DEVICE_TYPE_OTHER, "dq_sink", count_handler);
+
+    message_t msg = {0};
+    strncpy(msg.target, "dq_sink", sizeof(msg.target) - 1);
+    msg.type = MESSAGE_TYPE_DATA;
+    msg.priority = PRIORITY_NORMAL;
+    strncpy(msg.content, "x", sizeof(msg.content) - 1);
+
+    for (size_t d = 0; d < sizeof(depths) / sizeof(depths[0]); d++) {
+        // 直接入队不分发，积压到目标深度
+        for (int i = 0; i < depths[d]; i++) {
+            msg.msg_id = 0;
+            message_queue_send(&msg);
+        }
+
+        int n = iterations(100000);
+        uint64_t* samples = calloc((size_t)n, sizeof(uint64_t));
+        message_t head;
+        uint64_t start = now_ns();
+        for (int i = 0; i < n; i++) {
+            uint64_t t0 = now_ns();
+            message_queue_peek("dq_sink", &head);
+            message_queue_receive("dq_sink", &head);
+            samples[i] = now_ns() - t0;
+            message_queue_release_data(&head);
+            msg.msg_id = 0;
+            message_queue_send(&msg);
+        }
+        uint64_t elapsed = now_ns() - start;
+
+        char params[64];
+        snprintf(params, sizeof(params), "\"depth\": %d", depths[d]);
+        report("deep_queue", params, samples, n, (uint64_t)n, elapsed);
+        free(samples);
+
+        while (message_queue_receive("dq_sink", &head) == SOFTBUS_OK) {
+            message_queue_release_data(&head);
+        }
+    }
+    softbus_api_unregister_device("dq_sink");
+}
+
+#if ENABLE_SOCKET_MULTICAST
+
+// ---- 组播回环：子进程加入组并把收到的消息组播回来，测量往返 ----
+
+static void mc_echo_handler(const char* target, bool is_group, message_type_t type,
+                            softbus_priority_t priority, const void* data, size_t len) {
+    if (is_group && strcmp(target, MC_GROUP) == 0) {
+        socket_multicast_send_group(MC_REPLY_GROUP, data, len, type, priority);
+    }
+}
+
+static void mc_reply_handler(const char* target, bool is_group, message_type_t type,
+                             softbus_priority_t priority, const void* data, size_t len) {
+    (void)type;
+    (void)priority;
+    (void)data;
+    (void)len;
+    if (is_group && strcmp(target, MC_REPLY_GROUP) == 0) {
+        atomic_fetch_add_explicit(&g_mc_replies, 1, memory_order_release);
+    }
+}
+
+// 必须在启动任何线程之前调用：子进程由fork创建
+static void bench_multicast_loopback(void) {
+    static const size_t payloads[] = {16, 256, 1000, 8192};
+    int ready[2];
+    if (pipe(ready) < 0) {
+        return;
+    }
+
+    pid_t child = fork();
+    if (child == 0) {
+        close(ready[0]);
+        char ok = 0;
+        if (socket_multicast_init() == SOFTBUS_OK) {
+            socket_set_target_handler(mc_echo_handler);
+            if (socket_multicast_start_receiver() == SOFTBUS_OK && socket_group_join(MC_GROUP) == SOFTBUS_OK) {
+                ok = 1;
+            }
+        }
+        if (write(ready[1], &ok, 1) != 1 || !ok) {
+            _exit(1);
+        }
+        for (;;) {
+            pause();
+        }
+    }
+
+    close(ready[1]);
+    char ok = 0;
+    if (child < 0 || read(ready[0], &ok, 1) != 1 || !ok) {
+        printf("multicast_loopback  skipped: echo node failed to start\n");
+        close(ready[0]);
+        if (child > 0) {
+            waitpid(child, NULL, 0);
+        }
+        return;
+    }
+    close(ready[0]);
+
+    if (socket_multicast_init() != SOFTBUS_OK) {
+        kill(child, SIGTERM);
+        waitpid(child, NULL, 0);
+        return;
+    }
+    socket_set_target_handler(mc_reply_handler);
+    socket_multicast_start_receiver();
+    socket_group_join(MC_REPLY_GROUP);
+
+    for (size_t p = 0; p < sizeof(payloads) / sizeof(payloads[0]); p++) {
+        int n = iterations(2000);
+        uint8_t* data = calloc(1, payloads[p]);
+        uint64_t* samples = calloc((size_t)n, sizeof(uint64_t));
+        int completed = 0;
+        int lost = 0;
+
+        uint64_t start = now_ns();
+        for (int i = 0; i < n; i++) {
+            uint64_t expected = atomic_load_explicit(&g_mc_replies, memory_order_acquire) + 1;
+            uint64_t t0 = now_ns();
+            socket_multicast_send_group(MC_GROUP, data, payloads[p], MESSAGE_TYPE_DATA, PRIORITY_NORMAL);
+            while (atomic_load_explicit(&g_mc_replies, memory_order_acquire) < expected &&
+                   now_ns() - t0 < MC_REPLY_TIMEOUT_NS) {
+                sched_yield();
+            }
+            if (atomic_load_explicit(&g_mc_replies, memory_order_acquire) >= expected) {
+                samples[completed++] = (now_ns() - t0) / 2;
+            } else {
+                lost++;
+            }
+        }
+        uint64_t elapsed = now_ns() - start;
+
+        char params[64];
+        snprintf(params, sizeof(params), "\"payload\": %zu", payloads[p]);
+        report("multicast_loopback", params, samples, completed, (uint64_t)completed, elapsed);
+        if (lost) {
+            printf("                   %d of %d round trips timed out\n", lost, n);
+        }
+        free(samples);
+        free(data);
+    }
+
+    socket_group_leave(MC_REPLY_GROUP);
+    socket_multicast_stop_receiver();
+    socket_set_target_handler(NULL);
+    socket_multicast_deinit();
+    kill(child, SIGTERM);
+    waitpid(child, NULL, 0);
+}
+
+#endif // ENABLE_SOCKET_MULTICAST
+
+int main(int argc, char* argv[]) {
+    const char* output = argc > 1 ? argv[1] : DEFAULT_OUTPUT;
+    g_scale = argc > 2 ? atof(argv[2]) : 1.0;
+    if (g_scale <= 0.0) {
+        fprintf(stderr, "usage: %s [output.json] [scale > 0]\n", argv[0]);
+        return 1;
+    }
+
+    g_json = fopen(output, "w");
+    if (!g_json) {
+        perror("fopen");
+        return 1;
+    }
+    fprintf(g_json, "{\n  \"suite\": \"softbus\",\n  \"scale\": %.3f,\n  \"results\": [\n", g_scale);
+
+    // 注册和注销数千个设备时的INFO日志会淹没结果
+    softbus_log_set_level(SOFTBUS_LOG_LEVEL_WARN);
+    printf("Bus benchmark suite (scale %.2f)\n", g_scale);
+#if ENABLE_SOCKET_MULTICAST
+    // 组播回环用例需要fork，先于总线初始化（启动IO线程）运行
+    bench_multicast_loopback();
+#endif
+
+    if (softbus_api_init() != SOFTBUS_OK) {
+        fprintf(stderr, "Failed to initialize softbus\n");
+        fclose(g_json);
+        return 1;
+    }
+    bench_unicast_async();
+    bench_unicast_sync();
+    bench_group_fanout();
+    bench_multi_producer();
+    bench_registry_lookup();
+    bench_registry_layout();
+    bench_large_group();
+    bench_deep_queue();
+    softbus_api_deinit();
+
+    fprintf(g_json, "\n  ]\n}\n");
+    fclose(g_json);
+    printf("Results written to %s\n", output);
+    return 0;
+}
@@ -3,16 +3,21 @@
 
 #include "softbus_types.h"
 #include "device_ops.h"
-#include "rbtree.h"
+#include "prio_queue.h"
+#include "softbus_metrics.h"
+#include "softbus_watchdog.h"
 
-// 设备管理器结构体
+// 设备管理器结构体，即设备表中的冷数据记录；注册后位置固定，查找走device_manager.c中的哈希热数组，
+// 消息队列在device_manager.c的热槽中
 typedef struct {
     char name[MAX_NAME_LENGTH];
     device_type_t type;
     device_ops_t ops;
     void* private_data;
-    struct rb_root msg_tree;
+    softbus_queue_backend_t queue_backend;  // 注册前选择消息队列后端，默认红黑树
     void (*msg_callback)(void* msg);
+    device_metrics_t* metrics;  // 注册时创建，注销时释放
+    device_watchdog_t* watchdog;  // 处理函数预算与隔离状态，与metrics同生命周期
 } device_manager_t;
 
 // 设备管理器API
@@ -20,7 +25,35 @@ int device_manager_init(void);
 void device_manager_deinit(void);
 int device_manager_register(device_manager_t* device);
 int device_manager_unregister(const char* device_name);
-device_manager_t* device_manager_find(const char* device_name);
+// 按名称取得设备记录并加一个引用，未注册返回NULL；记录在device_manager_release前不会被回收，
+// 设备在此期间被注销时，由最后一个release调用deinit并释放队列
+device_manager_t* device_manager_acquire(const char* device_name);
+void device_manager_release(device_manager_t* device);
+// 持有引用的记录的下标，与device_manager_index相同
+int device_manager_record_index(const device_manager_t* device);
+// 持有引用的设备是否仍处于注册状态
+bool device_manager_is_live(const device_manager_t* device);
+// 消息队列操作，均在设备的队列锁内完成，发送方与处理线程可以并发调用
+// 入队成功后msg归队列所有，并计入设备统计；设备不存在返回SOFTBUS_NOT_FOUND
+int device_manager_enqueue(const char* device_name, message_t* msg);
+// 记一次未能入队（如分配失败）的消息
+void device_manager_count_dropped(const char* device_name);
+// 取出队头，*msg由调用者释放；设备不存在或队列为空返回SOFTBUS_NOT_FOUND
+int device_manager_dequeue(const char* device_name, message_t** msg);
+// 复制队头，不移除
+int device_manager_peek(const char* device_name, message_t* msg);
+// 按出队顺序复制前max条消息，返回数量
+int device_manager_snapshot(const char* device_name, message_t* msgs, int max);
+// 设备的记录下标（0到MAX_DEVICES-1），注册期间不变，用作组成员位集的位号；未注册返回-1。
+// 下标在设备回收后可能被新设备复用，跨越其他操作使用时先device_manager_acquire
+int device_manager_index(const char* device_name);
+int device_manager_name_at(int index, char name[MAX_NAME_LENGTH]);
 bool device_manager_is_device_registered(const char* device_name);
+int device_manager_get_names(char names[][MAX_NAME_LENGTH], int max_count);
+// 复制设备的统计快照
+int device_manager_get_stats(const char* device_name, softbus_device_stats_t* stats);
+int device_manager_reset_stats(const char* device_name);
+// 设置设备处理函数的单次预算（微秒）
+int device_manager_set_budget(const char* device_name, uint32_t wall_us, uint32_t cpu_us);
 
 #endif // DEVICE_MANAGER_H 
\ No newline at end of file
@@ -1,13 +1,69 @@
 #ifndef GROUP_MANAGER_H
 #define GROUP_MANAGER_H
 
-#include "softbus.h"
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "softbus_internal.h"
+#include "softbus_lock.h"
 
-typedef struct {
-    char name[32];
-    char* devices[32];  // 组内设备列表
-    int device_count;
-    pthread_mutex_t mutex;
+// 组管理：
+// - 组表锁只保护名称索引（哈希链）和占用位图，成员变化只加所在组的锁；
+// - 组结构位置固定，删除后复用，持有指针的调用者加组锁后检查in_use，不会访问已释放内存；
+// - 本地成员是设备表下标上的位集，同时维护设备到组的反向索引（组下标上的位集），
+//   注销设备只访问它所在的组；
+// - 远端成员保存名称和所在节点；
+// - 组可以包含其他组，添加时拒绝形成环；
+// - 本地成员数在0与非0之间变化时加入/退出该组的组播地址。
+// 锁顺序：组表锁 -> 组锁 -> 设备表锁，同一时刻只持有一个组锁。
+//
+// 发送方不加锁：每次成员变化在组锁内生成一份新的只读快照并原子替换，
+// 快照带引用计数。换下的旧快照挂到组的待回收链上，确认没有发送方正处于取引用的窗口后
+// 再释放组持有的引用，由最后一个持有者回收；替换快照从不等待发送方。
+// 快照中的本地成员已解析为名称，扇出时不再按下标查设备表。成员变化的代价是复制一次成员列表。
+//
+// 嵌套组的快照是展开后的成员：直接成员与各子组当前快照的并集，本地成员按位集求并，
+// 远端成员按名称去重。某个组变化后只沿父组链向上重新生成快照，某一层展开结果不变时停止，
+// 因此向顶层组发送与向同样大小的普通组发送代价相同。
+
+#define GROUP_SET_WORDS SOFTBUS_BITSET_WORDS(MAX_GROUPS)
+
+// 组成员（含子组展开后）的只读快照，通过group_manager_acquire取得，用完调用group_manager_release
+typedef struct group_snapshot {
+    _Atomic int refs;
+    uint64_t version;                   // 该组每次成员变化加1
+    uint32_t hash;
+    char name[MAX_NAME_LENGTH];
+    uint64_t local[DEVICE_SET_WORDS];
+    int local_count;
+    const int* local_index;             // 本地成员的设备表下标，升序
+    const char (*local_names)[MAX_NAME_LENGTH];
+    int remote_count;
+    int remote_node_count;              // 远端成员分布的不同节点数
+    const char (*remote)[MAX_NAME_LENGTH];
+    const softbus_node_addr_t* remote_nodes;
+    const char (*remote_group)[MAX_NAME_LENGTH];    // 远端成员直接所属的组，对端节点按该组投递
+    bool remote_nested;                 // 有来自子组的远端成员
+    struct group_snapshot* retired_next;    // 待回收链，仅组管理内部使用
+} group_snapshot_t;
+
+typedef struct device_group {
+    char name[MAX_NAME_LENGTH];
+    uint32_t hash;
+    int index;                          // 在组表中的下标，即反向索引中的位号
+    _Atomic int next;                   // 哈希链中的下一个组，-1结束
+    bool in_use;
+    uint64_t local[DEVICE_SET_WORDS];   // 本地成员，按设备表下标置位
+    char members[MAX_GROUP_MEMBERS][MAX_NAME_LENGTH];      // 远端成员
+    softbus_node_addr_t member_nodes[MAX_GROUP_MEMBERS];  // 远端成员所在节点
+    int member_count;                   // 远端成员数
+    uint64_t children[GROUP_SET_WORDS]; // 直接包含的子组，同时持有组表锁和本组锁才能修改
+    uint64_t parents[GROUP_SET_WORDS];  // 直接包含本组的父组，修改规则同上
+    uint64_t version;
+    bool stale;                         // 上次快照生成失败，下次不沿用旧快照中的名称
+    softbus_lock_t mutex;               // 保护以上成员字段，串行化快照替换
+    _Atomic(group_snapshot_t*) snapshot;    // 当前快照，未使用的组为NULL
+    _Atomic int readers;                // 正在取快照引用（读指针到增加引用计数之间）的发送方数
+    group_snapshot_t* retired;          // 已换下、组仍持有引用的快照，组锁保护
 } device_group_t;
 
 // 组管理API
@@ -15,8 +71,22 @@ int group_manager_init(void);
 void group_manager_deinit(void);
 int group_manager_create(const char* group_name);
 int group_manager_delete(const char* group_name);
+// 添加本地成员，设备必须已注册
 int group_manager_add_device(const char* group_name, const char* device_name);
+// 添加或更新远端成员；同名本地成员改为远端成员
+int group_manager_add_remote(const char* group_name, const char* device_name, const softbus_node_addr_t* node);
 int group_manager_remove_device(const char* group_name, const char* device_name);
-device_group_t* group_manager_find(const char* group_name);
+// 把child作为成员加入parent；child已经（直接或间接）包含parent时返回SOFTBUS_INVALID_ARG
+int group_manager_add_group(const char* parent_name, const char* child_name);
+int group_manager_remove_group(const char* parent_name, const char* child_name);
+// 设备从设备表注销后、记录下标回收前调用（调用者持有设备引用），从它所在的每个组中移除，
+// 代价与所在组数成正比
+void group_manager_device_removed(int device_index);
+bool group_manager_exists(const char* group_name);
+// 取组的当前快照，不加锁；组不存在时返回NULL
+const group_snapshot_t* group_manager_acquire(const char* group_name);
+void group_manager_release(const group_snapshot_t* snapshot);
+// 复制所有组名，返回数量
+int group_manager_get_names(char names[][MAX_NAME_LENGTH], int max_count);
 
-#endif // GROUP_MANAGER_H 
\ No newline at end of file
+#endif // GROUP_MANAGER_H
@@ -10,6 +10,9 @@ int message_queue_init(void);
 // 消息队列清理
 void message_queue_deinit(void);
 
+// 分配消息标识，单调递增且不为0
+uint64_t message_queue_next_id(void);
+
 // 发送消息
 int message_queue_send(const message_t* msg);
 
@@ -19,6 +22,9 @@ int message_queue_receive(const char* target, message_t* msg);
 // 查看消息但不移除
 int message_queue_peek(const char* target, message_t* msg);
 
+// 释放消息数据，按data_release或free释放
+void message_queue_release_data(message_t* msg);
+
 // 设置消息完成回调
 void message_queue_set_callback(const char* target, message_callback_t callback, void* user_data);
 
@@ -14,7 +14,9 @@ typedef struct {
     char content[1024];        // 消息内容
     void* data;                // 消息数据
     size_t data_len;           // 数据长度
+    void (*data_release)(void* data, size_t len); // 数据释放函数：非NULL时队列直接接管data不复制，为NULL时按malloc内存复制/释放
     struct timespec timestamp; // 时间戳
+    uint64_t msg_id;           // 消息标识，0表示由message_queue_send分配
 } message_t;
 
 // 消息回调函数类型
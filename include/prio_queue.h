@@ -0,0 +1,39 @@
+#ifndef PRIO_QUEUE_H
+#define PRIO_QUEUE_H
+
+#include <stddef.h>
+#include "message_types.h"
+
+// 设备消息队列的存储后端。所有后端的出队顺序相同：优先级高的在前，同优先级先进先出。
+// - RBTREE：红黑树（缓存最左节点），按优先级和入队时间排序，深度大时插入为O(log n)；
+// - HEAP：连续数组上的4叉最小堆，键为(优先级, 入队序号)，插入和删除只做整数比较，缓存友好；
+// - BUCKET：每个优先级一个环形数组，非空位图定位最高优先级，入队出队均为O(1)。
+// HEAP和BUCKET把超出PRIORITY_URGENT的优先级按PRIORITY_URGENT处理。
+// 队列不加锁，由调用者保证访问互斥；设备的队列只在device_manager的队列锁内访问。
+
+typedef enum {
+    SOFTBUS_QUEUE_RBTREE = 0,       // 默认
+    SOFTBUS_QUEUE_HEAP,
+    SOFTBUS_QUEUE_BUCKET,
+    SOFTBUS_QUEUE_BACKEND_COUNT
+} softbus_queue_backend_t;
+
+typedef struct prio_queue prio_queue_t;
+
+prio_queue_t* prio_queue_create(softbus_queue_backend_t backend);
+// 队列中剩余的消息不释放，调用者应先取空
+void prio_queue_destroy(prio_queue_t* q);
+
+// 消息由队列持有直到被pop，消息本身不复制
+int prio_queue_push(prio_queue_t* q, message_t* msg);
+message_t* prio_queue_peek(const prio_queue_t* q);
+message_t* prio_queue_pop(prio_queue_t* q);
+size_t prio_queue_size(const prio_queue_t* q);
+
+// 按出队顺序取前max条消息的指针，返回数量
+int prio_queue_snapshot(const prio_queue_t* q, message_t** out, int max);
+
+softbus_queue_backend_t prio_queue_backend(const prio_queue_t* q);
+const char* prio_queue_backend_name(softbus_queue_backend_t backend);
+
+#endif // PRIO_QUEUE_H
@@ -18,6 +18,16 @@ struct rb_root {
 
 #define RB_ROOT (struct rb_root) { NULL, }
 
+// 缓存最左节点的根：rb_first_cached为O(1)，适合总是从最小端取出的队列
+struct rb_root_cached {
+    struct rb_root rb_root;
+    struct rb_node *rb_leftmost;
+};
+
+#define RB_ROOT_CACHED (struct rb_root_cached) { {NULL, }, NULL }
+
+#define rb_first_cached(root) (root)->rb_leftmost
+
 #define rb_parent(r)   ((struct rb_node *)((r)->rb_parent_color & ~3))
 #define rb_color(r)    ((r)->rb_parent_color & 1)
 #define rb_is_red(r)   (!rb_color(r))
@@ -39,6 +49,36 @@ void rb_link_node(struct rb_node *node, struct rb_node *parent,
 void rb_insert_color(struct rb_node *, struct rb_root *);
 void rb_erase(struct rb_node *, struct rb_root *);
 struct rb_node *rb_first(const struct rb_root *);
+struct rb_node *rb_last(const struct rb_root *);
 struct rb_node *rb_next(const struct rb_node *);
+struct rb_node *rb_prev(const struct rb_node *);
+
+// 用new原位替换victim，不重新平衡；调用者需保证new与victim的排序位置相同
+void rb_replace_node(struct rb_node *victim, struct rb_node *new,
+                     struct rb_root *root);
+
+// 缓存版本：leftmost表示插入路径一直向左（新节点成为最小节点）
+void rb_insert_color_cached(struct rb_node *, struct rb_root_cached *, int leftmost);
+void rb_erase_cached(struct rb_node *, struct rb_root_cached *);
+void rb_replace_node_cached(struct rb_node *victim, struct rb_node *new,
+                            struct rb_root_cached *root);
+
+// 增强红黑树：每个节点额外维护一个由其子树决定的值（如子树最小截止时间）。
+// propagate从node开始向上重新计算直到stop（不含，NULL表示到根）；
+// rotate在旋转后调用，new_top取代old成为子树的根。
+// 插入前调用者需先对新节点的父节点执行propagate，使插入路径上的值包含新节点。
+struct rb_augment_callbacks {
+    void (*propagate)(struct rb_node *node, struct rb_node *stop);
+    void (*rotate)(struct rb_node *old, struct rb_node *new_top);
+};
+
+void rb_insert_augmented(struct rb_node *node, struct rb_root *root,
+                         const struct rb_augment_callbacks *augment);
+void rb_erase_augmented(struct rb_node *node, struct rb_root *root,
+                        const struct rb_augment_callbacks *augment);
+void rb_insert_augmented_cached(struct rb_node *node, struct rb_root_cached *root,
+                                int leftmost, const struct rb_augment_callbacks *augment);
+void rb_erase_augmented_cached(struct rb_node *node, struct rb_root_cached *root,
+                               const struct rb_augment_callbacks *augment);
 
 #endif // RBTREE_H 
\ No newline at end of file
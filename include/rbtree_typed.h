@@ -0,0 +1,143 @@
+#ifndef RBTREE_TYPED_H
+#define RBTREE_TYPED_H
+
+#include <stdbool.h>
+#include "rbtree.h"
+
+// 按类型生成的红黑树接口：比较函数是static inline，查找路径上的每次比较都内联到生成的函数中，
+// 不经过函数指针；重新平衡仍由rbtree.c完成（每次插入/删除一次，不随比较次数增长）。
+//
+// RB_DEFINE_TYPED(prefix, type, member, cmp)
+//   type中嵌入struct rb_node member，树根为struct rb_root_cached；
+//   cmp为 int cmp(const type* a, const type* b)，返回负数/0/正数。相等的元素插入到已有元素之后，
+//   按插入顺序出队。生成：
+//     prefix_insert / prefix_erase
+//     prefix_find         等于key的第一个元素
+//     prefix_lower_bound  第一个不小于key的元素
+//     prefix_first / prefix_last / prefix_next / prefix_prev
+//
+// RB_DEFINE_TYPED_MIN(prefix, type, member, cmp, value_type, aug_field, value_fn)
+//   在上述接口之外，aug_field维护子树中value_fn(node)的最小值（如子树最早截止时间），
+//   树按cmp排序的同时可以O(1)读出全树最小值、O(log n)找到取得最小值的节点：
+//     prefix_subtree_min  全树最小值写入*min，空树返回false
+//     prefix_min_node     取得最小值的元素（有多个时为按cmp顺序最靠前的一个）
+
+#define RB_DEFINE_TYPED_COMMON_(prefix, type, member, cmp)                                  \
+static inline type* prefix##_entry(const struct rb_node* node) {                            \
+    return node ? rb_entry(node, type, member) : NULL;                                      \
+}                                                                                           \
+static inline type* prefix##_first(const struct rb_root_cached* root) {                     \
+    return prefix##_entry(rb_first_cached(root));                                           \
+}                                                                                           \
+static inline type* prefix##_last(const struct rb_root_cached* root) {                      \
+    return prefix##_entry(rb_last(&root->rb_root));                                         \
+}                                                                                           \
+static inline type* prefix##_next(const type* node) {                                       \
+    return prefix##_entry(rb_next(&node->member));                                          \
+}                                                                                           \
+static inline type* prefix##_prev(const type* node) {                                       \
+    return prefix##_entry(rb_prev(&node->member));                                          \
+}                                                                                           \
+static inline type* prefix##_lower_bound(const struct rb_root_cached* root, const type* key) { \
+    struct rb_node* n = root->rb_root.rb_node;                                              \
+    struct rb_node* found = NULL;                                                           \
+    while (n) {                                                                             \
+        if (cmp(prefix##_entry(n), key) >= 0) {                                             \
+            found = n;                                                                      \
+            n = n->rb_left;                                                                 \
+        } else {                                                                            \
+            n = n->rb_right;                                                                \
+        }                                                                                   \
+    }                                                                                       \
+    return prefix##_entry(found);                                                           \
+}                                                                                           \
+static inline type* prefix##_find(const struct rb_root_cached* root, const type* key) {     \
+    type* node = prefix##_lower_bound(root, key);                                           \
+    return node && cmp(node, key) == 0 ? node : NULL;                                       \
+}                                                                                           \
+/* 查找插入位置，返回新节点是否成为最左节点 */                                              \
+static inline int prefix##_link_(struct rb_root_cached* root, type* node) {                 \
+    struct rb_node** link = &root->rb_root.rb_node;                                         \
+    struct rb_node* parent = NULL;                                                          \
+    int leftmost = 1;                                                                       \
+    while (*link) {                                                                         \
+        parent = *link;                                                                     \
+        if (cmp(node, prefix##_entry(parent)) < 0) {                                        \
+            link = &parent->rb_left;                                                        \
+        } else {                                                                            \
+            link = &parent->rb_right;                                                       \
+            leftmost = 0;                                                                   \
+        }                                                                                   \
+    }                                                                                       \
+    rb_link_node(&node->member, parent, link);                                              \
+    return leftmost;                                                                        \
+}
+
+#define RB_DEFINE_TYPED(prefix, type, member, cmp)                                          \
+RB_DEFINE_TYPED_COMMON_(prefix, type, member, cmp)                                          \
+static inline void prefix##_insert(struct rb_root_cached* root, type* node) {               \
+    int leftmost = prefix##_link_(root, node);                                              \
+    rb_insert_color_cached(&node->member, root, leftmost);                                  \
+}                                                                                           \
+static inline void prefix##_erase(struct rb_root_cached* root, type* node) {                \
+    rb_erase_cached(&node->member, root);                                                   \
+}
+
+#define RB_DEFINE_TYPED_MIN(prefix, type, member, cmp, value_type, aug_field, value_fn)     \
+RB_DEFINE_TYPED_COMMON_(prefix, type, member, cmp)                                          \
+static inline value_type prefix##_aug_compute_(const type* node) {                         \
+    value_type min = value_fn(node);                                                        \
+    if (node->member.rb_left && prefix##_entry(node->member.rb_left)->aug_field < min) {    \
+        min = prefix##_entry(node->member.rb_left)->aug_field;                              \
+    }                                                                                       \
+    if (node->member.rb_right && prefix##_entry(node->member.rb_right)->aug_field < min) {  \
+        min = prefix##_entry(node->member.rb_right)->aug_field;                             \
+    }                                                                                       \
+    return min;                                                                             \
+}                                                                                           \
+static void prefix##_aug_propagate_(struct rb_node* node, struct rb_node* stop) {           \
+    while (node && node != stop) {                                                          \
+        type* entry = prefix##_entry(node);                                                 \
+        entry->aug_field = prefix##_aug_compute_(entry);                                    \
+        node = rb_parent(node);                                                             \
+    }                                                                                       \
+}                                                                                           \
+static void prefix##_aug_rotate_(struct rb_node* old, struct rb_node* new_top) {            \
+    prefix##_entry(new_top)->aug_field = prefix##_entry(old)->aug_field;                    \
+    prefix##_entry(old)->aug_field = prefix##_aug_compute_(prefix##_entry(old));            \
+}                                                                                           \
+static const struct rb_augment_callbacks prefix##_augment_ = {                              \
+    prefix##_aug_propagate_, prefix##_aug_rotate_,                                          \
+};                                                                                          \
+static inline void prefix##_insert(struct rb_root_cached* root, type* node) {               \
+    int leftmost = prefix##_link_(root, node);                                              \
+    node->aug_field = value_fn(node);                                                       \
+    prefix##_aug_propagate_(rb_parent(&node->member), NULL);                                \
+    rb_insert_augmented_cached(&node->member, root, leftmost, &prefix##_augment_);          \
+}                                                                                           \
+static inline void prefix##_erase(struct rb_root_cached* root, type* node) {                \
+    rb_erase_augmented_cached(&node->member, root, &prefix##_augment_);                     \
+}                                                                                           \
+static inline bool prefix##_subtree_min(const struct rb_root_cached* root, value_type* min) { \
+    if (!root->rb_root.rb_node) {                                                           \
+        return false;                                                                       \
+    }                                                                                       \
+    *min = prefix##_entry(root->rb_root.rb_node)->aug_field;                                \
+    return true;                                                                            \
+}                                                                                           \
+static inline type* prefix##_min_node(const struct rb_root_cached* root) {                  \
+    struct rb_node* n = root->rb_root.rb_node;                                              \
+    while (n) {                                                                             \
+        type* entry = prefix##_entry(n);                                                    \
+        if (n->rb_left && prefix##_entry(n->rb_left)->aug_field == entry->aug_field) {      \
+            n = n->rb_left;                                                                 \
+        } else if (value_fn(entry) == entry->aug_field) {                                   \
+            return entry;                                                                   \
+        } else {                                                                            \
+            n = n->rb_right;                                                                \
+        }                                                                                   \
+    }                                                                                       \
+    return NULL;                                                                            \
+}
+
+#endif // RBTREE_TYPED_H
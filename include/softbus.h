@@ -7,6 +7,7 @@
 #include "softbus_types.h"
 #include "message_types.h"
 #include "device_manager.h"
+#include "softbus_lock.h"
 
 // 基础API函数
 int softbus_init(void);
@@ -24,6 +25,13 @@ void softbus_api_deinit(void);
 int softbus_api_register_device(device_type_t type, const char* device_name,
                               int (*handler)(const char* msg, message_type_t type));
 
+// 二进制消息处理函数：data为完整负载，len为其长度
+typedef int (*softbus_raw_handler_t)(const void* data, size_t len, message_type_t type);
+int softbus_api_register_device_raw(device_type_t type, const char* device_name, softbus_raw_handler_t handler);
+// 同上，并指定消息队列后端（见prio_queue.h）：深队列且优先级只有几档时BUCKET最快，HEAP次之
+int softbus_api_register_device_ex(device_type_t type, const char* device_name, softbus_raw_handler_t handler,
+                                   softbus_queue_backend_t backend);
+
 // 设备管理
 int softbus_api_unregister_device(const char* device_name);
 
@@ -31,13 +39,24 @@ int softbus_api_unregister_device(const char* device_name);
 int softbus_api_create_group(const char* group_name);
 int softbus_api_delete_group(const char* group_name);
 int softbus_api_add_to_group(const char* group_name, const char* device_name);
+// 添加位于其他节点的成员，node_port为该节点的单播端口
+int softbus_api_add_remote_to_group(const char* group_name, const char* device_name,
+                                    const char* node_ip, uint16_t node_port);
 int softbus_api_remove_from_group(const char* group_name, const char* device_name);
+// 组作为成员加入另一个组，发送到父组的消息投递给展开后的全部成员，每个设备只收到一次；
+// 形成环时返回SOFTBUS_INVALID_ARG
+int softbus_api_add_group_to_group(const char* parent_name, const char* child_name);
+int softbus_api_remove_group_from_group(const char* parent_name, const char* child_name);
 
 // 消息发送API
 int softbus_api_send_message_ex(const char* target, message_type_t type,
                               const char* message, softbus_priority_t priority,
                               softbus_mode_t mode, int timeout_ms);
 
+// 二进制消息发送API，负载大小不受MAX_MSG_LENGTH限制
+int softbus_api_send_data_ex(const char* target, message_type_t type, const void* data, size_t len,
+                             softbus_priority_t priority);
+
 // 组消息发送API
 int softbus_api_send_group_message_ex(const char* group_name, message_type_t type,
                                     const char* message, softbus_priority_t priority,
@@ -53,6 +72,20 @@ bool softbus_api_is_device_registered(const char* device_name);
 bool softbus_api_is_group_exists(const char* group_name);
 int softbus_api_get_group_devices(const char* group_name, char** device_names, int* count);
 
+// 设备运行统计：队列计数、深度以及入队到分发和处理函数执行时间的直方图
+int softbus_api_get_stats(const char* device_name, softbus_device_stats_t* stats);
+int softbus_api_reset_stats(const char* device_name);
+
+// 处理函数预算（微秒）：单次执行超出墙钟或CPU预算计入handler_overruns，
+// 看门狗线程对仍在运行且超出墙钟预算的处理函数告警。wall_us为0恢复默认100ms，cpu_us为0不统计CPU时间
+int softbus_api_set_handler_budget(const char* device_name, uint32_t wall_us, uint32_t cpu_us);
+// 开启后，连续超出预算的设备暂停分发一段时间，消息保留在队列中
+void softbus_api_set_quarantine(bool enable);
+
+// 内部锁（设备表、组表、回调表）按加锁位置的竞争统计，需以ENABLE_LOCK_STATS=1编译，否则返回0
+int softbus_api_get_lock_stats(softbus_lock_stats_t* stats, int max_count);
+void softbus_api_reset_lock_stats(void);
+
 // 向后兼容的函数声明
 static inline int softbus_api_send_message(const char* target, message_type_t type,
                                          const char* message, softbus_priority_t priority) {
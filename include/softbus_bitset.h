@@ -0,0 +1,87 @@
+#ifndef SOFTBUS_BITSET_H
+#define SOFTBUS_BITSET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 定长位集，按64位字存放，长度由调用者以字数给出。
+// 并集、差集、计数都是逐字的直线循环，编译器可以向量化；
+// 遍历每次跳过一个全0字，再用ctz逐个取出置位，稀疏集合的代价与置位数而不是总位数成正比。
+
+#define SOFTBUS_BITSET_WORD_BITS 64
+#define SOFTBUS_BITSET_WORDS(bits) (((bits) + SOFTBUS_BITSET_WORD_BITS - 1) / SOFTBUS_BITSET_WORD_BITS)
+
+static inline void softbus_bitset_set(uint64_t* set, int bit) {
+    set[bit / SOFTBUS_BITSET_WORD_BITS] |= 1ULL << (bit % SOFTBUS_BITSET_WORD_BITS);
+}
+
+static inline void softbus_bitset_clear(uint64_t* set, int bit) {
+    set[bit / SOFTBUS_BITSET_WORD_BITS] &= ~(1ULL << (bit % SOFTBUS_BITSET_WORD_BITS));
+}
+
+static inline bool softbus_bitset_test(const uint64_t* set, int bit) {
+    return (set[bit / SOFTBUS_BITSET_WORD_BITS] >> (bit % SOFTBUS_BITSET_WORD_BITS)) & 1;
+}
+
+static inline int softbus_bitset_count(const uint64_t* set, int words) {
+    int count = 0;
+    for (int i = 0; i < words; i++) {
+        count += __builtin_popcountll(set[i]);
+    }
+    return count;
+}
+
+static inline bool softbus_bitset_empty(const uint64_t* set, int words) {
+    uint64_t any = 0;
+    for (int i = 0; i < words; i++) {
+        any |= set[i];
+    }
+    return any == 0;
+}
+
+static inline void softbus_bitset_or(uint64_t* dst, const uint64_t* src, int words) {
+    for (int i = 0; i < words; i++) {
+        dst[i] |= src[i];
+    }
+}
+
+static inline void softbus_bitset_andnot(uint64_t* dst, const uint64_t* src, int words) {
+    for (int i = 0; i < words; i++) {
+        dst[i] &= ~src[i];
+    }
+}
+
+// 第一个不小于from的置位，没有时返回-1
+static inline int softbus_bitset_next(const uint64_t* set, int words, int from) {
+    int i = from / SOFTBUS_BITSET_WORD_BITS;
+    if (i >= words) {
+        return -1;
+    }
+    uint64_t word = set[i] & (~0ULL << (from % SOFTBUS_BITSET_WORD_BITS));
+    while (!word) {
+        if (++i >= words) {
+            return -1;
+        }
+        word = set[i];
+    }
+    return i * SOFTBUS_BITSET_WORD_BITS + __builtin_ctzll(word);
+}
+
+#define SOFTBUS_BITSET_FOREACH(bit, set, words)                             \
+    for (int bit = softbus_bitset_next((set), (words), 0); bit >= 0;        \
+         bit = softbus_bitset_next((set), (words), bit + 1))
+
+// 把置位展开为升序下标数组，返回数量；out至少能容纳max个元素
+static inline int softbus_bitset_to_array(const uint64_t* set, int words, int* out, int max) {
+    int n = 0;
+    for (int i = 0; i < words && n < max; i++) {
+        uint64_t word = set[i];
+        while (word && n < max) {
+            out[n++] = i * SOFTBUS_BITSET_WORD_BITS + __builtin_ctzll(word);
+            word &= word - 1;
+        }
+    }
+    return n;
+}
+
+#endif // SOFTBUS_BITSET_H
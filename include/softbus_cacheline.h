@@ -0,0 +1,37 @@
+#ifndef SOFTBUS_CACHELINE_H
+#define SOFTBUS_CACHELINE_H
+
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// 每个设备独立分配、在分发路径上写入的状态（消息队列、统计、看门狗）按缓存行对齐分配，
+// 类型本身也声明为缓存行对齐，大小是缓存行的整数倍，不同设备的处理线程不会写到同一缓存行。
+#define SOFTBUS_CACHE_LINE 64
+#define SOFTBUS_CACHE_ALIGNED __attribute__((aligned(SOFTBUS_CACHE_LINE)))
+
+// 分配清零的内存，size向上取整到缓存行；必须用softbus_cacheline_free释放
+static inline void* softbus_cacheline_alloc(size_t size) {
+    size = (size + SOFTBUS_CACHE_LINE - 1) & ~(size_t)(SOFTBUS_CACHE_LINE - 1);
+#ifdef _WIN32
+    void* p = _aligned_malloc(size, SOFTBUS_CACHE_LINE);
+#else
+    void* p = aligned_alloc(SOFTBUS_CACHE_LINE, size);
+#endif
+    if (p) {
+        memset(p, 0, size);
+    }
+    return p;
+}
+
+static inline void softbus_cacheline_free(void* p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+#endif // SOFTBUS_CACHELINE_H
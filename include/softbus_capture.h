@@ -0,0 +1,58 @@
+#ifndef SOFTBUS_CAPTURE_H
+#define SOFTBUS_CAPTURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "message_types.h"
+
+// 流量抓包：抓包开启时，每条进入本地消息队列的消息（头部和负载）被复制到发送线程自己的
+// 无锁字节环中，不加锁也不做IO；后台线程按时间戳合并各线程的记录，追加到紧凑的二进制日志。
+// 环满时丢弃并计数，不阻塞总线。日志可由softbus_replay工具按原始节奏或加速回放。
+//
+// 文件格式（主机字节序）：
+//   softbus_capture_file_header_t
+//   重复：softbus_capture_record_t，target_len字节的设备名（无结尾0），payload_len字节的负载
+
+#define SOFTBUS_CAPTURE_MAGIC "SBCAP01"            // 含结尾0共8字节
+#define SOFTBUS_CAPTURE_VERSION 1
+#define SOFTBUS_CAPTURE_RING_BYTES (1u << 20)       // 每个线程的缓冲字节数，必须为2的幂
+#define SOFTBUS_CAPTURE_MAX_PAYLOAD (64u * 1024)    // 单条记录保存的最大负载，超出部分截断
+#define SOFTBUS_CAPTURE_FLUSH_INTERVAL_US 2000
+
+#define SOFTBUS_CAPTURE_FLAG_TRUNCATED 0x01         // 负载被截断，orig_len为原始长度
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_header_size;    // sizeof(softbus_capture_record_t)，用于校验
+    uint64_t start_realtime_ns;     // 抓包开始的墙钟时间
+} softbus_capture_file_header_t;
+
+typedef struct {
+    uint64_t ts_ns;                 // 相对抓包开始的时间（CLOCK_MONOTONIC）
+    uint32_t payload_len;           // 记录中的负载长度
+    uint32_t orig_len;              // 原始负载长度
+    uint8_t target_len;
+    uint8_t type;                   // message_type_t
+    uint8_t priority;               // softbus_priority_t
+    uint8_t flags;
+    uint32_t reserved;
+} softbus_capture_record_t;
+
+extern _Atomic bool g_softbus_capture_active;
+
+// 开始抓包，写入path（覆盖已有文件）；已在抓包时返回SOFTBUS_BUSY
+int softbus_capture_start(const char* path);
+// 写出缓冲的记录并关闭文件
+int softbus_capture_stop(void);
+// 本次抓包因缓冲区满丢弃的消息数
+uint64_t softbus_capture_dropped(void);
+
+void softbus_capture_message(const message_t* msg);
+
+static inline bool softbus_capture_active(void) {
+    return atomic_load_explicit(&g_softbus_capture_active, memory_order_relaxed);
+}
+
+#endif // SOFTBUS_CAPTURE_H
@@ -0,0 +1,32 @@
+#ifndef SOFTBUS_DISCOVERY_H
+#define SOFTBUS_DISCOVERY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "softbus_types.h"
+
+// 远端设备发现：各节点在默认组播组上通告本地设备，
+// 收到的通告建立 设备名 -> 节点单播地址 的路由表，超过存活时间未刷新的路由被淘汰。
+// 设备注册/注销时立即发送增量通告，此外周期性发送全量通告；
+// 新节点启动时请求其他节点立即通告，无需等待一个周期。
+// 组播只用于发现，发往远端设备的消息按路由表单播到所在节点。
+
+#define DISCOVERY_ANNOUNCE_INTERVAL_MS 1000    // 全量通告周期
+#define DISCOVERY_ROUTE_TTL_MS 3500            // 路由存活时间，约三个通告周期
+#define DISCOVERY_ROUTE_BUCKETS 256            // 路由表哈希桶数，必须为2的幂
+#define DISCOVERY_MAX_ROUTES 4096              // 路由表容量
+#define DISCOVERY_ANNOUNCE_MAX_BYTES 1200      // 单个通告数据报的最大内容长度
+
+int discovery_init(void);
+void discovery_deinit(void);
+
+// 本地设备注册或注销后调用，立即通告变化
+void discovery_device_changed(const char* device_name, bool registered);
+
+// 查找远端设备所在节点，找不到时返回SOFTBUS_NOT_FOUND
+int discovery_lookup(const char* device_name, softbus_node_addr_t* node);
+
+// 当前路由表中的条目数
+int discovery_route_count(void);
+
+#endif // SOFTBUS_DISCOVERY_H
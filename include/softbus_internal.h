@@ -9,16 +9,20 @@
 #include "softbus_types.h"
 #include "device_manager.h"
 #include "softbus_msg.h"
+#include "softbus_bitset.h"
 
+// 容量上限，均可在编译时覆盖（如-DMAX_DEVICES=4096 -DMAX_GROUPS=1024用于大规模部署和基准）。
+// 设备表、组表和位集都是静态数组，组表约为MAX_GROUPS*MAX_DEVICES/8字节，默认保持嵌入式规模；
+// 组成员位集随MAX_DEVICES变长，设备到组的反向索引随MAX_GROUPS变长
+#ifndef MAX_DEVICES
 #define MAX_DEVICES 32
+#endif
+#ifndef MAX_GROUPS
 #define MAX_GROUPS 16
-#define MAX_GROUP_MEMBERS 16
-
-// 组管理结构体
-typedef struct {
-    char name[MAX_NAME_LENGTH];
-    char members[MAX_GROUP_MEMBERS][MAX_NAME_LENGTH];
-    int member_count;
-} group_manager_t;
+#endif
+#ifndef MAX_GROUP_MEMBERS
+#define MAX_GROUP_MEMBERS 16        // 每组的远端成员数
+#endif
+#define DEVICE_SET_WORDS SOFTBUS_BITSET_WORDS(MAX_DEVICES)
 
 #endif // SOFTBUS_INTERNAL_H 
\ No newline at end of file
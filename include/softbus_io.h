@@ -0,0 +1,64 @@
+#ifndef SOFTBUS_IO_H
+#define SOFTBUS_IO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "softbus_types.h"
+
+// 可注册的最大文件描述符数量（组播组、单播、本地IPC等）
+#define SOFTBUS_IO_MAX_FDS 64
+// 唤醒时可执行的最大刷新回调数量
+#define SOFTBUS_IO_MAX_FLUSH_HANDLERS 8
+// 最大定时器数量
+#define SOFTBUS_IO_MAX_TIMERS 32
+
+// IO事件
+#define SOFTBUS_IO_READ  0x01
+#define SOFTBUS_IO_WRITE 0x02
+#define SOFTBUS_IO_ERROR 0x04
+
+// fd事件回调，在IO线程中执行；非阻塞fd应在回调中读到EAGAIN为止
+typedef void (*softbus_io_handler_t)(int fd, uint32_t events, void* ctx);
+
+// 刷新回调，在IO线程被唤醒时执行（例如刷新发送队列）
+typedef void (*softbus_io_flush_t)(void* ctx);
+
+// IO引擎初始化/清理，按引用计数，最后一次deinit时释放
+int softbus_io_init(void);
+void softbus_io_deinit(void);
+
+// 启动/停止IO线程，按引用计数：每个需要IO线程的模块各调用一次start并在退出时配对stop，
+// 最后一次stop时通过eventfd唤醒并等待线程退出；最后一次deinit会停止仍在运行的线程
+int softbus_io_start(void);
+void softbus_io_stop(void);
+
+// fd管理，fd会被设置为非阻塞
+int softbus_io_add_fd(int fd, uint32_t events, softbus_io_handler_t handler, void* ctx);
+int softbus_io_mod_fd(int fd, uint32_t events);
+// 删除fd，返回时该fd的回调已不在执行，可以关闭fd、释放ctx；
+// 在IO线程外调用时不能持有回调中会获取的锁
+int softbus_io_del_fd(int fd);
+
+// 注册刷新回调
+int softbus_io_add_flush_handler(softbus_io_flush_t fn, void* ctx);
+void softbus_io_remove_flush_handler(softbus_io_flush_t fn, void* ctx);
+
+// 添加定时器，delay_us后在IO线程中执行fn；interval_us为0表示单次定时器
+// 成功返回正的定时器ID
+int softbus_io_timer_add(uint64_t delay_us, uint64_t interval_us, softbus_io_flush_t fn, void* ctx);
+// 取消定时器，返回时回调已不在执行；锁的限制同softbus_io_del_fd
+void softbus_io_timer_cancel(int timer_id);
+
+// 单调时钟，纳秒
+uint64_t softbus_io_now_ns(void);
+
+// 唤醒IO线程执行刷新回调，可在任意线程调用
+void softbus_io_wakeup(void);
+
+// 当前线程是否为IO线程
+bool softbus_io_in_loop_thread(void);
+
+// 将fd设置为非阻塞
+int softbus_io_set_nonblocking(int fd);
+
+#endif // SOFTBUS_IO_H
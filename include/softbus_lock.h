@@ -0,0 +1,103 @@
+#ifndef SOFTBUS_LOCK_H
+#define SOFTBUS_LOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+// 总线内部锁的竞争统计：
+// 每个加锁位置（文件:行）记录加锁次数、发生竞争的次数、等待时间（总计/最大）和持锁时间（总计/最大）。
+// 加锁先trylock，成功时不计等待时间；失败才记为竞争并计时阻塞等待。持锁时间记在加锁的位置上。
+// ENABLE_LOCK_STATS为0时softbus_lock_t就是pthread_mutex_t，加解锁宏直接展开为pthread调用。
+
+#ifndef ENABLE_LOCK_STATS
+#define ENABLE_LOCK_STATS 0
+#endif
+
+#define SOFTBUS_LOCK_NAME_LEN 32
+#define SOFTBUS_LOCK_SITE_LEN 64
+
+// 一个加锁位置的统计快照，时间单位为纳秒
+typedef struct {
+    char lock[SOFTBUS_LOCK_NAME_LEN];
+    char site[SOFTBUS_LOCK_SITE_LEN];
+    uint64_t acquisitions;
+    uint64_t contended;
+    uint64_t wait_ns_total;
+    uint64_t wait_ns_max;
+    uint64_t hold_ns_total;
+    uint64_t hold_ns_max;
+} softbus_lock_stats_t;
+
+#if ENABLE_LOCK_STATS
+
+typedef struct softbus_lock_site {
+    const char* file;
+    int line;
+    const char* lock_name;          // 首次加锁时登记
+    _Atomic bool registered;
+    _Atomic uint64_t acquisitions;
+    _Atomic uint64_t contended;
+    _Atomic uint64_t wait_ns_total;
+    _Atomic uint64_t wait_ns_max;
+    _Atomic uint64_t hold_ns_total;
+    _Atomic uint64_t hold_ns_max;
+    struct softbus_lock_site* next;
+} softbus_lock_site_t;
+
+typedef struct {
+    pthread_mutex_t mutex;
+    const char* name;
+    softbus_lock_site_t* owner_site;    // 以下两项只由持锁线程读写
+    uint64_t acquired_ns;
+} softbus_lock_t;
+
+#define SOFTBUS_LOCK_INITIALIZER(lock_name) {PTHREAD_MUTEX_INITIALIZER, (lock_name), NULL, 0}
+
+void softbus_lock_acquire(softbus_lock_t* lock, softbus_lock_site_t* site);
+void softbus_lock_release(softbus_lock_t* lock);
+
+// 每个调用位置展开一个静态统计项
+#define SOFTBUS_LOCK(lock)                                                              \
+    do {                                                                                \
+        static softbus_lock_site_t softbus_lock_site_ = {.file = __FILE__, .line = __LINE__}; \
+        softbus_lock_acquire((lock), &softbus_lock_site_);                             \
+    } while (0)
+#define SOFTBUS_UNLOCK(lock) softbus_lock_release(lock)
+
+static inline int softbus_lock_init(softbus_lock_t* lock, const char* name) {
+    lock->name = name;
+    lock->owner_site = NULL;
+    lock->acquired_ns = 0;
+    return pthread_mutex_init(&lock->mutex, NULL);
+}
+
+static inline void softbus_lock_destroy(softbus_lock_t* lock) {
+    pthread_mutex_destroy(&lock->mutex);
+}
+
+#else
+
+typedef pthread_mutex_t softbus_lock_t;
+
+#define SOFTBUS_LOCK_INITIALIZER(lock_name) PTHREAD_MUTEX_INITIALIZER
+#define SOFTBUS_LOCK(lock) pthread_mutex_lock(lock)
+#define SOFTBUS_UNLOCK(lock) pthread_mutex_unlock(lock)
+
+static inline int softbus_lock_init(softbus_lock_t* lock, const char* name) {
+    (void)name;
+    return pthread_mutex_init(lock, NULL);
+}
+
+static inline void softbus_lock_destroy(softbus_lock_t* lock) {
+    pthread_mutex_destroy(lock);
+}
+
+#endif // ENABLE_LOCK_STATS
+
+// 复制所有已登记加锁位置的统计，返回复制的数量；未启用时返回0
+int softbus_lock_get_stats(softbus_lock_stats_t* stats, int max_count);
+void softbus_lock_reset_stats(void);
+
+#endif // SOFTBUS_LOCK_H
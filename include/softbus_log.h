@@ -0,0 +1,146 @@
+#ifndef SOFTBUS_LOG_H
+#define SOFTBUS_LOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdatomic.h>
+
+// 异步分级日志：
+// - 低于SOFTBUS_LOG_MIN_LEVEL的日志在编译期消除，不求值参数也不产生代码；
+// - 调用线程只把格式串指针和参数原始值写入本线程的无锁环形缓冲区，不格式化也不加锁，
+//   环满时丢弃并计数，不会阻塞总线；
+// - 后台线程按时间戳合并各线程的记录，格式化后写入输出。
+// 格式串必须是字面量；支持printf的常用转换（d i u x X o c s p f e g及长度修饰），不支持*宽度。
+
+#define SOFTBUS_LOG_LEVEL_TRACE 0
+#define SOFTBUS_LOG_LEVEL_DEBUG 1
+#define SOFTBUS_LOG_LEVEL_INFO  2
+#define SOFTBUS_LOG_LEVEL_WARN  3
+#define SOFTBUS_LOG_LEVEL_ERROR 4
+#define SOFTBUS_LOG_LEVEL_NONE  5
+
+// 编译期最低级别，可通过 -DSOFTBUS_LOG_MIN_LEVEL=... 覆盖
+#ifndef SOFTBUS_LOG_MIN_LEVEL
+#define SOFTBUS_LOG_MIN_LEVEL SOFTBUS_LOG_LEVEL_INFO
+#endif
+
+#define SOFTBUS_LOG_MAX_ARGS 8
+#define SOFTBUS_LOG_STR_SPACE 112          // 每条记录中字符串参数的总空间，超出部分截断
+#define SOFTBUS_LOG_RING_SIZE 256          // 每个线程的缓冲记录数，必须为2的幂
+#define SOFTBUS_LOG_FLUSH_INTERVAL_US 5000 // 后台线程空闲时的轮询间隔
+
+typedef enum {
+    SOFTBUS_LOG_ARG_INT,
+    SOFTBUS_LOG_ARG_UINT,
+    SOFTBUS_LOG_ARG_DOUBLE,
+    SOFTBUS_LOG_ARG_PTR,
+    SOFTBUS_LOG_ARG_STR,
+} softbus_log_arg_type_t;
+
+typedef struct {
+    softbus_log_arg_type_t type;
+    union {
+        long long i;
+        unsigned long long u;
+        double d;
+        const void* p;
+        const char* s;  // 入队时复制到记录中
+    } v;
+} softbus_log_arg_t;
+
+extern _Atomic int g_softbus_log_level;
+
+// 运行期级别，只能比编译期级别更严格
+void softbus_log_set_level(int level);
+// 设置输出，NULL恢复为stdout
+void softbus_log_set_output(FILE* fp);
+// 同步写出所有已缓冲的日志
+void softbus_log_flush(void);
+// 因缓冲区满丢弃的记录数
+uint64_t softbus_log_dropped(void);
+
+void softbus_log_write(int level, const char* fmt, int nargs, const softbus_log_arg_t* args);
+
+static inline bool softbus_log_enabled(int level) {
+    return level >= atomic_load_explicit(&g_softbus_log_level, memory_order_relaxed);
+}
+
+// ---- 参数捕获 ----
+
+static inline softbus_log_arg_t softbus_log_arg_int(long long v) {
+    softbus_log_arg_t a = {.type = SOFTBUS_LOG_ARG_INT, .v.i = v};
+    return a;
+}
+static inline softbus_log_arg_t softbus_log_arg_uint(unsigned long long v) {
+    softbus_log_arg_t a = {.type = SOFTBUS_LOG_ARG_UINT, .v.u = v};
+    return a;
+}
+static inline softbus_log_arg_t softbus_log_arg_double(double v) {
+    softbus_log_arg_t a = {.type = SOFTBUS_LOG_ARG_DOUBLE, .v.d = v};
+    return a;
+}
+static inline softbus_log_arg_t softbus_log_arg_ptr(const void* v) {
+    softbus_log_arg_t a = {.type = SOFTBUS_LOG_ARG_PTR, .v.p = v};
+    return a;
+}
+static inline softbus_log_arg_t softbus_log_arg_str(const char* v) {
+    softbus_log_arg_t a = {.type = SOFTBUS_LOG_ARG_STR, .v.s = v};
+    return a;
+}
+
+#define SOFTBUS_LOG_ARG(x) _Generic((x),                                    \
+    char*: softbus_log_arg_str, const char*: softbus_log_arg_str,          \
+    float: softbus_log_arg_double, double: softbus_log_arg_double,         \
+    _Bool: softbus_log_arg_uint, char: softbus_log_arg_int,                \
+    signed char: softbus_log_arg_int, short: softbus_log_arg_int,          \
+    int: softbus_log_arg_int, long: softbus_log_arg_int,                   \
+    long long: softbus_log_arg_int,                                        \
+    unsigned char: softbus_log_arg_uint, unsigned short: softbus_log_arg_uint, \
+    unsigned int: softbus_log_arg_uint, unsigned long: softbus_log_arg_uint,   \
+    unsigned long long: softbus_log_arg_uint,                              \
+    default: softbus_log_arg_ptr)(x)
+
+#define SOFTBUS_LOG_NARGS(...) SOFTBUS_LOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define SOFTBUS_LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+
+#define SOFTBUS_LOG_CAT(a, b) SOFTBUS_LOG_CAT_(a, b)
+#define SOFTBUS_LOG_CAT_(a, b) a##b
+
+#define SOFTBUS_LOG_ARGS_0() NULL
+#define SOFTBUS_LOG_ARGS_1(a) ((const softbus_log_arg_t[]){SOFTBUS_LOG_ARG(a)})
+#define SOFTBUS_LOG_ARGS_2(a, b) ((const softbus_log_arg_t[]){SOFTBUS_LOG_ARG(a), SOFTBUS_LOG_ARG(b)})
+#define SOFTBUS_LOG_ARGS_3(a, b, c) \
+    ((const softbus_log_arg_t[]){SOFTBUS_LOG_ARG(a), SOFTBUS_LOG_ARG(b), SOFTBUS_LOG_ARG(c)})
+#define SOFTBUS_LOG_ARGS_4(a, b, c, d) \
+    ((const softbus_log_arg_t[]){SOFTBUS_LOG_ARG(a), SOFTBUS_LOG_ARG(b), SOFTBUS_LOG_ARG(c), SOFTBUS_LOG_ARG(d)})
+#define SOFTBUS_LOG_ARGS_5(a, b, c, d, e) \
+    ((const softbus_log_arg_t[]){SOFTBUS_LOG_ARG(a), SOFTBUS_LOG_ARG(b), SOFTBUS_LOG_ARG(c), SOFTBUS_LOG_ARG(d), \
+                                 SOFTBUS_LOG_ARG(e)})
+#define SOFTBUS_LOG_ARGS_6(a, b, c, d, e, f) \
+    ((const softbus_log_arg_t[]){SOFTBUS_LOG_ARG(a), SOFTBUS_LOG_ARG(b), SOFTBUS_LOG_ARG(c), SOFTBUS_LOG_ARG(d), \
+                                 SOFTBUS_LOG_ARG(e), SOFTBUS_LOG_ARG(f)})
+#define SOFTBUS_LOG_ARGS_7(a, b, c, d, e, f, g) \
+    ((const softbus_log_arg_t[]){SOFTBUS_LOG_ARG(a), SOFTBUS_LOG_ARG(b), SOFTBUS_LOG_ARG(c), SOFTBUS_LOG_ARG(d), \
+                                 SOFTBUS_LOG_ARG(e), SOFTBUS_LOG_ARG(f), SOFTBUS_LOG_ARG(g)})
+#define SOFTBUS_LOG_ARGS_8(a, b, c, d, e, f, g, h) \
+    ((const softbus_log_arg_t[]){SOFTBUS_LOG_ARG(a), SOFTBUS_LOG_ARG(b), SOFTBUS_LOG_ARG(c), SOFTBUS_LOG_ARG(d), \
+                                 SOFTBUS_LOG_ARG(e), SOFTBUS_LOG_ARG(f), SOFTBUS_LOG_ARG(g), SOFTBUS_LOG_ARG(h)})
+
+// 级别低于编译期下限时条件为常量假，整条语句被编译器消除
+#define SOFTBUS_LOG_AT(level, fmt, ...)                                                         \
+    do {                                                                                        \
+        if ((level) >= SOFTBUS_LOG_MIN_LEVEL && softbus_log_enabled(level)) {                   \
+            softbus_log_write((level), "" fmt, SOFTBUS_LOG_NARGS(__VA_ARGS__),                 \
+                              SOFTBUS_LOG_CAT(SOFTBUS_LOG_ARGS_, SOFTBUS_LOG_NARGS(__VA_ARGS__))(__VA_ARGS__)); \
+        }                                                                                       \
+    } while (0)
+
+#define SOFTBUS_LOGT(fmt, ...) SOFTBUS_LOG_AT(SOFTBUS_LOG_LEVEL_TRACE, fmt, ##__VA_ARGS__)
+#define SOFTBUS_LOGD(fmt, ...) SOFTBUS_LOG_AT(SOFTBUS_LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#define SOFTBUS_LOGI(fmt, ...) SOFTBUS_LOG_AT(SOFTBUS_LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#define SOFTBUS_LOGW(fmt, ...) SOFTBUS_LOG_AT(SOFTBUS_LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#define SOFTBUS_LOGE(fmt, ...) SOFTBUS_LOG_AT(SOFTBUS_LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+
+#endif // SOFTBUS_LOG_H
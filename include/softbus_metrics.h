@@ -0,0 +1,63 @@
+#ifndef SOFTBUS_METRICS_H
+#define SOFTBUS_METRICS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 每个设备的运行统计：计数器和时延直方图都用relaxed原子操作更新，热路径上不加锁。
+// 直方图采用HDR式的对数线性分桶：小于2^SUB_BITS的值每个值一个桶，
+// 之后每个2的幂区间再分为2^(SUB_BITS-1)个桶，相对误差不超过1/2^(SUB_BITS-1)。
+
+#define SOFTBUS_HIST_SUB_BITS 5
+#define SOFTBUS_HIST_MAX_BITS 36            // 可区分的上限约68.7秒（纳秒），更大的值计入最后一个桶
+#define SOFTBUS_HIST_BUCKETS \
+    ((SOFTBUS_HIST_MAX_BITS - SOFTBUS_HIST_SUB_BITS + 2) * (1 << (SOFTBUS_HIST_SUB_BITS - 1)))
+
+// 直方图快照，单位为纳秒
+typedef struct {
+    uint64_t count;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t sum_ns;
+    uint64_t buckets[SOFTBUS_HIST_BUCKETS];
+} softbus_histogram_t;
+
+typedef struct {
+    uint64_t enqueued;          // 成功入队的消息
+    uint64_t dequeued;          // 从队列取出的消息
+    uint64_t dropped;           // 入队失败或无处理函数而丢弃的消息
+    uint64_t bytes;             // 入队的负载字节数
+    uint64_t handler_errors;    // 处理函数返回非SOFTBUS_OK的次数
+    uint64_t handler_cpu_ns;    // 处理函数累计CPU时间，仅在设置了CPU预算时统计
+    uint64_t handler_overruns;  // 处理函数超出预算的次数
+    uint64_t quarantines;       // 因连续超出预算被暂停分发的次数
+    uint32_t depth;             // 当前队列深度
+    uint32_t depth_high_water;  // 队列深度峰值
+    softbus_histogram_t queue_latency;    // 入队到分发（message_t.timestamp到取出）
+    softbus_histogram_t handler_latency;  // 处理函数执行时间
+} softbus_device_stats_t;
+
+// 百分位对应的值（桶上界），percentile取0~100；空直方图返回0
+uint64_t softbus_histogram_percentile(const softbus_histogram_t* hist, double percentile);
+double softbus_histogram_mean(const softbus_histogram_t* hist);
+
+// ---- 设备管理器和消息队列内部使用 ----
+
+typedef struct device_metrics device_metrics_t;
+
+device_metrics_t* device_metrics_create(void);
+void device_metrics_destroy(device_metrics_t* metrics);
+void device_metrics_reset(device_metrics_t* metrics);
+
+void device_metrics_enqueued(device_metrics_t* metrics, size_t bytes);
+void device_metrics_dropped(device_metrics_t* metrics);
+// queued_ns为消息在队列中停留的时间
+void device_metrics_dequeued(device_metrics_t* metrics, uint64_t queued_ns);
+// cpu_ns为0表示未统计CPU时间
+void device_metrics_handled(device_metrics_t* metrics, uint64_t exec_ns, uint64_t cpu_ns, int result);
+void device_metrics_overrun(device_metrics_t* metrics);
+void device_metrics_quarantined(device_metrics_t* metrics);
+
+void device_metrics_snapshot(const device_metrics_t* metrics, softbus_device_stats_t* stats);
+
+#endif // SOFTBUS_METRICS_H
@@ -0,0 +1,75 @@
+#ifndef SOFTBUS_NETEM_H
+#define SOFTBUS_NETEM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netinet/in.h>
+#endif
+
+// 进程内网络仿真器：多个总线节点在同一进程中运行，通过内存中的网络互连，
+// 用于在一台机器上评估路由、组播和可靠性代码在上百个节点时的表现。
+// 仿真器位于传输层之下，替代UDP socket的收发：节点拥有虚拟的IPv4单播地址，
+// 可以加入组播地址；每个数据报按配置施加带宽限制、时延、抖动、丢包和乱序，
+// 由投递线程在到期时交给目标节点的接收回调。
+
+#define NETEM_MAX_NODES 1024
+#define NETEM_MAX_GROUPS 256               // 同时存在的组播地址
+#define NETEM_MAX_DATAGRAM 65536
+#define NETEM_ADDR_BASE 0x0a000001u        // 节点地址从10.0.0.1开始依次分配
+#define NETEM_NODE_PORT 45000
+
+typedef struct {
+    uint32_t latency_us;        // 单向基础时延
+    uint32_t jitter_us;         // 时延在[0, jitter_us)内均匀抖动
+    double loss;                // 每个接收方独立的丢包概率
+    double reorder;             // 额外延迟reorder_delay_us的概率，造成乱序
+    uint32_t reorder_delay_us;
+    uint64_t bandwidth_bps;     // 每个节点的发送带宽，0表示不限
+    uint32_t seed;              // 随机数种子，相同配置下结果可复现
+} netem_config_t;
+
+typedef struct {
+    uint64_t sent;              // 节点发出的数据报
+    uint64_t delivered;         // 投递到接收方的副本
+    uint64_t dropped;           // 因丢包配置丢弃的副本
+    uint64_t reordered;
+    uint64_t no_route;          // 目标地址没有节点或组播没有成员
+    uint64_t bytes_delivered;
+} netem_stats_t;
+
+typedef struct netem netem_t;
+typedef struct netem_node netem_node_t;
+
+// 接收回调，在投递线程中执行；buf只在回调期间有效
+typedef void (*netem_receive_t)(netem_node_t* node, const struct sockaddr_in* from,
+                                const uint8_t* buf, size_t len, void* ctx);
+
+netem_t* netem_create(const netem_config_t* config);
+void netem_destroy(netem_t* net);
+
+// 运行中修改链路参数，对之后发送的数据报生效
+void netem_set_config(netem_t* net, const netem_config_t* config);
+
+// 添加节点，地址按添加顺序分配
+netem_node_t* netem_node_add(netem_t* net, netem_receive_t handler, void* ctx);
+void netem_node_addr(const netem_node_t* node, struct sockaddr_in* addr);
+int netem_node_index(const netem_node_t* node);
+
+int netem_join(netem_node_t* node, uint32_t group_addr);
+int netem_leave(netem_node_t* node, uint32_t group_addr);
+
+// 发送一个数据报，dest为组播地址时复制给所有成员（不含发送者）
+int netem_send(netem_node_t* node, const struct sockaddr_in* dest, const uint8_t* buf, size_t len);
+
+// 等待所有已发出的数据报投递完毕，超时返回SOFTBUS_TIMEOUT
+int netem_drain(netem_t* net, int timeout_ms);
+
+void netem_get_stats(netem_t* net, netem_stats_t* stats);
+void netem_reset_stats(netem_t* net);
+
+#endif // SOFTBUS_NETEM_H
@@ -0,0 +1,76 @@
+#ifndef SOFTBUS_RMCAST_H
+#define SOFTBUS_RMCAST_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netinet/in.h>
+#endif
+#include "softbus_wire.h"
+
+// 基于NACK的可靠组播，由socket层在发往组播地址的数据报上使用：
+// 发送方为每个(本节点, 组播地址)流分配递增序号并保留最近一个接收窗口的数据报，
+// 接收方按序号检测空洞后等待一段随机时间再发NACK，NACK单播给发送方并同时发往组播地址：
+// 其他接收方看到别人已请求的序号就不再重复请求，发送方把一小段时间内对同一序号的请求合并为一次重传。
+// NACK带上接收方见过的最大序号和重传轮次（由心跳告知），发送方据此区分重传确实丢了还是NACK在重传到达前发出，
+// 不依赖修复时延。接收方连续几轮没有进展时加倍NACK间隔。发送方空闲时发送心跳以便发现尾部丢包。
+// 心跳携带发送方仍保留的最小序号，NACK请求的数据已不在历史中时发送方单播回一个心跳，
+// 接收方只放弃发送方已经不再保留的数据；发送方长时间没有任何响应时才放弃整个空洞。
+// 接收方收到即投递，不保证顺序（消息队列本身按优先级排序），只保证不重复、尽量不丢。
+
+#define RMCAST_WINDOW 2048                 // 接收窗口，必须为8的倍数
+#define RMCAST_HISTORY_SIZE RMCAST_WINDOW  // 每个发送流保留的数据报数，不小于接收窗口，窗口前移时放弃的只会是发送方已丢弃的数据
+#define RMCAST_MAX_SEND_STREAMS 64         // 本节点同时发送的组播流
+#define RMCAST_MAX_RECV_STREAMS 64         // 同时跟踪的远端组播流
+#define RMCAST_TICK_MS 5                   // 有待处理的空洞或心跳时的定时周期
+#define RMCAST_NACK_DELAY_MS 5             // 发现空洞后等待乱序数据到达的时间
+#define RMCAST_NACK_JITTER_MS 10           // NACK前额外的随机等待上限，让各接收方错开，先发出的NACK抑制其余的
+#define RMCAST_NACK_INTERVAL_MS 20         // 同一个流两轮NACK之间的最小间隔
+#define RMCAST_NACK_MAX_BACKOFF 3          // 没有进展时NACK间隔最多加倍的次数
+#define RMCAST_SENDER_TIMEOUT_MS 1000      // 发送方这么久没有任何数据报或心跳时放弃空洞
+#define RMCAST_RETX_DELAY_MS 2             // 发送方收到NACK后汇总请求的时间，在此之后的第一个定时周期重传
+#define RMCAST_RETX_HOLDOFF_MS 50          // 不带重传标记的旧格式NACK对同一数据报两次重传的最小间隔；重传后这么久仍收到过时的NACK时单播心跳补发标记
+#define RMCAST_NACK_MAX_RANGES 64          // 单个NACK携带的缺失区间数
+#define RMCAST_HEARTBEAT_MS 100            // 心跳间隔
+#define RMCAST_HEARTBEAT_LINGER_MS 2000    // 最后一次发送后继续发送心跳的时长
+
+// 实际发送数据报的函数，由下层（socket层或网络仿真器）提供，ctx为创建实例时传入的output_ctx
+typedef int (*rmcast_output_t)(void* ctx, const struct sockaddr_in* dest, const uint8_t* buf, size_t len);
+
+typedef struct rmcast rmcast_t;
+
+typedef struct {
+    uint64_t tx_sequenced;      // 带序号发出的数据报
+    uint64_t retransmits;       // 响应NACK重传的数据报
+    uint64_t heartbeats;        // 发出的心跳
+    uint64_t nacks_sent;
+    uint64_t nacks_received;
+    uint64_t nacks_suppressed;  // 因其他接收方已请求而未再请求的序号
+    uint64_t rx_duplicates;     // 丢弃的重复数据报
+    uint64_t rx_recovered;      // 通过重传补齐的数据报
+    uint64_t rx_lost;           // 放弃恢复的数据报（发送方已不再保留或长时间无响应）
+} rmcast_stats_t;
+
+// 创建一个节点的可靠组播实例，重传、心跳和NACK都经output发出。
+// group_port为组播端口（主机字节序），NACK同时发往该端口上的组播地址；为0时NACK只单播给发送方，不做抑制
+rmcast_t* rmcast_create(uint32_t node_id, uint16_t group_port, rmcast_output_t output, void* output_ctx);
+void rmcast_destroy(rmcast_t* rm);
+
+// 为一个已编码（不含序号扩展）的帧分配序号、记入历史并发送
+int rmcast_send(rmcast_t* rm, const struct sockaddr_in* dest, const uint8_t* frame, size_t len);
+
+// 接收带序号的数据报，返回false表示重复应丢弃
+bool rmcast_accept(rmcast_t* rm, const softbus_wire_hdr_t* hdr, const struct sockaddr_in* sender);
+
+// 处理控制帧（心跳、NACK），body为帧头之后的内容
+void rmcast_handle_control(rmcast_t* rm, const softbus_wire_hdr_t* hdr, const uint8_t* body, size_t len,
+                           const struct sockaddr_in* sender);
+
+void rmcast_get_stats(rmcast_t* rm, rmcast_stats_t* stats);
+void rmcast_reset_stats(rmcast_t* rm);
+
+#endif // SOFTBUS_RMCAST_H
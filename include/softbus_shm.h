@@ -0,0 +1,69 @@
+#ifndef SOFTBUS_SHM_H
+#define SOFTBUS_SHM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "softbus_types.h"
+#include "device_ops.h"
+
+// 是否启用共享内存传输（仅Linux）
+#ifndef ENABLE_SHM_TRANSPORT
+#ifdef _WIN32
+#define ENABLE_SHM_TRANSPORT 0
+#else
+#define ENABLE_SHM_TRANSPORT 1
+#endif
+#endif
+
+#if ENABLE_SHM_TRANSPORT
+
+// 共享内存段配置
+#define SHM_DEFAULT_BUS_NAME "/softbus_bus"
+#define SHM_MAX_PROCS 8            // 同一总线上的最大进程数
+#define SHM_MAX_DEVICES 128        // 设备目录容量
+#define SHM_RING_SLOTS 256         // 每个进程收件环的槽位数，必须为2的幂
+#define SHM_MAX_PAYLOAD 4000       // 单条消息最大负载，不受MAX_MSG_SIZE限制
+#define SHM_SPIN_COUNT 2000        // 进入futex等待前的自旋次数
+
+// 接收回调，在共享内存接收线程中执行
+typedef void (*shm_receive_handler_t)(const char* target, message_type_t type, softbus_priority_t priority,
+                                      const void* data, size_t len, void* user_data);
+
+// 映射（必要时创建）名为bus_name的共享内存段，并占用一个进程槽位
+int shm_transport_init(const char* bus_name);
+
+// 释放进程槽位和本进程注册的设备，解除映射
+void shm_transport_deinit(void);
+
+// 删除共享内存段名称，已映射的进程不受影响
+int shm_transport_unlink(const char* bus_name);
+
+// 启动/停止接收线程
+int shm_transport_start(void);
+void shm_transport_stop(void);
+
+// 未启动接收线程时在调用线程中处理收件环，最多max_count条，返回处理的条数；
+// 接收线程运行时返回SOFTBUS_BUSY
+int shm_transport_poll(int max_count);
+
+// 在共享设备目录中登记/注销本进程的设备
+int shm_transport_register_device(const char* device_name);
+int shm_transport_unregister_device(const char* device_name);
+
+// 查找设备所在的其他进程，返回进程槽位，未找到或位于本进程时返回-1
+int shm_transport_lookup(const char* device_name);
+
+// 查找设备所在的其他进程，返回其pid，未找到或位于本进程时返回-1
+int shm_transport_lookup_pid(const char* device_name);
+
+// 发送消息到其他进程的设备；接收方在线时不产生系统调用
+int shm_transport_send(const char* target, message_type_t type, softbus_priority_t priority,
+                       const void* data, size_t len);
+
+// 设置接收回调，默认投递到本地消息队列
+void shm_transport_set_receive_handler(shm_receive_handler_t handler, void* user_data);
+
+#endif // ENABLE_SHM_TRANSPORT
+
+#endif // SOFTBUS_SHM_H
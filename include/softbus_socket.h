@@ -1,6 +1,9 @@
 #ifndef SOFTBUS_SOCKET_H
 #define SOFTBUS_SOCKET_H
 
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
 #include "softbus_types.h"
 
 // 是否启用socket组播功能
@@ -13,6 +16,54 @@
 #define MULTICAST_GROUP "239.0.0.1"
 #define MAX_MSG_SIZE 1024
 
+// 分片与重组配置：超过MAX_MSG_SIZE的消息按MTU分片发送
+#define SOCKET_MAX_MESSAGE_SIZE (1024 * 1024)   // 分片后允许的最大消息
+#define SOCKET_REASM_SLOTS 16                   // 同时重组的消息数量
+#define SOCKET_REASM_MAX_FRAGMENTS 1024         // 单条消息的最大分片数
+#define SOCKET_REASM_TIMEOUT_MS 2000            // 未收齐的消息超时丢弃
+#define SOCKET_REASM_MEMORY_CAP (4 * 1024 * 1024)  // 未完成消息占用的内存上限
+#define SOCKET_REASM_POOL_KEEP 4                // 每种规格缓存的空闲缓冲区数量
+
+// 小消息合并配置
+#define SOCKET_DEFAULT_MTU 1472                 // 以太网MTU减去IP/UDP头
+#define SOCKET_MAX_DATAGRAM 9000                // 允许配置的最大数据报（巨帧）
+#define SOCKET_DEFAULT_COALESCE_DELAY_US 200    // 默认最长合并等待时间
+#define SOCKET_COALESCE_MAX_DESTS 8             // 同时合并的目的地址数量
+
+// 组播地址池：每个组按名字哈希映射到池中的一个地址，所有节点计算结果一致
+#define SOCKET_GROUP_POOL_BASE "239.1.0.0"
+#define SOCKET_GROUP_POOL_SIZE 256
+#define SOCKET_GROUP_MAX_MEMBERSHIPS 64         // 本节点同时加入的组播地址数量
+#define SOCKET_MEMBERSHIPS_PER_SOCKET 20        // 内核默认igmp_max_memberships
+
+// 收发统计，packets_per_msg小于1表示发生了合并
+typedef struct {
+    uint64_t tx_messages;
+    uint64_t tx_datagrams;
+    uint64_t rx_messages;
+    uint64_t rx_datagrams;
+    uint64_t rx_loopback_dropped;   // 丢弃的本节点组播回环副本
+    uint64_t tx_fragments;
+    uint64_t rx_fragments;
+    uint64_t reasm_completed;       // 重组完成的消息
+    uint64_t reasm_timeouts;        // 超时丢弃的未完成消息
+    uint64_t reasm_evicted;         // 因槽位或内存上限被淘汰的未完成消息
+    uint64_t rm_retransmits;        // 可靠组播：响应NACK重传的数据报
+    uint64_t rm_heartbeats;
+    uint64_t rm_nacks_sent;
+    uint64_t rm_nacks_received;
+    uint64_t rm_nacks_suppressed;   // 因其他接收方已请求而未再请求的序号
+    uint64_t rm_duplicates;         // 丢弃的重复组播数据报
+    uint64_t rm_recovered;          // 经重传补齐的组播数据报
+    uint64_t rm_lost;               // 放弃恢复的组播数据报
+    double tx_packets_per_msg;
+    double rx_packets_per_msg;
+} socket_stats_t;
+
+// 带目标的记录接收回调，在IO线程中执行；is_group表示target是组名
+typedef void (*socket_target_handler_t)(const char* target, bool is_group, message_type_t type,
+                                        softbus_priority_t priority, const void* data, size_t len);
+
 // Socket组播初始化
 int socket_multicast_init(void);
 
@@ -22,13 +73,70 @@ void socket_multicast_deinit(void);
 // 发送组播消息
 int socket_multicast_send(const char* message, size_t len);
 
+// 发送组播消息，指定消息类型和优先级；合并模式下PRIORITY_URGENT立即发送
+// 超过MAX_MSG_SIZE（不超过SOCKET_MAX_MESSAGE_SIZE）的消息自动分片
+int socket_multicast_send_ex(const void* data, size_t len, message_type_t type, softbus_priority_t priority);
+
+// 经单播socket发送一条带目标的消息到远端节点；is_group为true时由对端投递给该组的本地成员
+int socket_send_to_node(const softbus_node_addr_t* node, const char* target, bool is_group,
+                        const void* data, size_t len, message_type_t type, softbus_priority_t priority);
+
+// 设置带目标记录的处理函数；未设置时设备目标直接投递到本地消息队列，组目标被丢弃
+void socket_set_target_handler(socket_target_handler_t handler);
+
+// 设置组播地址池，base为池中第一个地址；仅在未加入任何组时可修改
+int socket_set_group_pool(const char* base, uint32_t size);
+
+// 组名对应的组播地址（网络字节序）
+uint32_t socket_group_address(const char* group);
+
+// 加入/退出组名对应的组播地址；映射到同一地址的组共享一次成员关系
+int socket_group_join(const char* group);
+int socket_group_leave(const char* group);
+
+// 发送组消息到该组的组播地址，只有加入了该组的节点会在内核层收到
+int socket_multicast_send_group(const char* group, const void* data, size_t len,
+                                message_type_t type, softbus_priority_t priority);
+
+// 解析点分十进制IPv4地址和主机字节序端口
+int socket_node_addr_parse(const char* ip, uint16_t port, softbus_node_addr_t* node);
+
+// 本节点标识，用于识别自己发出的组播回环
+uint32_t socket_get_node_id(void);
+
+// 可靠组播之外的控制帧（如设备通告）的接收回调，在IO线程中执行；
+// sender为对端单播地址，body从kind字节开始
+typedef void (*socket_control_handler_t)(uint32_t node_id, const softbus_node_addr_t* sender,
+                                         const uint8_t* body, size_t len);
+void socket_set_control_handler(socket_control_handler_t handler);
+
+// 发送控制帧，node为NULL时发往默认组播组；不经过可靠组播，丢失由上层周期性重发弥补
+int socket_send_control(const softbus_node_addr_t* node, const void* body, size_t len);
+
+// 开关可靠组播（默认开启）：组播数据报带序号，接收方发现丢包后NACK请求重传
+void socket_set_reliable(bool enable);
+
+// 配置小消息合并：同一目的地址的多条消息打包到一个数据报，
+// 达到mtu、等待delay_us或遇到紧急消息时发送；mtu为0使用默认值
+int socket_set_coalescing(bool enable, uint32_t delay_us, size_t mtu);
+
+// 立即发送所有待合并的消息
+int socket_flush(void);
+
+// 获取/清零收发统计
+void socket_get_stats(socket_stats_t* stats);
+void socket_reset_stats(void);
+
 // 接收组播消息
 int socket_multicast_receive(char* buffer, size_t buffer_size, int timeout_ms);
 
-// 启动组播接收线程
+// 获取单播socket绑定的本地端口
+int socket_unicast_get_port(void);
+
+// 启动IO线程，由epoll统一服务组播、单播等socket
 int socket_multicast_start_receiver(void);
 
-// 停止组播接收线程
+// 停止IO线程，通过eventfd唤醒后等待线程退出
 void socket_multicast_stop_receiver(void);
 
 #endif // ENABLE_SOCKET_MULTICAST
@@ -0,0 +1,59 @@
+#ifndef SOFTBUS_TRACE_H
+#define SOFTBUS_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 消息生命周期追踪：在消息经过的每个阶段记录(msg_id, 时间戳, 阶段)，
+// 事件写入调用线程自己的环形缓冲区（满后覆盖最旧的事件），不加锁；
+// 导出为Chrome trace JSON，可在 chrome://tracing 或 Perfetto 中按消息查看排队、处理和唤醒的耗时。
+// ENABLE_TRACE为0时追踪点展开为空语句，不产生任何代码。
+
+#ifndef ENABLE_TRACE
+#define ENABLE_TRACE 0
+#endif
+
+typedef enum {
+    TRACE_API_ENTRY,            // 进入发送API
+    TRACE_ENQUEUE,              // 插入目标设备的消息队列
+    TRACE_DEQUEUE,              // 从消息队列取出
+    TRACE_HANDLER_BEGIN,
+    TRACE_HANDLER_END,
+    TRACE_RESPONSE_ENQUEUE,     // 处理函数中发出的响应入队
+    TRACE_COMPLETE,             // 完成回调（同步模式释放信号量）
+    TRACE_API_EXIT,             // 发送API返回，同步模式下即等待线程被唤醒
+} trace_point_t;
+
+#if ENABLE_TRACE
+
+#define SOFTBUS_TRACE_RING_SIZE 16384       // 每个线程保留的事件数，必须为2的幂
+
+// 记录一个追踪点，target可为NULL
+void softbus_trace_record(trace_point_t point, uint64_t msg_id, const char* target);
+
+// 当前线程正在处理的消息，处理函数中发出的消息据此记为响应
+void softbus_trace_set_current(uint64_t msg_id);
+uint64_t softbus_trace_current(void);
+
+// 运行期开关（默认开启）
+void softbus_trace_set_enabled(bool enabled);
+
+// 把所有线程缓冲区中的事件写成Chrome trace JSON
+int softbus_trace_dump(const char* path);
+
+// 清空所有缓冲区
+void softbus_trace_clear(void);
+
+#define SOFTBUS_TRACE(point, msg_id, target) softbus_trace_record((point), (msg_id), (target))
+#define SOFTBUS_TRACE_SET_CURRENT(msg_id) softbus_trace_set_current(msg_id)
+#define SOFTBUS_TRACE_CURRENT() softbus_trace_current()
+
+#else
+
+#define SOFTBUS_TRACE(point, msg_id, target) ((void)0)
+#define SOFTBUS_TRACE_SET_CURRENT(msg_id) ((void)0)
+#define SOFTBUS_TRACE_CURRENT() ((uint64_t)0)
+
+#endif // ENABLE_TRACE
+
+#endif // SOFTBUS_TRACE_H
@@ -1,6 +1,8 @@
 #ifndef SOFTBUS_TYPES_H
 #define SOFTBUS_TYPES_H
 
+#include <stdint.h>
+
 // 返回值定义
 #define SOFTBUS_OK           0
 #define SOFTBUS_ERROR       -1
@@ -49,6 +51,12 @@ typedef enum {
     SOFTBUS_MODE_SYNC    // 同步模式：等待接收方处理完成后返回
 } softbus_mode_t;
 
+// 远端节点地址：IPv4地址和单播端口，均为网络字节序；addr为0表示本节点
+typedef struct {
+    uint32_t addr;
+    uint16_t port;
+} softbus_node_addr_t;
+
 // 同步等待超时时间（毫秒）
 #define SOFTBUS_SYNC_TIMEOUT_DEFAULT 5000
 
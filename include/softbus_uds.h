@@ -0,0 +1,63 @@
+#ifndef SOFTBUS_UDS_H
+#define SOFTBUS_UDS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "softbus_types.h"
+#include "device_ops.h"
+
+// 是否启用Unix域socket传输（仅Linux）
+#ifndef ENABLE_UDS_TRANSPORT
+#ifdef _WIN32
+#define ENABLE_UDS_TRANSPORT 0
+#else
+#define ENABLE_UDS_TRANSPORT 1
+#endif
+#endif
+
+#if ENABLE_UDS_TRANSPORT
+
+// 抽象命名空间地址前缀，完整地址为 "\0softbus.<节点名>"
+#define UDS_ADDR_PREFIX "softbus."
+#define UDS_MAX_NODE_NAME 48
+// 不超过该长度的负载随数据报内联发送，更大的负载通过密封的memfd传递
+#define UDS_INLINE_MAX (16 * 1024)
+// 通过memfd传递的单条消息上限
+#define UDS_MAX_PAYLOAD ((size_t)1 << 30)
+
+// 大负载发送缓冲区：由memfd支撑，调用者直接写入addr后发送，避免额外复制
+typedef struct {
+    int fd;
+    void* addr;
+    size_t len;
+} uds_buffer_t;
+
+// 接收回调，在IO线程中执行；data在回调返回后仍然有效，需由回调调用release释放
+typedef void (*uds_receive_handler_t)(const char* target, message_type_t type, softbus_priority_t priority,
+                                      void* data, size_t len, void (*release)(void* data, size_t len),
+                                      void* user_data);
+
+// 初始化并绑定本节点地址，node_name为NULL时使用 "<pid>"；接收在共享的IO线程中进行，
+// 初始化时启动（引用计数加一），清理时停止
+int uds_transport_init(const char* node_name);
+void uds_transport_deinit(void);
+
+// 获取本节点名
+const char* uds_transport_node_name(void);
+
+// 发送消息到peer节点上的target设备，大负载自动改用memfd
+int uds_transport_send(const char* peer, const char* target, message_type_t type, softbus_priority_t priority,
+                       const void* data, size_t len);
+
+// 零拷贝发送：申请memfd缓冲区，写入后发送；发送后缓冲区被密封并归接收方使用
+int uds_transport_alloc(size_t len, uds_buffer_t* buf);
+int uds_transport_send_buffer(const char* peer, const char* target, message_type_t type, softbus_priority_t priority,
+                              uds_buffer_t* buf);
+void uds_transport_free_buffer(uds_buffer_t* buf);
+
+// 设置接收回调，默认投递到本地消息队列
+void uds_transport_set_receive_handler(uds_receive_handler_t handler, void* user_data);
+
+#endif // ENABLE_UDS_TRANSPORT
+
+#endif // SOFTBUS_UDS_H
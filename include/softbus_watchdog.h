@@ -0,0 +1,53 @@
+#ifndef SOFTBUS_WATCHDOG_H
+#define SOFTBUS_WATCHDOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "softbus_types.h"
+#include "softbus_metrics.h"
+#include "device_ops.h"
+
+// 处理函数剖析与看门狗：
+// - 每次调用process_msg都记录墙钟时间（CLOCK_MONOTONIC，vDSO读取），
+//   设置了CPU预算的设备额外记录线程CPU时间；
+// - 单次调用超出设备的墙钟或CPU预算计为一次超时；
+// - 看门狗线程周期检查正在执行的处理函数，运行超过墙钟预算时立即告警，不必等它返回；
+// - 开启隔离后，设备连续WATCHDOG_QUARANTINE_STRIKES次超时即暂停向其分发（消息留在队列中），
+//   WATCHDOG_QUARANTINE_MS后恢复；恢复后再次超时立即重新隔离，一次按预算完成即清除记录。
+// 每个设备同一时刻只跟踪一个正在执行的处理函数，与process_messages的单消费者模型一致。
+
+#define WATCHDOG_DEFAULT_WALL_BUDGET_US 100000  // 默认墙钟预算100ms
+#define WATCHDOG_SCAN_INTERVAL_MS 10
+#define WATCHDOG_QUARANTINE_STRIKES 3
+#define WATCHDOG_QUARANTINE_MS 1000
+
+typedef struct device_watchdog device_watchdog_t;
+
+// 一次处理函数调用的计时
+typedef struct {
+    uint64_t start_ns;
+    uint64_t start_cpu_ns;
+    uint64_t wall_ns;           // watchdog_handler_end填写
+    uint64_t cpu_ns;            // 未设置CPU预算时为0
+} watchdog_call_t;
+
+int watchdog_init(void);
+void watchdog_deinit(void);
+
+// 开关隔离（默认关闭）
+void watchdog_set_quarantine(bool enable);
+
+// 设备的看门狗状态，超时和隔离次数计入metrics
+device_watchdog_t* watchdog_device_create(const char* device_name, device_metrics_t* metrics);
+void watchdog_device_destroy(device_watchdog_t* wd);
+
+// 设置单次调用预算（微秒）；wall_us为0使用默认值，cpu_us为0不统计CPU时间
+void watchdog_set_budget(device_watchdog_t* wd, uint32_t wall_us, uint32_t cpu_us);
+
+// 设备是否可以分发，隔离期间返回false
+bool watchdog_dispatch_allowed(device_watchdog_t* wd);
+
+void watchdog_handler_begin(device_watchdog_t* wd, message_type_t type, watchdog_call_t* call);
+void watchdog_handler_end(device_watchdog_t* wd, watchdog_call_t* call);
+
+#endif // SOFTBUS_WATCHDOG_H
@@ -0,0 +1,176 @@
+#ifndef SOFTBUS_WIRE_H
+#define SOFTBUS_WIRE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// 数据报格式：帧头 + 若干条消息记录，多字节字段均为网络字节序
+//
+//   帧头   | magic(2) | version(1) | flags(1) | count(2) | reserved(2) | node_id(4) |
+//   记录   | len(2) | type(1) | priority(1) | target_info(1) | target(n) | payload(len) |
+//
+// 多条小消息可合并到一个数据报中，接收方一次遍历完成拆包。
+// node_id标识发送节点，用于丢弃自己发出又被组播回环收到的数据报。
+// target_info低7位为目标名长度n，最高位表示目标是组；n为0时投递给旧的"multicast"目标。
+//
+// 超过MAX_MSG_SIZE的消息拆成多个分片帧，每帧只含一条记录，记录的len为本片长度：
+//   分片帧 | 帧头(flags=FRAGMENT, count=1) | msg_id(4) | index(2) | frag_count(2) | total_len(4) | offset(4) | 记录 |
+//
+// 可靠组播的数据报在帧头后附加序号扩展，stream为发往的组播地址，seq按(发送节点, stream)递增：
+//   序号扩展 | stream(4) | seq(4) |
+// 控制帧（flags=CONTROL, count=0）用于心跳和NACK，帧头后为kind(1)和各自的内容：
+//   心跳     | kind=1 | stream(4) | last_seq(4) | first_seq(4) | retx_epoch(4) |
+//   NACK     | kind=2 | stream(4) | range_count(1) | { start(4) | len(2) } * range_count | target(4) | seen(4) | retx_epoch(4) |
+// first_seq为发送方仍可重传的最小序号，retx_epoch为发送方的重传轮次；NACK同时组播给其他接收方，
+// target为所请求流的发送节点，seen和retx_epoch为接收方发出请求时见过的最大序号和重传轮次。各自末尾的字段可以缺省
+//   设备通告 | kind=3 | flags(1) | count(1) | { name_len(1) | name } * count |
+
+#define SOFTBUS_WIRE_MAGIC   0x5342  // "SB"
+#define SOFTBUS_WIRE_VERSION 3
+
+#define SOFTBUS_WIRE_HDR_SIZE 12
+#define SOFTBUS_WIRE_REC_SIZE 5       // 记录固定部分，不含目标名
+
+#define SOFTBUS_WIRE_FLAG_FRAGMENT 0x01
+#define SOFTBUS_WIRE_FRAG_SIZE     16
+#define SOFTBUS_WIRE_FLAG_SEQ      0x02
+#define SOFTBUS_WIRE_SEQ_SIZE      8
+#define SOFTBUS_WIRE_FLAG_CONTROL  0x04
+
+#define SOFTBUS_WIRE_CTRL_HEARTBEAT 1
+#define SOFTBUS_WIRE_CTRL_NACK      2
+#define SOFTBUS_WIRE_CTRL_ANNOUNCE  3
+
+#define SOFTBUS_WIRE_ANNOUNCE_WITHDRAW 0x01  // 列出的设备已注销
+#define SOFTBUS_WIRE_ANNOUNCE_SOLICIT  0x02  // 请求收到的节点立即通告全部设备
+
+#define SOFTBUS_WIRE_TARGET_GROUP    0x80
+#define SOFTBUS_WIRE_TARGET_LEN_MASK 0x7f
+
+// 帧头
+typedef struct {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t flags;
+    uint16_t count;
+    uint32_t node_id;
+    uint32_t stream;    // 仅FLAG_SEQ时有效
+    uint32_t seq;
+    uint8_t hdr_len;    // 解析得到的帧头总长度，含扩展
+} softbus_wire_hdr_t;
+
+// 消息记录头
+typedef struct {
+    uint16_t len;
+    uint8_t type;
+    uint8_t priority;
+    uint8_t target_info;
+} softbus_wire_rec_t;
+
+// 分片头
+typedef struct {
+    uint32_t msg_id;
+    uint16_t index;
+    uint16_t count;
+    uint32_t total_len;
+    uint32_t offset;
+} softbus_wire_frag_t;
+
+static inline void softbus_wire_put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+static inline uint16_t softbus_wire_get_u16(const uint8_t* p) {
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static inline void softbus_wire_put_u32(uint8_t* p, uint32_t v) {
+    softbus_wire_put_u16(p, (uint16_t)(v >> 16));
+    softbus_wire_put_u16(p + 2, (uint16_t)v);
+}
+
+static inline uint32_t softbus_wire_get_u32(const uint8_t* p) {
+    return ((uint32_t)softbus_wire_get_u16(p) << 16) | softbus_wire_get_u16(p + 2);
+}
+
+// 编码帧头，返回写入的字节数
+static inline size_t softbus_wire_encode_hdr(uint8_t* p, const softbus_wire_hdr_t* hdr) {
+    softbus_wire_put_u16(p, hdr->magic);
+    p[2] = hdr->version;
+    p[3] = hdr->flags;
+    softbus_wire_put_u16(p + 4, hdr->count);
+    softbus_wire_put_u16(p + 6, 0);
+    softbus_wire_put_u32(p + 8, hdr->node_id);
+    if (!(hdr->flags & SOFTBUS_WIRE_FLAG_SEQ)) {
+        return SOFTBUS_WIRE_HDR_SIZE;
+    }
+    softbus_wire_put_u32(p + SOFTBUS_WIRE_HDR_SIZE, hdr->stream);
+    softbus_wire_put_u32(p + SOFTBUS_WIRE_HDR_SIZE + 4, hdr->seq);
+    return SOFTBUS_WIRE_HDR_SIZE + SOFTBUS_WIRE_SEQ_SIZE;
+}
+
+// 解析帧头，magic或版本不匹配时返回-1
+static inline int softbus_wire_decode_hdr(const uint8_t* p, size_t len, softbus_wire_hdr_t* hdr) {
+    if (len < SOFTBUS_WIRE_HDR_SIZE) {
+        return -1;
+    }
+    hdr->magic = softbus_wire_get_u16(p);
+    hdr->version = p[2];
+    hdr->flags = p[3];
+    hdr->count = softbus_wire_get_u16(p + 4);
+    hdr->node_id = softbus_wire_get_u32(p + 8);
+    hdr->stream = 0;
+    hdr->seq = 0;
+    hdr->hdr_len = SOFTBUS_WIRE_HDR_SIZE;
+    if (hdr->magic != SOFTBUS_WIRE_MAGIC || hdr->version != SOFTBUS_WIRE_VERSION) {
+        return -1;
+    }
+    if (hdr->flags & SOFTBUS_WIRE_FLAG_SEQ) {
+        if (len < SOFTBUS_WIRE_HDR_SIZE + SOFTBUS_WIRE_SEQ_SIZE) {
+            return -1;
+        }
+        hdr->stream = softbus_wire_get_u32(p + SOFTBUS_WIRE_HDR_SIZE);
+        hdr->seq = softbus_wire_get_u32(p + SOFTBUS_WIRE_HDR_SIZE + 4);
+        hdr->hdr_len += SOFTBUS_WIRE_SEQ_SIZE;
+    }
+    return 0;
+}
+
+static inline void softbus_wire_encode_rec(uint8_t* p, const softbus_wire_rec_t* rec) {
+    softbus_wire_put_u16(p, rec->len);
+    p[2] = rec->type;
+    p[3] = rec->priority;
+    p[4] = rec->target_info;
+}
+
+static inline void softbus_wire_decode_rec(const uint8_t* p, softbus_wire_rec_t* rec) {
+    rec->len = softbus_wire_get_u16(p);
+    rec->type = p[2];
+    rec->priority = p[3];
+    rec->target_info = p[4];
+}
+
+static inline void softbus_wire_encode_frag(uint8_t* p, const softbus_wire_frag_t* frag) {
+    softbus_wire_put_u32(p, frag->msg_id);
+    softbus_wire_put_u16(p + 4, frag->index);
+    softbus_wire_put_u16(p + 6, frag->count);
+    softbus_wire_put_u32(p + 8, frag->total_len);
+    softbus_wire_put_u32(p + 12, frag->offset);
+}
+
+static inline void softbus_wire_decode_frag(const uint8_t* p, softbus_wire_frag_t* frag) {
+    frag->msg_id = softbus_wire_get_u32(p);
+    frag->index = softbus_wire_get_u16(p + 4);
+    frag->count = softbus_wire_get_u16(p + 6);
+    frag->total_len = softbus_wire_get_u32(p + 8);
+    frag->offset = softbus_wire_get_u32(p + 12);
+}
+
+// 记录头加目标名的长度，负载紧随其后
+static inline size_t softbus_wire_rec_hdr_size(const softbus_wire_rec_t* rec) {
+    return SOFTBUS_WIRE_REC_SIZE + (rec->target_info & SOFTBUS_WIRE_TARGET_LEN_MASK);
+}
+
+#endif // SOFTBUS_WIRE_H
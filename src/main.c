@@ -13,6 +13,8 @@
 #include "softbus_types.h"
 #include "message_types.h"
 #include "message_queue.h"
+#include "softbus_trace.h"
+#include "softbus_capture.h"
 
 // 添加全局变量控制程序运行
 static volatile int running = 1;
@@ -166,6 +168,11 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
+    // softbus_demo [capture_file]：抓取本次运行的总线流量，可用softbus_replay回放
+    if (argc > 1 && softbus_capture_start(argv[1]) == SOFTBUS_OK) {
+        printf("Capturing traffic to %s\n", argv[1]);
+    }
+
     // 注册设备
     printf("\nRegistering devices...\n");
     ret = softbus_api_register_device(DEVICE_TYPE_SENSOR, "temperature_sensor", temperature_sensor_handler);
@@ -289,6 +296,11 @@ int main(int argc, char *argv[]) {
     printf("Processed %d messages for LED controller\n", ret);
 
 cleanup:
+#if ENABLE_TRACE
+    if (softbus_trace_dump("build/softbus_trace.json") == SOFTBUS_OK) {
+        printf("\nTrace written to build/softbus_trace.json\n");
+    }
+#endif
     printf("\nCleaning up...\n");
     softbus_api_deinit();
 
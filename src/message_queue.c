@@ -2,9 +2,14 @@
 #include <stdlib.h>
 #include <pthread.h>
 #include <time.h>
+#include <stdatomic.h>
 #include "message_queue.h"
 #include "device_manager.h"
-#include "rbtree.h"
+#include "prio_queue.h"
+#include "softbus_log.h"
+#include "softbus_capture.h"
+#include "softbus_lock.h"
+#include "softbus_trace.h"
 #include "softbus_types.h"
 #include "message_types.h"
 #include "softbus_internal.h"
@@ -17,23 +22,27 @@ typedef struct {
 } message_callback_info_t;
 
 // 全局变量
-static pthread_mutex_t g_callback_mutex = PTHREAD_MUTEX_INITIALIZER;
+static softbus_lock_t g_callback_mutex = SOFTBUS_LOCK_INITIALIZER("callbacks");
 static message_callback_info_t g_callbacks[MAX_DEVICES];
 static int g_callback_count = 0;
+static _Atomic uint64_t g_next_msg_id = 1;
 
 // 内部函数声明
 static message_callback_info_t* find_callback(const char* target);
-static int insert_message(device_manager_t* dev, message_t* msg);
 
 int message_queue_init(void) {
-    pthread_mutex_init(&g_callback_mutex, NULL);
+    softbus_lock_init(&g_callback_mutex, "callbacks");
     g_callback_count = 0;
     memset(g_callbacks, 0, sizeof(g_callbacks));
     return 0;
 }
 
 void message_queue_deinit(void) {
-    pthread_mutex_destroy(&g_callback_mutex);
+    softbus_lock_destroy(&g_callback_mutex);
+}
+
+uint64_t message_queue_next_id(void) {
+    return atomic_fetch_add_explicit(&g_next_msg_id, 1, memory_order_relaxed);
 }
 
 int message_queue_send(const message_t* msg) {
@@ -41,59 +50,82 @@ int message_queue_send(const message_t* msg) {
         return SOFTBUS_INVALID_ARG;
     }
 
-    printf("Sending message to %s: type=%d, content=%s\n", 
-           msg->target, msg->type, msg->content);
-
-    // 查找目标设备
-    device_manager_t* dev = device_manager_find(msg->target);
-    if (!dev) {
-        printf("Target device not found: %s\n", msg->target);
-        return SOFTBUS_NOT_FOUND;
-    }
+    SOFTBUS_LOGD("Sending message to %s: type=%d, content=%s\n", 
+                 msg->target, msg->type, msg->content);
 
     // 创建消息副本
     message_t* new_msg = (message_t*)malloc(sizeof(message_t));
     if (!new_msg) {
-        printf("Failed to allocate memory for new message\n");
+        SOFTBUS_LOGE("Failed to allocate memory for new message\n");
+        device_manager_count_dropped(msg->target);
         return SOFTBUS_ERROR;
     }
     memcpy(new_msg, msg, sizeof(message_t));
 
-    // 如果消息包含数据，复制数据
-    if (msg->data && msg->data_len > 0) {
+    // 如果消息包含数据，复制数据；带释放函数的数据（如共享映射）直接接管，不复制
+    if (msg->data && msg->data_len > 0 && msg->data_release) {
+        new_msg->data = msg->data;
+    } else if (msg->data && msg->data_len > 0) {
+        new_msg->data_release = NULL;
         new_msg->data = malloc(msg->data_len);
         if (!new_msg->data) {
-            printf("Failed to allocate memory for message data\n");
+            SOFTBUS_LOGE("Failed to allocate memory for message data\n");
             free(new_msg);
+            device_manager_count_dropped(msg->target);
             return SOFTBUS_ERROR;
         }
         memcpy(new_msg->data, msg->data, msg->data_len);
     } else {
         new_msg->data = NULL;
         new_msg->data_len = 0;
+        new_msg->data_release = NULL;
     }
 
     // 设置消息时间戳
     clock_gettime(CLOCK_REALTIME, &new_msg->timestamp);
+    if (new_msg->msg_id == 0) {
+        new_msg->msg_id = message_queue_next_id();
+    }
 
-    // 插入消息到设备的消息树中
-    int ret = insert_message(dev, new_msg);
+    // 插入后消息可能立即被其他线程取走，追踪点和抓包在插入前记录；
+    // 处理函数执行期间发出的消息记为正在处理的消息的响应
+    SOFTBUS_TRACE(TRACE_RESPONSE_ENQUEUE, SOFTBUS_TRACE_CURRENT(), msg->target);
+    SOFTBUS_TRACE(TRACE_ENQUEUE, new_msg->msg_id, msg->target);
+    if (softbus_capture_active()) {
+        softbus_capture_message(new_msg);
+    }
+
+    // 在目标设备的队列锁内插入，发送方可以在任意线程
+    int ret = device_manager_enqueue(msg->target, new_msg);
     if (ret != SOFTBUS_OK) {
-        printf("Failed to insert message into queue\n");
-        if (new_msg->data) {
+        if (ret == SOFTBUS_NOT_FOUND) {
+            SOFTBUS_LOGW("Target device not found: %s\n", msg->target);
+        } else {
+            SOFTBUS_LOGE("Failed to insert message into queue\n");
+        }
+        // 接管的数据在失败时仍归调用者所有
+        if (new_msg->data && !new_msg->data_release) {
             free(new_msg->data);
         }
         free(new_msg);
         return ret;
     }
 
-    printf("Message successfully queued for %s\n", msg->target);
+    SOFTBUS_LOGD("Message successfully queued for %s\n", msg->target);
 
-    // 查找并调用回调函数
+    // 在回调表锁内取回调，锁外调用
+    message_callback_t callback = NULL;
+    void* user_data = NULL;
+    SOFTBUS_LOCK(&g_callback_mutex);
     message_callback_info_t* callback_info = find_callback(msg->target);
-    if (callback_info && callback_info->callback) {
-        printf("Calling message callback for %s\n", msg->target);
-        callback_info->callback(msg->target, SOFTBUS_OK, callback_info->user_data);
+    if (callback_info) {
+        callback = callback_info->callback;
+        user_data = callback_info->user_data;
+    }
+    SOFTBUS_UNLOCK(&g_callback_mutex);
+    if (callback) {
+        SOFTBUS_LOGD("Calling message callback for %s\n", msg->target);
+        callback(msg->target, SOFTBUS_OK, user_data);
     }
 
     return SOFTBUS_OK;
@@ -104,23 +136,7 @@ int message_queue_peek(const char* target, message_t* msg) {
         return SOFTBUS_INVALID_ARG;
     }
 
-    // 查找目标设备
-    device_manager_t* dev = device_manager_find(target);
-    if (!dev) {
-        return SOFTBUS_NOT_FOUND;
-    }
-
-    // 获取第一个消息
-    struct rb_node* node = rb_first(&dev->msg_tree);
-    if (!node) {
-        return SOFTBUS_NOT_FOUND;
-    }
-
-    // 复制消息内容
-    message_t* first_msg = rb_entry(node, message_t, node);
-    memcpy(msg, first_msg, sizeof(message_t));
-
-    return SOFTBUS_OK;
+    return device_manager_peek(target, msg);
 }
 
 int message_queue_receive(const char* target, message_t* msg) {
@@ -128,58 +144,54 @@ int message_queue_receive(const char* target, message_t* msg) {
         return SOFTBUS_INVALID_ARG;
     }
 
-    printf("Receiving message for %s\n", target);
+    SOFTBUS_LOGD("Receiving message for %s\n", target);
 
-    // 查找目标设备
-    device_manager_t* dev = device_manager_find(target);
-    if (!dev) {
-        printf("Target device not found: %s\n", target);
-        return SOFTBUS_NOT_FOUND;
-    }
-
-    // 获取并移除第一个消息
-    struct rb_node* node = rb_first(&dev->msg_tree);
-    if (!node) {
-        printf("No messages in queue for %s\n", target);
+    // 在设备的队列锁内取出第一个消息
+    message_t* first_msg = NULL;
+    if (device_manager_dequeue(target, &first_msg) != SOFTBUS_OK) {
+        SOFTBUS_LOGD("No messages in queue for %s\n", target);
         return SOFTBUS_NOT_FOUND;
     }
 
     // 复制消息内容
-    message_t* first_msg = rb_entry(node, message_t, node);
     memcpy(msg, first_msg, sizeof(message_t));
 
-    // 如果消息包含数据，复制数据
-    if (first_msg->data && first_msg->data_len > 0) {
-        msg->data = malloc(first_msg->data_len);
-        if (!msg->data) {
-            printf("Failed to allocate memory for received message data\n");
-            return SOFTBUS_ERROR;
-        }
-        memcpy(msg->data, first_msg->data, first_msg->data_len);
-    } else {
+    // 数据所有权直接转交给调用者，由message_queue_release_data释放
+    if (!first_msg->data || first_msg->data_len == 0) {
         msg->data = NULL;
         msg->data_len = 0;
+        msg->data_release = NULL;
     }
 
-    printf("Retrieved message from queue: type=%d, content=%s\n", 
-           msg->type, msg->content);
+    SOFTBUS_LOGD("Retrieved message from queue: type=%d, content=%s\n", 
+                 msg->type, msg->content);
 
-    // 从树中移除消息
-    rb_erase(node, &dev->msg_tree);
-    if (first_msg->data) {
-        free(first_msg->data);
-    }
     free(first_msg);
+    SOFTBUS_TRACE(TRACE_DEQUEUE, msg->msg_id, target);
 
     return SOFTBUS_OK;
 }
 
+void message_queue_release_data(message_t* msg) {
+    if (!msg || !msg->data) {
+        return;
+    }
+    if (msg->data_release) {
+        msg->data_release(msg->data, msg->data_len);
+    } else {
+        free(msg->data);
+    }
+    msg->data = NULL;
+    msg->data_len = 0;
+    msg->data_release = NULL;
+}
+
 void message_queue_set_callback(const char* target, message_callback_t callback, void* user_data) {
     if (!target) {
         return;
     }
 
-    pthread_mutex_lock(&g_callback_mutex);
+    SOFTBUS_LOCK(&g_callback_mutex);
 
     // 查找现有回调
     message_callback_info_t* callback_info = find_callback(target);
@@ -196,7 +208,7 @@ void message_queue_set_callback(const char* target, message_callback_t callback,
         g_callback_count++;
     }
 
-    pthread_mutex_unlock(&g_callback_mutex);
+    SOFTBUS_UNLOCK(&g_callback_mutex);
 }
 
 void message_queue_remove_callback(const char* target) {
@@ -204,7 +216,7 @@ void message_queue_remove_callback(const char* target) {
         return;
     }
 
-    pthread_mutex_lock(&g_callback_mutex);
+    SOFTBUS_LOCK(&g_callback_mutex);
 
     // 查找回调
     int idx = -1;
@@ -223,10 +235,11 @@ void message_queue_remove_callback(const char* target) {
         g_callback_count--;
     }
 
-    pthread_mutex_unlock(&g_callback_mutex);
+    SOFTBUS_UNLOCK(&g_callback_mutex);
 }
 
 // 内部函数实现
+// 调用者持有g_callback_mutex
 static message_callback_info_t* find_callback(const char* target) {
     for (int i = 0; i < g_callback_count; i++) {
         if (strcmp(g_callbacks[i].target, target) == 0) {
@@ -236,35 +249,3 @@ static message_callback_info_t* find_callback(const char* target) {
     return NULL;
 }
 
-static int insert_message(device_manager_t* dev, message_t* msg) {
-    struct rb_node** p = &dev->msg_tree.rb_node;
-    struct rb_node* parent = NULL;
-    message_t* entry;
-
-    // 查找插入位置
-    while (*p) {
-        parent = *p;
-        entry = rb_entry(parent, message_t, node);
-
-        // 根据时间戳和优先级排序
-        if (msg->priority > entry->priority) {
-            p = &(*p)->rb_left;
-        } else if (msg->priority < entry->priority) {
-            p = &(*p)->rb_right;
-        } else {
-            if (msg->timestamp.tv_sec < entry->timestamp.tv_sec ||
-                (msg->timestamp.tv_sec == entry->timestamp.tv_sec &&
-                 msg->timestamp.tv_nsec < entry->timestamp.tv_nsec)) {
-                p = &(*p)->rb_left;
-            } else {
-                p = &(*p)->rb_right;
-            }
-        }
-    }
-
-    // 插入新节点
-    rb_link_node(&msg->node, parent, p);
-    rb_insert_color(&msg->node, &dev->msg_tree);
-
-    return SOFTBUS_OK;
-} 
\ No newline at end of file
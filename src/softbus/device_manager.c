@@ -2,53 +2,98 @@
 #include <string.h>
 #include <stdlib.h>
 #include <pthread.h>
+#include <time.h>
+#include <stdatomic.h>
 #include "device_manager.h"
 #include "softbus_types.h"
 #include "message_types.h"
 #include "message_queue.h"
-#include "rbtree.h"
+#include "prio_queue.h"
+#include "softbus_log.h"
+#include "softbus_lock.h"
+#include "softbus_cacheline.h"
+#include "softbus_bitset.h"
+#include "softbus_internal.h"
 
-#define MAX_DEVICES 32
+// 设备表按冷热拆分：
+// 查找索引按注册顺序紧凑排列，只扫描名称哈希（32个设备共两条缓存行），命中后才比较记录中的名称；
+// 收发路径每条消息都要访问的队列指针、队列锁、引用计数和状态放在按记录下标排列的热槽中，每个设备独占一条缓存行；
+// 冷数据是注册时传入的设备记录（名称、操作函数、私有数据、统计与看门狗），只在哈希命中后或分发时访问。
+// 冷记录仍是完整的device_manager_t：它是注册接口的公开结构体，分发时操作函数、私有数据和看门狗一起使用，
+// 再拆成按字段的数组不会减少命中后访问的缓存行。
+//
+// 生命周期：注册持有一个引用，device_manager_acquire各加一个。注销只把设备从查找索引中摘除并清除live，
+// 最后一个引用释放时才调用deinit、清空队列并回收下标，因此持有引用期间记录和下标不会被复用，
+// 处理函数中注销自己也不会释放正在使用的记录。
+//
+// 消息队列由发送方（应用线程、IO线程、共享内存接收线程）和处理线程并发访问，每个设备一把队列锁。
+// 加队列锁时先持有表锁，回收在表锁内加队列锁后才释放队列，因此持有队列锁期间队列不会被释放。
+// 锁顺序：表锁 -> 队列锁。
+typedef struct {
+    softbus_lock_t lock;  // 队列锁
+    prio_queue_t* queue;  // 注册时按queue_backend创建，回收时释放
+    atomic_int refs;
+    atomic_bool live;     // 在查找索引中；注销时清除
+} SOFTBUS_CACHE_ALIGNED device_slot_t;
 
-// 设备列表
 static struct {
-    device_manager_t devices[MAX_DEVICES];
+    uint32_t hash[MAX_DEVICES] SOFTBUS_CACHE_ALIGNED;  // 名称的FNV-1a哈希
+    uint16_t slot[MAX_DEVICES];                        // 对应的记录下标
     int count;
-    pthread_mutex_t mutex;
+    uint64_t used[SOFTBUS_BITSET_WORDS(MAX_DEVICES)];  // 记录占用位图，回收时才清除
+    softbus_lock_t mutex;
+    device_slot_t slots[MAX_DEVICES];                  // 与records同下标
+    device_manager_t records[MAX_DEVICES] SOFTBUS_CACHE_ALIGNED;
 } g_device_manager;
 
+// 内部函数声明
+static uint32_t name_hash(const char* name);
+static int find_locked(const char* device_name);
+static int lock_queue(const char* device_name);
+static void destroy_slot_locked(int slot);
+static uint64_t elapsed_since_ns(const struct timespec* ts);
+
 // 初始化设备管理器
 int device_manager_init(void) {
-    printf("Initializing device manager...\n");
+    SOFTBUS_LOGI("Initializing device manager...\n");
     memset(&g_device_manager, 0, sizeof(g_device_manager));
-    pthread_mutex_init(&g_device_manager.mutex, NULL);
+    softbus_lock_init(&g_device_manager.mutex, "device_manager");
+    for (int i = 0; i < MAX_DEVICES; i++) {
+        softbus_lock_init(&g_device_manager.slots[i].lock, "device_queue");
+    }
     return SOFTBUS_OK;
 }
 
 // 清理设备管理器
 void device_manager_deinit(void) {
-    printf("Cleaning up device manager...\n");
-    pthread_mutex_lock(&g_device_manager.mutex);
-    for (int i = 0; i < g_device_manager.count; i++) {
-        device_manager_t* device = &g_device_manager.devices[i];
-        printf("Cleaning up device: %s\n", device->name);
-        if (device->ops.deinit) {
-            device->ops.deinit(device->private_data);
-        }
-        // 清理消息树
-        struct rb_node* node;
-        while ((node = rb_first(&device->msg_tree)) != NULL) {
-            message_t* msg = rb_entry(node, message_t, node);
-            rb_erase(node, &device->msg_tree);
-            if (msg->data) {
-                free(msg->data);
-            }
-            free(msg);
-        }
+    SOFTBUS_LOGI("Cleaning up device manager...\n");
+    SOFTBUS_LOCK(&g_device_manager.mutex);
+    // 已注销但仍被引用的记录也在这里回收
+    SOFTBUS_BITSET_FOREACH(slot, g_device_manager.used, SOFTBUS_BITSET_WORDS(MAX_DEVICES)) {
+        SOFTBUS_LOGD("Cleaning up device: %s\n", g_device_manager.records[slot].name);
+        destroy_slot_locked(slot);
     }
     g_device_manager.count = 0;
-    pthread_mutex_unlock(&g_device_manager.mutex);
-    pthread_mutex_destroy(&g_device_manager.mutex);
+    SOFTBUS_UNLOCK(&g_device_manager.mutex);
+    for (int i = 0; i < MAX_DEVICES; i++) {
+        softbus_lock_destroy(&g_device_manager.slots[i].lock);
+    }
+    softbus_lock_destroy(&g_device_manager.mutex);
+}
+
+// 复制已注册设备的名称，返回复制的数量
+int device_manager_get_names(char names[][MAX_NAME_LENGTH], int max_count) {
+    if (!names || max_count <= 0) {
+        return 0;
+    }
+
+    SOFTBUS_LOCK(&g_device_manager.mutex);
+    int count = g_device_manager.count < max_count ? g_device_manager.count : max_count;
+    for (int i = 0; i < count; i++) {
+        memcpy(names[i], g_device_manager.records[g_device_manager.slot[i]].name, MAX_NAME_LENGTH);
+    }
+    SOFTBUS_UNLOCK(&g_device_manager.mutex);
+    return count;
 }
 
 // 注册设备
@@ -57,46 +102,83 @@ int device_manager_register(device_manager_t* device) {
         return SOFTBUS_INVALID_ARG;
     }
 
-    printf("Registering device: %s (type: %d)\n", device->name, device->type);
-    pthread_mutex_lock(&g_device_manager.mutex);
+    SOFTBUS_LOGI("Registering device: %s (type: %d)\n", device->name, device->type);
+    SOFTBUS_LOCK(&g_device_manager.mutex);
 
     // 检查设备是否已存在
-    for (int i = 0; i < g_device_manager.count; i++) {
-        if (strcmp(g_device_manager.devices[i].name, device->name) == 0) {
-            printf("Device already exists: %s\n", device->name);
-            pthread_mutex_unlock(&g_device_manager.mutex);
-            return SOFTBUS_ERROR;
-        }
+    if (find_locked(device->name) >= 0) {
+        SOFTBUS_LOGW("Device already exists: %s\n", device->name);
+        SOFTBUS_UNLOCK(&g_device_manager.mutex);
+        return SOFTBUS_ERROR;
     }
 
     // 检查是否达到最大设备数
     if (g_device_manager.count >= MAX_DEVICES) {
-        printf("Maximum device limit reached\n");
-        pthread_mutex_unlock(&g_device_manager.mutex);
+        SOFTBUS_LOGE("Maximum device limit reached\n");
+        SOFTBUS_UNLOCK(&g_device_manager.mutex);
         return SOFTBUS_ERROR;
     }
 
-    // 添加设备
-    device_manager_t* new_device = &g_device_manager.devices[g_device_manager.count];
+    // 添加设备：占用第一个空闲记录，初始化成功后再登记到热数组
+    int slot = 0;
+    while (g_device_manager.used[slot / SOFTBUS_BITSET_WORD_BITS] == ~0ULL) {
+        slot += SOFTBUS_BITSET_WORD_BITS;
+    }
+    slot += __builtin_ctzll(~g_device_manager.used[slot / SOFTBUS_BITSET_WORD_BITS]);
+    device_manager_t* new_device = &g_device_manager.records[slot];
+    device_slot_t* hot = &g_device_manager.slots[slot];
     memcpy(new_device, device, sizeof(device_manager_t));
+    new_device->name[MAX_NAME_LENGTH - 1] = '\0';
     
-    // 初始化消息树
-    new_device->msg_tree.rb_node = NULL;
+    // 创建消息队列
+    hot->queue = prio_queue_create(new_device->queue_backend);
+    if (!hot->queue) {
+        SOFTBUS_UNLOCK(&g_device_manager.mutex);
+        return SOFTBUS_NO_MEM;
+    }
+
+    new_device->metrics = device_metrics_create();
+    if (!new_device->metrics) {
+        prio_queue_destroy(hot->queue);
+        hot->queue = NULL;
+        SOFTBUS_UNLOCK(&g_device_manager.mutex);
+        return SOFTBUS_NO_MEM;
+    }
+    new_device->watchdog = watchdog_device_create(new_device->name, new_device->metrics);
+    if (!new_device->watchdog) {
+        device_metrics_destroy(new_device->metrics);
+        new_device->metrics = NULL;
+        prio_queue_destroy(hot->queue);
+        hot->queue = NULL;
+        SOFTBUS_UNLOCK(&g_device_manager.mutex);
+        return SOFTBUS_NO_MEM;
+    }
     
     // 如果有初始化函数，调用它
     if (new_device->ops.init) {
         int ret = new_device->ops.init(new_device->private_data);
         if (ret != SOFTBUS_OK) {
-            printf("Failed to initialize device: %s\n", device->name);
-            pthread_mutex_unlock(&g_device_manager.mutex);
+            SOFTBUS_LOGE("Failed to initialize device: %s\n", device->name);
+            watchdog_device_destroy(new_device->watchdog);
+            new_device->watchdog = NULL;
+            device_metrics_destroy(new_device->metrics);
+            new_device->metrics = NULL;
+            prio_queue_destroy(hot->queue);
+            hot->queue = NULL;
+            SOFTBUS_UNLOCK(&g_device_manager.mutex);
             return ret;
         }
     }
 
+    g_device_manager.hash[g_device_manager.count] = name_hash(new_device->name);
+    g_device_manager.slot[g_device_manager.count] = (uint16_t)slot;
+    softbus_bitset_set(g_device_manager.used, slot);
+    atomic_store_explicit(&hot->refs, 1, memory_order_relaxed);
+    atomic_store(&hot->live, true);
     g_device_manager.count++;
-    printf("Device registered successfully: %s\n", device->name);
+    SOFTBUS_LOGI("Device registered successfully: %s\n", device->name);
 
-    pthread_mutex_unlock(&g_device_manager.mutex);
+    SOFTBUS_UNLOCK(&g_device_manager.mutex);
     return SOFTBUS_OK;
 }
 
@@ -106,71 +188,335 @@ int device_manager_unregister(const char* device_name) {
         return SOFTBUS_INVALID_ARG;
     }
 
-    printf("Unregistering device: %s\n", device_name);
-    pthread_mutex_lock(&g_device_manager.mutex);
+    SOFTBUS_LOGI("Unregistering device: %s\n", device_name);
+    SOFTBUS_LOCK(&g_device_manager.mutex);
 
     // 查找设备
-    int idx = -1;
-    for (int i = 0; i < g_device_manager.count; i++) {
-        if (strcmp(g_device_manager.devices[i].name, device_name) == 0) {
-            idx = i;
-            break;
-        }
+    int idx = find_locked(device_name);
+    if (idx < 0) {
+        SOFTBUS_LOGW("Device not found: %s\n", device_name);
+        SOFTBUS_UNLOCK(&g_device_manager.mutex);
+        return SOFTBUS_NOT_FOUND;
+    }
+
+    // 从查找索引中摘除，索引前移填补空缺，保持注册顺序；记录在最后一个引用释放时回收
+    int slot = g_device_manager.slot[idx];
+    device_slot_t* hot = &g_device_manager.slots[slot];
+    atomic_store(&hot->live, false);
+    int tail = g_device_manager.count - idx - 1;
+    memmove(&g_device_manager.hash[idx], &g_device_manager.hash[idx + 1], (size_t)tail * sizeof(uint32_t));
+    memmove(&g_device_manager.slot[idx], &g_device_manager.slot[idx + 1], (size_t)tail * sizeof(uint16_t));
+    g_device_manager.count--;
+    if (atomic_fetch_sub_explicit(&hot->refs, 1, memory_order_acq_rel) == 1) {
+        destroy_slot_locked(slot);
+    }
+    SOFTBUS_LOGI("Device unregistered successfully: %s\n", device_name);
+    SOFTBUS_UNLOCK(&g_device_manager.mutex);
+    return SOFTBUS_OK;
+}
+
+// 查找设备并加一个引用
+device_manager_t* device_manager_acquire(const char* device_name) {
+    if (!device_name) {
+        return NULL;
+    }
+
+    SOFTBUS_LOCK(&g_device_manager.mutex);
+    int idx = find_locked(device_name);
+    device_manager_t* device = NULL;
+    if (idx >= 0) {
+        int slot = g_device_manager.slot[idx];
+        atomic_fetch_add_explicit(&g_device_manager.slots[slot].refs, 1, memory_order_relaxed);
+        device = &g_device_manager.records[slot];
+    }
+    SOFTBUS_UNLOCK(&g_device_manager.mutex);
+    if (!device) {
+        SOFTBUS_LOGD("Device not found: %s\n", device_name);
     }
+    return device;
+}
+
+// 释放引用，已注销设备的最后一个引用负责回收
+void device_manager_release(device_manager_t* device) {
+    if (!device) {
+        return;
+    }
+
+    int slot = (int)(device - g_device_manager.records);
+    if (atomic_fetch_sub_explicit(&g_device_manager.slots[slot].refs, 1, memory_order_acq_rel) == 1) {
+        SOFTBUS_LOCK(&g_device_manager.mutex);
+        destroy_slot_locked(slot);
+        SOFTBUS_UNLOCK(&g_device_manager.mutex);
+    }
+}
+
+// 记录下标，持有引用期间不变
+int device_manager_record_index(const device_manager_t* device) {
+    return device ? (int)(device - g_device_manager.records) : -1;
+}
 
-    if (idx == -1) {
-        printf("Device not found: %s\n", device_name);
-        pthread_mutex_unlock(&g_device_manager.mutex);
+// 设备是否仍在查找索引中
+bool device_manager_is_live(const device_manager_t* device) {
+    return device && atomic_load(&g_device_manager.slots[device - g_device_manager.records].live);
+}
+
+// 消息入队，成功后消息归队列所有
+int device_manager_enqueue(const char* device_name, message_t* msg) {
+    if (!device_name || !msg) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    int slot = lock_queue(device_name);
+    if (slot < 0) {
         return SOFTBUS_NOT_FOUND;
     }
+    device_slot_t* hot = &g_device_manager.slots[slot];
+    device_metrics_t* metrics = g_device_manager.records[slot].metrics;
+    int ret = prio_queue_push(hot->queue, msg);
+    if (ret == SOFTBUS_OK) {
+        device_metrics_enqueued(metrics, msg->data ? msg->data_len : strlen(msg->content) + 1);
+    } else {
+        device_metrics_dropped(metrics);
+    }
+    SOFTBUS_UNLOCK(&hot->lock);
+    return ret;
+}
 
-    // 调用设备清理函数
-    device_manager_t* device = &g_device_manager.devices[idx];
-    if (device->ops.deinit) {
-        device->ops.deinit(device->private_data);
+// 记一次未能入队的消息
+void device_manager_count_dropped(const char* device_name) {
+    if (!device_name) {
+        return;
     }
 
-    // 清理消息树
-    struct rb_node* node;
-    while ((node = rb_first(&device->msg_tree)) != NULL) {
-        message_t* msg = rb_entry(node, message_t, node);
-        rb_erase(node, &device->msg_tree);
-        if (msg->data) {
-            free(msg->data);
-        }
-        free(msg);
+    int slot = lock_queue(device_name);
+    if (slot >= 0) {
+        device_metrics_dropped(g_device_manager.records[slot].metrics);
+        SOFTBUS_UNLOCK(&g_device_manager.slots[slot].lock);
     }
+}
 
-    // 移动设备列表以填补空缺
-    for (int i = idx; i < g_device_manager.count - 1; i++) {
-        memcpy(&g_device_manager.devices[i], &g_device_manager.devices[i + 1], sizeof(device_manager_t));
+// 取出队头消息，由调用者释放
+int device_manager_dequeue(const char* device_name, message_t** msg) {
+    if (!device_name || !msg) {
+        return SOFTBUS_INVALID_ARG;
     }
 
-    g_device_manager.count--;
-    printf("Device unregistered successfully: %s\n", device_name);
-    pthread_mutex_unlock(&g_device_manager.mutex);
+    *msg = NULL;
+    int slot = lock_queue(device_name);
+    if (slot < 0) {
+        return SOFTBUS_NOT_FOUND;
+    }
+    device_slot_t* hot = &g_device_manager.slots[slot];
+    message_t* first = prio_queue_pop(hot->queue);
+    if (first) {
+        device_metrics_dequeued(g_device_manager.records[slot].metrics, elapsed_since_ns(&first->timestamp));
+    }
+    SOFTBUS_UNLOCK(&hot->lock);
+
+    *msg = first;
+    return first ? SOFTBUS_OK : SOFTBUS_NOT_FOUND;
+}
+
+// 复制队头消息，不移除
+int device_manager_peek(const char* device_name, message_t* msg) {
+    if (!device_name || !msg) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    int slot = lock_queue(device_name);
+    if (slot < 0) {
+        return SOFTBUS_NOT_FOUND;
+    }
+    message_t* first = prio_queue_peek(g_device_manager.slots[slot].queue);
+    if (first) {
+        memcpy(msg, first, sizeof(message_t));
+    }
+    SOFTBUS_UNLOCK(&g_device_manager.slots[slot].lock);
+    return first ? SOFTBUS_OK : SOFTBUS_NOT_FOUND;
+}
+
+// 按出队顺序复制前max条消息，返回数量
+int device_manager_snapshot(const char* device_name, message_t* msgs, int max) {
+    if (!device_name || !msgs || max <= 0) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    message_t** pending = malloc((size_t)max * sizeof(message_t*));
+    if (!pending) {
+        return SOFTBUS_NO_MEM;
+    }
+    int slot = lock_queue(device_name);
+    if (slot < 0) {
+        free(pending);
+        return SOFTBUS_NOT_FOUND;
+    }
+    int count = prio_queue_snapshot(g_device_manager.slots[slot].queue, pending, max);
+    for (int i = 0; i < count; i++) {
+        memcpy(&msgs[i], pending[i], sizeof(message_t));
+    }
+    SOFTBUS_UNLOCK(&g_device_manager.slots[slot].lock);
+    free(pending);
+    return count;
+}
+
+// 设备的记录下标，注册期间不变，可作为位集中的位号；未注册返回-1
+int device_manager_index(const char* device_name) {
+    if (!device_name) {
+        return -1;
+    }
+
+    SOFTBUS_LOCK(&g_device_manager.mutex);
+    int idx = find_locked(device_name);
+    int slot = idx >= 0 ? g_device_manager.slot[idx] : -1;
+    SOFTBUS_UNLOCK(&g_device_manager.mutex);
+    return slot;
+}
+
+// 复制记录下标对应设备的名称
+int device_manager_name_at(int index, char name[MAX_NAME_LENGTH]) {
+    if (index < 0 || index >= MAX_DEVICES || !name) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    SOFTBUS_LOCK(&g_device_manager.mutex);
+    if (!softbus_bitset_test(g_device_manager.used, index) || !atomic_load(&g_device_manager.slots[index].live)) {
+        SOFTBUS_UNLOCK(&g_device_manager.mutex);
+        return SOFTBUS_NOT_FOUND;
+    }
+    memcpy(name, g_device_manager.records[index].name, MAX_NAME_LENGTH);
+    SOFTBUS_UNLOCK(&g_device_manager.mutex);
     return SOFTBUS_OK;
 }
 
-// 查找设备
-device_manager_t* device_manager_find(const char* device_name) {
+// 检查设备是否已注册
+bool device_manager_is_device_registered(const char* device_name) {
     if (!device_name) {
-        return NULL;
+        return false;
+    }
+
+    SOFTBUS_LOCK(&g_device_manager.mutex);
+    bool registered = find_locked(device_name) >= 0;
+    SOFTBUS_UNLOCK(&g_device_manager.mutex);
+    return registered;
+} 
+
+// 复制设备的统计快照
+int device_manager_get_stats(const char* device_name, softbus_device_stats_t* stats) {
+    if (!device_name || !stats) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    SOFTBUS_LOCK(&g_device_manager.mutex);
+    int idx = find_locked(device_name);
+    if (idx < 0) {
+        SOFTBUS_UNLOCK(&g_device_manager.mutex);
+        return SOFTBUS_NOT_FOUND;
+    }
+    device_manager_t* device = &g_device_manager.records[g_device_manager.slot[idx]];
+    device_metrics_snapshot(device->metrics, stats);
+    SOFTBUS_UNLOCK(&g_device_manager.mutex);
+    return SOFTBUS_OK;
+}
+
+// 清零设备的统计，当前队列深度保留
+int device_manager_reset_stats(const char* device_name) {
+    if (!device_name) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    SOFTBUS_LOCK(&g_device_manager.mutex);
+    int idx = find_locked(device_name);
+    if (idx < 0) {
+        SOFTBUS_UNLOCK(&g_device_manager.mutex);
+        return SOFTBUS_NOT_FOUND;
+    }
+    device_manager_t* device = &g_device_manager.records[g_device_manager.slot[idx]];
+    device_metrics_reset(device->metrics);
+    SOFTBUS_UNLOCK(&g_device_manager.mutex);
+    return SOFTBUS_OK;
+}
+
+// 设置设备处理函数的单次预算（微秒）
+int device_manager_set_budget(const char* device_name, uint32_t wall_us, uint32_t cpu_us) {
+    if (!device_name) {
+        return SOFTBUS_INVALID_ARG;
     }
 
-    pthread_mutex_lock(&g_device_manager.mutex);
+    SOFTBUS_LOCK(&g_device_manager.mutex);
+    int idx = find_locked(device_name);
+    if (idx < 0) {
+        SOFTBUS_UNLOCK(&g_device_manager.mutex);
+        return SOFTBUS_NOT_FOUND;
+    }
+    device_manager_t* device = &g_device_manager.records[g_device_manager.slot[idx]];
+    watchdog_set_budget(device->watchdog, wall_us, cpu_us);
+    SOFTBUS_UNLOCK(&g_device_manager.mutex);
+    return SOFTBUS_OK;
+}
+
+// 内部函数实现
+static uint32_t name_hash(const char* name) {
+    uint32_t h = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        h = (h ^ *p) * 16777619u;
+    }
+    return h;
+}
+
+// 返回设备在热数组中的位置，未找到返回-1；调用者持有mutex
+static int find_locked(const char* device_name) {
+    uint32_t h = name_hash(device_name);
     for (int i = 0; i < g_device_manager.count; i++) {
-        if (strcmp(g_device_manager.devices[i].name, device_name) == 0) {
-            pthread_mutex_unlock(&g_device_manager.mutex);
-            return &g_device_manager.devices[i];
+        if (g_device_manager.hash[i] == h &&
+            strcmp(g_device_manager.records[g_device_manager.slot[i]].name, device_name) == 0) {
+            return i;
         }
     }
-    pthread_mutex_unlock(&g_device_manager.mutex);
-    printf("Device not found: %s\n", device_name);
-    return NULL;
+    return -1;
 }
 
-// 检查设备是否已注册
-bool device_manager_is_device_registered(const char* device_name) {
-    return device_manager_find(device_name) != NULL;
-} 
\ No newline at end of file
+// 查找设备并加它的队列锁，返回记录下标，未找到返回-1
+static int lock_queue(const char* device_name) {
+    SOFTBUS_LOCK(&g_device_manager.mutex);
+    int idx = find_locked(device_name);
+    int slot = idx >= 0 ? g_device_manager.slot[idx] : -1;
+    if (slot >= 0) {
+        SOFTBUS_LOCK(&g_device_manager.slots[slot].lock);
+    }
+    SOFTBUS_UNLOCK(&g_device_manager.mutex);
+    return slot;
+}
+
+// 回收记录：调用deinit，等正在入队/出队的线程退出队列锁后清空队列，释放下标；调用者持有mutex
+static void destroy_slot_locked(int slot) {
+    device_manager_t* device = &g_device_manager.records[slot];
+    device_slot_t* hot = &g_device_manager.slots[slot];
+    if (device->ops.deinit) {
+        device->ops.deinit(device->private_data);
+    }
+
+    SOFTBUS_LOCK(&hot->lock);
+    message_t* msg;
+    while ((msg = prio_queue_pop(hot->queue)) != NULL) {
+        message_queue_release_data(msg);
+        free(msg);
+    }
+    prio_queue_destroy(hot->queue);
+    hot->queue = NULL;
+    SOFTBUS_UNLOCK(&hot->lock);
+    watchdog_device_destroy(device->watchdog);
+    device_metrics_destroy(device->metrics);
+
+    memset(device, 0, sizeof(device_manager_t));
+    atomic_store_explicit(&hot->refs, 0, memory_order_relaxed);
+    atomic_store(&hot->live, false);
+    softbus_bitset_clear(g_device_manager.used, slot);
+}
+
+// 距离给定时间戳（CLOCK_REALTIME）经过的纳秒数，时钟回拨时返回0
+static uint64_t elapsed_since_ns(const struct timespec* ts) {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    int64_t ns = (int64_t)(now.tv_sec - ts->tv_sec) * 1000000000LL + (now.tv_nsec - ts->tv_nsec);
+    return ns > 0 ? (uint64_t)ns : 0;
+}
@@ -0,0 +1,793 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "group_manager.h"
+#include "device_manager.h"
+#include "softbus_log.h"
+#include "softbus_socket.h"
+
+#define GROUP_HASH_BUCKETS (MAX_GROUPS * 2)
+
+// 组表
+static struct {
+    device_group_t groups[MAX_GROUPS];          // 位置固定，删除后复用
+    _Atomic int buckets[GROUP_HASH_BUCKETS];    // 按名称哈希的链头，-1为空；发送方无锁读取
+    uint64_t used[GROUP_SET_WORDS];
+    int count;
+    softbus_lock_t mutex;                       // 保护buckets、used、count、各组的name/hash/next和组间包含关系
+    // 反向索引：每个设备所在的组，按组下标置位；按字原子更新，不需要组表锁
+    _Atomic uint64_t device_groups[MAX_DEVICES][GROUP_SET_WORDS];
+} g_group_manager = {
+    .mutex = SOFTBUS_LOCK_INITIALIZER("groups"),
+};
+
+// 内部函数声明
+static uint32_t group_name_hash(const char* name);
+static int find_locked(const char* group_name, uint32_t hash);
+static device_group_t* find_group(const char* group_name);
+static device_group_t* lock_group(const char* group_name);
+static bool reaches_locked(int from, int target);
+static int link_groups_locked(int parent, int child, bool link, uint64_t* ancestors);
+static group_snapshot_t* build_snapshot(device_group_t* group, const group_snapshot_t* prev);
+static bool snapshot_equal(const group_snapshot_t* a, const group_snapshot_t* b);
+static int publish_snapshot(device_group_t* group, bool* changed);
+static int publish_and_unlock(device_group_t* group);
+static void refresh_ancestors(const uint64_t* parents);
+static void replace_snapshot(device_group_t* group, group_snapshot_t* snapshot);
+static void reclaim_retired(device_group_t* group, bool force);
+static group_snapshot_t* acquire_snapshot(device_group_t* group);
+static int find_remote(const device_group_t* group, const char* device_name);
+static void remove_remote(device_group_t* group, int idx);
+static void set_local(device_group_t* group, int device_index);
+static void clear_local(device_group_t* group, int device_index);
+static void update_multicast(const char* group_name, int local_before, int local_after);
+
+int group_manager_init(void) {
+    memset(&g_group_manager, 0, sizeof(g_group_manager));
+    if (softbus_lock_init(&g_group_manager.mutex, "groups") != 0) {
+        return SOFTBUS_ERROR;
+    }
+    for (int i = 0; i < GROUP_HASH_BUCKETS; i++) {
+        atomic_init(&g_group_manager.buckets[i], -1);
+    }
+    for (int i = 0; i < MAX_GROUPS; i++) {
+        device_group_t* group = &g_group_manager.groups[i];
+        group->index = i;
+        atomic_init(&group->next, -1);
+        atomic_init(&group->snapshot, NULL);
+        atomic_init(&group->readers, 0);
+        softbus_lock_init(&group->mutex, "group");
+    }
+    return SOFTBUS_OK;
+}
+
+void group_manager_deinit(void) {
+    SOFTBUS_LOCK(&g_group_manager.mutex);
+    // 调用者保证此时没有发送方仍持有快照
+    for (int i = 0; i < MAX_GROUPS; i++) {
+        device_group_t* group = &g_group_manager.groups[i];
+        group->in_use = false;
+        replace_snapshot(group, NULL);
+        reclaim_retired(group, true);
+        softbus_lock_destroy(&group->mutex);
+    }
+    g_group_manager.count = 0;
+    memset(g_group_manager.used, 0, sizeof(g_group_manager.used));
+    SOFTBUS_UNLOCK(&g_group_manager.mutex);
+    softbus_lock_destroy(&g_group_manager.mutex);
+}
+
+int group_manager_create(const char* group_name) {
+    if (!group_name) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    uint32_t hash = group_name_hash(group_name);
+    SOFTBUS_LOCK(&g_group_manager.mutex);
+
+    if (g_group_manager.count >= MAX_GROUPS || find_locked(group_name, hash) >= 0) {
+        SOFTBUS_UNLOCK(&g_group_manager.mutex);
+        return SOFTBUS_ERROR;
+    }
+
+    int idx = 0;
+    while (g_group_manager.used[idx / SOFTBUS_BITSET_WORD_BITS] == ~0ULL) {
+        idx += SOFTBUS_BITSET_WORD_BITS;
+    }
+    idx += __builtin_ctzll(~g_group_manager.used[idx / SOFTBUS_BITSET_WORD_BITS]);
+
+    device_group_t* group = &g_group_manager.groups[idx];
+    SOFTBUS_LOCK(&group->mutex);
+    strncpy(group->name, group_name, MAX_NAME_LENGTH - 1);
+    group->name[MAX_NAME_LENGTH - 1] = '\0';
+    group->hash = hash;
+    memset(group->local, 0, sizeof(group->local));
+    memset(group->children, 0, sizeof(group->children));
+    memset(group->parents, 0, sizeof(group->parents));
+    group->member_count = 0;
+    group->stale = false;
+    // 先发布快照再挂入哈希链，无锁查找到该组时快照已就绪
+    bool changed;
+    int ret = publish_snapshot(group, &changed);
+    group->in_use = ret == SOFTBUS_OK;
+    SOFTBUS_UNLOCK(&group->mutex);
+    if (ret != SOFTBUS_OK) {
+        SOFTBUS_UNLOCK(&g_group_manager.mutex);
+        return ret;
+    }
+
+    int bucket = (int)(hash % GROUP_HASH_BUCKETS);
+    atomic_store_explicit(&group->next, atomic_load_explicit(&g_group_manager.buckets[bucket], memory_order_relaxed),
+                          memory_order_relaxed);
+    atomic_store_explicit(&g_group_manager.buckets[bucket], idx, memory_order_release);
+    softbus_bitset_set(g_group_manager.used, idx);
+    g_group_manager.count++;
+
+    SOFTBUS_UNLOCK(&g_group_manager.mutex);
+    return SOFTBUS_OK;
+}
+
+int group_manager_delete(const char* group_name) {
+    if (!group_name) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    uint32_t hash = group_name_hash(group_name);
+    SOFTBUS_LOCK(&g_group_manager.mutex);
+
+    int idx = find_locked(group_name, hash);
+    if (idx < 0) {
+        SOFTBUS_UNLOCK(&g_group_manager.mutex);
+        return SOFTBUS_NOT_FOUND;
+    }
+
+    // 从哈希链中摘除
+    // 被摘除组的next保持不变，正在遍历的无锁查找仍能走完原来的链
+    _Atomic int* link = &g_group_manager.buckets[hash % GROUP_HASH_BUCKETS];
+    while (atomic_load_explicit(link, memory_order_relaxed) != idx) {
+        link = &g_group_manager.groups[atomic_load_explicit(link, memory_order_relaxed)].next;
+    }
+    device_group_t* group = &g_group_manager.groups[idx];
+    atomic_store_explicit(link, atomic_load_explicit(&group->next, memory_order_relaxed), memory_order_release);
+
+    // 先从父组中移除，父组展开结果变化时沿父组链向上更新；再断开与子组的包含关系
+    uint64_t children[GROUP_SET_WORDS];
+    uint64_t parents[GROUP_SET_WORDS];
+    uint64_t ancestors[GROUP_SET_WORDS] = {0};
+    memcpy(children, group->children, sizeof(children));
+    memcpy(parents, group->parents, sizeof(parents));
+    SOFTBUS_BITSET_FOREACH(parent, parents, GROUP_SET_WORDS) {
+        link_groups_locked(parent, idx, false, ancestors);
+    }
+    SOFTBUS_BITSET_FOREACH(child, children, GROUP_SET_WORDS) {
+        link_groups_locked(idx, child, false, ancestors);
+    }
+
+    // 清除成员的反向索引后才释放下标，下标复用时不会带着旧的成员关系
+    SOFTBUS_LOCK(&group->mutex);
+    group->in_use = false;
+    SOFTBUS_BITSET_FOREACH(dev, group->local, DEVICE_SET_WORDS) {
+        atomic_fetch_and_explicit(&g_group_manager.device_groups[dev][idx / SOFTBUS_BITSET_WORD_BITS],
+                                  ~(1ULL << (idx % SOFTBUS_BITSET_WORD_BITS)), memory_order_relaxed);
+    }
+    memset(group->local, 0, sizeof(group->local));
+    group->member_count = 0;
+    const group_snapshot_t* old = atomic_load_explicit(&group->snapshot, memory_order_relaxed);
+    update_multicast(group->name, old ? old->local_count : 0, 0);
+    replace_snapshot(group, NULL);
+    SOFTBUS_UNLOCK(&group->mutex);
+
+    softbus_bitset_clear(g_group_manager.used, idx);
+    g_group_manager.count--;
+    SOFTBUS_UNLOCK(&g_group_manager.mutex);
+
+    refresh_ancestors(ancestors);
+    return SOFTBUS_OK;
+}
+
+int group_manager_add_device(const char* group_name, const char* device_name) {
+    if (!group_name || !device_name) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    // 持有引用期间设备的记录下标不会被复用
+    device_manager_t* device = device_manager_acquire(device_name);
+    if (!device) {
+        return SOFTBUS_NOT_FOUND;
+    }
+    int dev = device_manager_record_index(device);
+
+    device_group_t* group = lock_group(group_name);
+    if (!group) {
+        device_manager_release(device);
+        return SOFTBUS_NOT_FOUND;
+    }
+
+    int remote_idx = find_remote(group, device_name);
+    if (remote_idx >= 0) {
+        remove_remote(group, remote_idx);
+    }
+    set_local(group, dev);
+    // 注销先清除live再取走反向索引（group_manager_device_removed）：
+    // 此处置位在前、检查在后，两者至少有一方看到对方，已注销时撤销刚加入的成员
+    atomic_thread_fence(memory_order_seq_cst);
+    int ret = SOFTBUS_OK;
+    if (!device_manager_is_live(device)) {
+        clear_local(group, dev);
+        ret = SOFTBUS_NOT_FOUND;
+    }
+    int published = publish_and_unlock(group);
+    device_manager_release(device);
+    return ret == SOFTBUS_OK ? published : ret;
+}
+
+int group_manager_add_remote(const char* group_name, const char* device_name, const softbus_node_addr_t* node) {
+    if (!group_name || !device_name || !node) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    device_manager_t* device = device_manager_acquire(device_name);
+    int dev = device_manager_record_index(device);
+    device_group_t* group = lock_group(group_name);
+    if (!group) {
+        device_manager_release(device);
+        return SOFTBUS_NOT_FOUND;
+    }
+
+    int remote_idx = find_remote(group, device_name);
+    if (remote_idx < 0) {
+        // 检查组是否已满
+        if (group->member_count >= MAX_GROUP_MEMBERS) {
+            SOFTBUS_UNLOCK(&group->mutex);
+            device_manager_release(device);
+            return SOFTBUS_ERROR;
+        }
+        remote_idx = group->member_count++;
+        strncpy(group->members[remote_idx], device_name, MAX_NAME_LENGTH - 1);
+        group->members[remote_idx][MAX_NAME_LENGTH - 1] = '\0';
+    }
+    group->member_nodes[remote_idx] = *node;
+
+    if (dev >= 0 && softbus_bitset_test(group->local, dev)) {
+        clear_local(group, dev);
+    }
+    int ret = publish_and_unlock(group);
+    device_manager_release(device);
+    return ret;
+}
+
+int group_manager_remove_device(const char* group_name, const char* device_name) {
+    if (!group_name || !device_name) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    // 持有引用，避免清掉复用同一下标的新设备的成员位
+    device_manager_t* device = device_manager_acquire(device_name);
+    int dev = device_manager_record_index(device);
+    device_group_t* group = lock_group(group_name);
+    if (!group) {
+        device_manager_release(device);
+        return SOFTBUS_NOT_FOUND;
+    }
+
+    // 先按本地成员查找，再查远端成员
+    int ret;
+    if (dev >= 0 && softbus_bitset_test(group->local, dev)) {
+        clear_local(group, dev);
+        ret = publish_and_unlock(group);
+    } else {
+        int remote_idx = find_remote(group, device_name);
+        if (remote_idx < 0) {
+            SOFTBUS_UNLOCK(&group->mutex);
+            device_manager_release(device);
+            return SOFTBUS_NOT_FOUND;
+        }
+        remove_remote(group, remote_idx);
+        ret = publish_and_unlock(group);
+    }
+    device_manager_release(device);
+    return ret;
+}
+
+int group_manager_add_group(const char* parent_name, const char* child_name) {
+    if (!parent_name || !child_name) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    SOFTBUS_LOCK(&g_group_manager.mutex);
+    int parent = find_locked(parent_name, group_name_hash(parent_name));
+    int child = find_locked(child_name, group_name_hash(child_name));
+    if (parent < 0 || child < 0) {
+        SOFTBUS_UNLOCK(&g_group_manager.mutex);
+        return SOFTBUS_NOT_FOUND;
+    }
+    // 子组能到达父组时再加这条边就成环
+    if (parent == child || reaches_locked(child, parent)) {
+        SOFTBUS_UNLOCK(&g_group_manager.mutex);
+        SOFTBUS_LOGE("Adding group %s to %s would create a cycle\n", child_name, parent_name);
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    uint64_t ancestors[GROUP_SET_WORDS] = {0};
+    int ret = link_groups_locked(parent, child, true, ancestors);
+    SOFTBUS_UNLOCK(&g_group_manager.mutex);
+
+    refresh_ancestors(ancestors);
+    return ret;
+}
+
+int group_manager_remove_group(const char* parent_name, const char* child_name) {
+    if (!parent_name || !child_name) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    SOFTBUS_LOCK(&g_group_manager.mutex);
+    int parent = find_locked(parent_name, group_name_hash(parent_name));
+    int child = find_locked(child_name, group_name_hash(child_name));
+    if (parent < 0 || child < 0 || !softbus_bitset_test(g_group_manager.groups[parent].children, child)) {
+        SOFTBUS_UNLOCK(&g_group_manager.mutex);
+        return SOFTBUS_NOT_FOUND;
+    }
+
+    uint64_t ancestors[GROUP_SET_WORDS] = {0};
+    int ret = link_groups_locked(parent, child, false, ancestors);
+    SOFTBUS_UNLOCK(&g_group_manager.mutex);
+
+    refresh_ancestors(ancestors);
+    return ret;
+}
+
+void group_manager_device_removed(int device_index) {
+    if (device_index < 0 || device_index >= MAX_DEVICES) {
+        return;
+    }
+
+    // 一次取走该设备的全部反向索引，只访问它直接所在的组，包含这些组的父组随后逐层更新。
+    // 调用者已注销设备（清除live）并持有引用；与group_manager_add_device的置位后检查配对，用seq_cst
+    uint64_t groups[GROUP_SET_WORDS];
+    for (int w = 0; w < GROUP_SET_WORDS; w++) {
+        groups[w] = atomic_exchange_explicit(&g_group_manager.device_groups[device_index][w], 0,
+                                             memory_order_seq_cst);
+    }
+
+    SOFTBUS_BITSET_FOREACH(idx, groups, GROUP_SET_WORDS) {
+        device_group_t* group = &g_group_manager.groups[idx];
+        SOFTBUS_LOCK(&group->mutex);
+        if (group->in_use && softbus_bitset_test(group->local, device_index)) {
+            softbus_bitset_clear(group->local, device_index);
+            publish_and_unlock(group);
+        } else {
+            SOFTBUS_UNLOCK(&group->mutex);
+        }
+    }
+}
+
+bool group_manager_exists(const char* group_name) {
+    const group_snapshot_t* snapshot = group_manager_acquire(group_name);
+    group_manager_release(snapshot);
+    return snapshot != NULL;
+}
+
+const group_snapshot_t* group_manager_acquire(const char* group_name) {
+    if (!group_name) {
+        return NULL;
+    }
+
+    // 无锁沿哈希链查找，名称以快照中的为准；遍历中途遇到组被删除或复用可能走到别的链，
+    // 步数以组数为上限
+    uint32_t hash = group_name_hash(group_name);
+    int steps = MAX_GROUPS;
+    for (int idx = atomic_load_explicit(&g_group_manager.buckets[hash % GROUP_HASH_BUCKETS], memory_order_acquire);
+         idx >= 0 && steps-- > 0; idx = atomic_load_explicit(&g_group_manager.groups[idx].next, memory_order_acquire)) {
+        group_snapshot_t* snapshot = acquire_snapshot(&g_group_manager.groups[idx]);
+        if (snapshot && snapshot->hash == hash && strcmp(snapshot->name, group_name) == 0) {
+            return snapshot;
+        }
+        group_manager_release(snapshot);
+    }
+
+    // 未命中时加组表锁再查一次，只有组不存在或与删除、创建并发时才走到这里
+    SOFTBUS_LOCK(&g_group_manager.mutex);
+    int idx = find_locked(group_name, hash);
+    group_snapshot_t* snapshot = idx >= 0 ? acquire_snapshot(&g_group_manager.groups[idx]) : NULL;
+    SOFTBUS_UNLOCK(&g_group_manager.mutex);
+    return snapshot;
+}
+
+void group_manager_release(const group_snapshot_t* snapshot) {
+    if (!snapshot) {
+        return;
+    }
+    group_snapshot_t* s = (group_snapshot_t*)snapshot;
+    if (atomic_fetch_sub_explicit(&s->refs, 1, memory_order_acq_rel) == 1) {
+        free(s);
+    }
+}
+
+int group_manager_get_names(char names[][MAX_NAME_LENGTH], int max_count) {
+    if (!names || max_count <= 0) {
+        return 0;
+    }
+
+    int count = 0;
+    SOFTBUS_LOCK(&g_group_manager.mutex);
+    SOFTBUS_BITSET_FOREACH(idx, g_group_manager.used, GROUP_SET_WORDS) {
+        if (count >= max_count) {
+            break;
+        }
+        memcpy(names[count++], g_group_manager.groups[idx].name, MAX_NAME_LENGTH);
+    }
+    SOFTBUS_UNLOCK(&g_group_manager.mutex);
+    return count;
+}
+
+// 内部函数实现
+static uint32_t group_name_hash(const char* name) {
+    uint32_t h = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        h = (h ^ *p) * 16777619u;
+    }
+    return h;
+}
+
+// 调用者持有组表锁
+static int find_locked(const char* group_name, uint32_t hash) {
+    for (int idx = atomic_load_explicit(&g_group_manager.buckets[hash % GROUP_HASH_BUCKETS], memory_order_relaxed);
+         idx >= 0; idx = atomic_load_explicit(&g_group_manager.groups[idx].next, memory_order_relaxed)) {
+        const device_group_t* group = &g_group_manager.groups[idx];
+        if (group->hash == hash && strcmp(group->name, group_name) == 0) {
+            return idx;
+        }
+    }
+    return -1;
+}
+
+// 返回的组结构一直有效，读取成员字段需持有其mutex并检查in_use
+static device_group_t* find_group(const char* group_name) {
+    SOFTBUS_LOCK(&g_group_manager.mutex);
+    int idx = find_locked(group_name, group_name_hash(group_name));
+    SOFTBUS_UNLOCK(&g_group_manager.mutex);
+    return idx >= 0 ? &g_group_manager.groups[idx] : NULL;
+}
+
+// 查找并锁定组；组表锁只在查找期间持有，加组锁后再确认该组未被删除或复用
+static device_group_t* lock_group(const char* group_name) {
+    device_group_t* group = find_group(group_name);
+    if (!group) {
+        return NULL;
+    }
+    SOFTBUS_LOCK(&group->mutex);
+    if (!group->in_use || strcmp(group->name, group_name) != 0) {
+        SOFTBUS_UNLOCK(&group->mutex);
+        return NULL;
+    }
+    return group;
+}
+
+// 调用者持有组表锁。按层展开子组位集，判断from能否经包含关系到达target
+static bool reaches_locked(int from, int target) {
+    uint64_t seen[GROUP_SET_WORDS] = {0};
+    uint64_t frontier[GROUP_SET_WORDS];
+    memcpy(frontier, g_group_manager.groups[from].children, sizeof(frontier));
+    while (!softbus_bitset_empty(frontier, GROUP_SET_WORDS)) {
+        if (softbus_bitset_test(frontier, target)) {
+            return true;
+        }
+        softbus_bitset_or(seen, frontier, GROUP_SET_WORDS);
+        uint64_t next[GROUP_SET_WORDS] = {0};
+        SOFTBUS_BITSET_FOREACH(idx, frontier, GROUP_SET_WORDS) {
+            softbus_bitset_or(next, g_group_manager.groups[idx].children, GROUP_SET_WORDS);
+        }
+        softbus_bitset_andnot(next, seen, GROUP_SET_WORDS);
+        memcpy(frontier, next, sizeof(frontier));
+    }
+    return false;
+}
+
+// 调用者持有组表锁。建立或断开parent包含child的关系并重新生成parent的快照，
+// parent展开结果变化时把它的父组并入ancestors，由调用者释放组表锁后逐层更新
+static int link_groups_locked(int parent, int child, bool link, uint64_t* ancestors) {
+    device_group_t* p = &g_group_manager.groups[parent];
+    device_group_t* c = &g_group_manager.groups[child];
+
+    SOFTBUS_LOCK(&c->mutex);
+    if (link) {
+        softbus_bitset_set(c->parents, parent);
+    } else {
+        softbus_bitset_clear(c->parents, parent);
+    }
+    SOFTBUS_UNLOCK(&c->mutex);
+
+    SOFTBUS_LOCK(&p->mutex);
+    if (link) {
+        softbus_bitset_set(p->children, child);
+    } else {
+        softbus_bitset_clear(p->children, child);
+    }
+    int ret = SOFTBUS_OK;
+    if (p->in_use) {
+        bool changed;
+        ret = publish_snapshot(p, &changed);
+        if (changed) {
+            softbus_bitset_or(ancestors, p->parents, GROUP_SET_WORDS);
+        }
+    }
+    SOFTBUS_UNLOCK(&p->mutex);
+    return ret;
+}
+
+// 按组的当前成员生成快照，整块分配：头部之后依次是远端节点、本地下标、本地名称、远端名称、远端所属组。
+// 本地成员是直接成员与各子组快照的并集，名称优先从上一份快照和子组快照中按下标归并取得，
+// 只有新加入的成员才查设备表；远端成员按名称去重，直接成员优先
+static group_snapshot_t* build_snapshot(device_group_t* group, const group_snapshot_t* prev) {
+    int child_count = softbus_bitset_count(group->children, GROUP_SET_WORDS);
+    const group_snapshot_t** kids = NULL;
+    int* cursors = NULL;
+    if (child_count > 0) {
+        kids = malloc((size_t)child_count * (sizeof(*kids) + sizeof(int)));
+        if (!kids) {
+            return NULL;
+        }
+        cursors = (int*)(kids + child_count);
+    }
+
+    // 子组快照无锁取得，不需要子组锁
+    uint64_t flat[DEVICE_SET_WORDS];
+    memcpy(flat, group->local, sizeof(flat));
+    int remote_max = group->member_count;
+    int kid_count = 0;
+    SOFTBUS_BITSET_FOREACH(idx, group->children, GROUP_SET_WORDS) {
+        const group_snapshot_t* kid = acquire_snapshot(&g_group_manager.groups[idx]);
+        if (!kid) {
+            continue;
+        }
+        softbus_bitset_or(flat, kid->local, DEVICE_SET_WORDS);
+        remote_max += kid->remote_count;
+        cursors[kid_count] = 0;
+        kids[kid_count++] = kid;
+    }
+
+    int local_max = softbus_bitset_count(flat, DEVICE_SET_WORDS);
+    size_t size = sizeof(group_snapshot_t) + (size_t)remote_max * sizeof(softbus_node_addr_t) +
+                  (size_t)local_max * (sizeof(int) + MAX_NAME_LENGTH) + (size_t)remote_max * MAX_NAME_LENGTH * 2;
+    group_snapshot_t* snapshot = malloc(size);
+    if (!snapshot) {
+        for (int k = 0; k < kid_count; k++) {
+            group_manager_release(kids[k]);
+        }
+        free(kids);
+        return NULL;
+    }
+
+    softbus_node_addr_t* nodes = (softbus_node_addr_t*)(snapshot + 1);
+    int* local_index = (int*)(nodes + remote_max);
+    char (*local_names)[MAX_NAME_LENGTH] = (char (*)[MAX_NAME_LENGTH])(local_index + local_max);
+    char (*remote)[MAX_NAME_LENGTH] = local_names + local_max;
+    char (*remote_group)[MAX_NAME_LENGTH] = remote + remote_max;
+
+    atomic_init(&snapshot->refs, 1);
+    snapshot->version = 0;
+    snapshot->hash = group->hash;
+    memcpy(snapshot->name, group->name, MAX_NAME_LENGTH);
+    memset(snapshot->local, 0, sizeof(snapshot->local));
+
+    int n = 0;
+    int j = 0;
+    SOFTBUS_BITSET_FOREACH(idx, flat, DEVICE_SET_WORDS) {
+        const char* name = NULL;
+        while (prev && j < prev->local_count && prev->local_index[j] < idx) {
+            j++;
+        }
+        if (prev && j < prev->local_count && prev->local_index[j] == idx) {
+            name = prev->local_names[j];
+        }
+        for (int k = 0; k < kid_count; k++) {
+            while (cursors[k] < kids[k]->local_count && kids[k]->local_index[cursors[k]] < idx) {
+                cursors[k]++;
+            }
+            if (!name && cursors[k] < kids[k]->local_count && kids[k]->local_index[cursors[k]] == idx) {
+                name = kids[k]->local_names[cursors[k]];
+            }
+        }
+        if (name) {
+            memcpy(local_names[n], name, MAX_NAME_LENGTH);
+        } else if (device_manager_name_at(idx, local_names[n]) != SOFTBUS_OK) {
+            continue;  // 正在注销，随后的device_removed会再生成快照
+        }
+        local_index[n++] = idx;
+        softbus_bitset_set(snapshot->local, idx);
+    }
+    snapshot->local_count = n;
+    snapshot->local_index = local_index;
+    snapshot->local_names = (const char (*)[MAX_NAME_LENGTH])local_names;
+
+    int remote_count = group->member_count;
+    memcpy(nodes, group->member_nodes, (size_t)remote_count * sizeof(softbus_node_addr_t));
+    memcpy(remote, group->members, (size_t)remote_count * MAX_NAME_LENGTH);
+    for (int i = 0; i < remote_count; i++) {
+        memcpy(remote_group[i], group->name, MAX_NAME_LENGTH);
+    }
+    bool nested = false;
+    for (int k = 0; k < kid_count; k++) {
+        for (int i = 0; i < kids[k]->remote_count; i++) {
+            bool seen = false;
+            for (int m = 0; m < remote_count && !seen; m++) {
+                seen = strcmp(remote[m], kids[k]->remote[i]) == 0;
+            }
+            if (seen) {
+                continue;
+            }
+            nodes[remote_count] = kids[k]->remote_nodes[i];
+            memcpy(remote[remote_count], kids[k]->remote[i], MAX_NAME_LENGTH);
+            memcpy(remote_group[remote_count], kids[k]->remote_group[i], MAX_NAME_LENGTH);
+            remote_count++;
+            nested = true;
+        }
+        group_manager_release(kids[k]);
+    }
+    free(kids);
+
+    int node_count = 0;
+    for (int i = 0; i < remote_count; i++) {
+        bool seen = false;
+        for (int k = 0; k < i && !seen; k++) {
+            seen = nodes[k].addr == nodes[i].addr && nodes[k].port == nodes[i].port;
+        }
+        node_count += !seen;
+    }
+    snapshot->remote_count = remote_count;
+    snapshot->remote_node_count = node_count;
+    snapshot->remote = (const char (*)[MAX_NAME_LENGTH])remote;
+    snapshot->remote_nodes = nodes;
+    snapshot->remote_group = (const char (*)[MAX_NAME_LENGTH])remote_group;
+    snapshot->remote_nested = nested;
+    snapshot->retired_next = NULL;
+    return snapshot;
+}
+
+static bool snapshot_equal(const group_snapshot_t* a, const group_snapshot_t* b) {
+    if (a->local_count != b->local_count || a->remote_count != b->remote_count ||
+        memcmp(a->local, b->local, sizeof(a->local)) != 0) {
+        return false;
+    }
+    size_t remote_count = (size_t)a->remote_count;
+    return memcmp(a->remote_nodes, b->remote_nodes, remote_count * sizeof(softbus_node_addr_t)) == 0 &&
+           memcmp(a->remote, b->remote, remote_count * MAX_NAME_LENGTH) == 0 &&
+           memcmp(a->remote_group, b->remote_group, remote_count * MAX_NAME_LENGTH) == 0;
+}
+
+// 调用者持有组锁。展开结果与当前快照相同时不替换，changed为false，父组也不必更新。
+// 分配失败时保留旧快照，发送方暂时看到变化前的成员，下次变化时全部重新解析
+static int publish_snapshot(device_group_t* group, bool* changed) {
+    *changed = false;
+    const group_snapshot_t* old = atomic_load_explicit(&group->snapshot, memory_order_relaxed);
+    group_snapshot_t* snapshot = build_snapshot(group, group->stale ? NULL : old);
+    if (!snapshot) {
+        SOFTBUS_LOGE("Failed to publish snapshot of group %s\n", group->name);
+        group->stale = true;
+        return SOFTBUS_NO_MEM;
+    }
+    group->stale = false;
+    if (old && snapshot_equal(old, snapshot)) {
+        free(snapshot);
+        return SOFTBUS_OK;
+    }
+
+    snapshot->version = ++group->version;
+    update_multicast(group->name, old ? old->local_count : 0, snapshot->local_count);
+    replace_snapshot(group, snapshot);
+    *changed = true;
+    return SOFTBUS_OK;
+}
+
+// 成员变化后发布快照并释放组锁，展开结果变化时再逐层更新父组
+static int publish_and_unlock(device_group_t* group) {
+    bool changed;
+    uint64_t parents[GROUP_SET_WORDS];
+    int ret = publish_snapshot(group, &changed);
+    memcpy(parents, group->parents, sizeof(parents));
+    SOFTBUS_UNLOCK(&group->mutex);
+
+    if (changed) {
+        refresh_ancestors(parents);
+    }
+    return ret;
+}
+
+// 不持有任何锁时调用。每个父组在自己的组锁内按子组的当前快照重新生成，
+// 并发的多次更新中最后一次总能看到全部子组的最新结果
+static void refresh_ancestors(const uint64_t* parents) {
+    SOFTBUS_BITSET_FOREACH(idx, parents, GROUP_SET_WORDS) {
+        device_group_t* group = &g_group_manager.groups[idx];
+        SOFTBUS_LOCK(&group->mutex);
+        if (group->in_use) {
+            publish_and_unlock(group);
+        } else {
+            SOFTBUS_UNLOCK(&group->mutex);
+        }
+    }
+}
+
+// 调用者持有组锁。换下的快照可能还有发送方读到了指针但尚未增加引用计数，不能立即释放组的引用，
+// 先挂到待回收链上；已取得引用的发送方继续使用旧快照，不受影响
+static void replace_snapshot(device_group_t* group, group_snapshot_t* snapshot) {
+    group_snapshot_t* old = atomic_exchange(&group->snapshot, snapshot);
+    if (old) {
+        old->retired_next = group->retired;
+        group->retired = old;
+    }
+    reclaim_retired(group, false);
+}
+
+// 调用者持有组锁。readers在换下之后某一时刻为0，说明换下前进入窗口的发送方都已取得引用，
+// 之后进入的只能读到新指针，此时释放待回收链上各快照的组引用。不为0时留到下次替换再试，不等待；
+// force只在确认没有发送方时使用
+static void reclaim_retired(device_group_t* group, bool force) {
+    if (!group->retired || (!force && atomic_load(&group->readers) != 0)) {
+        return;
+    }
+    group_snapshot_t* snapshot = group->retired;
+    group->retired = NULL;
+    while (snapshot) {
+        group_snapshot_t* next = snapshot->retired_next;
+        group_manager_release(snapshot);
+        snapshot = next;
+    }
+}
+
+static group_snapshot_t* acquire_snapshot(device_group_t* group) {
+    atomic_fetch_add(&group->readers, 1);
+    group_snapshot_t* snapshot = atomic_load(&group->snapshot);
+    if (snapshot) {
+        atomic_fetch_add_explicit(&snapshot->refs, 1, memory_order_relaxed);
+    }
+    atomic_fetch_sub_explicit(&group->readers, 1, memory_order_release);
+    return snapshot;
+}
+
+static int find_remote(const device_group_t* group, const char* device_name) {
+    for (int i = 0; i < group->member_count; i++) {
+        if (strcmp(group->members[i], device_name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// 移除第idx个远端成员，后面的成员前移
+static void remove_remote(device_group_t* group, int idx) {
+    for (int i = idx; i < group->member_count - 1; i++) {
+        memcpy(group->members[i], group->members[i + 1], MAX_NAME_LENGTH);
+        group->member_nodes[i] = group->member_nodes[i + 1];
+    }
+    group->member_count--;
+}
+
+static void set_local(device_group_t* group, int device_index) {
+    softbus_bitset_set(group->local, device_index);
+    atomic_fetch_or_explicit(&g_group_manager.device_groups[device_index][group->index / SOFTBUS_BITSET_WORD_BITS],
+                             1ULL << (group->index % SOFTBUS_BITSET_WORD_BITS), memory_order_relaxed);
+}
+
+static void clear_local(device_group_t* group, int device_index) {
+    softbus_bitset_clear(group->local, device_index);
+    atomic_fetch_and_explicit(&g_group_manager.device_groups[device_index][group->index / SOFTBUS_BITSET_WORD_BITS],
+                              ~(1ULL << (group->index % SOFTBUS_BITSET_WORD_BITS)), memory_order_relaxed);
+}
+
+// 本地成员数（含子组展开后）在0与非0之间变化时加入/退出该组的组播地址，
+// 没有本地成员的组流量由网卡和内核过滤，不会到达用户态
+static void update_multicast(const char* group_name, int local_before, int local_after) {
+#if ENABLE_SOCKET_MULTICAST
+    if (local_before == 0 && local_after > 0) {
+        socket_group_join(group_name);
+    } else if (local_before > 0 && local_after == 0) {
+        socket_group_leave(group_name);
+    }
+#else
+    (void)group_name;
+    (void)local_before;
+    (void)local_after;
+#endif
+}
@@ -0,0 +1,359 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "prio_queue.h"
+#include "rbtree_typed.h"
+#include "softbus_log.h"
+#include "softbus_cacheline.h"
+
+#define PRIO_LEVELS (PRIORITY_URGENT + 1)
+#define HEAP_ARITY 4
+#define HEAP_INIT_CAP 16
+#define BUCKET_INIT_CAP 16
+#define SEQ_BITS 56
+
+// 堆元素：键的高8位为反转后的优先级，低56位为入队序号，键越小越先出队
+typedef struct {
+    uint64_t key;
+    message_t* msg;
+} heap_entry_t;
+
+// 单个优先级的环形数组，容量为2的幂
+typedef struct {
+    message_t** slots;
+    uint32_t head;
+    uint32_t count;
+    uint32_t cap;
+} bucket_t;
+
+typedef struct {
+    const char* name;
+    int (*push)(prio_queue_t* q, message_t* msg);
+    message_t* (*peek)(const prio_queue_t* q);
+    message_t* (*pop)(prio_queue_t* q);
+    int (*snapshot)(const prio_queue_t* q, message_t** out, int max);
+    void (*fini)(prio_queue_t* q);
+} prio_queue_ops_t;
+
+struct prio_queue {
+    const prio_queue_ops_t* ops;
+    softbus_queue_backend_t backend;
+    size_t count;
+    uint64_t seq;
+    union {
+        struct rb_root_cached tree;
+        struct {
+            heap_entry_t* items;
+            size_t cap;
+        } heap;
+        struct {
+            bucket_t levels[PRIO_LEVELS];
+            uint32_t nonempty;      // 第i位表示优先级i的桶非空
+        } bucket;
+    } u;
+} SOFTBUS_CACHE_ALIGNED;
+
+// 队列顺序：优先级高的在前，同优先级按入队时间先后
+static inline int message_cmp(const message_t* a, const message_t* b) {
+    if (a->priority != b->priority) {
+        return a->priority > b->priority ? -1 : 1;
+    }
+    if (a->timestamp.tv_sec != b->timestamp.tv_sec) {
+        return a->timestamp.tv_sec < b->timestamp.tv_sec ? -1 : 1;
+    }
+    if (a->timestamp.tv_nsec != b->timestamp.tv_nsec) {
+        return a->timestamp.tv_nsec < b->timestamp.tv_nsec ? -1 : 1;
+    }
+    return 0;
+}
+
+RB_DEFINE_TYPED(msgq, message_t, node, message_cmp)
+
+static inline int prio_level(const message_t* msg) {
+    int prio = (int)msg->priority;
+    if (prio < 0) {
+        return 0;
+    }
+    return prio >= PRIO_LEVELS ? PRIO_LEVELS - 1 : prio;
+}
+
+// ---------- 红黑树 ----------
+
+static int rbtree_push(prio_queue_t* q, message_t* msg) {
+    msgq_insert(&q->u.tree, msg);
+    return SOFTBUS_OK;
+}
+
+static message_t* rbtree_peek(const prio_queue_t* q) {
+    return msgq_first(&q->u.tree);
+}
+
+static message_t* rbtree_pop(prio_queue_t* q) {
+    message_t* msg = msgq_first(&q->u.tree);
+    if (msg) {
+        msgq_erase(&q->u.tree, msg);
+    }
+    return msg;
+}
+
+static int rbtree_snapshot(const prio_queue_t* q, message_t** out, int max) {
+    int n = 0;
+    for (message_t* msg = msgq_first(&q->u.tree); msg && n < max; msg = msgq_next(msg)) {
+        out[n++] = msg;
+    }
+    return n;
+}
+
+static void rbtree_fini(prio_queue_t* q) {
+    (void)q;
+}
+
+// ---------- 4叉堆 ----------
+
+static inline uint64_t heap_key(const message_t* msg, uint64_t seq) {
+    return ((uint64_t)(PRIO_LEVELS - 1 - prio_level(msg)) << SEQ_BITS) | (seq & ((1ULL << SEQ_BITS) - 1));
+}
+
+static int heap_push(prio_queue_t* q, message_t* msg) {
+    if (q->count == q->u.heap.cap) {
+        size_t cap = q->u.heap.cap ? q->u.heap.cap * 2 : HEAP_INIT_CAP;
+        heap_entry_t* items = realloc(q->u.heap.items, cap * sizeof(heap_entry_t));
+        if (!items) {
+            return SOFTBUS_NO_MEM;
+        }
+        q->u.heap.items = items;
+        q->u.heap.cap = cap;
+    }
+
+    heap_entry_t* items = q->u.heap.items;
+    heap_entry_t entry = {heap_key(msg, q->seq), msg};
+    size_t i = q->count;
+    while (i > 0) {
+        size_t parent = (i - 1) / HEAP_ARITY;
+        if (items[parent].key <= entry.key) {
+            break;
+        }
+        items[i] = items[parent];
+        i = parent;
+    }
+    items[i] = entry;
+    return SOFTBUS_OK;
+}
+
+static message_t* heap_peek(const prio_queue_t* q) {
+    return q->count ? q->u.heap.items[0].msg : NULL;
+}
+
+static message_t* heap_pop(prio_queue_t* q) {
+    if (!q->count) {
+        return NULL;
+    }
+    heap_entry_t* items = q->u.heap.items;
+    message_t* msg = items[0].msg;
+    size_t n = q->count - 1;
+    heap_entry_t last = items[n];
+
+    // 把末尾元素从根向下筛到合适位置
+    size_t i = 0;
+    for (;;) {
+        size_t child = i * HEAP_ARITY + 1;
+        if (child >= n) {
+            break;
+        }
+        size_t end = child + HEAP_ARITY < n ? child + HEAP_ARITY : n;
+        size_t best = child;
+        for (size_t c = child + 1; c < end; c++) {
+            if (items[c].key < items[best].key) {
+                best = c;
+            }
+        }
+        if (items[best].key >= last.key) {
+            break;
+        }
+        items[i] = items[best];
+        i = best;
+    }
+    items[i] = last;
+    return msg;
+}
+
+static int heap_entry_cmp(const void* a, const void* b) {
+    uint64_t x = ((const heap_entry_t*)a)->key;
+    uint64_t y = ((const heap_entry_t*)b)->key;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static int heap_snapshot(const prio_queue_t* q, message_t** out, int max) {
+    heap_entry_t* sorted = malloc(q->count * sizeof(heap_entry_t));
+    if (!sorted) {
+        return 0;
+    }
+    memcpy(sorted, q->u.heap.items, q->count * sizeof(heap_entry_t));
+    qsort(sorted, q->count, sizeof(heap_entry_t), heap_entry_cmp);
+    int n = 0;
+    for (size_t i = 0; i < q->count && n < max; i++) {
+        out[n++] = sorted[i].msg;
+    }
+    free(sorted);
+    return n;
+}
+
+static void heap_fini(prio_queue_t* q) {
+    free(q->u.heap.items);
+    q->u.heap.items = NULL;
+    q->u.heap.cap = 0;
+}
+
+// ---------- 优先级桶 ----------
+
+static int bucket_push(prio_queue_t* q, message_t* msg) {
+    int level = prio_level(msg);
+    bucket_t* b = &q->u.bucket.levels[level];
+    if (b->count == b->cap) {
+        uint32_t cap = b->cap ? b->cap * 2 : BUCKET_INIT_CAP;
+        message_t** slots = malloc(cap * sizeof(message_t*));
+        if (!slots) {
+            return SOFTBUS_NO_MEM;
+        }
+        // 扩容时把环展开到新数组开头
+        for (uint32_t i = 0; i < b->count; i++) {
+            slots[i] = b->slots[(b->head + i) & (b->cap - 1)];
+        }
+        free(b->slots);
+        b->slots = slots;
+        b->head = 0;
+        b->cap = cap;
+    }
+    b->slots[(b->head + b->count) & (b->cap - 1)] = msg;
+    b->count++;
+    q->u.bucket.nonempty |= 1u << level;
+    return SOFTBUS_OK;
+}
+
+static inline bucket_t* bucket_top(const prio_queue_t* q) {
+    uint32_t mask = q->u.bucket.nonempty;
+    if (!mask) {
+        return NULL;
+    }
+    int level = 31 - __builtin_clz(mask);
+    return (bucket_t*)&q->u.bucket.levels[level];
+}
+
+static message_t* bucket_peek(const prio_queue_t* q) {
+    bucket_t* b = bucket_top(q);
+    return b ? b->slots[b->head] : NULL;
+}
+
+static message_t* bucket_pop(prio_queue_t* q) {
+    bucket_t* b = bucket_top(q);
+    if (!b) {
+        return NULL;
+    }
+    message_t* msg = b->slots[b->head];
+    b->head = (b->head + 1) & (b->cap - 1);
+    if (--b->count == 0) {
+        q->u.bucket.nonempty &= ~(1u << (b - q->u.bucket.levels));
+    }
+    return msg;
+}
+
+static int bucket_snapshot(const prio_queue_t* q, message_t** out, int max) {
+    int n = 0;
+    for (int level = PRIO_LEVELS - 1; level >= 0 && n < max; level--) {
+        const bucket_t* b = &q->u.bucket.levels[level];
+        for (uint32_t i = 0; i < b->count && n < max; i++) {
+            out[n++] = b->slots[(b->head + i) & (b->cap - 1)];
+        }
+    }
+    return n;
+}
+
+static void bucket_fini(prio_queue_t* q) {
+    for (int level = 0; level < PRIO_LEVELS; level++) {
+        free(q->u.bucket.levels[level].slots);
+    }
+    memset(&q->u.bucket, 0, sizeof(q->u.bucket));
+}
+
+static const prio_queue_ops_t g_queue_ops[SOFTBUS_QUEUE_BACKEND_COUNT] = {
+    [SOFTBUS_QUEUE_RBTREE] = {"rbtree", rbtree_push, rbtree_peek, rbtree_pop, rbtree_snapshot, rbtree_fini},
+    [SOFTBUS_QUEUE_HEAP] = {"heap", heap_push, heap_peek, heap_pop, heap_snapshot, heap_fini},
+    [SOFTBUS_QUEUE_BUCKET] = {"bucket", bucket_push, bucket_peek, bucket_pop, bucket_snapshot, bucket_fini},
+};
+
+prio_queue_t* prio_queue_create(softbus_queue_backend_t backend) {
+    if ((unsigned)backend >= SOFTBUS_QUEUE_BACKEND_COUNT) {
+        SOFTBUS_LOGE("Invalid queue backend: %d\n", (int)backend);
+        return NULL;
+    }
+    prio_queue_t* q = softbus_cacheline_alloc(sizeof(prio_queue_t));
+    if (!q) {
+        return NULL;
+    }
+    q->ops = &g_queue_ops[backend];
+    q->backend = backend;
+    if (backend == SOFTBUS_QUEUE_RBTREE) {
+        q->u.tree = RB_ROOT_CACHED;
+    }
+    return q;
+}
+
+void prio_queue_destroy(prio_queue_t* q) {
+    if (!q) {
+        return;
+    }
+    if (q->count) {
+        SOFTBUS_LOGW("Destroying %s queue with %zu messages left\n", q->ops->name, q->count);
+    }
+    q->ops->fini(q);
+    softbus_cacheline_free(q);
+}
+
+int prio_queue_push(prio_queue_t* q, message_t* msg) {
+    if (!q || !msg) {
+        return SOFTBUS_INVALID_ARG;
+    }
+    int ret = q->ops->push(q, msg);
+    if (ret == SOFTBUS_OK) {
+        q->count++;
+        q->seq++;
+    }
+    return ret;
+}
+
+message_t* prio_queue_peek(const prio_queue_t* q) {
+    return q ? q->ops->peek(q) : NULL;
+}
+
+message_t* prio_queue_pop(prio_queue_t* q) {
+    if (!q) {
+        return NULL;
+    }
+    message_t* msg = q->ops->pop(q);
+    if (msg) {
+        q->count--;
+    }
+    return msg;
+}
+
+size_t prio_queue_size(const prio_queue_t* q) {
+    return q ? q->count : 0;
+}
+
+int prio_queue_snapshot(const prio_queue_t* q, message_t** out, int max) {
+    if (!q || !out || max <= 0 || !q->count) {
+        return 0;
+    }
+    return q->ops->snapshot(q, out, max);
+}
+
+softbus_queue_backend_t prio_queue_backend(const prio_queue_t* q) {
+    return q ? q->backend : SOFTBUS_QUEUE_RBTREE;
+}
+
+const char* prio_queue_backend_name(softbus_queue_backend_t backend) {
+    if ((unsigned)backend >= SOFTBUS_QUEUE_BACKEND_COUNT) {
+        return "unknown";
+    }
+    return g_queue_ops[backend].name;
+}
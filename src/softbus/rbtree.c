@@ -5,7 +5,8 @@ void rb_set_parent(struct rb_node *rb, struct rb_node *p) {
     rb->rb_parent_color = (rb->rb_parent_color & 3) | (uintptr_t)p;
 }
 
-static void __rb_rotate_left(struct rb_node *node, struct rb_root *root)
+static void __rb_rotate_left(struct rb_node *node, struct rb_root *root,
+                            const struct rb_augment_callbacks *augment)
 {
     struct rb_node *right = node->rb_right;
     struct rb_node *parent = rb_parent(node);
@@ -26,9 +27,13 @@ static void __rb_rotate_left(struct rb_node *node, struct rb_root *root)
     else
         root->rb_node = right;
     rb_set_parent(node, right);
+
+    if (augment)
+        augment->rotate(node, right);
 }
 
-static void __rb_rotate_right(struct rb_node *node, struct rb_root *root)
+static void __rb_rotate_right(struct rb_node *node, struct rb_root *root,
+                             const struct rb_augment_callbacks *augment)
 {
     struct rb_node *left = node->rb_left;
     struct rb_node *parent = rb_parent(node);
@@ -49,9 +54,13 @@ static void __rb_rotate_right(struct rb_node *node, struct rb_root *root)
     else
         root->rb_node = left;
     rb_set_parent(node, left);
+
+    if (augment)
+        augment->rotate(node, left);
 }
 
-void rb_insert_color(struct rb_node *node, struct rb_root *root)
+static void __rb_insert(struct rb_node *node, struct rb_root *root,
+                        const struct rb_augment_callbacks *augment)
 {
     struct rb_node *parent, *gparent;
 
@@ -73,7 +82,7 @@ void rb_insert_color(struct rb_node *node, struct rb_root *root)
 
             if (parent->rb_right == node)
             {
-                __rb_rotate_left(parent, root);
+                __rb_rotate_left(parent, root, augment);
                 struct rb_node *tmp = parent;
                 parent = node;
                 node = tmp;
@@ -81,7 +90,7 @@ void rb_insert_color(struct rb_node *node, struct rb_root *root)
 
             rb_set_black(parent);
             rb_set_red(gparent);
-            __rb_rotate_right(gparent, root);
+            __rb_rotate_right(gparent, root, augment);
         }
         else
         {
@@ -97,7 +106,7 @@ void rb_insert_color(struct rb_node *node, struct rb_root *root)
 
             if (parent->rb_left == node)
             {
-                __rb_rotate_right(parent, root);
+                __rb_rotate_right(parent, root, augment);
                 struct rb_node *tmp = parent;
                 parent = node;
                 node = tmp;
@@ -105,15 +114,27 @@ void rb_insert_color(struct rb_node *node, struct rb_root *root)
 
             rb_set_black(parent);
             rb_set_red(gparent);
-            __rb_rotate_left(gparent, root);
+            __rb_rotate_left(gparent, root, augment);
         }
     }
 
     rb_set_black(root->rb_node);
 }
 
+void rb_insert_color(struct rb_node *node, struct rb_root *root)
+{
+    __rb_insert(node, root, NULL);
+}
+
+void rb_insert_augmented(struct rb_node *node, struct rb_root *root,
+                         const struct rb_augment_callbacks *augment)
+{
+    __rb_insert(node, root, augment);
+}
+
 static void __rb_erase_color(struct rb_node *node, struct rb_node *parent,
-                            struct rb_root *root)
+                            struct rb_root *root,
+                            const struct rb_augment_callbacks *augment)
 {
     struct rb_node *other;
 
@@ -126,7 +147,7 @@ static void __rb_erase_color(struct rb_node *node, struct rb_node *parent,
             {
                 rb_set_black(other);
                 rb_set_red(parent);
-                __rb_rotate_left(parent, root);
+                __rb_rotate_left(parent, root, augment);
                 other = parent->rb_right;
             }
             if ((!other->rb_left || rb_is_black(other->rb_left)) &&
@@ -142,13 +163,13 @@ static void __rb_erase_color(struct rb_node *node, struct rb_node *parent,
                 {
                     rb_set_black(other->rb_left);
                     rb_set_red(other);
-                    __rb_rotate_right(other, root);
+                    __rb_rotate_right(other, root, augment);
                     other = parent->rb_right;
                 }
                 rb_set_color(other, rb_color(parent));
                 rb_set_black(parent);
                 rb_set_black(other->rb_right);
-                __rb_rotate_left(parent, root);
+                __rb_rotate_left(parent, root, augment);
                 node = root->rb_node;
                 break;
             }
@@ -160,7 +181,7 @@ static void __rb_erase_color(struct rb_node *node, struct rb_node *parent,
             {
                 rb_set_black(other);
                 rb_set_red(parent);
-                __rb_rotate_right(parent, root);
+                __rb_rotate_right(parent, root, augment);
                 other = parent->rb_left;
             }
             if ((!other->rb_left || rb_is_black(other->rb_left)) &&
@@ -176,13 +197,13 @@ static void __rb_erase_color(struct rb_node *node, struct rb_node *parent,
                 {
                     rb_set_black(other->rb_right);
                     rb_set_red(other);
-                    __rb_rotate_left(other, root);
+                    __rb_rotate_left(other, root, augment);
                     other = parent->rb_left;
                 }
                 rb_set_color(other, rb_color(parent));
                 rb_set_black(parent);
                 rb_set_black(other->rb_left);
-                __rb_rotate_right(parent, root);
+                __rb_rotate_right(parent, root, augment);
                 node = root->rb_node;
                 break;
             }
@@ -192,7 +213,8 @@ static void __rb_erase_color(struct rb_node *node, struct rb_node *parent,
         rb_set_black(node);
 }
 
-void rb_erase(struct rb_node *node, struct rb_root *root)
+static void __rb_erase(struct rb_node *node, struct rb_root *root,
+                       const struct rb_augment_callbacks *augment)
 {
     struct rb_node *child, *parent;
     int color;
@@ -241,6 +263,10 @@ void rb_erase(struct rb_node *node, struct rb_root *root)
         node->rb_left = old->rb_left;
         rb_set_parent(old->rb_left, node);
 
+        // 后继节点原来的父节点（或后继节点本身）以上的子树都发生了变化
+        if (augment)
+            augment->propagate(parent, NULL);
+
         goto color;
     }
 
@@ -259,9 +285,23 @@ void rb_erase(struct rb_node *node, struct rb_root *root)
     else
         root->rb_node = child;
 
+    if (augment && parent)
+        augment->propagate(parent, NULL);
+
 color:
     if (color == RB_BLACK)
-        __rb_erase_color(child, parent, root);
+        __rb_erase_color(child, parent, root, augment);
+}
+
+void rb_erase(struct rb_node *node, struct rb_root *root)
+{
+    __rb_erase(node, root, NULL);
+}
+
+void rb_erase_augmented(struct rb_node *node, struct rb_root *root,
+                        const struct rb_augment_callbacks *augment)
+{
+    __rb_erase(node, root, augment);
 }
 
 void rb_link_node(struct rb_node *node, struct rb_node *parent,
@@ -337,4 +377,67 @@ struct rb_node *rb_prev(const struct rb_node *node)
         node = parent;
 
     return parent;
-} 
\ No newline at end of file
+}
+
+void rb_replace_node(struct rb_node *victim, struct rb_node *new,
+                     struct rb_root *root)
+{
+    struct rb_node *parent = rb_parent(victim);
+
+    // 复制父指针、颜色和子指针
+    *new = *victim;
+
+    if (victim->rb_left)
+        rb_set_parent(victim->rb_left, new);
+    if (victim->rb_right)
+        rb_set_parent(victim->rb_right, new);
+
+    if (parent)
+    {
+        if (victim == parent->rb_left)
+            parent->rb_left = new;
+        else
+            parent->rb_right = new;
+    }
+    else
+        root->rb_node = new;
+}
+
+void rb_insert_color_cached(struct rb_node *node,
+                            struct rb_root_cached *root, int leftmost)
+{
+    if (leftmost)
+        root->rb_leftmost = node;
+    rb_insert_color(node, &root->rb_root);
+}
+
+void rb_erase_cached(struct rb_node *node, struct rb_root_cached *root)
+{
+    if (root->rb_leftmost == node)
+        root->rb_leftmost = rb_next(node);
+    rb_erase(node, &root->rb_root);
+}
+
+void rb_insert_augmented_cached(struct rb_node *node, struct rb_root_cached *root,
+                                int leftmost, const struct rb_augment_callbacks *augment)
+{
+    if (leftmost)
+        root->rb_leftmost = node;
+    rb_insert_augmented(node, &root->rb_root, augment);
+}
+
+void rb_erase_augmented_cached(struct rb_node *node, struct rb_root_cached *root,
+                               const struct rb_augment_callbacks *augment)
+{
+    if (root->rb_leftmost == node)
+        root->rb_leftmost = rb_next(node);
+    rb_erase_augmented(node, &root->rb_root, augment);
+}
+
+void rb_replace_node_cached(struct rb_node *victim, struct rb_node *new,
+                            struct rb_root_cached *root)
+{
+    if (root->rb_leftmost == victim)
+        root->rb_leftmost = new;
+    rb_replace_node(victim, new, &root->rb_root);
+}
@@ -1,22 +1,25 @@
+#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include "softbus.h"
-#include "rbtree.h"
 #include "softbus_internal.h"
+#include "group_manager.h"
 #include "softbus_socket.h"
+#include "softbus_shm.h"
+#include "softbus_uds.h"
+#include "softbus_log.h"
+#include "softbus_lock.h"
 
 /* 全局变量 */
 static device_manager_t g_devices[MAX_DEVICES];
-static group_manager_t g_groups[MAX_GROUPS];
 static int g_device_count = 0;
-static int g_group_count = 0;
+static softbus_lock_t g_devices_mutex = SOFTBUS_LOCK_INITIALIZER("softbus_devices");  // 保护g_devices
 static uint32_t g_msg_id_counter = 0;
 static int g_is_initialized = 0;
 static softbus_cast_mode_t g_cast_mode = SOFTBUS_UNICAST;
 
 /* 内部函数声明 */
 static device_manager_t* find_device(const char* name);
-static group_manager_t* find_group(const char* name);
 static uint32_t generate_msg_id(void);
 static int softbus_send_multicast_msg(const char* group_name, void* data, size_t len, softbus_priority_t prio);
 static int softbus_send_msg_prio(const char* target, void* data, size_t len, softbus_priority_t prio);
@@ -27,9 +30,7 @@ int softbus_init(void) {
     }
     
     memset(g_devices, 0, sizeof(g_devices));
-    memset(g_groups, 0, sizeof(g_groups));
     g_device_count = 0;
-    g_group_count = 0;
     g_msg_id_counter = 0;
     g_is_initialized = 1;
     
@@ -37,18 +38,33 @@ int softbus_init(void) {
     // 初始化socket组播
     int ret = socket_multicast_init();
     if (ret != SOFTBUS_OK) {
-        printf("Failed to initialize socket multicast\n");
+        SOFTBUS_LOGE("Failed to initialize socket multicast\n");
         return ret;
     }
 
     // 启动组播接收线程
     ret = socket_multicast_start_receiver();
     if (ret != SOFTBUS_OK) {
-        printf("Failed to start multicast receiver\n");
+        SOFTBUS_LOGE("Failed to start multicast receiver\n");
         socket_multicast_deinit();
         return ret;
     }
 #endif
+
+#if ENABLE_SHM_TRANSPORT
+    // 共享内存传输用于同主机多进程，不可用时仍可通过socket通信
+    if (shm_transport_init(SHM_DEFAULT_BUS_NAME) != SOFTBUS_OK || shm_transport_start() != SOFTBUS_OK) {
+        SOFTBUS_LOGW("Shared memory transport unavailable, continuing without it\n");
+        shm_transport_deinit();
+    }
+#endif
+
+#if ENABLE_UDS_TRANSPORT
+    // Unix域socket以pid为节点名，承载超出共享内存槽位的大负载
+    if (uds_transport_init(NULL) != SOFTBUS_OK) {
+        SOFTBUS_LOGW("Unix domain transport unavailable, continuing without it\n");
+    }
+#endif
     
     return SOFTBUS_OK;
 }
@@ -58,6 +74,10 @@ int softbus_deinit(void) {
         return SOFTBUS_ERROR;
     }
     
+#if ENABLE_UDS_TRANSPORT
+    uds_transport_deinit();
+#endif
+
 #if ENABLE_SOCKET_MULTICAST
     // 停止组播接收线程
     socket_multicast_stop_receiver();
@@ -65,19 +85,14 @@ int softbus_deinit(void) {
     socket_multicast_deinit();
 #endif
 
+#if ENABLE_SHM_TRANSPORT
+    shm_transport_deinit();
+#endif
+
     for (int i = 0; i < g_device_count; i++) {
         if (g_devices[i].ops.deinit) {
             g_devices[i].ops.deinit(g_devices[i].private_data);
         }
-        
-        // 清理消息树中的所有消息
-        struct rb_node* node;
-        while ((node = rb_first(&g_devices[i].msg_tree)) != NULL) {
-            softbus_msg_t* msg = rb_entry(node, softbus_msg_t, node);
-            rb_erase(node, &g_devices[i].msg_tree);
-            free(msg->data);
-            free(msg);
-        }
     }
     
     g_is_initialized = 0;
@@ -85,16 +100,22 @@ int softbus_deinit(void) {
 }
 
 int softbus_register_device(const char* name, device_ops_t* ops) {
-    if (!g_is_initialized || !name || !ops || g_device_count >= MAX_DEVICES) {
+    if (!g_is_initialized || !name || !ops) {
         return SOFTBUS_ERROR;
     }
     
+    SOFTBUS_LOCK(&g_devices_mutex);
     device_manager_t* dev = find_device(name);
     if (dev) {
         // 如果设备已存在，更新其操作函数
         memcpy(&dev->ops, ops, sizeof(device_ops_t));
+        SOFTBUS_UNLOCK(&g_devices_mutex);
         return SOFTBUS_OK;
     }
+    if (g_device_count >= MAX_DEVICES) {
+        SOFTBUS_UNLOCK(&g_devices_mutex);
+        return SOFTBUS_ERROR;
+    }
     
     // 添加新设备
     dev = &g_devices[g_device_count];
@@ -102,14 +123,15 @@ int softbus_register_device(const char* name, device_ops_t* ops) {
     dev->name[MAX_NAME_LENGTH - 1] = '\0';
     memcpy(&dev->ops, ops, sizeof(device_ops_t));
     dev->private_data = NULL;
-    dev->msg_callback = NULL;
-    dev->msg_tree = RB_ROOT;  // 初始化红黑树
+    dev->msg_callback = NULL;  // 这里只登记操作函数，消息队列由device_manager持有
     
     if (dev->ops.init && dev->ops.init(dev->private_data) != SOFTBUS_OK) {
+        SOFTBUS_UNLOCK(&g_devices_mutex);
         return SOFTBUS_ERROR;
     }
     
     g_device_count++;
+    SOFTBUS_UNLOCK(&g_devices_mutex);
     return SOFTBUS_OK;
 }
 
@@ -118,8 +140,10 @@ int softbus_unregister_device(const char* name) {
         return SOFTBUS_ERROR;
     }
     
+    SOFTBUS_LOCK(&g_devices_mutex);
     device_manager_t* dev = find_device(name);
     if (!dev) {
+        SOFTBUS_UNLOCK(&g_devices_mutex);
         return SOFTBUS_NOT_FOUND;
     }
     
@@ -127,15 +151,6 @@ int softbus_unregister_device(const char* name) {
         dev->ops.deinit(dev->private_data);
     }
     
-    // 清理消息树中的所有消息
-    struct rb_node* node;
-    while ((node = rb_first(&dev->msg_tree)) != NULL) {
-        softbus_msg_t* msg = rb_entry(node, softbus_msg_t, node);
-        rb_erase(node, &dev->msg_tree);
-        free(msg->data);
-        free(msg);
-    }
-    
     // 移动设备列表以填补空缺
     int idx = dev - g_devices;
     for (int i = idx; i < g_device_count - 1; i++) {
@@ -143,6 +158,7 @@ int softbus_unregister_device(const char* name) {
     }
     
     g_device_count--;
+    SOFTBUS_UNLOCK(&g_devices_mutex);
     return SOFTBUS_OK;
 }
 
@@ -156,24 +172,25 @@ static int softbus_send_msg_prio(const char* target, void* data, size_t len, sof
     }
     
     // 如果当前是组播模式且目标是组名，则使用组播发送
-    if (g_cast_mode == SOFTBUS_MULTICAST && find_group(target)) {
+    if (g_cast_mode == SOFTBUS_MULTICAST && group_manager_exists(target)) {
         return softbus_send_multicast_msg(target, data, len, prio);
     }
     
     // 否则使用单播发送
-    device_manager_t* dev = device_manager_find(target);  // 使用device_manager中的查找函数
+    device_manager_t* dev = device_manager_acquire(target);  // 使用device_manager中的查找函数
     if (!dev) {
         return SOFTBUS_NOT_FOUND;
     }
     
     // 处理消息
+    int ret = SOFTBUS_ERROR;  // 没有消息处理函数
     if (dev->ops.process_msg) {
         softbus_msg_t* msg = (softbus_msg_t*)data;
-        return dev->ops.process_msg(dev->private_data, msg->data, msg->data_len, 
-                                  prio == PRIORITY_HIGH ? MESSAGE_TYPE_COMMAND : MESSAGE_TYPE_DATA);
+        ret = dev->ops.process_msg(dev->private_data, msg->data, msg->data_len, 
+                                   prio == PRIORITY_HIGH ? MESSAGE_TYPE_COMMAND : MESSAGE_TYPE_DATA);
     }
-    
-    return SOFTBUS_ERROR;  // 没有消息处理函数
+    device_manager_release(dev);
+    return ret;
 }
 
 static int softbus_send_multicast_msg(const char* group_name, void* data, size_t len, 
@@ -182,16 +199,16 @@ static int softbus_send_multicast_msg(const char* group_name, void* data, size_t
         return SOFTBUS_ERROR;
     }
     
-    group_manager_t* group = find_group(group_name);
+    const group_snapshot_t* group = group_manager_acquire(group_name);
     if (!group) {
         return SOFTBUS_NOT_FOUND;
     }
     
     int success_count = 0;
     
-    // 向组内每个设备发送消息
-    for (int i = 0; i < group->member_count; i++) {
-        device_manager_t* dev = device_manager_find(group->members[i]);
+    // 向组内每个本地设备发送消息
+    for (int i = 0; i < group->local_count; i++) {
+        device_manager_t* dev = device_manager_acquire(group->local_names[i]);
         if (!dev) {
             continue;
         }
@@ -205,12 +222,15 @@ static int softbus_send_multicast_msg(const char* group_name, void* data, size_t
                 success_count++;
             }
         }
+        device_manager_release(dev);
     }
     
+    group_manager_release(group);
     return (success_count > 0) ? SOFTBUS_OK : SOFTBUS_ERROR;
 }
 
 /* 内部辅助函数实现 */
+// 调用者持有g_devices_mutex
 static device_manager_t* find_device(const char* name) {
     for (int i = 0; i < g_device_count; i++) {
         if (strcmp(g_devices[i].name, name) == 0) {
@@ -220,15 +240,6 @@ static device_manager_t* find_device(const char* name) {
     return NULL;
 }
 
-static group_manager_t* find_group(const char* name) {
-    for (int i = 0; i < g_group_count; i++) {
-        if (strcmp(g_groups[i].name, name) == 0) {
-            return &g_groups[i];
-        }
-    }
-    return NULL;
-}
-
 static uint32_t generate_msg_id(void) {
     return ++g_msg_id_counter;
 } 
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <pthread.h>
@@ -5,20 +6,46 @@
 #include <time.h>
 #include "softbus.h"
 #include "softbus_internal.h"
+#include "group_manager.h"
 #include "device_manager.h"
 #include "message_queue.h"
 #include "softbus_socket.h"
+#include "softbus_shm.h"
+#include "softbus_uds.h"
+#include "softbus_discovery.h"
+#include "softbus_log.h"
+#include "softbus_trace.h"
+#include "softbus_watchdog.h"
+#include "softbus_capture.h"
+#include "softbus_lock.h"
 
 // 内部函数声明
-static device_manager_t* find_device(const char* device_name);
-static group_manager_t* find_group(const char* group_name);
 static int msg_handler_wrapper(void* private_data, const void* data, size_t len, message_type_t type);
+static int raw_handler_wrapper(void* private_data, const void* data, size_t len, message_type_t type);
+static int register_device_common(device_type_t type, const char* device_name,
+                                  int (*process_msg)(void*, const void*, size_t, message_type_t),
+                                  void* private_data, softbus_queue_backend_t backend);
+static void release_heap_data(void* data, size_t len);
+#if ENABLE_SOCKET_MULTICAST
+static void remote_target_handler(const char* target, bool is_group, message_type_t type,
+                                  softbus_priority_t priority, const void* data, size_t len);
+static void deliver_remote_message(const char* device_name, message_type_t type, softbus_priority_t priority,
+                                   const void* data, size_t len);
+#endif
 static void message_complete_callback(const char* target, int result, void* user_data);
+static int send_message_impl(uint64_t msg_id, const char* target, message_type_t type,
+                             const char* message, softbus_priority_t priority,
+                             softbus_mode_t mode, int timeout_ms);
+static int send_data_impl(uint64_t msg_id, const char* target, message_type_t type,
+                          const void* data, size_t len, softbus_priority_t priority);
+static int send_group_snapshot(const group_snapshot_t* group, message_type_t type, const char* message,
+                               softbus_priority_t priority, softbus_mode_t mode, int timeout_ms,
+                               group_message_callback_t callback, void* user_data);
 
 // 全局变量
-static group_manager_t g_groups[MAX_GROUPS];
-static int g_group_count = 0;
-static pthread_mutex_t g_groups_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// 远端节点数达到该值时改用组播地址发送组消息
+#define SOFTBUS_GROUP_MULTICAST_MIN_NODES 2
 
 // 同步等待结构
 typedef struct {
@@ -26,39 +53,61 @@ typedef struct {
     int result;
     bool completed;
     char response[1024];  // 添加响应消息内容
+    uint64_t msg_id;      // 等待的消息，用于追踪
 } sync_wait_t;
 
 // 消息处理包装函数实现
 static int msg_handler_wrapper(void* private_data, const void* data, size_t len, message_type_t type) {
     const char* msg = (const char*)data;
     int (*handler)(const char*, message_type_t) = (int (*)(const char*, message_type_t))private_data;
+    char text[MAX_MSG_LENGTH];
+
+    // 二进制负载可能没有结尾的'\0'，文本处理函数只看截断后的副本
+    if (len == 0 || msg[len - 1] != '\0') {
+        size_t copy_len = len < sizeof(text) - 1 ? len : sizeof(text) - 1;
+        memcpy(text, data, copy_len);
+        text[copy_len] = '\0';
+        msg = text;
+    }
     
-    printf("Message handler wrapper called with message: %s\n", msg);
+    SOFTBUS_LOGD("Message handler wrapper called with message: %s\n", msg);
     if (!handler) {
-        printf("Error: No message handler registered\n");
+        SOFTBUS_LOGE("No message handler registered\n");
         return SOFTBUS_ERROR;
     }
     
     int result = handler(msg, type);
-    printf("Message handler result: %d\n", result);
+    SOFTBUS_LOGD("Message handler result: %d\n", result);
     
     return result;
 }
 
-int softbus_api_init(void) {
-    // 初始化互斥锁
-    if (pthread_mutex_init(&g_groups_mutex, NULL) != 0) {
+// 二进制处理函数包装：负载原样交给处理函数
+static int raw_handler_wrapper(void* private_data, const void* data, size_t len, message_type_t type) {
+    softbus_raw_handler_t handler = (softbus_raw_handler_t)private_data;
+    if (!handler) {
+        SOFTBUS_LOGE("No message handler registered\n");
         return SOFTBUS_ERROR;
     }
+    return handler(data, len, type);
+}
 
+static void release_heap_data(void* data, size_t len) {
+    (void)len;
+    free(data);
+}
+
+int softbus_api_init(void) {
     // 初始化组管理器
-    g_group_count = 0;
-    memset(g_groups, 0, sizeof(g_groups));
+    int ret = group_manager_init();
+    if (ret != SOFTBUS_OK) {
+        return ret;
+    }
 
     // 初始化消息队列
-    int ret = message_queue_init();
+    ret = message_queue_init();
     if (ret != SOFTBUS_OK) {
-        pthread_mutex_destroy(&g_groups_mutex);
+        group_manager_deinit();
         return ret;
     }
 
@@ -66,7 +115,7 @@ int softbus_api_init(void) {
     ret = device_manager_init();
     if (ret != SOFTBUS_OK) {
         message_queue_deinit();
-        pthread_mutex_destroy(&g_groups_mutex);
+        group_manager_deinit();
         return ret;
     }
 
@@ -75,26 +124,54 @@ int softbus_api_init(void) {
     if (ret != SOFTBUS_OK) {
         device_manager_deinit();
         message_queue_deinit();
-        pthread_mutex_destroy(&g_groups_mutex);
+        group_manager_deinit();
         return ret;
     }
 
+    // 看门狗只负责告警，启动失败不影响消息收发
+    if (watchdog_init() != SOFTBUS_OK) {
+        SOFTBUS_LOGW("Handler watchdog unavailable\n");
+    }
+
+#if ENABLE_SOCKET_MULTICAST
+    // 接收其他节点发来的组消息和设备消息
+    socket_set_target_handler(remote_target_handler);
+
+    // 发现失败时仍可使用组播和显式指定节点的组成员
+    if (discovery_init() != SOFTBUS_OK) {
+        SOFTBUS_LOGW("Remote device discovery unavailable\n");
+    }
+#endif
+
     return SOFTBUS_OK;
 }
 
 void softbus_api_deinit(void) {
-    // 注销所有设备
-    for (int i = 0; i < g_group_count; i++) {
-        for (int j = 0; j < g_groups[i].member_count; j++) {
-            softbus_api_unregister_device(g_groups[i].members[j]);
+    // 注销所有组内的本地设备，远端成员不属于本节点
+    static char group_names[MAX_GROUPS][MAX_NAME_LENGTH];
+    int group_count = group_manager_get_names(group_names, MAX_GROUPS);
+    for (int i = 0; i < group_count; i++) {
+        const group_snapshot_t* group = group_manager_acquire(group_names[i]);
+        if (!group) {
+            continue;
         }
+        for (int j = 0; j < group->local_count; j++) {
+            softbus_api_unregister_device(group->local_names[j]);
+        }
+        group_manager_release(group);
     }
 
-    // 清理所有组
-    pthread_mutex_lock(&g_groups_mutex);
-    g_group_count = 0;
-    memset(g_groups, 0, sizeof(g_groups));
-    pthread_mutex_unlock(&g_groups_mutex);
+#if ENABLE_SOCKET_MULTICAST
+    discovery_deinit();
+    socket_set_target_handler(NULL);
+#endif
+
+    watchdog_deinit();
+
+    // 写出尚未落盘的抓包记录
+    if (softbus_capture_active()) {
+        softbus_capture_stop();
+    }
 
     // 清理软总线系统
     softbus_deinit();
@@ -105,8 +182,11 @@ void softbus_api_deinit(void) {
     // 清理消息队列
     message_queue_deinit();
 
-    // 销毁互斥锁
-    pthread_mutex_destroy(&g_groups_mutex);
+    // 清理所有组
+    group_manager_deinit();
+
+    // 写出后台线程尚未处理的日志
+    softbus_log_flush();
 }
 
 int softbus_api_register_device(device_type_t type, const char* device_name,
@@ -114,19 +194,39 @@ int softbus_api_register_device(device_type_t type, const char* device_name,
     if (!device_name || !handler) {
         return SOFTBUS_INVALID_ARG;
     }
+    return register_device_common(type, device_name, msg_handler_wrapper, (void*)handler, SOFTBUS_QUEUE_RBTREE);
+}
+
+int softbus_api_register_device_raw(device_type_t type, const char* device_name, softbus_raw_handler_t handler) {
+    if (!device_name || !handler) {
+        return SOFTBUS_INVALID_ARG;
+    }
+    return register_device_common(type, device_name, raw_handler_wrapper, (void*)handler, SOFTBUS_QUEUE_RBTREE);
+}
 
+int softbus_api_register_device_ex(device_type_t type, const char* device_name, softbus_raw_handler_t handler,
+                                   softbus_queue_backend_t backend) {
+    if (!device_name || !handler || (unsigned)backend >= SOFTBUS_QUEUE_BACKEND_COUNT) {
+        return SOFTBUS_INVALID_ARG;
+    }
+    return register_device_common(type, device_name, raw_handler_wrapper, (void*)handler, backend);
+}
+
+static int register_device_common(device_type_t type, const char* device_name,
+                                  int (*process_msg)(void*, const void*, size_t, message_type_t),
+                                  void* private_data, softbus_queue_backend_t backend) {
     device_manager_t device = {0};
     strncpy(device.name, device_name, MAX_NAME_LENGTH - 1);
     device.name[MAX_NAME_LENGTH - 1] = '\0';
     device.type = type;
-    device.msg_tree.rb_node = NULL;  // 初始化红黑树根节点
+    device.queue_backend = backend;  // 队列在device_manager_register中创建
     device.msg_callback = NULL;
     
     // 初始化设备操作函数
     device.ops.init = NULL;
     device.ops.deinit = NULL;
-    device.ops.process_msg = msg_handler_wrapper;  // 设置消息处理函数
-    device.private_data = handler;  // 存储消息处理回调
+    device.ops.process_msg = process_msg;  // 设置消息处理函数
+    device.private_data = private_data;  // 存储消息处理回调
 
     int ret = device_manager_register(&device);
     if (ret == SOFTBUS_OK) {
@@ -134,20 +234,24 @@ int softbus_api_register_device(device_type_t type, const char* device_name,
         device_ops_t ops = {
             .init = NULL,
             .deinit = NULL,
-            .process_msg = msg_handler_wrapper
+            .process_msg = process_msg
         };
         ret = softbus_register_device(device_name, &ops);
         
         if (ret == SOFTBUS_OK) {
             // 设置消息队列回调
             message_queue_set_callback(device_name, message_complete_callback, NULL);
+
+#if ENABLE_SHM_TRANSPORT
+            // 登记到共享设备目录，使同主机其他进程可以直接投递
+            shm_transport_register_device(device_name);
+#endif
+#if ENABLE_SOCKET_MULTICAST
+            discovery_device_changed(device_name, true);
+#endif
             
-            // 启动消息处理
-            device_manager_t* dev = device_manager_find(device_name);
-            if (dev) {
-                // 处理任何待处理的消息
-                softbus_api_process_messages(device_name);
-            }
+            // 启动消息处理，处理任何待处理的消息
+            softbus_api_process_messages(device_name);
         }
     }
     return ret;
@@ -164,43 +268,29 @@ int softbus_api_unregister_device(const char* device_name) {
     // 移除消息队列回调
     message_queue_remove_callback(device_name);
 
-    // 从所有组中移除设备
-    pthread_mutex_lock(&g_groups_mutex);
-    for (int i = 0; i < g_group_count; i++) {
-        for (int j = 0; j < g_groups[i].member_count; j++) {
-            if (strcmp(g_groups[i].members[j], device_name) == 0) {
-                // 移动成员列表以填补空缺
-                for (int k = j; k < g_groups[i].member_count - 1; k++) {
-                    strcpy(g_groups[i].members[k], g_groups[i].members[k + 1]);
-                }
-                g_groups[i].member_count--;
-                break;
-            }
-        }
-    }
-    pthread_mutex_unlock(&g_groups_mutex);
+#if ENABLE_SHM_TRANSPORT
+    shm_transport_unregister_device(device_name);
+#endif
 
-    // 获取设备管理器
-    device_manager_t* device = device_manager_find(device_name);
-    if (device) {
-        // 调用设备的清理函数
-        if (device->ops.deinit) {
-            device->ops.deinit(device->private_data);
-        }
-        
-        // 清理设备的私有数据
-        if (device->private_data) {
-            free(device->private_data);
-            device->private_data = NULL;
-        }
-    }
+    // 持有引用使记录下标在组成员清理完成前不被复用；先从设备表摘除，
+    // 之后并发加入组的操作能看到设备已注销，再按反向索引从所在的组中移除设备
+    device_manager_t* device = device_manager_acquire(device_name);
+    int index = device_manager_record_index(device);
 
-    // 从设备管理器中注销设备
+    // 从设备管理器中注销设备，deinit在最后一个引用释放时调用
     int ret = device_manager_unregister(device_name);
+    if (ret == SOFTBUS_OK) {
+        group_manager_device_removed(index);
+    }
+    device_manager_release(device);
     if (ret != SOFTBUS_OK) {
         return ret;
     }
 
+#if ENABLE_SOCKET_MULTICAST
+    discovery_device_changed(device_name, false);
+#endif
+
     // 从softbus系统中注销设备
     return softbus_unregister_device(device_name);
 }
@@ -210,166 +300,66 @@ int softbus_api_create_group(const char* group_name) {
     if (!group_name) {
         return SOFTBUS_INVALID_ARG;
     }
-
-    pthread_mutex_lock(&g_groups_mutex);
-
-    if (g_group_count >= MAX_GROUPS) {
-        pthread_mutex_unlock(&g_groups_mutex);
-        return SOFTBUS_ERROR;
-    }
-
-    // 检查组是否已存在
-    for (int i = 0; i < g_group_count; i++) {
-        if (strcmp(g_groups[i].name, group_name) == 0) {
-            pthread_mutex_unlock(&g_groups_mutex);
-            return SOFTBUS_ERROR;
-        }
-    }
-
-    // 创建新组
-    strncpy(g_groups[g_group_count].name, group_name, MAX_NAME_LENGTH - 1);
-    g_groups[g_group_count].name[MAX_NAME_LENGTH - 1] = '\0';
-    g_groups[g_group_count].member_count = 0;
-    g_group_count++;
-
-    pthread_mutex_unlock(&g_groups_mutex);
-    return SOFTBUS_OK;
+    return group_manager_create(group_name);
 }
 
 int softbus_api_delete_group(const char* group_name) {
     if (!group_name) {
         return SOFTBUS_INVALID_ARG;
     }
-
-    pthread_mutex_lock(&g_groups_mutex);
-
-    // 查找组
-    int idx = -1;
-    for (int i = 0; i < g_group_count; i++) {
-        if (strcmp(g_groups[i].name, group_name) == 0) {
-            idx = i;
-            break;
-        }
-    }
-
-    if (idx == -1) {
-        pthread_mutex_unlock(&g_groups_mutex);
-        return SOFTBUS_NOT_FOUND;
-    }
-
-    // 移动组列表以填补空缺
-    for (int i = idx; i < g_group_count - 1; i++) {
-        memcpy(&g_groups[i], &g_groups[i + 1], sizeof(group_manager_t));
-    }
-
-    g_group_count--;
-    pthread_mutex_unlock(&g_groups_mutex);
-    return SOFTBUS_OK;
+    return group_manager_delete(group_name);
 }
 
 int softbus_api_add_to_group(const char* group_name, const char* device_name) {
     if (!group_name || !device_name) {
         return SOFTBUS_INVALID_ARG;
     }
+    return group_manager_add_device(group_name, device_name);
+}
 
-    pthread_mutex_lock(&g_groups_mutex);
-
-    // 查找组
-    int group_idx = -1;
-    for (int i = 0; i < g_group_count; i++) {
-        if (strcmp(g_groups[i].name, group_name) == 0) {
-            group_idx = i;
-            break;
-        }
-    }
-
-    if (group_idx == -1) {
-        pthread_mutex_unlock(&g_groups_mutex);
-        return SOFTBUS_NOT_FOUND;
-    }
-
-    group_manager_t* group = &g_groups[group_idx];
-
-    // 检查设备是否已在组中
-    for (int i = 0; i < group->member_count; i++) {
-        if (strcmp(group->members[i], device_name) == 0) {
-            pthread_mutex_unlock(&g_groups_mutex);
-            return SOFTBUS_OK;
-        }
-    }
-
-    // 检查组是否已满
-    if (group->member_count >= MAX_GROUP_MEMBERS) {
-        pthread_mutex_unlock(&g_groups_mutex);
-        return SOFTBUS_ERROR;
+int softbus_api_add_remote_to_group(const char* group_name, const char* device_name,
+                                    const char* node_ip, uint16_t node_port) {
+    if (!group_name || !device_name || !node_ip) {
+        return SOFTBUS_INVALID_ARG;
     }
-
-    // 检查设备是否存在
-    if (!device_manager_is_device_registered(device_name)) {
-        pthread_mutex_unlock(&g_groups_mutex);
-        return SOFTBUS_NOT_FOUND;
+#if ENABLE_SOCKET_MULTICAST
+    softbus_node_addr_t node;
+    if (socket_node_addr_parse(node_ip, node_port, &node) != SOFTBUS_OK) {
+        return SOFTBUS_INVALID_ARG;
     }
-
-    // 添加设备到组
-    strncpy(group->members[group->member_count], device_name, MAX_NAME_LENGTH - 1);
-    group->members[group->member_count][MAX_NAME_LENGTH - 1] = '\0';
-    group->member_count++;
-
-    pthread_mutex_unlock(&g_groups_mutex);
-    return SOFTBUS_OK;
+    return group_manager_add_remote(group_name, device_name, &node);
+#else
+    (void)node_port;
+    return SOFTBUS_ERROR;
+#endif
 }
 
 int softbus_api_remove_from_group(const char* group_name, const char* device_name) {
     if (!group_name || !device_name) {
         return SOFTBUS_INVALID_ARG;
     }
+    return group_manager_remove_device(group_name, device_name);
+}
 
-    pthread_mutex_lock(&g_groups_mutex);
-
-    // 查找组
-    int group_idx = -1;
-    for (int i = 0; i < g_group_count; i++) {
-        if (strcmp(g_groups[i].name, group_name) == 0) {
-            group_idx = i;
-            break;
-        }
-    }
-
-    if (group_idx == -1) {
-        pthread_mutex_unlock(&g_groups_mutex);
-        return SOFTBUS_NOT_FOUND;
-    }
-
-    group_manager_t* group = &g_groups[group_idx];
-
-    // 查找设备
-    int dev_idx = -1;
-    for (int i = 0; i < group->member_count; i++) {
-        if (strcmp(group->members[i], device_name) == 0) {
-            dev_idx = i;
-            break;
-        }
-    }
-
-    if (dev_idx == -1) {
-        pthread_mutex_unlock(&g_groups_mutex);
-        return SOFTBUS_NOT_FOUND;
+int softbus_api_add_group_to_group(const char* parent_name, const char* child_name) {
+    if (!parent_name || !child_name) {
+        return SOFTBUS_INVALID_ARG;
     }
+    return group_manager_add_group(parent_name, child_name);
+}
 
-    // 移动成员列表以填补空缺
-    for (int i = dev_idx; i < group->member_count - 1; i++) {
-        strcpy(group->members[i], group->members[i + 1]);
+int softbus_api_remove_group_from_group(const char* parent_name, const char* child_name) {
+    if (!parent_name || !child_name) {
+        return SOFTBUS_INVALID_ARG;
     }
-
-    group->member_count--;
-    pthread_mutex_unlock(&g_groups_mutex);
-    return SOFTBUS_OK;
+    return group_manager_remove_group(parent_name, child_name);
 }
 
 // 消息完成回调函数
 static void message_complete_callback(const char* target, int result, void* user_data) {
     sync_wait_t* wait = (sync_wait_t*)user_data;
     if (wait) {
+        SOFTBUS_TRACE(TRACE_COMPLETE, wait->msg_id, target);
         wait->result = result;
         wait->completed = true;
         
@@ -378,7 +368,7 @@ static void message_complete_callback(const char* target, int result, void* user
         if (message_queue_peek(target, &response_msg) == SOFTBUS_OK) {
             strncpy(wait->response, response_msg.content, sizeof(wait->response) - 1);
             wait->response[sizeof(wait->response) - 1] = '\0';
-            printf("Response received: %s\n", wait->response);
+            SOFTBUS_LOGD("Response received: %s\n", wait->response);
         }
         
         sem_post(&wait->sem);
@@ -389,28 +379,53 @@ static void message_complete_callback(const char* target, int result, void* user
 int softbus_api_send_message_ex(const char* target, message_type_t type,
                               const char* message, softbus_priority_t priority,
                               softbus_mode_t mode, int timeout_ms) {
+    uint64_t msg_id = message_queue_next_id();
+    SOFTBUS_TRACE(TRACE_API_ENTRY, msg_id, target);
+    int ret = send_message_impl(msg_id, target, type, message, priority, mode, timeout_ms);
+    SOFTBUS_TRACE(TRACE_API_EXIT, msg_id, target);
+    return ret;
+}
+
+static int send_message_impl(uint64_t msg_id, const char* target, message_type_t type,
+                             const char* message, softbus_priority_t priority,
+                             softbus_mode_t mode, int timeout_ms) {
     if (!target || !message) {
         return SOFTBUS_INVALID_ARG;
     }
 
     // 检查设备是否存在
     if (!device_manager_is_device_registered(target)) {
+#if ENABLE_SHM_TRANSPORT
+        // 同主机其他进程的设备：经共享内存直接写入对方消息队列，远端投递为异步
+        if (shm_transport_lookup(target) >= 0) {
+            return shm_transport_send(target, type, priority, message, strlen(message) + 1);
+        }
+#endif
+#if ENABLE_SOCKET_MULTICAST
+        // 其他节点上的设备：按发现得到的路由单播到所在节点，远端投递为异步
+        softbus_node_addr_t node;
+        if (discovery_lookup(target, &node) == SOFTBUS_OK) {
+            return socket_send_to_node(&node, target, false, message, strlen(message) + 1, type, priority);
+        }
+#endif
         return SOFTBUS_NOT_FOUND;
     }
 
     message_t msg = {0};
     strncpy(msg.target, target, sizeof(msg.target) - 1);
+    msg.msg_id = msg_id;
     msg.type = type;
     msg.priority = priority;
     strncpy(msg.content, message, sizeof(msg.content) - 1);
     msg.data_len = strlen(message) + 1;
     
-    // 分配消息数据内存
+    // 分配消息数据内存，入队后由队列接管
     msg.data = malloc(msg.data_len);
     if (!msg.data) {
         return SOFTBUS_NO_MEM;
     }
     memcpy(msg.data, message, msg.data_len);
+    msg.data_release = release_heap_data;
     
     clock_gettime(CLOCK_REALTIME, &msg.timestamp);
 
@@ -428,6 +443,7 @@ int softbus_api_send_message_ex(const char* target, message_type_t type,
     } else {
         // 同步模式：创建等待结构并等待完成
         sync_wait_t wait = {0};
+        wait.msg_id = msg_id;
         sem_init(&wait.sem, 0, 0);
         wait.completed = false;
         wait.result = SOFTBUS_ERROR;
@@ -460,7 +476,7 @@ int softbus_api_send_message_ex(const char* target, message_type_t type,
             ret = wait.result;
             // 打印响应消息
             if (ret == SOFTBUS_OK && wait.response[0] != '\0') {
-                printf("Received response from %s: %s\n", target, wait.response);
+                SOFTBUS_LOGD("Received response from %s: %s\n", target, wait.response);
             }
         } else {
             ret = SOFTBUS_TIMEOUT;
@@ -473,7 +489,68 @@ int softbus_api_send_message_ex(const char* target, message_type_t type,
     }
 }
 
+// 二进制消息发送：本进程直接入队，同主机其他进程按大小选择共享内存或memfd传递
+int softbus_api_send_data_ex(const char* target, message_type_t type, const void* data, size_t len,
+                             softbus_priority_t priority) {
+    uint64_t msg_id = message_queue_next_id();
+    SOFTBUS_TRACE(TRACE_API_ENTRY, msg_id, target);
+    int ret = send_data_impl(msg_id, target, type, data, len, priority);
+    SOFTBUS_TRACE(TRACE_API_EXIT, msg_id, target);
+    return ret;
+}
+
+static int send_data_impl(uint64_t msg_id, const char* target, message_type_t type,
+                          const void* data, size_t len, softbus_priority_t priority) {
+    if (!target || (!data && len > 0)) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    if (!device_manager_is_device_registered(target)) {
+#if ENABLE_SHM_TRANSPORT
+        int pid = shm_transport_lookup_pid(target);
+        if (pid > 0) {
+            if (len <= SHM_MAX_PAYLOAD) {
+                return shm_transport_send(target, type, priority, data, len);
+            }
+#if ENABLE_UDS_TRANSPORT
+            // 超出共享内存槽位的负载：写入密封的memfd后只传递描述符
+            char peer[UDS_MAX_NODE_NAME];
+            snprintf(peer, sizeof(peer), "%d", pid);
+            return uds_transport_send(peer, target, type, priority, data, len);
+#endif
+        }
+#endif
+        return SOFTBUS_NOT_FOUND;
+    }
+
+    message_t msg = {0};
+    strncpy(msg.target, target, sizeof(msg.target) - 1);
+    msg.msg_id = msg_id;
+    msg.type = type;
+    msg.priority = priority;
+    size_t preview = len < sizeof(msg.content) - 1 ? len : sizeof(msg.content) - 1;
+    memcpy(msg.content, data, preview);
+    msg.data = malloc(len ? len : 1);
+    if (!msg.data) {
+        return SOFTBUS_NO_MEM;
+    }
+    memcpy(msg.data, data, len);
+    msg.data_len = len;
+    msg.data_release = release_heap_data;
+    clock_gettime(CLOCK_REALTIME, &msg.timestamp);
+
+    int ret = message_queue_send(&msg);
+    if (ret != SOFTBUS_OK) {
+        free(msg.data);
+        return ret;
+    }
+    softbus_api_process_messages(target);
+    return SOFTBUS_OK;
+}
+
 // 实现扩展的组消息发送API
+// 本地成员在进程内直接投递；远端成员按所在节点归并，每个节点只发送一个数据报，
+// 由对端节点投递给该组在其本地的成员
 int softbus_api_send_group_message_ex(const char* group_name, message_type_t type,
                                     const char* message, softbus_priority_t priority,
                                     softbus_mode_t mode, int timeout_ms,
@@ -482,129 +559,137 @@ int softbus_api_send_group_message_ex(const char* group_name, message_type_t typ
         return SOFTBUS_INVALID_ARG;
     }
 
-#if ENABLE_SOCKET_MULTICAST
-    // 如果启用了socket组播，优先使用组播发送消息
-    int ret = socket_multicast_send(message, strlen(message));
-    if (ret == SOFTBUS_OK) {
-        printf("Message sent via multicast: %s\n", message);
-        if (callback) {
-            callback("multicast", message, SOFTBUS_OK, user_data);
-        }
-        return SOFTBUS_OK;
+    // 取快照不加锁，扇出期间成员变化生成新快照，不影响本次发送
+    const group_snapshot_t* group = group_manager_acquire(group_name);
+    if (!group) {
+        return SOFTBUS_NOT_FOUND;
     }
-    // 如果组播发送失败，回退到普通的组消息发送
-    printf("Multicast send failed, falling back to normal group message...\n");
-#endif
-
-    pthread_mutex_lock(&g_groups_mutex);
+    int final_ret = send_group_snapshot(group, type, message, priority, mode, timeout_ms, callback, user_data);
+    group_manager_release(group);
+    return final_ret;
+}
 
-    // 查找组
-    int group_idx = -1;
-    for (int i = 0; i < g_group_count; i++) {
-        if (strcmp(g_groups[i].name, group_name) == 0) {
-            group_idx = i;
-            break;
+static int send_group_snapshot(const group_snapshot_t* group, message_type_t type, const char* message,
+                               softbus_priority_t priority, softbus_mode_t mode, int timeout_ms,
+                               group_message_callback_t callback, void* user_data) {
+    int final_ret = SOFTBUS_OK;
+
+    // 本地成员：名称已在快照中解析好，同步模式下逐个等待处理完成
+    for (int i = 0; i < group->local_count; i++) {
+        const char* name = group->local_names[i];
+        int ret = softbus_api_send_message_ex(name, type, message, priority,
+                                              mode, mode == SOFTBUS_MODE_SYNC ? timeout_ms : 0);
+        if (ret == SOFTBUS_NOT_FOUND) {
+            continue;  // 取快照之后已注销
+        }
+        if (ret != SOFTBUS_OK) {
+            final_ret = ret;
+        }
+        if (callback && (ret != SOFTBUS_OK || mode == SOFTBUS_MODE_SYNC)) {
+            callback(name, NULL, ret, user_data);
         }
     }
 
-    if (group_idx == -1) {
-        pthread_mutex_unlock(&g_groups_mutex);
-        return SOFTBUS_NOT_FOUND;
+#if ENABLE_SOCKET_MULTICAST
+    const char* group_name = group->name;
+    int member_count = group->remote_count;
+    const char (*device_names)[MAX_NAME_LENGTH] = group->remote;
+    const softbus_node_addr_t* nodes = group->remote_nodes;
+    const char (*owners)[MAX_NAME_LENGTH] = group->remote_group;
+    size_t len = strlen(message) + 1;
+
+    // 远端节点较多时发送一个组播，只有加入了该组地址的节点会收到；
+    // 有来自子组的远端成员时对端按各自所属的组投递，不走组播
+    if (!group->remote_nested && group->remote_node_count >= SOFTBUS_GROUP_MULTICAST_MIN_NODES) {
+        int ret = socket_multicast_send_group(group_name, message, len, type, priority);
+        if (ret != SOFTBUS_OK) {
+            final_ret = ret;
+        }
+        for (int i = 0; callback && i < member_count; i++) {
+            callback(device_names[i], NULL, ret, user_data);
+        }
+        return final_ret;
     }
 
-    group_manager_t* group = &g_groups[group_idx];
-    int member_count = group->member_count;
-    char device_names[MAX_GROUP_MEMBERS][MAX_NAME_LENGTH];
-    memcpy(device_names, group->members, sizeof(device_names));
-
-    pthread_mutex_unlock(&g_groups_mutex);
-
-    // 同步模式下需要等待所有设备都处理完成并返回响应
-    if (mode == SOFTBUS_MODE_SYNC) {
-        sync_wait_t wait = {0};
-        sem_init(&wait.sem, 0, 0);
-        wait.completed = false;
-        wait.result = SOFTBUS_OK;
-
-        // 为每个设备发送消息并等待响应
-        for (int i = 0; i < member_count; i++) {
-            // 发送消息
-            int ret = softbus_api_send_message_ex(device_names[i], type, message,
-                                            priority, mode, timeout_ms);
-            if (ret != SOFTBUS_OK) {
-                wait.result = ret;
-                if (callback) {
-                    callback(device_names[i], NULL, ret, user_data);
-                }
-                continue;
+    // 远端成员：同一节点上属于同一组的多个成员共用一个数据报
+    for (int i = 0; i < member_count; i++) {
+        bool sent_before = false;
+        for (int j = 0; j < i; j++) {
+            if (nodes[j].addr == nodes[i].addr && nodes[j].port == nodes[i].port &&
+                strcmp(owners[j], owners[i]) == 0) {
+                sent_before = true;
+                break;
             }
+        }
+        if (sent_before) {
+            continue;
+        }
 
-            // 等待响应消息
-            device_manager_t* dev = device_manager_find(device_names[i]);
-            if (dev && dev->ops.process_msg) {
-                // 处理消息并获取响应
-                ret = dev->ops.process_msg(dev->private_data, message, strlen(message) + 1, type);
-                
-                // 获取响应消息
-                message_t response_msg;
-                if (message_queue_receive(device_names[i], &response_msg) == SOFTBUS_OK) {
-                    // 收到响应消息
-                    if (callback) {
-                        callback(device_names[i], response_msg.content, ret, user_data);
-                    }
-                    // 释放响应消息数据
-                    if (response_msg.data) {
-                        free(response_msg.data);
-                        response_msg.data = NULL;
-                    }
-                } else {
-                    // 没有收到响应消息
-                    if (callback) {
-                        callback(device_names[i], NULL, SOFTBUS_TIMEOUT, user_data);
-                    }
-                    wait.result = SOFTBUS_TIMEOUT;
+        int ret = socket_send_to_node(&nodes[i], owners[i], true, message, len, type, priority);
+        if (ret != SOFTBUS_OK) {
+            final_ret = ret;
+        }
+        // 远端投递是异步的，只能报告数据报是否发出
+        if (callback) {
+            for (int j = i; j < member_count; j++) {
+                if (nodes[j].addr == nodes[i].addr && nodes[j].port == nodes[i].port &&
+                    strcmp(owners[j], owners[i]) == 0) {
+                    callback(device_names[j], NULL, ret, user_data);
                 }
             }
         }
+    }
+#endif
 
-        sem_destroy(&wait.sem);
-        return wait.result;
-    } else {
-        // 异步模式下直接发送给所有设备
-        int final_ret = SOFTBUS_OK;
-        for (int i = 0; i < member_count; i++) {
-            int ret = softbus_api_send_message_ex(device_names[i], type, message,
-                                            priority, mode, 0);
-            if (ret != SOFTBUS_OK) {
-                final_ret = ret;
-                if (callback) {
-                    callback(device_names[i], NULL, ret, user_data);
-                }
-            }
+    return final_ret;
+}
+
+#if ENABLE_SOCKET_MULTICAST
+// 远端节点发来的带目标消息：组消息只投递给本地成员，不再向其他节点转发
+static void remote_target_handler(const char* target, bool is_group, message_type_t type,
+                                  softbus_priority_t priority, const void* data, size_t len) {
+    if (!is_group) {
+        if (device_manager_is_device_registered(target)) {
+            deliver_remote_message(target, type, priority, data, len);
         }
-        return final_ret;
+        return;
+    }
+
+    const group_snapshot_t* group = group_manager_acquire(target);
+    if (!group) {
+        return;
+    }
+    for (int i = 0; i < group->local_count; i++) {
+        deliver_remote_message(group->local_names[i], type, priority, data, len);
     }
+    group_manager_release(group);
 }
 
+static void deliver_remote_message(const char* device_name, message_type_t type, softbus_priority_t priority,
+                                   const void* data, size_t len) {
+    message_t msg = {0};
+    strncpy(msg.target, device_name, sizeof(msg.target) - 1);
+    msg.type = type;
+    msg.priority = priority;
+    size_t copy_len = len < sizeof(msg.content) - 1 ? len : sizeof(msg.content) - 1;
+    memcpy(msg.content, data, copy_len);
+    msg.content[copy_len] = '\0';
+    msg.data = (void*)data;  // 未设置data_release，message_queue_send会复制数据
+    msg.data_len = len;
+    clock_gettime(CLOCK_REALTIME, &msg.timestamp);
+    message_queue_send(&msg);
+}
+#endif
+
 // 消息查询函数
 int softbus_api_get_pending_messages(const char* device_name, message_t* msgs, int* count) {
     if (!device_name || !msgs || !count || *count <= 0) {
         return SOFTBUS_INVALID_ARG;
     }
 
-    device_manager_t* dev = find_device(device_name);
-    if (!dev) {
-        return SOFTBUS_NOT_FOUND;
-    }
-
-    int msg_count = 0;
-    struct rb_node* node = rb_first(&dev->msg_tree);
-    
-    while (node && msg_count < *count) {
-        message_t* msg = rb_entry(node, message_t, node);
-        memcpy(&msgs[msg_count], msg, sizeof(message_t));
-        msg_count++;
-        node = rb_next(node);
+    int msg_count = device_manager_snapshot(device_name, msgs, *count);
+    if (msg_count < 0) {
+        return msg_count;
     }
 
     *count = msg_count;
@@ -617,69 +702,102 @@ int softbus_api_process_messages(const char* device_name) {
         return SOFTBUS_INVALID_ARG;
     }
 
-    printf("Processing messages for device: %s\n", device_name);
+    SOFTBUS_LOGD("Processing messages for device: %s\n", device_name);
     
     message_t msg;
     int processed = 0;
     
-    // 获取设备管理器
-    device_manager_t* device = device_manager_find(device_name);
+    // 获取设备管理器，持有引用期间处理函数注销设备也不会释放记录
+    device_manager_t* device = device_manager_acquire(device_name);
     if (!device) {
-        printf("Device not found: %s\n", device_name);
+        SOFTBUS_LOGW("Device not found: %s\n", device_name);
         return SOFTBUS_NOT_FOUND;
     }
     
-    // 处理所有待处理的消息
-    while (message_queue_receive(device_name, &msg) == SOFTBUS_OK) {
-        printf("Processing message for device %s: type=%d, content=%s\n",
-               device_name, msg.type, msg.content);
+    // 处理所有待处理的消息，设备被隔离时消息留在队列中，恢复后再分发
+    while (watchdog_dispatch_allowed(device->watchdog) &&
+           message_queue_receive(device_name, &msg) == SOFTBUS_OK) {
+        SOFTBUS_LOGD("Processing message for device %s: type=%d, content=%s\n",
+                     device_name, msg.type, msg.content);
         
         if (device->ops.process_msg) {
+            // 优先交付完整负载，content只是截断的预览
+            const void* payload = msg.data ? msg.data : msg.content;
+            size_t payload_len = msg.data ? msg.data_len : strlen(msg.content) + 1;
+            watchdog_call_t call;
+            SOFTBUS_TRACE_SET_CURRENT(msg.msg_id);
+            SOFTBUS_TRACE(TRACE_HANDLER_BEGIN, msg.msg_id, device_name);
+            watchdog_handler_begin(device->watchdog, msg.type, &call);
             int result = device->ops.process_msg(device->private_data, 
-                                               msg.content, 
-                                               strlen(msg.content) + 1, 
+                                               payload, 
+                                               payload_len, 
                                                msg.type);
-            printf("Message handler returned: %d\n", result);
+            watchdog_handler_end(device->watchdog, &call);
+            SOFTBUS_TRACE(TRACE_HANDLER_END, msg.msg_id, device_name);
+            SOFTBUS_TRACE_SET_CURRENT(0);
+            device_metrics_handled(device->metrics, call.wall_ns, call.cpu_ns, result);
+            SOFTBUS_LOGD("Message handler returned: %d\n", result);
             
             // 如果是同步模式，等待响应
             if (msg.type == MESSAGE_TYPE_COMMAND) {
                 message_t response;
                 if (message_queue_receive(device_name, &response) == SOFTBUS_OK) {
-                    printf("Response received from %s: %s\n", device_name, response.content);
-                    if (response.data) {
-                        free(response.data);
-                    }
+                    SOFTBUS_LOGD("Response received from %s: %s\n", device_name, response.content);
+                    message_queue_release_data(&response);
                 }
             }
             
             processed++;
         } else {
-            printf("No message handler found for device: %s\n", device_name);
+            SOFTBUS_LOGW("No message handler found for device: %s\n", device_name);
+            device_metrics_dropped(device->metrics);
         }
         
         // 释放消息数据
-        if (msg.data) {
-            free(msg.data);
-            msg.data = NULL;
-        }
+        message_queue_release_data(&msg);
     }
+    device_manager_release(device);
     
-    printf("Processed %d messages for device %s\n", processed, device_name);
+    SOFTBUS_LOGD("Processed %d messages for device %s\n", processed, device_name);
     return processed;
 }
 
+int softbus_api_get_stats(const char* device_name, softbus_device_stats_t* stats) {
+    return device_manager_get_stats(device_name, stats);
+}
+
+int softbus_api_reset_stats(const char* device_name) {
+    return device_manager_reset_stats(device_name);
+}
+
+int softbus_api_set_handler_budget(const char* device_name, uint32_t wall_us, uint32_t cpu_us) {
+    return device_manager_set_budget(device_name, wall_us, cpu_us);
+}
+
+void softbus_api_set_quarantine(bool enable) {
+    watchdog_set_quarantine(enable);
+}
+
+int softbus_api_get_lock_stats(softbus_lock_stats_t* stats, int max_count) {
+    return softbus_lock_get_stats(stats, max_count);
+}
+
+void softbus_api_reset_lock_stats(void) {
+    softbus_lock_reset_stats();
+}
+
 bool softbus_api_is_device_registered(const char* device_name) {
     if (!device_name) {
         return false;
     }
-    return find_device(device_name) != NULL;
+    return device_manager_is_device_registered(device_name);
 }
 
 bool softbus_api_is_group_exists(const char* group_name) {
     if (!group_name) {
         return false;
     }
-    return find_group(group_name) != NULL;
+    return group_manager_exists(group_name);
 }
 
 int softbus_api_get_group_devices(const char* group_name, char** device_names, int* count) {
@@ -687,43 +805,26 @@ int softbus_api_get_group_devices(const char* group_name, char** device_names, i
         return SOFTBUS_INVALID_ARG;
     }
 
-    group_manager_t* group = find_group(group_name);
+    const group_snapshot_t* group = group_manager_acquire(group_name);
     if (!group) {
         return SOFTBUS_NOT_FOUND;
     }
 
-    int copy_count = (*count < group->member_count) ? *count : group->member_count;
-    
-    for (int i = 0; i < copy_count; i++) {
-        strncpy(device_names[i], group->members[i], MAX_NAME_LENGTH - 1);
-        device_names[i][MAX_NAME_LENGTH - 1] = '\0';
+    // 本地成员在前
+    int copy_count = 0;
+    for (int i = 0; i < group->local_count && copy_count < *count; i++) {
+        memcpy(device_names[copy_count++], group->local_names[i], MAX_NAME_LENGTH);
+    }
+    for (int i = 0; i < group->remote_count && copy_count < *count; i++) {
+        memcpy(device_names[copy_count++], group->remote[i], MAX_NAME_LENGTH);
     }
+    group_manager_release(group);
 
     *count = copy_count;
     return SOFTBUS_OK;
 }
 
 // 内部函数实现
-static device_manager_t* find_device(const char* device_name) {
-    if (!device_name) {
-        return NULL;
-    }
-    return device_manager_find(device_name);
-}
-
-static group_manager_t* find_group(const char* group_name) {
-    if (!group_name) {
-        return NULL;
-    }
-    
-    for (int i = 0; i < g_group_count; i++) {
-        if (strcmp(g_groups[i].name, group_name) == 0) {
-            return &g_groups[i];
-        }
-    }
-    return NULL;
-}
-
 // 添加外部处理函数的声明
 extern int temperature_sensor_handler(const char* msg, message_type_t type);
 extern int led_controller_handler(const char* msg, message_type_t type); 
\ No newline at end of file
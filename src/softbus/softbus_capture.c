@@ -0,0 +1,291 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include "softbus_capture.h"
+#include "softbus_log.h"
+
+#define CAPTURE_RECORD_MAX (sizeof(softbus_capture_record_t) + UINT8_MAX + SOFTBUS_CAPTURE_MAX_PAYLOAD)
+
+// 每个线程一个单生产者单消费者字节环，记录变长且可跨越环尾；消费者为持有drain_mutex的线程
+typedef struct capture_ring {
+    _Atomic uint64_t head;      // 生产者写入位置（字节）
+    _Atomic uint64_t tail;      // 消费者读取位置（字节）
+    _Atomic bool orphaned;      // 所属线程已退出，读空后释放
+    struct capture_ring* next;
+    uint8_t buf[SOFTBUS_CAPTURE_RING_BYTES];
+} capture_ring_t;
+
+_Atomic bool g_softbus_capture_active;
+
+static struct {
+    pthread_once_t once;
+    pthread_key_t key;
+    capture_ring_t* rings;
+    pthread_mutex_t rings_mutex;
+    pthread_mutex_t drain_mutex;
+    pthread_mutex_t ctl_mutex;  // 串行化start/stop
+    FILE* fp;
+    _Atomic uint64_t start_ns;
+    _Atomic uint64_t dropped;
+    _Atomic bool running;
+    pthread_t writer;
+    uint8_t scratch[CAPTURE_RECORD_MAX];
+} g_capture = {
+    .once = PTHREAD_ONCE_INIT,
+    .rings_mutex = PTHREAD_MUTEX_INITIALIZER,
+    .drain_mutex = PTHREAD_MUTEX_INITIALIZER,
+    .ctl_mutex = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static __thread capture_ring_t* t_ring;
+
+// 内部函数声明
+static void* capture_writer_thread(void* arg);
+static void capture_drain(void);
+
+static uint64_t capture_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void ring_thread_exit(void* ring) {
+    atomic_store_explicit(&((capture_ring_t*)ring)->orphaned, true, memory_order_release);
+}
+
+static void capture_init_once(void) {
+    pthread_key_create(&g_capture.key, ring_thread_exit);
+}
+
+static capture_ring_t* ring_get(void) {
+    if (t_ring) {
+        return t_ring;
+    }
+    pthread_once(&g_capture.once, capture_init_once);
+
+    capture_ring_t* ring = calloc(1, sizeof(*ring));
+    if (!ring) {
+        return NULL;
+    }
+    pthread_mutex_lock(&g_capture.rings_mutex);
+    ring->next = g_capture.rings;
+    g_capture.rings = ring;
+    pthread_mutex_unlock(&g_capture.rings_mutex);
+    pthread_setspecific(g_capture.key, ring);
+    t_ring = ring;
+    return ring;
+}
+
+static void ring_put(capture_ring_t* ring, uint64_t pos, const void* src, size_t len) {
+    size_t off = (size_t)(pos & (SOFTBUS_CAPTURE_RING_BYTES - 1));
+    size_t first = SOFTBUS_CAPTURE_RING_BYTES - off;
+    if (first >= len) {
+        memcpy(ring->buf + off, src, len);
+    } else {
+        memcpy(ring->buf + off, src, first);
+        memcpy(ring->buf, (const uint8_t*)src + first, len - first);
+    }
+}
+
+static void ring_get_bytes(const capture_ring_t* ring, uint64_t pos, void* dst, size_t len) {
+    size_t off = (size_t)(pos & (SOFTBUS_CAPTURE_RING_BYTES - 1));
+    size_t first = SOFTBUS_CAPTURE_RING_BYTES - off;
+    if (first >= len) {
+        memcpy(dst, ring->buf + off, len);
+    } else {
+        memcpy(dst, ring->buf + off, first);
+        memcpy((uint8_t*)dst + first, ring->buf, len - first);
+    }
+}
+
+void softbus_capture_message(const message_t* msg) {
+    if (!msg || !softbus_capture_active()) {
+        return;
+    }
+    capture_ring_t* ring = ring_get();
+    if (!ring) {
+        atomic_fetch_add_explicit(&g_capture.dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    // 与message_queue_send交付给处理函数的负载一致：优先data，否则为content字符串
+    const void* payload = msg->data && msg->data_len > 0 ? msg->data : msg->content;
+    size_t len = msg->data && msg->data_len > 0 ? msg->data_len : strnlen(msg->content, sizeof(msg->content) - 1) + 1;
+
+    softbus_capture_record_t rec = {0};
+    uint64_t now = capture_now_ns();
+    uint64_t start = atomic_load_explicit(&g_capture.start_ns, memory_order_acquire);
+    rec.ts_ns = now > start ? now - start : 0;
+    rec.orig_len = len > UINT32_MAX ? UINT32_MAX : (uint32_t)len;
+    rec.payload_len = len > SOFTBUS_CAPTURE_MAX_PAYLOAD ? SOFTBUS_CAPTURE_MAX_PAYLOAD : (uint32_t)len;
+    rec.flags = rec.payload_len < len ? SOFTBUS_CAPTURE_FLAG_TRUNCATED : 0;
+    rec.target_len = (uint8_t)strnlen(msg->target, sizeof(msg->target));
+    rec.type = (uint8_t)msg->type;
+    rec.priority = (uint8_t)msg->priority;
+
+    size_t total = sizeof(rec) + rec.target_len + rec.payload_len;
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail + total > SOFTBUS_CAPTURE_RING_BYTES) {
+        atomic_fetch_add_explicit(&g_capture.dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    ring_put(ring, head, &rec, sizeof(rec));
+    ring_put(ring, head + sizeof(rec), msg->target, rec.target_len);
+    ring_put(ring, head + sizeof(rec) + rec.target_len, payload, rec.payload_len);
+    atomic_store_explicit(&ring->head, head + total, memory_order_release);
+}
+
+// 按时间戳合并各线程的记录并写入文件；未在抓包时只丢弃缓冲的记录
+static void capture_drain(void) {
+    pthread_mutex_lock(&g_capture.drain_mutex);
+
+    for (;;) {
+        capture_ring_t* oldest = NULL;
+        softbus_capture_record_t oldest_rec;
+        pthread_mutex_lock(&g_capture.rings_mutex);
+        for (capture_ring_t* ring = g_capture.rings; ring; ring = ring->next) {
+            uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+            uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+            if (head == tail) {
+                continue;
+            }
+            softbus_capture_record_t rec;
+            ring_get_bytes(ring, tail, &rec, sizeof(rec));
+            if (!oldest || rec.ts_ns < oldest_rec.ts_ns) {
+                oldest = ring;
+                oldest_rec = rec;
+            }
+        }
+        pthread_mutex_unlock(&g_capture.rings_mutex);
+        if (!oldest) {
+            break;
+        }
+
+        uint64_t tail = atomic_load_explicit(&oldest->tail, memory_order_relaxed);
+        size_t total = sizeof(oldest_rec) + oldest_rec.target_len + oldest_rec.payload_len;
+        if (g_capture.fp) {
+            ring_get_bytes(oldest, tail, g_capture.scratch, total);
+            fwrite(g_capture.scratch, 1, total, g_capture.fp);
+        }
+        atomic_store_explicit(&oldest->tail, tail + total, memory_order_release);
+    }
+
+    // 释放已退出线程的空环
+    pthread_mutex_lock(&g_capture.rings_mutex);
+    capture_ring_t** link = &g_capture.rings;
+    while (*link) {
+        capture_ring_t* ring = *link;
+        if (atomic_load_explicit(&ring->orphaned, memory_order_acquire) &&
+            atomic_load_explicit(&ring->head, memory_order_acquire) ==
+                atomic_load_explicit(&ring->tail, memory_order_relaxed)) {
+            *link = ring->next;
+            free(ring);
+        } else {
+            link = &ring->next;
+        }
+    }
+    pthread_mutex_unlock(&g_capture.rings_mutex);
+
+    pthread_mutex_unlock(&g_capture.drain_mutex);
+}
+
+static void* capture_writer_thread(void* arg) {
+    (void)arg;
+    while (atomic_load_explicit(&g_capture.running, memory_order_acquire)) {
+        capture_drain();
+        usleep(SOFTBUS_CAPTURE_FLUSH_INTERVAL_US);
+    }
+    return NULL;
+}
+
+int softbus_capture_start(const char* path) {
+    if (!path) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_capture.ctl_mutex);
+    if (atomic_load_explicit(&g_capture.running, memory_order_relaxed)) {
+        pthread_mutex_unlock(&g_capture.ctl_mutex);
+        return SOFTBUS_BUSY;
+    }
+
+    FILE* fp = fopen(path, "wb");
+    if (!fp) {
+        SOFTBUS_LOGE("Failed to open capture file: %s\n", path);
+        pthread_mutex_unlock(&g_capture.ctl_mutex);
+        return SOFTBUS_ERROR;
+    }
+
+    struct timespec rt;
+    clock_gettime(CLOCK_REALTIME, &rt);
+    softbus_capture_file_header_t header = {0};
+    memcpy(header.magic, SOFTBUS_CAPTURE_MAGIC, sizeof(header.magic));
+    header.version = SOFTBUS_CAPTURE_VERSION;
+    header.record_header_size = sizeof(softbus_capture_record_t);
+    header.start_realtime_ns = (uint64_t)rt.tv_sec * 1000000000ULL + (uint64_t)rt.tv_nsec;
+    if (fwrite(&header, sizeof(header), 1, fp) != 1) {
+        fclose(fp);
+        pthread_mutex_unlock(&g_capture.ctl_mutex);
+        return SOFTBUS_ERROR;
+    }
+
+    // 上次停止后才写完的记录不属于本次抓包
+    capture_drain();
+
+    pthread_mutex_lock(&g_capture.drain_mutex);
+    g_capture.fp = fp;
+    pthread_mutex_unlock(&g_capture.drain_mutex);
+    atomic_store_explicit(&g_capture.dropped, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_capture.start_ns, capture_now_ns(), memory_order_release);
+
+    atomic_store_explicit(&g_capture.running, true, memory_order_release);
+    if (pthread_create(&g_capture.writer, NULL, capture_writer_thread, NULL) != 0) {
+        atomic_store_explicit(&g_capture.running, false, memory_order_relaxed);
+        pthread_mutex_lock(&g_capture.drain_mutex);
+        g_capture.fp = NULL;
+        pthread_mutex_unlock(&g_capture.drain_mutex);
+        fclose(fp);
+        pthread_mutex_unlock(&g_capture.ctl_mutex);
+        return SOFTBUS_ERROR;
+    }
+    atomic_store_explicit(&g_softbus_capture_active, true, memory_order_release);
+
+    SOFTBUS_LOGI("Traffic capture started: %s\n", path);
+    pthread_mutex_unlock(&g_capture.ctl_mutex);
+    return SOFTBUS_OK;
+}
+
+int softbus_capture_stop(void) {
+    pthread_mutex_lock(&g_capture.ctl_mutex);
+    if (!atomic_load_explicit(&g_capture.running, memory_order_relaxed)) {
+        pthread_mutex_unlock(&g_capture.ctl_mutex);
+        return SOFTBUS_ERROR;
+    }
+
+    atomic_store_explicit(&g_softbus_capture_active, false, memory_order_relaxed);
+    atomic_store_explicit(&g_capture.running, false, memory_order_release);
+    pthread_join(g_capture.writer, NULL);
+    capture_drain();
+
+    pthread_mutex_lock(&g_capture.drain_mutex);
+    int ret = fclose(g_capture.fp) == 0 ? SOFTBUS_OK : SOFTBUS_ERROR;
+    g_capture.fp = NULL;
+    pthread_mutex_unlock(&g_capture.drain_mutex);
+
+    uint64_t dropped = atomic_load_explicit(&g_capture.dropped, memory_order_relaxed);
+    if (dropped) {
+        SOFTBUS_LOGW("Traffic capture dropped %llu messages (buffer full)\n", (unsigned long long)dropped);
+    }
+    SOFTBUS_LOGI("Traffic capture stopped\n");
+    pthread_mutex_unlock(&g_capture.ctl_mutex);
+    return ret;
+}
+
+uint64_t softbus_capture_dropped(void) {
+    return atomic_load_explicit(&g_capture.dropped, memory_order_relaxed);
+}
@@ -0,0 +1,277 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "softbus_discovery.h"
+#include "softbus_socket.h"
+#include "softbus_io.h"
+#include "softbus_wire.h"
+#include "device_manager.h"
+#include "softbus_internal.h"
+
+#if ENABLE_SOCKET_MULTICAST
+
+#define MS_TO_NS(ms) ((uint64_t)(ms) * 1000000ULL)
+#define ANNOUNCE_HDR_SIZE 3   // kind | flags | count
+#define ANNOUNCE_MAX_NAMES 255
+
+// 一条路由：远端设备所在的节点
+typedef struct route_entry {
+    char name[MAX_NAME_LENGTH];
+    uint32_t hash;
+    uint32_t node_id;
+    softbus_node_addr_t node;
+    uint64_t expires_ns;
+    struct route_entry* next;
+} route_entry_t;
+
+static struct {
+    bool initialized;
+    int timer_id;
+    int count;
+    route_entry_t* buckets[DISCOVERY_ROUTE_BUCKETS];
+    pthread_mutex_t mutex;
+} g_routes = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+};
+
+// 内部函数声明
+static void announce_all(void);
+
+static uint32_t name_hash(const char* name) {
+    uint32_t hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    return hash;
+}
+
+static route_entry_t** route_find_locked(const char* name, uint32_t hash) {
+    route_entry_t** link = &g_routes.buckets[hash & (DISCOVERY_ROUTE_BUCKETS - 1)];
+    while (*link) {
+        if ((*link)->hash == hash && strcmp((*link)->name, name) == 0) {
+            return link;
+        }
+        link = &(*link)->next;
+    }
+    return link;
+}
+
+// 插入或刷新路由；设备换了节点时直接改指新节点
+static void route_update_locked(const char* name, uint32_t node_id, const softbus_node_addr_t* node, uint64_t now) {
+    uint32_t hash = name_hash(name);
+    route_entry_t** link = route_find_locked(name, hash);
+    route_entry_t* entry = *link;
+    if (!entry) {
+        if (g_routes.count >= DISCOVERY_MAX_ROUTES) {
+            return;
+        }
+        entry = calloc(1, sizeof(*entry));
+        if (!entry) {
+            return;
+        }
+        strncpy(entry->name, name, MAX_NAME_LENGTH - 1);
+        entry->hash = hash;
+        *link = entry;
+        g_routes.count++;
+    }
+    entry->node_id = node_id;
+    entry->node = *node;
+    entry->expires_ns = now + MS_TO_NS(DISCOVERY_ROUTE_TTL_MS);
+}
+
+// 撤销路由，只删除由发出撤销的节点所拥有的条目
+static void route_withdraw_locked(const char* name, uint32_t node_id) {
+    route_entry_t** link = route_find_locked(name, name_hash(name));
+    route_entry_t* entry = *link;
+    if (entry && entry->node_id == node_id) {
+        *link = entry->next;
+        free(entry);
+        g_routes.count--;
+    }
+}
+
+// 淘汰过期路由
+static void route_expire(uint64_t now) {
+    pthread_mutex_lock(&g_routes.mutex);
+    for (int i = 0; i < DISCOVERY_ROUTE_BUCKETS; i++) {
+        route_entry_t** link = &g_routes.buckets[i];
+        while (*link) {
+            route_entry_t* entry = *link;
+            if (entry->expires_ns <= now) {
+                *link = entry->next;
+                free(entry);
+                g_routes.count--;
+            } else {
+                link = &entry->next;
+            }
+        }
+    }
+    pthread_mutex_unlock(&g_routes.mutex);
+}
+
+static void route_clear(void) {
+    pthread_mutex_lock(&g_routes.mutex);
+    for (int i = 0; i < DISCOVERY_ROUTE_BUCKETS; i++) {
+        route_entry_t* entry = g_routes.buckets[i];
+        while (entry) {
+            route_entry_t* next = entry->next;
+            free(entry);
+            entry = next;
+        }
+        g_routes.buckets[i] = NULL;
+    }
+    g_routes.count = 0;
+    pthread_mutex_unlock(&g_routes.mutex);
+}
+
+// 按数据报大小分批发送设备名列表
+static void send_announce(uint8_t flags, char names[][MAX_NAME_LENGTH], int count) {
+    uint8_t buf[DISCOVERY_ANNOUNCE_MAX_BYTES];
+    int i = 0;
+    do {
+        size_t len = ANNOUNCE_HDR_SIZE;
+        int n = 0;
+        while (i < count && n < ANNOUNCE_MAX_NAMES) {
+            size_t name_len = strlen(names[i]);
+            if (len + 1 + name_len > sizeof(buf)) {
+                break;
+            }
+            buf[len] = (uint8_t)name_len;
+            memcpy(buf + len + 1, names[i], name_len);
+            len += 1 + name_len;
+            n++;
+            i++;
+        }
+        buf[0] = SOFTBUS_WIRE_CTRL_ANNOUNCE;
+        buf[1] = flags;
+        buf[2] = (uint8_t)n;
+        socket_send_control(NULL, buf, len);
+    } while (i < count);
+}
+
+// 名称表随MAX_DEVICES增长（默认256KB），不放在IO线程的栈上
+static void announce_all(void) {
+    char (*names)[MAX_NAME_LENGTH] = malloc((size_t)MAX_DEVICES * MAX_NAME_LENGTH);
+    if (!names) {
+        return;
+    }
+    int count = device_manager_get_names(names, MAX_DEVICES);
+    if (count > 0) {
+        send_announce(0, names, count);
+    }
+    free(names);
+}
+
+// 收到其他节点的通告，在IO线程中执行
+static void handle_announce(uint32_t node_id, const softbus_node_addr_t* sender, const uint8_t* body, size_t len) {
+    if (len < ANNOUNCE_HDR_SIZE || body[0] != SOFTBUS_WIRE_CTRL_ANNOUNCE) {
+        return;
+    }
+    uint8_t flags = body[1];
+    int count = body[2];
+    uint64_t now = softbus_io_now_ns();
+
+    pthread_mutex_lock(&g_routes.mutex);
+    size_t offset = ANNOUNCE_HDR_SIZE;
+    for (int i = 0; i < count && offset < len; i++) {
+        size_t name_len = body[offset];
+        if (name_len == 0 || name_len >= MAX_NAME_LENGTH || offset + 1 + name_len > len) {
+            break;
+        }
+        char name[MAX_NAME_LENGTH];
+        memcpy(name, body + offset + 1, name_len);
+        name[name_len] = '\0';
+        offset += 1 + name_len;
+
+        if (flags & SOFTBUS_WIRE_ANNOUNCE_WITHDRAW) {
+            route_withdraw_locked(name, node_id);
+        } else {
+            route_update_locked(name, node_id, sender, now);
+        }
+    }
+    pthread_mutex_unlock(&g_routes.mutex);
+
+    // 新节点请求通告，立即回复全量列表
+    if (flags & SOFTBUS_WIRE_ANNOUNCE_SOLICIT) {
+        announce_all();
+    }
+}
+
+// 周期定时器：发送全量通告并淘汰过期路由
+static void discovery_tick(void* ctx) {
+    (void)ctx;
+    announce_all();
+    route_expire(softbus_io_now_ns());
+}
+
+int discovery_init(void) {
+    if (g_routes.initialized) {
+        return SOFTBUS_OK;
+    }
+
+    socket_set_control_handler(handle_announce);
+    uint64_t interval_us = (uint64_t)DISCOVERY_ANNOUNCE_INTERVAL_MS * 1000ULL;
+    int id = softbus_io_timer_add(interval_us, interval_us, discovery_tick, NULL);
+    if (id <= 0) {
+        socket_set_control_handler(NULL);
+        return SOFTBUS_ERROR;
+    }
+    g_routes.timer_id = id;
+    g_routes.initialized = true;
+
+    // 通告已有设备，同时请求其他节点立即通告；分配失败时由周期通告补上
+    char (*names)[MAX_NAME_LENGTH] = malloc((size_t)MAX_DEVICES * MAX_NAME_LENGTH);
+    if (names) {
+        int count = device_manager_get_names(names, MAX_DEVICES);
+        send_announce(SOFTBUS_WIRE_ANNOUNCE_SOLICIT, names, count);
+        free(names);
+    }
+    return SOFTBUS_OK;
+}
+
+void discovery_deinit(void) {
+    if (!g_routes.initialized) {
+        return;
+    }
+    g_routes.initialized = false;
+    softbus_io_timer_cancel(g_routes.timer_id);
+    g_routes.timer_id = 0;
+    socket_set_control_handler(NULL);
+    route_clear();
+}
+
+void discovery_device_changed(const char* device_name, bool registered) {
+    if (!device_name || !g_routes.initialized) {
+        return;
+    }
+    char names[1][MAX_NAME_LENGTH];
+    strncpy(names[0], device_name, MAX_NAME_LENGTH - 1);
+    names[0][MAX_NAME_LENGTH - 1] = '\0';
+    send_announce(registered ? 0 : SOFTBUS_WIRE_ANNOUNCE_WITHDRAW, names, 1);
+}
+
+int discovery_lookup(const char* device_name, softbus_node_addr_t* node) {
+    if (!device_name || !node) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    int ret = SOFTBUS_NOT_FOUND;
+    pthread_mutex_lock(&g_routes.mutex);
+    route_entry_t* entry = *route_find_locked(device_name, name_hash(device_name));
+    if (entry && entry->expires_ns > softbus_io_now_ns()) {
+        *node = entry->node;
+        ret = SOFTBUS_OK;
+    }
+    pthread_mutex_unlock(&g_routes.mutex);
+    return ret;
+}
+
+int discovery_route_count(void) {
+    pthread_mutex_lock(&g_routes.mutex);
+    int count = g_routes.count;
+    pthread_mutex_unlock(&g_routes.mutex);
+    return count;
+}
+
+#endif // ENABLE_SOCKET_MULTICAST
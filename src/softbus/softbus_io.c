@@ -0,0 +1,691 @@
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#ifdef _WIN32
+#include <winsock2.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#endif
+#include <time.h>
+#include "softbus_io.h"
+
+#define IO_MAX_EVENTS 32
+
+// fd注册项
+typedef struct {
+    int fd;
+    uint32_t events;
+    softbus_io_handler_t handler;
+    void* ctx;
+    bool in_use;
+} io_entry_t;
+
+// 刷新回调注册项
+typedef struct {
+    softbus_io_flush_t fn;
+    void* ctx;
+} io_flush_entry_t;
+
+// 定时器注册项
+typedef struct {
+    int id;
+    uint64_t deadline_ns;
+    uint64_t interval_ns;
+    softbus_io_flush_t fn;
+    void* ctx;
+    bool in_use;
+    bool firing;    // 单次定时器已到期、回调尚未返回，仍占用槽位以便取消时等待
+} io_timer_t;
+
+// IO引擎状态
+static struct {
+    int epoll_fd;
+    int wake_fd;
+    int timer_fd;
+    io_entry_t entries[SOFTBUS_IO_MAX_FDS];
+    io_flush_entry_t flush_handlers[SOFTBUS_IO_MAX_FLUSH_HANDLERS];
+    int flush_count;
+    io_timer_t timers[SOFTBUS_IO_MAX_TIMERS];
+    int next_timer_id;
+    // 正在IO线程中执行的fd回调和定时器，删除/取消时等待其返回，受mutex保护
+    int dispatching_fd;
+    int running_timer_id;
+    pthread_cond_t idle_cond;
+    pthread_mutex_t mutex;
+    pthread_t thread;
+    _Atomic int running;
+    volatile int flush_pending;
+    // 生命周期由lifecycle保护：多个传输模块共享同一个IO引擎，init/deinit和start/stop各自按引用计数
+    pthread_mutex_t lifecycle;
+    int refcount;
+    int start_count;
+    bool initialized;   // 同时持有lifecycle和mutex才修改，持有任一即可读取
+} g_io = {
+    .epoll_fd = -1,
+    .wake_fd = -1,
+    .timer_fd = -1,
+    .dispatching_fd = -1,
+    .idle_cond = PTHREAD_COND_INITIALIZER,
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .lifecycle = PTHREAD_MUTEX_INITIALIZER,
+};
+
+// 内部函数声明
+static io_entry_t* find_entry(int fd);
+static io_timer_t* find_timer_locked(int timer_id);
+static void run_flush_handlers(void);
+static void run_timers(void);
+static void arm_timer_locked(void);
+static void stop_thread_locked(void);
+static void* io_loop_thread(void* arg);
+
+int softbus_io_set_nonblocking(int fd) {
+#ifdef _WIN32
+    u_long mode = 1;
+    return ioctlsocket(fd, FIONBIO, &mode) == 0 ? SOFTBUS_OK : SOFTBUS_ERROR;
+#else
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        return SOFTBUS_ERROR;
+    }
+    return SOFTBUS_OK;
+#endif
+}
+
+int softbus_io_init(void) {
+    pthread_mutex_lock(&g_io.lifecycle);
+    if (g_io.initialized) {
+        g_io.refcount++;
+        pthread_mutex_unlock(&g_io.lifecycle);
+        return SOFTBUS_OK;
+    }
+
+    memset(g_io.entries, 0, sizeof(g_io.entries));
+    memset(g_io.flush_handlers, 0, sizeof(g_io.flush_handlers));
+    memset(g_io.timers, 0, sizeof(g_io.timers));
+    g_io.flush_count = 0;
+    g_io.next_timer_id = 0;
+    g_io.dispatching_fd = -1;
+    g_io.running_timer_id = 0;
+    g_io.running = 0;
+    g_io.flush_pending = 0;
+    g_io.start_count = 0;
+
+#ifndef _WIN32
+    g_io.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (g_io.epoll_fd < 0) {
+        perror("Failed to create epoll instance");
+        pthread_mutex_unlock(&g_io.lifecycle);
+        return SOFTBUS_ERROR;
+    }
+
+    // eventfd用于停止和刷新唤醒
+    g_io.wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (g_io.wake_fd < 0) {
+        perror("Failed to create eventfd");
+        close(g_io.epoll_fd);
+        g_io.epoll_fd = -1;
+        pthread_mutex_unlock(&g_io.lifecycle);
+        return SOFTBUS_ERROR;
+    }
+
+    struct epoll_event ev = {0};
+    ev.events = EPOLLIN;
+    ev.data.fd = g_io.wake_fd;
+    if (epoll_ctl(g_io.epoll_fd, EPOLL_CTL_ADD, g_io.wake_fd, &ev) < 0) {
+        perror("Failed to register eventfd");
+        close(g_io.wake_fd);
+        close(g_io.epoll_fd);
+        g_io.wake_fd = -1;
+        g_io.epoll_fd = -1;
+        pthread_mutex_unlock(&g_io.lifecycle);
+        return SOFTBUS_ERROR;
+    }
+
+    // timerfd提供微秒级定时器精度
+    g_io.timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    ev.events = EPOLLIN;
+    ev.data.fd = g_io.timer_fd;
+    if (g_io.timer_fd < 0 || epoll_ctl(g_io.epoll_fd, EPOLL_CTL_ADD, g_io.timer_fd, &ev) < 0) {
+        perror("Failed to create timerfd");
+        if (g_io.timer_fd >= 0) {
+            close(g_io.timer_fd);
+        }
+        close(g_io.wake_fd);
+        close(g_io.epoll_fd);
+        g_io.timer_fd = -1;
+        g_io.wake_fd = -1;
+        g_io.epoll_fd = -1;
+        pthread_mutex_unlock(&g_io.lifecycle);
+        return SOFTBUS_ERROR;
+    }
+#endif
+
+    pthread_mutex_lock(&g_io.mutex);
+    g_io.initialized = true;
+    pthread_mutex_unlock(&g_io.mutex);
+    g_io.refcount = 1;
+    pthread_mutex_unlock(&g_io.lifecycle);
+    return SOFTBUS_OK;
+}
+
+void softbus_io_deinit(void) {
+    pthread_mutex_lock(&g_io.lifecycle);
+    if (!g_io.initialized || --g_io.refcount > 0) {
+        pthread_mutex_unlock(&g_io.lifecycle);
+        return;
+    }
+
+    // 最后一个使用者离开，不论还有多少次start未配对都停止线程
+    stop_thread_locked();
+
+    pthread_mutex_lock(&g_io.mutex);
+    g_io.initialized = false;
+    pthread_mutex_unlock(&g_io.mutex);
+
+#ifndef _WIN32
+    if (g_io.timer_fd >= 0) {
+        close(g_io.timer_fd);
+        g_io.timer_fd = -1;
+    }
+    if (g_io.wake_fd >= 0) {
+        close(g_io.wake_fd);
+        g_io.wake_fd = -1;
+    }
+    if (g_io.epoll_fd >= 0) {
+        close(g_io.epoll_fd);
+        g_io.epoll_fd = -1;
+    }
+#endif
+    pthread_mutex_unlock(&g_io.lifecycle);
+}
+
+int softbus_io_start(void) {
+    pthread_mutex_lock(&g_io.lifecycle);
+    if (!g_io.initialized) {
+        pthread_mutex_unlock(&g_io.lifecycle);
+        return SOFTBUS_ERROR;
+    }
+    if (g_io.start_count++ > 0) {
+        pthread_mutex_unlock(&g_io.lifecycle);
+        return SOFTBUS_OK;  // 已经在运行
+    }
+
+    g_io.running = 1;
+    if (pthread_create(&g_io.thread, NULL, io_loop_thread, NULL) != 0) {
+        perror("Failed to create io thread");
+        g_io.running = 0;
+        g_io.start_count = 0;
+        pthread_mutex_unlock(&g_io.lifecycle);
+        return SOFTBUS_ERROR;
+    }
+
+    pthread_mutex_unlock(&g_io.lifecycle);
+    return SOFTBUS_OK;
+}
+
+void softbus_io_stop(void) {
+    pthread_mutex_lock(&g_io.lifecycle);
+    if (g_io.start_count > 0 && --g_io.start_count == 0) {
+        stop_thread_locked();
+    }
+    pthread_mutex_unlock(&g_io.lifecycle);
+}
+
+int softbus_io_add_fd(int fd, uint32_t events, softbus_io_handler_t handler, void* ctx) {
+    if (fd < 0 || !handler) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    if (softbus_io_set_nonblocking(fd) != SOFTBUS_OK) {
+        return SOFTBUS_ERROR;
+    }
+
+    pthread_mutex_lock(&g_io.mutex);
+    if (!g_io.initialized) {
+        pthread_mutex_unlock(&g_io.mutex);
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    if (find_entry(fd)) {
+        pthread_mutex_unlock(&g_io.mutex);
+        return SOFTBUS_ERROR;
+    }
+
+    io_entry_t* entry = NULL;
+    for (int i = 0; i < SOFTBUS_IO_MAX_FDS; i++) {
+        if (!g_io.entries[i].in_use) {
+            entry = &g_io.entries[i];
+            break;
+        }
+    }
+    if (!entry) {
+        pthread_mutex_unlock(&g_io.mutex);
+        return SOFTBUS_BUSY;
+    }
+
+#ifndef _WIN32
+    struct epoll_event ev = {0};
+    ev.events = ((events & SOFTBUS_IO_READ) ? EPOLLIN : 0) | ((events & SOFTBUS_IO_WRITE) ? EPOLLOUT : 0);
+    ev.data.fd = fd;
+    if (epoll_ctl(g_io.epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        perror("Failed to add fd to epoll");
+        pthread_mutex_unlock(&g_io.mutex);
+        return SOFTBUS_ERROR;
+    }
+#endif
+
+    entry->fd = fd;
+    entry->events = events;
+    entry->handler = handler;
+    entry->ctx = ctx;
+    entry->in_use = true;
+
+    pthread_mutex_unlock(&g_io.mutex);
+    return SOFTBUS_OK;
+}
+
+int softbus_io_mod_fd(int fd, uint32_t events) {
+    pthread_mutex_lock(&g_io.mutex);
+
+    io_entry_t* entry = find_entry(fd);
+    if (!entry) {
+        pthread_mutex_unlock(&g_io.mutex);
+        return SOFTBUS_NOT_FOUND;
+    }
+
+#ifndef _WIN32
+    struct epoll_event ev = {0};
+    ev.events = ((events & SOFTBUS_IO_READ) ? EPOLLIN : 0) | ((events & SOFTBUS_IO_WRITE) ? EPOLLOUT : 0);
+    ev.data.fd = fd;
+    if (epoll_ctl(g_io.epoll_fd, EPOLL_CTL_MOD, fd, &ev) < 0) {
+        pthread_mutex_unlock(&g_io.mutex);
+        return SOFTBUS_ERROR;
+    }
+#endif
+
+    entry->events = events;
+    pthread_mutex_unlock(&g_io.mutex);
+    return SOFTBUS_OK;
+}
+
+int softbus_io_del_fd(int fd) {
+    pthread_mutex_lock(&g_io.mutex);
+
+    io_entry_t* entry = find_entry(fd);
+    if (!entry) {
+        pthread_mutex_unlock(&g_io.mutex);
+        return SOFTBUS_NOT_FOUND;
+    }
+
+#ifndef _WIN32
+    epoll_ctl(g_io.epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+#endif
+    memset(entry, 0, sizeof(*entry));
+
+    // 等待进行中的回调返回，之后调用者可以安全关闭fd、释放ctx；回调自己删除时不等待
+    if (!softbus_io_in_loop_thread()) {
+        while (g_io.dispatching_fd == fd) {
+            pthread_cond_wait(&g_io.idle_cond, &g_io.mutex);
+        }
+    }
+
+    pthread_mutex_unlock(&g_io.mutex);
+    return SOFTBUS_OK;
+}
+
+int softbus_io_add_flush_handler(softbus_io_flush_t fn, void* ctx) {
+    if (!fn) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_io.mutex);
+    if (g_io.flush_count >= SOFTBUS_IO_MAX_FLUSH_HANDLERS) {
+        pthread_mutex_unlock(&g_io.mutex);
+        return SOFTBUS_BUSY;
+    }
+    g_io.flush_handlers[g_io.flush_count].fn = fn;
+    g_io.flush_handlers[g_io.flush_count].ctx = ctx;
+    g_io.flush_count++;
+    pthread_mutex_unlock(&g_io.mutex);
+    return SOFTBUS_OK;
+}
+
+void softbus_io_remove_flush_handler(softbus_io_flush_t fn, void* ctx) {
+    pthread_mutex_lock(&g_io.mutex);
+    for (int i = 0; i < g_io.flush_count; i++) {
+        if (g_io.flush_handlers[i].fn == fn && g_io.flush_handlers[i].ctx == ctx) {
+            // 移动回调列表以填补空缺
+            for (int j = i; j < g_io.flush_count - 1; j++) {
+                g_io.flush_handlers[j] = g_io.flush_handlers[j + 1];
+            }
+            g_io.flush_count--;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_io.mutex);
+}
+
+int softbus_io_timer_add(uint64_t delay_us, uint64_t interval_us, softbus_io_flush_t fn, void* ctx) {
+    if (!fn) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_io.mutex);
+    if (!g_io.initialized) {
+        pthread_mutex_unlock(&g_io.mutex);
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    io_timer_t* timer = NULL;
+    for (int i = 0; i < SOFTBUS_IO_MAX_TIMERS; i++) {
+        if (!g_io.timers[i].in_use) {
+            timer = &g_io.timers[i];
+            break;
+        }
+    }
+    if (!timer) {
+        pthread_mutex_unlock(&g_io.mutex);
+        return SOFTBUS_BUSY;
+    }
+
+    // 定时器ID单调递增，避免取消已复用的槽位
+    g_io.next_timer_id = (g_io.next_timer_id + 1) & 0x7fffffff;
+    timer->id = g_io.next_timer_id;
+    timer->deadline_ns = softbus_io_now_ns() + delay_us * 1000ULL;
+    timer->interval_ns = interval_us * 1000ULL;
+    timer->fn = fn;
+    timer->ctx = ctx;
+    timer->in_use = true;
+    arm_timer_locked();
+
+    int id = timer->id;
+    pthread_mutex_unlock(&g_io.mutex);
+    return id;
+}
+
+void softbus_io_timer_cancel(int timer_id) {
+    if (timer_id <= 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&g_io.mutex);
+    io_timer_t* timer = find_timer_locked(timer_id);
+    if (timer) {
+        memset(timer, 0, sizeof(*timer));
+        arm_timer_locked();
+    }
+    // 回调可能正在执行，等待其返回后调用者才能释放ctx；回调中取消自己时不等待
+    if (!softbus_io_in_loop_thread()) {
+        while (g_io.running_timer_id == timer_id) {
+            pthread_cond_wait(&g_io.idle_cond, &g_io.mutex);
+        }
+    }
+    pthread_mutex_unlock(&g_io.mutex);
+}
+
+uint64_t softbus_io_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void softbus_io_wakeup(void) {
+    g_io.flush_pending = 1;
+#ifndef _WIN32
+    if (g_io.wake_fd >= 0) {
+        uint64_t one = 1;
+        ssize_t ret = write(g_io.wake_fd, &one, sizeof(one));
+        (void)ret;  // 计数溢出(EAGAIN)时线程必然已处于待唤醒状态
+    }
+#endif
+}
+
+bool softbus_io_in_loop_thread(void) {
+    return g_io.running && pthread_equal(pthread_self(), g_io.thread);
+}
+
+// 内部函数实现
+
+// 停止IO线程，调用者需持有lifecycle
+static void stop_thread_locked(void) {
+    g_io.start_count = 0;
+    if (!g_io.running) {
+        return;
+    }
+
+    g_io.running = 0;
+    softbus_io_wakeup();
+    if (!pthread_equal(pthread_self(), g_io.thread)) {
+        pthread_join(g_io.thread, NULL);
+    }
+}
+
+static io_entry_t* find_entry(int fd) {
+    for (int i = 0; i < SOFTBUS_IO_MAX_FDS; i++) {
+        if (g_io.entries[i].in_use && g_io.entries[i].fd == fd) {
+            return &g_io.entries[i];
+        }
+    }
+    return NULL;
+}
+
+static io_timer_t* find_timer_locked(int timer_id) {
+    for (int i = 0; i < SOFTBUS_IO_MAX_TIMERS; i++) {
+        if (g_io.timers[i].in_use && g_io.timers[i].id == timer_id) {
+            return &g_io.timers[i];
+        }
+    }
+    return NULL;
+}
+
+static void run_flush_handlers(void) {
+    io_flush_entry_t handlers[SOFTBUS_IO_MAX_FLUSH_HANDLERS];
+    int count;
+
+    g_io.flush_pending = 0;
+
+    pthread_mutex_lock(&g_io.mutex);
+    count = g_io.flush_count;
+    memcpy(handlers, g_io.flush_handlers, sizeof(handlers[0]) * count);
+    pthread_mutex_unlock(&g_io.mutex);
+
+    for (int i = 0; i < count; i++) {
+        handlers[i].fn(handlers[i].ctx);
+    }
+}
+
+// 按最早的截止时间设置timerfd，调用者需持有锁
+static void arm_timer_locked(void) {
+#ifndef _WIN32
+    uint64_t earliest = 0;
+    for (int i = 0; i < SOFTBUS_IO_MAX_TIMERS; i++) {
+        if (g_io.timers[i].in_use && !g_io.timers[i].firing &&
+            (earliest == 0 || g_io.timers[i].deadline_ns < earliest)) {
+            earliest = g_io.timers[i].deadline_ns;
+        }
+    }
+
+    // it_value全零表示解除定时
+    struct itimerspec its = {0};
+    if (earliest != 0) {
+        its.it_value.tv_sec = earliest / 1000000000ULL;
+        its.it_value.tv_nsec = earliest % 1000000000ULL;
+        if (its.it_value.tv_sec == 0 && its.it_value.tv_nsec == 0) {
+            its.it_value.tv_nsec = 1;
+        }
+    }
+    timerfd_settime(g_io.timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+#endif
+}
+
+// 执行到期的定时器，周期定时器重新计算截止时间
+static void run_timers(void) {
+    io_timer_t due[SOFTBUS_IO_MAX_TIMERS];
+    int due_count = 0;
+    uint64_t now = softbus_io_now_ns();
+
+    pthread_mutex_lock(&g_io.mutex);
+    for (int i = 0; i < SOFTBUS_IO_MAX_TIMERS; i++) {
+        io_timer_t* timer = &g_io.timers[i];
+        if (!timer->in_use || timer->firing || timer->deadline_ns > now) {
+            continue;
+        }
+        due[due_count++] = *timer;
+        if (timer->interval_ns > 0) {
+            timer->deadline_ns = now + timer->interval_ns;
+        } else {
+            timer->firing = true;
+        }
+    }
+    arm_timer_locked();
+
+    // 逐个执行，执行期间记录ID供取消时等待；前面的回调中已被取消的跳过
+    for (int i = 0; i < due_count; i++) {
+        io_timer_t* timer = find_timer_locked(due[i].id);
+        if (!timer) {
+            continue;
+        }
+        g_io.running_timer_id = due[i].id;
+        pthread_mutex_unlock(&g_io.mutex);
+        due[i].fn(due[i].ctx);
+        pthread_mutex_lock(&g_io.mutex);
+        g_io.running_timer_id = 0;
+        // 回调中取消自己时槽位已被清空或复用，按ID重新查找
+        timer = find_timer_locked(due[i].id);
+        if (timer && timer->firing) {
+            memset(timer, 0, sizeof(*timer));
+        }
+        pthread_cond_broadcast(&g_io.idle_cond);
+    }
+    pthread_mutex_unlock(&g_io.mutex);
+}
+
+// 按fd查找回调并在锁外执行，允许回调中增删fd；执行期间记录fd，删除时据此等待
+static void dispatch_fd(int fd, uint32_t events) {
+    pthread_mutex_lock(&g_io.mutex);
+    io_entry_t* entry = find_entry(fd);
+    if (!entry) {
+        pthread_mutex_unlock(&g_io.mutex);
+        return;
+    }
+    softbus_io_handler_t handler = entry->handler;
+    void* ctx = entry->ctx;
+    g_io.dispatching_fd = fd;
+    pthread_mutex_unlock(&g_io.mutex);
+
+    handler(fd, events, ctx);
+
+    pthread_mutex_lock(&g_io.mutex);
+    g_io.dispatching_fd = -1;
+    pthread_cond_broadcast(&g_io.idle_cond);
+    pthread_mutex_unlock(&g_io.mutex);
+}
+
+#ifndef _WIN32
+
+// IO线程函数：一个线程服务所有已注册的socket
+static void* io_loop_thread(void* arg) {
+    (void)arg;
+    struct epoll_event events[IO_MAX_EVENTS];
+
+    while (g_io.running) {
+        int n = epoll_wait(g_io.epoll_fd, events, IO_MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("epoll_wait failed");
+            break;
+        }
+
+        bool woken = false;
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            if (fd == g_io.wake_fd) {
+                uint64_t count;
+                while (read(g_io.wake_fd, &count, sizeof(count)) > 0) {
+                }
+                woken = true;
+                continue;
+            }
+            if (fd == g_io.timer_fd) {
+                uint64_t expirations;
+                while (read(g_io.timer_fd, &expirations, sizeof(expirations)) > 0) {
+                }
+                run_timers();
+                continue;
+            }
+
+            uint32_t ev = 0;
+            if (events[i].events & EPOLLIN) ev |= SOFTBUS_IO_READ;
+            if (events[i].events & EPOLLOUT) ev |= SOFTBUS_IO_WRITE;
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) ev |= SOFTBUS_IO_ERROR;
+            dispatch_fd(fd, ev);
+        }
+
+        if (woken && g_io.running) {
+            run_flush_handlers();
+        }
+    }
+
+    return NULL;
+}
+
+#else
+
+// Windows下没有epoll/eventfd，使用select轮询，唤醒标志在超时后检查
+static void* io_loop_thread(void* arg) {
+    (void)arg;
+
+    while (g_io.running) {
+        fd_set rfds, wfds;
+        FD_ZERO(&rfds);
+        FD_ZERO(&wfds);
+        int fds[SOFTBUS_IO_MAX_FDS];
+        int nfds = 0;
+
+        pthread_mutex_lock(&g_io.mutex);
+        for (int i = 0; i < SOFTBUS_IO_MAX_FDS; i++) {
+            if (!g_io.entries[i].in_use) {
+                continue;
+            }
+            if (g_io.entries[i].events & SOFTBUS_IO_READ) FD_SET(g_io.entries[i].fd, &rfds);
+            if (g_io.entries[i].events & SOFTBUS_IO_WRITE) FD_SET(g_io.entries[i].fd, &wfds);
+            fds[nfds++] = g_io.entries[i].fd;
+        }
+        pthread_mutex_unlock(&g_io.mutex);
+
+        int n = 0;
+        if (nfds > 0) {
+            struct timeval tv = {0, 10000};
+            n = select(0, &rfds, &wfds, NULL, &tv);
+        } else {
+            Sleep(10);
+        }
+        for (int i = 0; n > 0 && i < nfds; i++) {
+            uint32_t ev = 0;
+            if (FD_ISSET(fds[i], &rfds)) ev |= SOFTBUS_IO_READ;
+            if (FD_ISSET(fds[i], &wfds)) ev |= SOFTBUS_IO_WRITE;
+            if (ev) {
+                dispatch_fd(fds[i], ev);
+            }
+        }
+
+        run_timers();
+        if (g_io.flush_pending && g_io.running) {
+            run_flush_handlers();
+        }
+    }
+
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include "softbus_lock.h"
+
+#if ENABLE_LOCK_STATS
+
+// 已登记的加锁位置，只增不减（统计项是各调用位置的静态变量）
+static struct {
+    softbus_lock_site_t* sites;
+    pthread_mutex_t mutex;
+} g_lock_stats = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static uint64_t lock_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void update_max(_Atomic uint64_t* max, uint64_t value) {
+    uint64_t cur = atomic_load_explicit(max, memory_order_relaxed);
+    while (value > cur &&
+           !atomic_compare_exchange_weak_explicit(max, &cur, value, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+static void site_register(softbus_lock_t* lock, softbus_lock_site_t* site) {
+    pthread_mutex_lock(&g_lock_stats.mutex);
+    if (!atomic_load_explicit(&site->registered, memory_order_relaxed)) {
+        site->lock_name = lock->name ? lock->name : "?";
+        site->next = g_lock_stats.sites;
+        g_lock_stats.sites = site;
+        atomic_store_explicit(&site->registered, true, memory_order_release);
+    }
+    pthread_mutex_unlock(&g_lock_stats.mutex);
+}
+
+void softbus_lock_acquire(softbus_lock_t* lock, softbus_lock_site_t* site) {
+    if (!atomic_load_explicit(&site->registered, memory_order_acquire)) {
+        site_register(lock, site);
+    }
+
+    if (pthread_mutex_trylock(&lock->mutex) == EBUSY) {
+        uint64_t start = lock_now_ns();
+        pthread_mutex_lock(&lock->mutex);
+        lock->acquired_ns = lock_now_ns();
+        uint64_t wait = lock->acquired_ns - start;
+        atomic_fetch_add_explicit(&site->contended, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&site->wait_ns_total, wait, memory_order_relaxed);
+        update_max(&site->wait_ns_max, wait);
+    } else {
+        lock->acquired_ns = lock_now_ns();
+    }
+    atomic_fetch_add_explicit(&site->acquisitions, 1, memory_order_relaxed);
+    lock->owner_site = site;
+}
+
+void softbus_lock_release(softbus_lock_t* lock) {
+    softbus_lock_site_t* site = lock->owner_site;
+    uint64_t hold = lock_now_ns() - lock->acquired_ns;
+    lock->owner_site = NULL;
+    pthread_mutex_unlock(&lock->mutex);
+
+    if (site) {
+        atomic_fetch_add_explicit(&site->hold_ns_total, hold, memory_order_relaxed);
+        update_max(&site->hold_ns_max, hold);
+    }
+}
+
+int softbus_lock_get_stats(softbus_lock_stats_t* stats, int max_count) {
+    if (!stats || max_count <= 0) {
+        return 0;
+    }
+
+    int count = 0;
+    pthread_mutex_lock(&g_lock_stats.mutex);
+    for (softbus_lock_site_t* site = g_lock_stats.sites; site && count < max_count; site = site->next) {
+        softbus_lock_stats_t* s = &stats[count++];
+        const char* file = strrchr(site->file, '/');
+        snprintf(s->lock, sizeof(s->lock), "%s", site->lock_name);
+        snprintf(s->site, sizeof(s->site), "%s:%d", file ? file + 1 : site->file, site->line);
+        s->acquisitions = atomic_load_explicit(&site->acquisitions, memory_order_relaxed);
+        s->contended = atomic_load_explicit(&site->contended, memory_order_relaxed);
+        s->wait_ns_total = atomic_load_explicit(&site->wait_ns_total, memory_order_relaxed);
+        s->wait_ns_max = atomic_load_explicit(&site->wait_ns_max, memory_order_relaxed);
+        s->hold_ns_total = atomic_load_explicit(&site->hold_ns_total, memory_order_relaxed);
+        s->hold_ns_max = atomic_load_explicit(&site->hold_ns_max, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&g_lock_stats.mutex);
+    return count;
+}
+
+void softbus_lock_reset_stats(void) {
+    pthread_mutex_lock(&g_lock_stats.mutex);
+    for (softbus_lock_site_t* site = g_lock_stats.sites; site; site = site->next) {
+        atomic_store_explicit(&site->acquisitions, 0, memory_order_relaxed);
+        atomic_store_explicit(&site->contended, 0, memory_order_relaxed);
+        atomic_store_explicit(&site->wait_ns_total, 0, memory_order_relaxed);
+        atomic_store_explicit(&site->wait_ns_max, 0, memory_order_relaxed);
+        atomic_store_explicit(&site->hold_ns_total, 0, memory_order_relaxed);
+        atomic_store_explicit(&site->hold_ns_max, 0, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&g_lock_stats.mutex);
+}
+
+#else
+
+int softbus_lock_get_stats(softbus_lock_stats_t* stats, int max_count) {
+    (void)stats;
+    (void)max_count;
+    return 0;
+}
+
+void softbus_lock_reset_stats(void) {
+}
+
+#endif // ENABLE_LOCK_STATS
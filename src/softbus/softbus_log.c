@@ -0,0 +1,339 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include "softbus_log.h"
+
+// 一条日志记录：只保存格式串指针和参数原始值，字符串参数复制到strs中
+typedef struct {
+    uint64_t ts_ns;
+    const char* fmt;
+    uint8_t level;
+    uint8_t nargs;
+    softbus_log_arg_t args[SOFTBUS_LOG_MAX_ARGS];
+    char strs[SOFTBUS_LOG_STR_SPACE];
+} log_record_t;
+
+// 每个线程一个单生产者单消费者环：生产者为所属线程，消费者为持有drain_mutex的线程
+typedef struct log_ring {
+    _Atomic uint32_t head;      // 生产者写入位置
+    _Atomic uint32_t tail;      // 消费者读取位置
+    _Atomic bool orphaned;      // 所属线程已退出，读空后释放
+    struct log_ring* next;
+    log_record_t records[SOFTBUS_LOG_RING_SIZE];
+} log_ring_t;
+
+_Atomic int g_softbus_log_level = SOFTBUS_LOG_MIN_LEVEL;
+
+static struct {
+    pthread_once_t once;
+    pthread_key_t key;
+    log_ring_t* rings;          // 所有线程的环，新环插入表头
+    pthread_mutex_t rings_mutex;
+    pthread_mutex_t drain_mutex;
+    FILE* output;
+    _Atomic uint64_t dropped;
+    uint64_t dropped_reported;
+    pthread_t writer;
+    bool writer_started;
+} g_log = {
+    .once = PTHREAD_ONCE_INIT,
+    .rings_mutex = PTHREAD_MUTEX_INITIALIZER,
+    .drain_mutex = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static __thread log_ring_t* t_ring;
+
+static const char* const g_level_names[] = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR"};
+
+// 内部函数声明
+static void* log_writer_thread(void* arg);
+static void log_drain(void);
+
+static uint64_t log_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void ring_thread_exit(void* ring) {
+    atomic_store_explicit(&((log_ring_t*)ring)->orphaned, true, memory_order_release);
+}
+
+static void log_init_once(void) {
+    pthread_key_create(&g_log.key, ring_thread_exit);
+    if (pthread_create(&g_log.writer, NULL, log_writer_thread, NULL) == 0) {
+        pthread_detach(g_log.writer);
+        g_log.writer_started = true;
+    }
+    // 进程退出时写出剩余日志
+    atexit(softbus_log_flush);
+}
+
+static log_ring_t* ring_get(void) {
+    if (t_ring) {
+        return t_ring;
+    }
+    pthread_once(&g_log.once, log_init_once);
+
+    log_ring_t* ring = calloc(1, sizeof(*ring));
+    if (!ring) {
+        return NULL;
+    }
+    pthread_mutex_lock(&g_log.rings_mutex);
+    ring->next = g_log.rings;
+    g_log.rings = ring;
+    pthread_mutex_unlock(&g_log.rings_mutex);
+    pthread_setspecific(g_log.key, ring);
+    t_ring = ring;
+    return ring;
+}
+
+void softbus_log_write(int level, const char* fmt, int nargs, const softbus_log_arg_t* args) {
+    log_ring_t* ring = ring_get();
+    if (!ring) {
+        atomic_fetch_add_explicit(&g_log.dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail >= SOFTBUS_LOG_RING_SIZE) {
+        atomic_fetch_add_explicit(&g_log.dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    log_record_t* rec = &ring->records[head & (SOFTBUS_LOG_RING_SIZE - 1)];
+    rec->ts_ns = log_now_ns();
+    rec->fmt = fmt;
+    rec->level = (uint8_t)level;
+    rec->nargs = (uint8_t)(nargs < SOFTBUS_LOG_MAX_ARGS ? nargs : SOFTBUS_LOG_MAX_ARGS);
+
+    // 字符串参数在调用返回后可能失效，复制到记录中，用偏移代替指针
+    size_t used = 0;
+    rec->strs[sizeof(rec->strs) - 1] = '\0';
+    for (int i = 0; i < rec->nargs; i++) {
+        rec->args[i] = args[i];
+        if (args[i].type != SOFTBUS_LOG_ARG_STR) {
+            continue;
+        }
+        if (used >= sizeof(rec->strs) - 1) {
+            rec->args[i].v.u = sizeof(rec->strs) - 1;  // 空间用完，指向末尾的空串
+            continue;
+        }
+        const char* s = args[i].v.s ? args[i].v.s : "(null)";
+        size_t n = strnlen(s, sizeof(rec->strs) - used - 1);
+        memcpy(rec->strs + used, s, n);
+        rec->strs[used + n] = '\0';
+        rec->args[i].v.u = used;
+        used += n + 1;
+    }
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+// ---- 后台格式化 ----
+
+// 按格式串逐个转换格式化一条记录
+static size_t format_record(const log_record_t* rec, char* out, size_t cap) {
+    size_t len = 0;
+    int arg = 0;
+    const char* p = rec->fmt;
+
+#define OUT_APPEND(...)                                                  \
+    do {                                                                 \
+        int n_ = snprintf(out + len, cap - len, __VA_ARGS__);            \
+        if (n_ > 0) {                                                    \
+            len += (size_t)n_ < cap - len ? (size_t)n_ : cap - len - 1;  \
+        }                                                                \
+    } while (0)
+
+    while (*p && len + 1 < cap) {
+        if (*p != '%') {
+            out[len++] = *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            out[len++] = '%';
+            p += 2;
+            continue;
+        }
+
+        // 截取一个完整的转换说明，如 %-08.3lld
+        char spec[32];
+        size_t n = 0;
+        spec[n++] = *p++;
+        while (*p && strchr("-+ #0123456789.", *p) && n < sizeof(spec) - 4) {
+            spec[n++] = *p++;
+        }
+        while (*p && strchr("hlzjt", *p) && n < sizeof(spec) - 2) {
+            spec[n++] = *p++;
+        }
+        if (!*p) {
+            break;
+        }
+        char conv = *p++;
+        spec[n++] = conv;
+        spec[n] = '\0';
+
+        if (arg >= rec->nargs) {
+            OUT_APPEND("%s", "<?>");
+            continue;
+        }
+        const softbus_log_arg_t* a = &rec->args[arg++];
+
+        // 长度修饰统一替换为ll，值已按long long保存
+        char fixed[32];
+        size_t m = 0;
+        for (size_t i = 0; i < n - 1; i++) {
+            if (!strchr("hlzjt", spec[i])) {
+                fixed[m++] = spec[i];
+            }
+        }
+        switch (conv) {
+            case 'd': case 'i': case 'u': case 'x': case 'X': case 'o':
+                fixed[m++] = 'l';
+                fixed[m++] = 'l';
+                fixed[m++] = conv;
+                fixed[m] = '\0';
+                if (a->type == SOFTBUS_LOG_ARG_DOUBLE) {
+                    OUT_APPEND(fixed, (long long)a->v.d);
+                } else {
+                    OUT_APPEND(fixed, a->v.i);
+                }
+                break;
+            case 'c':
+                OUT_APPEND(spec, (int)a->v.i);
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+                fixed[m++] = conv;
+                fixed[m] = '\0';
+                OUT_APPEND(fixed, a->type == SOFTBUS_LOG_ARG_DOUBLE ? a->v.d : (double)a->v.i);
+                break;
+            case 's':
+                OUT_APPEND(spec, a->type == SOFTBUS_LOG_ARG_STR ? rec->strs + a->v.u : "<?>");
+                break;
+            case 'p':
+                OUT_APPEND("%p", a->v.p);
+                break;
+            default:
+                OUT_APPEND("%s", spec);
+                break;
+        }
+    }
+#undef OUT_APPEND
+
+    out[len] = '\0';
+    return len;
+}
+
+static void write_record(FILE* fp, const log_record_t* rec) {
+    char line[512];
+    format_record(rec, line, sizeof(line));
+    size_t n = strlen(line);
+    while (n > 0 && line[n - 1] == '\n') {
+        line[--n] = '\0';
+    }
+
+    if (rec->level == SOFTBUS_LOG_LEVEL_INFO) {
+        fprintf(fp, "%s\n", line);
+    } else {
+        fprintf(fp, "[%s] %s\n", g_level_names[rec->level < SOFTBUS_LOG_LEVEL_NONE ? rec->level : 0], line);
+    }
+}
+
+// 按时间戳合并各线程的记录并写出，调用者不能持有drain_mutex
+static void log_drain(void) {
+    pthread_mutex_lock(&g_log.drain_mutex);
+    FILE* fp = g_log.output ? g_log.output : stdout;
+    bool wrote = false;
+
+    for (;;) {
+        log_ring_t* oldest = NULL;
+        uint64_t oldest_ts = 0;
+        pthread_mutex_lock(&g_log.rings_mutex);
+        for (log_ring_t* ring = g_log.rings; ring; ring = ring->next) {
+            uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+            uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+            if (head == tail) {
+                continue;
+            }
+            uint64_t ts = ring->records[tail & (SOFTBUS_LOG_RING_SIZE - 1)].ts_ns;
+            if (!oldest || ts < oldest_ts) {
+                oldest = ring;
+                oldest_ts = ts;
+            }
+        }
+        pthread_mutex_unlock(&g_log.rings_mutex);
+        if (!oldest) {
+            break;
+        }
+
+        uint32_t tail = atomic_load_explicit(&oldest->tail, memory_order_relaxed);
+        write_record(fp, &oldest->records[tail & (SOFTBUS_LOG_RING_SIZE - 1)]);
+        atomic_store_explicit(&oldest->tail, tail + 1, memory_order_release);
+        wrote = true;
+    }
+
+    uint64_t dropped = atomic_load_explicit(&g_log.dropped, memory_order_relaxed);
+    if (dropped != g_log.dropped_reported) {
+        fprintf(fp, "[WARN] log buffer full, dropped %llu records\n",
+                (unsigned long long)(dropped - g_log.dropped_reported));
+        g_log.dropped_reported = dropped;
+        wrote = true;
+    }
+    if (wrote) {
+        fflush(fp);
+    }
+
+    // 释放已退出线程的空环
+    pthread_mutex_lock(&g_log.rings_mutex);
+    log_ring_t** link = &g_log.rings;
+    while (*link) {
+        log_ring_t* ring = *link;
+        if (atomic_load_explicit(&ring->orphaned, memory_order_acquire) &&
+            atomic_load_explicit(&ring->head, memory_order_acquire) ==
+                atomic_load_explicit(&ring->tail, memory_order_relaxed)) {
+            *link = ring->next;
+            free(ring);
+        } else {
+            link = &ring->next;
+        }
+    }
+    pthread_mutex_unlock(&g_log.rings_mutex);
+
+    pthread_mutex_unlock(&g_log.drain_mutex);
+}
+
+static void* log_writer_thread(void* arg) {
+    (void)arg;
+    for (;;) {
+        log_drain();
+        usleep(SOFTBUS_LOG_FLUSH_INTERVAL_US);
+    }
+    return NULL;
+}
+
+void softbus_log_set_level(int level) {
+    if (level < SOFTBUS_LOG_MIN_LEVEL) {
+        level = SOFTBUS_LOG_MIN_LEVEL;
+    }
+    atomic_store_explicit(&g_softbus_log_level, level, memory_order_relaxed);
+}
+
+void softbus_log_set_output(FILE* fp) {
+    softbus_log_flush();
+    pthread_mutex_lock(&g_log.drain_mutex);
+    g_log.output = fp;
+    pthread_mutex_unlock(&g_log.drain_mutex);
+}
+
+void softbus_log_flush(void) {
+    log_drain();
+}
+
+uint64_t softbus_log_dropped(void) {
+    return atomic_load_explicit(&g_log.dropped, memory_order_relaxed);
+}
@@ -0,0 +1,224 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "softbus_metrics.h"
+#include "softbus_types.h"
+#include "softbus_cacheline.h"
+
+#define HIST_HALF (1u << (SOFTBUS_HIST_SUB_BITS - 1))
+
+typedef struct {
+    _Atomic uint64_t min_ns;
+    _Atomic uint64_t max_ns;
+    _Atomic uint64_t sum_ns;
+    _Atomic uint64_t buckets[SOFTBUS_HIST_BUCKETS];
+} metrics_histogram_t;
+
+struct device_metrics {
+    _Atomic uint64_t enqueued;
+    _Atomic uint64_t dequeued;
+    _Atomic uint64_t dropped;
+    _Atomic uint64_t bytes;
+    _Atomic uint64_t handler_errors;
+    _Atomic uint64_t handler_cpu_ns;
+    _Atomic uint64_t handler_overruns;
+    _Atomic uint64_t quarantines;
+    _Atomic uint32_t depth;
+    _Atomic uint32_t depth_high_water;
+    metrics_histogram_t queue_latency;
+    metrics_histogram_t handler_latency;
+} SOFTBUS_CACHE_ALIGNED;
+
+// 值到桶下标：v < 2^SUB_BITS时直接对应，否则保留最高SUB_BITS位
+static uint32_t hist_index(uint64_t v) {
+    if (v < (1u << SOFTBUS_HIST_SUB_BITS)) {
+        return (uint32_t)v;
+    }
+    if (v >> SOFTBUS_HIST_MAX_BITS) {
+        return SOFTBUS_HIST_BUCKETS - 1;
+    }
+    uint32_t msb = 63u - (uint32_t)__builtin_clzll(v);
+    uint32_t shift = msb - SOFTBUS_HIST_SUB_BITS + 1;
+    return shift * HIST_HALF + (uint32_t)(v >> shift);
+}
+
+// 桶内最大值
+static uint64_t hist_bucket_upper(uint32_t idx) {
+    if (idx < (1u << SOFTBUS_HIST_SUB_BITS)) {
+        return idx;
+    }
+    uint32_t shift = idx / HIST_HALF - 1;
+    uint64_t top = idx % HIST_HALF + HIST_HALF;
+    return ((top + 1) << shift) - 1;
+}
+
+static void hist_reset(metrics_histogram_t* hist) {
+    atomic_store_explicit(&hist->min_ns, UINT64_MAX, memory_order_relaxed);
+    atomic_store_explicit(&hist->max_ns, 0, memory_order_relaxed);
+    atomic_store_explicit(&hist->sum_ns, 0, memory_order_relaxed);
+    for (uint32_t i = 0; i < SOFTBUS_HIST_BUCKETS; i++) {
+        atomic_store_explicit(&hist->buckets[i], 0, memory_order_relaxed);
+    }
+}
+
+static void hist_record(metrics_histogram_t* hist, uint64_t v) {
+    atomic_fetch_add_explicit(&hist->buckets[hist_index(v)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&hist->sum_ns, v, memory_order_relaxed);
+
+    uint64_t cur = atomic_load_explicit(&hist->min_ns, memory_order_relaxed);
+    while (v < cur && !atomic_compare_exchange_weak_explicit(&hist->min_ns, &cur, v,
+                                                              memory_order_relaxed, memory_order_relaxed)) {
+    }
+    cur = atomic_load_explicit(&hist->max_ns, memory_order_relaxed);
+    while (v > cur && !atomic_compare_exchange_weak_explicit(&hist->max_ns, &cur, v,
+                                                              memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+// 快照不是原子的：并发记录时各字段可能相差几条，对统计用途足够；总数由各桶累加得到
+static void hist_snapshot(const metrics_histogram_t* hist, softbus_histogram_t* out) {
+    out->count = 0;
+    for (uint32_t i = 0; i < SOFTBUS_HIST_BUCKETS; i++) {
+        out->buckets[i] = atomic_load_explicit(&hist->buckets[i], memory_order_relaxed);
+        out->count += out->buckets[i];
+    }
+    out->sum_ns = atomic_load_explicit(&hist->sum_ns, memory_order_relaxed);
+    out->max_ns = atomic_load_explicit(&hist->max_ns, memory_order_relaxed);
+    out->min_ns = out->count ? atomic_load_explicit(&hist->min_ns, memory_order_relaxed) : 0;
+}
+
+uint64_t softbus_histogram_percentile(const softbus_histogram_t* hist, double percentile) {
+    if (!hist || hist->count == 0) {
+        return 0;
+    }
+    if (percentile < 0.0) {
+        percentile = 0.0;
+    } else if (percentile > 100.0) {
+        percentile = 100.0;
+    }
+
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)hist->count + 0.5);
+    if (rank == 0) {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < SOFTBUS_HIST_BUCKETS; i++) {
+        seen += hist->buckets[i];
+        if (seen >= rank) {
+            uint64_t upper = hist_bucket_upper(i);
+            return upper < hist->max_ns ? upper : hist->max_ns;
+        }
+    }
+    return hist->max_ns;
+}
+
+double softbus_histogram_mean(const softbus_histogram_t* hist) {
+    if (!hist || hist->count == 0) {
+        return 0.0;
+    }
+    return (double)hist->sum_ns / (double)hist->count;
+}
+
+device_metrics_t* device_metrics_create(void) {
+    device_metrics_t* metrics = softbus_cacheline_alloc(sizeof(*metrics));
+    if (metrics) {
+        device_metrics_reset(metrics);
+    }
+    return metrics;
+}
+
+void device_metrics_destroy(device_metrics_t* metrics) {
+    softbus_cacheline_free(metrics);
+}
+
+void device_metrics_reset(device_metrics_t* metrics) {
+    if (!metrics) {
+        return;
+    }
+    atomic_store_explicit(&metrics->enqueued, 0, memory_order_relaxed);
+    atomic_store_explicit(&metrics->dequeued, 0, memory_order_relaxed);
+    atomic_store_explicit(&metrics->dropped, 0, memory_order_relaxed);
+    atomic_store_explicit(&metrics->bytes, 0, memory_order_relaxed);
+    atomic_store_explicit(&metrics->handler_errors, 0, memory_order_relaxed);
+    atomic_store_explicit(&metrics->handler_cpu_ns, 0, memory_order_relaxed);
+    atomic_store_explicit(&metrics->handler_overruns, 0, memory_order_relaxed);
+    atomic_store_explicit(&metrics->quarantines, 0, memory_order_relaxed);
+    // 队列中仍有消息，峰值从当前深度重新开始
+    atomic_store_explicit(&metrics->depth_high_water,
+                          atomic_load_explicit(&metrics->depth, memory_order_relaxed), memory_order_relaxed);
+    hist_reset(&metrics->queue_latency);
+    hist_reset(&metrics->handler_latency);
+}
+
+void device_metrics_enqueued(device_metrics_t* metrics, size_t bytes) {
+    if (!metrics) {
+        return;
+    }
+    atomic_fetch_add_explicit(&metrics->enqueued, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&metrics->bytes, bytes, memory_order_relaxed);
+
+    uint32_t depth = atomic_fetch_add_explicit(&metrics->depth, 1, memory_order_relaxed) + 1;
+    uint32_t high = atomic_load_explicit(&metrics->depth_high_water, memory_order_relaxed);
+    while (depth > high && !atomic_compare_exchange_weak_explicit(&metrics->depth_high_water, &high, depth,
+                                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+void device_metrics_dropped(device_metrics_t* metrics) {
+    if (metrics) {
+        atomic_fetch_add_explicit(&metrics->dropped, 1, memory_order_relaxed);
+    }
+}
+
+void device_metrics_dequeued(device_metrics_t* metrics, uint64_t queued_ns) {
+    if (!metrics) {
+        return;
+    }
+    atomic_fetch_add_explicit(&metrics->dequeued, 1, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&metrics->depth, 1, memory_order_relaxed);
+    hist_record(&metrics->queue_latency, queued_ns);
+}
+
+void device_metrics_handled(device_metrics_t* metrics, uint64_t exec_ns, uint64_t cpu_ns, int result) {
+    if (!metrics) {
+        return;
+    }
+    if (result != SOFTBUS_OK) {
+        atomic_fetch_add_explicit(&metrics->handler_errors, 1, memory_order_relaxed);
+    }
+    if (cpu_ns) {
+        atomic_fetch_add_explicit(&metrics->handler_cpu_ns, cpu_ns, memory_order_relaxed);
+    }
+    hist_record(&metrics->handler_latency, exec_ns);
+}
+
+void device_metrics_overrun(device_metrics_t* metrics) {
+    if (metrics) {
+        atomic_fetch_add_explicit(&metrics->handler_overruns, 1, memory_order_relaxed);
+    }
+}
+
+void device_metrics_quarantined(device_metrics_t* metrics) {
+    if (metrics) {
+        atomic_fetch_add_explicit(&metrics->quarantines, 1, memory_order_relaxed);
+    }
+}
+
+void device_metrics_snapshot(const device_metrics_t* metrics, softbus_device_stats_t* stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (!metrics) {
+        return;
+    }
+    stats->enqueued = atomic_load_explicit(&metrics->enqueued, memory_order_relaxed);
+    stats->dequeued = atomic_load_explicit(&metrics->dequeued, memory_order_relaxed);
+    stats->dropped = atomic_load_explicit(&metrics->dropped, memory_order_relaxed);
+    stats->bytes = atomic_load_explicit(&metrics->bytes, memory_order_relaxed);
+    stats->handler_errors = atomic_load_explicit(&metrics->handler_errors, memory_order_relaxed);
+    stats->handler_cpu_ns = atomic_load_explicit(&metrics->handler_cpu_ns, memory_order_relaxed);
+    stats->handler_overruns = atomic_load_explicit(&metrics->handler_overruns, memory_order_relaxed);
+    stats->quarantines = atomic_load_explicit(&metrics->quarantines, memory_order_relaxed);
+    stats->depth = atomic_load_explicit(&metrics->depth, memory_order_relaxed);
+    stats->depth_high_water = atomic_load_explicit(&metrics->depth_high_water, memory_order_relaxed);
+    hist_snapshot(&metrics->queue_latency, &stats->queue_latency);
+    hist_snapshot(&metrics->handler_latency, &stats->handler_latency);
+}
@@ -0,0 +1,478 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#ifndef _WIN32
+#include <arpa/inet.h>
+#endif
+#include "softbus_netem.h"
+#include "softbus_io.h"
+#include "softbus_types.h"
+
+// 一个数据报的内容，组播时由多个待投递副本共享
+typedef struct {
+    int refcount;
+    size_t len;
+    struct sockaddr_in from;
+    uint8_t data[];
+} netem_buf_t;
+
+// 待投递副本，按到期时间排列在最小堆中，同一时刻按发送顺序投递
+typedef struct {
+    uint64_t due_ns;
+    uint64_t order;
+    netem_node_t* to;
+    netem_buf_t* buf;
+} netem_pending_t;
+
+typedef struct {
+    uint32_t addr;              // 网络字节序，0表示空闲
+    int member_count;
+    uint8_t members[NETEM_MAX_NODES / 8];
+} netem_group_t;
+
+struct netem_node {
+    netem_t* net;
+    int index;
+    uint32_t addr;              // 网络字节序
+    netem_receive_t handler;
+    void* ctx;
+    uint64_t tx_free_ns;        // 发送链路空闲的时刻，用于带宽限制
+};
+
+struct netem {
+    netem_config_t config;
+    uint32_t rng;
+
+    netem_node_t* nodes[NETEM_MAX_NODES];
+    int node_count;
+    netem_group_t groups[NETEM_MAX_GROUPS];
+
+    netem_pending_t* heap;
+    size_t heap_len;
+    size_t heap_cap;
+    uint64_t next_order;
+    int delivering;             // 已出堆、回调尚未返回的副本数
+
+    netem_stats_t stats;
+
+    bool running;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;        // 有新的待投递副本
+    pthread_cond_t idle_cond;   // 所有副本投递完毕
+};
+
+// ---- 随机数与时间 ----
+
+static uint32_t rng_next_locked(netem_t* net) {
+    // xorshift32，足够用于丢包和抖动
+    uint32_t x = net->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    net->rng = x;
+    return x;
+}
+
+static double rng_uniform_locked(netem_t* net) {
+    return (double)rng_next_locked(net) / 4294967296.0;
+}
+
+static void abs_deadline(uint64_t due_ns, struct timespec* ts) {
+    ts->tv_sec = (time_t)(due_ns / 1000000000ULL);
+    ts->tv_nsec = (long)(due_ns % 1000000000ULL);
+}
+
+// ---- 最小堆 ----
+
+static bool pending_before(const netem_pending_t* a, const netem_pending_t* b) {
+    return a->due_ns < b->due_ns || (a->due_ns == b->due_ns && a->order < b->order);
+}
+
+static int heap_push_locked(netem_t* net, const netem_pending_t* item) {
+    if (net->heap_len == net->heap_cap) {
+        size_t cap = net->heap_cap ? net->heap_cap * 2 : 1024;
+        netem_pending_t* heap = realloc(net->heap, cap * sizeof(*heap));
+        if (!heap) {
+            return SOFTBUS_NO_MEM;
+        }
+        net->heap = heap;
+        net->heap_cap = cap;
+    }
+
+    size_t i = net->heap_len++;
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!pending_before(item, &net->heap[parent])) {
+            break;
+        }
+        net->heap[i] = net->heap[parent];
+        i = parent;
+    }
+    net->heap[i] = *item;
+    return SOFTBUS_OK;
+}
+
+static netem_pending_t heap_pop_locked(netem_t* net) {
+    netem_pending_t top = net->heap[0];
+    netem_pending_t last = net->heap[--net->heap_len];
+    size_t i = 0;
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= net->heap_len) {
+            break;
+        }
+        if (child + 1 < net->heap_len && pending_before(&net->heap[child + 1], &net->heap[child])) {
+            child++;
+        }
+        if (!pending_before(&net->heap[child], &last)) {
+            break;
+        }
+        net->heap[i] = net->heap[child];
+        i = child;
+    }
+    if (net->heap_len > 0) {
+        net->heap[i] = last;
+    }
+    return top;
+}
+
+static void buf_release(netem_buf_t* buf) {
+    if (--buf->refcount == 0) {
+        free(buf);
+    }
+}
+
+// ---- 投递线程 ----
+
+static void* delivery_thread(void* arg) {
+    netem_t* net = arg;
+
+    pthread_mutex_lock(&net->mutex);
+    while (net->running) {
+        if (net->heap_len == 0) {
+            pthread_cond_wait(&net->cond, &net->mutex);
+            continue;
+        }
+        uint64_t now = softbus_io_now_ns();
+        if (net->heap[0].due_ns > now) {
+            struct timespec ts;
+            abs_deadline(net->heap[0].due_ns, &ts);
+            pthread_cond_timedwait(&net->cond, &net->mutex, &ts);
+            continue;
+        }
+
+        netem_pending_t item = heap_pop_locked(net);
+        net->stats.delivered++;
+        net->stats.bytes_delivered += item.buf->len;
+        net->delivering++;
+        pthread_mutex_unlock(&net->mutex);
+
+        netem_node_t* to = item.to;
+        if (to->handler) {
+            to->handler(to, &item.buf->from, item.buf->data, item.buf->len, to->ctx);
+        }
+
+        pthread_mutex_lock(&net->mutex);
+        buf_release(item.buf);
+        net->delivering--;
+        if (net->heap_len == 0 && net->delivering == 0) {
+            pthread_cond_broadcast(&net->idle_cond);
+        }
+    }
+    pthread_mutex_unlock(&net->mutex);
+    return NULL;
+}
+
+// ---- 公共接口 ----
+
+netem_t* netem_create(const netem_config_t* config) {
+    netem_t* net = calloc(1, sizeof(*net));
+    if (!net) {
+        return NULL;
+    }
+    if (config) {
+        net->config = *config;
+    }
+    net->rng = net->config.seed ? net->config.seed : 0x9e3779b9u;
+
+    // 条件变量使用单调时钟，与softbus_io_now_ns一致
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&net->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_cond_init(&net->idle_cond, NULL);
+    pthread_mutex_init(&net->mutex, NULL);
+
+    net->running = true;
+    if (pthread_create(&net->thread, NULL, delivery_thread, net) != 0) {
+        perror("Failed to create netem delivery thread");
+        pthread_cond_destroy(&net->cond);
+        pthread_cond_destroy(&net->idle_cond);
+        pthread_mutex_destroy(&net->mutex);
+        free(net);
+        return NULL;
+    }
+    return net;
+}
+
+void netem_destroy(netem_t* net) {
+    if (!net) {
+        return;
+    }
+
+    pthread_mutex_lock(&net->mutex);
+    net->running = false;
+    pthread_cond_signal(&net->cond);
+    pthread_mutex_unlock(&net->mutex);
+    pthread_join(net->thread, NULL);
+
+    while (net->heap_len > 0) {
+        netem_pending_t item = heap_pop_locked(net);
+        buf_release(item.buf);
+    }
+    free(net->heap);
+    for (int i = 0; i < net->node_count; i++) {
+        free(net->nodes[i]);
+    }
+    pthread_cond_destroy(&net->cond);
+    pthread_cond_destroy(&net->idle_cond);
+    pthread_mutex_destroy(&net->mutex);
+    free(net);
+}
+
+void netem_set_config(netem_t* net, const netem_config_t* config) {
+    if (!net || !config) {
+        return;
+    }
+    pthread_mutex_lock(&net->mutex);
+    net->config = *config;
+    pthread_mutex_unlock(&net->mutex);
+}
+
+netem_node_t* netem_node_add(netem_t* net, netem_receive_t handler, void* ctx) {
+    if (!net) {
+        return NULL;
+    }
+
+    netem_node_t* node = calloc(1, sizeof(*node));
+    if (!node) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&net->mutex);
+    if (net->node_count >= NETEM_MAX_NODES) {
+        pthread_mutex_unlock(&net->mutex);
+        free(node);
+        return NULL;
+    }
+    node->net = net;
+    node->index = net->node_count;
+    node->addr = htonl(NETEM_ADDR_BASE + (uint32_t)node->index);
+    node->handler = handler;
+    node->ctx = ctx;
+    net->nodes[net->node_count++] = node;
+    pthread_mutex_unlock(&net->mutex);
+    return node;
+}
+
+void netem_node_addr(const netem_node_t* node, struct sockaddr_in* addr) {
+    if (!node || !addr) {
+        return;
+    }
+    memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_addr.s_addr = node->addr;
+    addr->sin_port = htons(NETEM_NODE_PORT);
+}
+
+int netem_node_index(const netem_node_t* node) {
+    return node ? node->index : -1;
+}
+
+static netem_group_t* group_find_locked(netem_t* net, uint32_t group_addr, bool create) {
+    netem_group_t* free_group = NULL;
+    for (int i = 0; i < NETEM_MAX_GROUPS; i++) {
+        netem_group_t* group = &net->groups[i];
+        if (group->addr == group_addr) {
+            return group;
+        }
+        if (group->addr == 0 && !free_group) {
+            free_group = group;
+        }
+    }
+    if (!create || !free_group) {
+        return NULL;
+    }
+    memset(free_group, 0, sizeof(*free_group));
+    free_group->addr = group_addr;
+    return free_group;
+}
+
+int netem_join(netem_node_t* node, uint32_t group_addr) {
+    if (!node || !IN_MULTICAST(ntohl(group_addr))) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    netem_t* net = node->net;
+    pthread_mutex_lock(&net->mutex);
+    netem_group_t* group = group_find_locked(net, group_addr, true);
+    if (!group) {
+        pthread_mutex_unlock(&net->mutex);
+        return SOFTBUS_ERROR;
+    }
+    uint8_t bit = (uint8_t)(1u << (node->index & 7));
+    if (!(group->members[node->index >> 3] & bit)) {
+        group->members[node->index >> 3] |= bit;
+        group->member_count++;
+    }
+    pthread_mutex_unlock(&net->mutex);
+    return SOFTBUS_OK;
+}
+
+int netem_leave(netem_node_t* node, uint32_t group_addr) {
+    if (!node) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    netem_t* net = node->net;
+    pthread_mutex_lock(&net->mutex);
+    netem_group_t* group = group_find_locked(net, group_addr, false);
+    uint8_t bit = (uint8_t)(1u << (node->index & 7));
+    if (!group || !(group->members[node->index >> 3] & bit)) {
+        pthread_mutex_unlock(&net->mutex);
+        return SOFTBUS_NOT_FOUND;
+    }
+    group->members[node->index >> 3] &= (uint8_t)~bit;
+    if (--group->member_count == 0) {
+        group->addr = 0;
+    }
+    pthread_mutex_unlock(&net->mutex);
+    return SOFTBUS_OK;
+}
+
+// 为一个接收方安排投递：独立决定丢包、抖动和乱序
+static void schedule_copy_locked(netem_t* net, netem_node_t* to, netem_buf_t* buf, uint64_t depart_ns) {
+    const netem_config_t* cfg = &net->config;
+    if (cfg->loss > 0 && rng_uniform_locked(net) < cfg->loss) {
+        net->stats.dropped++;
+        return;
+    }
+
+    uint64_t delay_us = cfg->latency_us;
+    if (cfg->jitter_us > 0) {
+        delay_us += rng_next_locked(net) % cfg->jitter_us;
+    }
+    if (cfg->reorder > 0 && rng_uniform_locked(net) < cfg->reorder) {
+        delay_us += cfg->reorder_delay_us;
+        net->stats.reordered++;
+    }
+
+    netem_pending_t item = {depart_ns + delay_us * 1000ULL, net->next_order++, to, buf};
+    if (heap_push_locked(net, &item) == SOFTBUS_OK) {
+        buf->refcount++;
+    }
+}
+
+int netem_send(netem_node_t* node, const struct sockaddr_in* dest, const uint8_t* buf, size_t len) {
+    if (!node || !dest || !buf || len == 0 || len > NETEM_MAX_DATAGRAM) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    netem_buf_t* copy = malloc(sizeof(*copy) + len);
+    if (!copy) {
+        return SOFTBUS_NO_MEM;
+    }
+    copy->refcount = 1;  // 发送过程持有一个引用，安排完所有副本后释放
+    copy->len = len;
+    netem_node_addr(node, &copy->from);
+    memcpy(copy->data, buf, len);
+
+    netem_t* net = node->net;
+    pthread_mutex_lock(&net->mutex);
+    net->stats.sent++;
+
+    // 带宽限制：数据报在发送链路上排队，按长度占用传输时间
+    uint64_t now = softbus_io_now_ns();
+    uint64_t depart = node->tx_free_ns > now ? node->tx_free_ns : now;
+    if (net->config.bandwidth_bps > 0) {
+        depart += (uint64_t)len * 8ULL * 1000000000ULL / net->config.bandwidth_bps;
+    }
+    node->tx_free_ns = depart;
+
+    size_t queued_before = net->heap_len;
+    uint32_t dest_addr = dest->sin_addr.s_addr;
+    if (IN_MULTICAST(ntohl(dest_addr))) {
+        netem_group_t* group = group_find_locked(net, dest_addr, false);
+        if (!group) {
+            net->stats.no_route++;
+        } else {
+            for (int i = 0; i < net->node_count; i++) {
+                if (i != node->index && (group->members[i >> 3] & (1u << (i & 7)))) {
+                    schedule_copy_locked(net, net->nodes[i], copy, depart);
+                }
+            }
+        }
+    } else {
+        uint32_t index = ntohl(dest_addr) - NETEM_ADDR_BASE;
+        if (index < (uint32_t)net->node_count && ntohs(dest->sin_port) == NETEM_NODE_PORT) {
+            schedule_copy_locked(net, net->nodes[index], copy, depart);
+        } else {
+            net->stats.no_route++;
+        }
+    }
+
+    if (net->heap_len != queued_before) {
+        pthread_cond_signal(&net->cond);
+    }
+    buf_release(copy);
+    pthread_mutex_unlock(&net->mutex);
+    return SOFTBUS_OK;
+}
+
+int netem_drain(netem_t* net, int timeout_ms) {
+    if (!net) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += timeout_ms / 1000;
+    ts.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+
+    int ret = SOFTBUS_OK;
+    pthread_mutex_lock(&net->mutex);
+    while (net->heap_len > 0 || net->delivering > 0) {
+        if (pthread_cond_timedwait(&net->idle_cond, &net->mutex, &ts) != 0) {
+            ret = SOFTBUS_TIMEOUT;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&net->mutex);
+    return ret;
+}
+
+void netem_get_stats(netem_t* net, netem_stats_t* stats) {
+    if (!net || !stats) {
+        return;
+    }
+    pthread_mutex_lock(&net->mutex);
+    *stats = net->stats;
+    pthread_mutex_unlock(&net->mutex);
+}
+
+void netem_reset_stats(netem_t* net) {
+    if (!net) {
+        return;
+    }
+    pthread_mutex_lock(&net->mutex);
+    memset(&net->stats, 0, sizeof(net->stats));
+    pthread_mutex_unlock(&net->mutex);
+}
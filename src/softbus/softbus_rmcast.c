@@ -0,0 +1,852 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "softbus_rmcast.h"
+#include "softbus_io.h"
+#include "softbus_types.h"
+
+#define MS_TO_NS(ms) ((uint64_t)(ms) * 1000000ULL)
+
+// 序号比较，允许回绕
+#define SEQ_DIFF(a, b) ((int32_t)((uint32_t)(a) - (uint32_t)(b)))
+
+// 发送历史中的一个数据报
+typedef struct {
+    uint32_t seq;
+    size_t len;
+    size_t capacity;
+    uint64_t last_retx_ns;  // 上次重传时间，0表示没有重传过
+    uint32_t retx_next_seq; // 上次重传时的下一个序号，接收方见到它说明重传也该到了
+    uint32_t retx_epoch;    // 上次重传所在的重传轮次，接收方从之后的心跳得知
+    uint8_t* buf;
+} rm_history_t;
+
+// 本节点发出的一个组播流
+typedef struct {
+    bool in_use;
+    struct sockaddr_in dest;
+    uint32_t next_seq;
+    uint64_t last_send_ns;
+    uint64_t last_heartbeat_ns;
+    rm_history_t* history;          // 按seq % RMCAST_HISTORY_SIZE存放最近发出的数据报
+    uint64_t retx_due_ns;           // 汇总的重传请求的发送时间，0表示没有待重传的数据报
+    uint32_t retx_epoch;            // 重传轮次，每次发出汇总的重传加一，由心跳带给接收方
+    uint32_t retx_lo;               // 待重传序号的范围[retx_lo, retx_hi)
+    uint32_t retx_hi;
+    uint8_t retx_pending[RMCAST_HISTORY_SIZE / 8];  // 按seq % RMCAST_HISTORY_SIZE标记已被请求、等待重传的序号
+} rm_send_stream_t;
+
+// 远端节点的一个组播流
+typedef struct {
+    bool in_use;
+    uint32_t node_id;
+    uint32_t stream;
+    struct sockaddr_in sender;      // NACK发往的地址
+    uint32_t base;                  // 最小的未收到序号，之前的都已收到或放弃
+    uint32_t highest;               // 已知存在的最大序号加一
+    uint64_t gap_since_ns;          // 出现空洞的时间，0表示没有空洞
+    uint64_t nack_due_ns;           // 下一轮NACK的时间，0表示尚未安排
+    uint32_t retx_epoch;            // 心跳中见过的发送方最新重传轮次，随NACK带回
+    uint32_t nack_backoff;          // 连续没有进展的NACK轮数，决定下一轮的间隔
+    uint64_t last_active_ns;
+    uint64_t created_ns;
+    uint8_t bitmap[RMCAST_WINDOW / 8];  // 按seq % RMCAST_WINDOW标记[base, base + RMCAST_WINDOW)内已收到的序号
+    uint8_t requested[RMCAST_WINDOW / 8];  // 自上一轮NACK以来其他接收方已请求过的序号，本轮不再请求
+} rm_recv_stream_t;
+
+// 一个节点的可靠组播状态，多个实例可以在同一进程中共存（如网络仿真器中的多个节点）
+struct rmcast {
+    uint32_t node_id;
+    uint16_t group_port;            // 网络字节序，0表示NACK只单播给发送方
+    rmcast_output_t output;
+    void* output_ctx;
+    struct rmcast* next;            // 实例链表，受g_rmcast.mutex保护
+
+    rm_send_stream_t send_streams[RMCAST_MAX_SEND_STREAMS];
+    pthread_mutex_t send_mutex;
+
+    rm_recv_stream_t recv_streams[RMCAST_MAX_RECV_STREAMS];
+    pthread_mutex_t recv_mutex;
+    uint32_t rng;                   // NACK随机等待用的xorshift32状态，受recv_mutex保护
+
+    struct {
+        atomic_uint_fast64_t tx_sequenced;
+        atomic_uint_fast64_t retransmits;
+        atomic_uint_fast64_t heartbeats;
+        atomic_uint_fast64_t nacks_sent;
+        atomic_uint_fast64_t nacks_received;
+        atomic_uint_fast64_t nacks_suppressed;
+        atomic_uint_fast64_t rx_duplicates;
+        atomic_uint_fast64_t rx_recovered;
+        atomic_uint_fast64_t rx_lost;
+    } stats;
+};
+
+#define RM_STAT_INC(rm, field) atomic_fetch_add_explicit(&(rm)->stats.field, 1, memory_order_relaxed)
+
+// 所有实例共用一个一次性定时器：IO引擎的定时器槽位有限，网络仿真器中可能有上百个实例。
+// 定时处理在mutex内遍历实例，rmcast_destroy摘除实例后不会再有进行中的定时处理访问它。
+static struct {
+    pthread_mutex_t mutex;
+    rmcast_t* instances;
+    int timer_id;
+} g_rmcast = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+};
+
+// 内部函数声明
+static void rm_tick_all(void* ctx);
+static bool rm_tick(rmcast_t* rm);
+
+// 需要处理空洞或发送心跳时启动一次性定时器，调用者不能持有实例的锁
+static void rm_arm_timer(void) {
+    pthread_mutex_lock(&g_rmcast.mutex);
+    if (g_rmcast.timer_id <= 0) {
+        int id = softbus_io_timer_add((uint64_t)RMCAST_TICK_MS * 1000ULL, 0, rm_tick_all, NULL);
+        g_rmcast.timer_id = id > 0 ? id : 0;
+    }
+    pthread_mutex_unlock(&g_rmcast.mutex);
+}
+
+static void encode_control_hdr(const rmcast_t* rm, uint8_t* p) {
+    softbus_wire_hdr_t hdr = {.magic = SOFTBUS_WIRE_MAGIC, .version = SOFTBUS_WIRE_VERSION,
+                              .flags = SOFTBUS_WIRE_FLAG_CONTROL, .node_id = rm->node_id};
+    softbus_wire_encode_hdr(p, &hdr);
+}
+
+rmcast_t* rmcast_create(uint32_t node_id, uint16_t group_port, rmcast_output_t output, void* output_ctx) {
+    if (!output) {
+        return NULL;
+    }
+
+    rmcast_t* rm = calloc(1, sizeof(*rm));
+    if (!rm) {
+        return NULL;
+    }
+    rm->node_id = node_id;
+    rm->group_port = htons(group_port);
+    rm->rng = node_id * 2654435761u | 1u;  // 各节点的随机序列不同
+    rm->output = output;
+    rm->output_ctx = output_ctx;
+    pthread_mutex_init(&rm->send_mutex, NULL);
+    pthread_mutex_init(&rm->recv_mutex, NULL);
+
+    pthread_mutex_lock(&g_rmcast.mutex);
+    rm->next = g_rmcast.instances;
+    g_rmcast.instances = rm;
+    pthread_mutex_unlock(&g_rmcast.mutex);
+    return rm;
+}
+
+void rmcast_destroy(rmcast_t* rm) {
+    if (!rm) {
+        return;
+    }
+
+    // 定时处理全程持有g_rmcast.mutex，摘除后即可安全释放；最后一个实例销毁时取消定时器
+    pthread_mutex_lock(&g_rmcast.mutex);
+    for (rmcast_t** pp = &g_rmcast.instances; *pp; pp = &(*pp)->next) {
+        if (*pp == rm) {
+            *pp = rm->next;
+            break;
+        }
+    }
+    int timer_id = 0;
+    if (!g_rmcast.instances) {
+        timer_id = g_rmcast.timer_id;
+        g_rmcast.timer_id = 0;
+    }
+    pthread_mutex_unlock(&g_rmcast.mutex);
+    // 定时回调需要g_rmcast.mutex，在锁外取消；实例表已空，回调不会再启动定时器
+    softbus_io_timer_cancel(timer_id);
+
+    for (int i = 0; i < RMCAST_MAX_SEND_STREAMS; i++) {
+        rm_history_t* history = rm->send_streams[i].history;
+        for (int j = 0; history && j < RMCAST_HISTORY_SIZE; j++) {
+            free(history[j].buf);
+        }
+        free(history);
+    }
+    pthread_mutex_destroy(&rm->send_mutex);
+    pthread_mutex_destroy(&rm->recv_mutex);
+    free(rm);
+}
+
+// ---- 发送方 ----
+
+static rm_send_stream_t* send_stream_get_locked(rmcast_t* rm, const struct sockaddr_in* dest) {
+    rm_send_stream_t* free_stream = NULL;
+    rm_send_stream_t* idlest = NULL;
+    for (int i = 0; i < RMCAST_MAX_SEND_STREAMS; i++) {
+        rm_send_stream_t* st = &rm->send_streams[i];
+        if (!st->in_use) {
+            if (!free_stream) {
+                free_stream = st;
+            }
+            continue;
+        }
+        if (st->dest.sin_addr.s_addr == dest->sin_addr.s_addr && st->dest.sin_port == dest->sin_port) {
+            return st;
+        }
+        if (!idlest || st->last_send_ns < idlest->last_send_ns) {
+            idlest = st;
+        }
+    }
+
+    // 流表满时复用最久未发送的流，序号从头开始，接收方会将其视为新流；历史缓冲区保留复用
+    rm_send_stream_t* st = free_stream ? free_stream : idlest;
+    rm_history_t* history = st->history;
+    if (!history) {
+        history = calloc(RMCAST_HISTORY_SIZE, sizeof(*history));
+        if (!history) {
+            return NULL;
+        }
+    }
+    for (int i = 0; i < RMCAST_HISTORY_SIZE; i++) {
+        history[i].len = 0;
+    }
+    memset(st, 0, sizeof(*st));
+    st->history = history;
+    st->in_use = true;
+    st->dest = *dest;
+    st->next_seq = 1;
+    return st;
+}
+
+int rmcast_send(rmcast_t* rm, const struct sockaddr_in* dest, const uint8_t* frame, size_t len) {
+    softbus_wire_hdr_t hdr;
+    if (!rm || !dest || !frame || softbus_wire_decode_hdr(frame, len, &hdr) != 0 || (hdr.flags & SOFTBUS_WIRE_FLAG_SEQ)) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&rm->send_mutex);
+    rm_send_stream_t* st = send_stream_get_locked(rm, dest);
+    if (!st) {
+        pthread_mutex_unlock(&rm->send_mutex);
+        return SOFTBUS_NO_MEM;
+    }
+
+    // 写入历史环，重传时原样再发；先确保缓冲区足够再分配序号，避免留下发送方自己也补不上的空洞
+    rm_history_t* h = &st->history[st->next_seq % RMCAST_HISTORY_SIZE];
+    size_t out_len = len + SOFTBUS_WIRE_SEQ_SIZE;
+    if (h->capacity < out_len) {
+        uint8_t* buf = realloc(h->buf, out_len);
+        if (!buf) {
+            pthread_mutex_unlock(&rm->send_mutex);
+            return SOFTBUS_NO_MEM;
+        }
+        h->buf = buf;
+        h->capacity = out_len;
+    }
+    hdr.flags |= SOFTBUS_WIRE_FLAG_SEQ;
+    hdr.stream = dest->sin_addr.s_addr;
+    hdr.seq = st->next_seq++;
+    size_t hdr_len = softbus_wire_encode_hdr(h->buf, &hdr);
+    memcpy(h->buf + hdr_len, frame + SOFTBUS_WIRE_HDR_SIZE, len - SOFTBUS_WIRE_HDR_SIZE);
+    h->len = hdr_len + len - SOFTBUS_WIRE_HDR_SIZE;
+    h->seq = hdr.seq;
+    h->last_retx_ns = 0;
+
+    bool was_idle = st->last_send_ns == 0;
+    st->last_send_ns = softbus_io_now_ns();
+    int ret = rm->output(rm->output_ctx, dest, h->buf, h->len);
+    pthread_mutex_unlock(&rm->send_mutex);
+
+    RM_STAT_INC(rm, tx_sequenced);
+    if (was_idle) {
+        rm_arm_timer();
+    }
+    return ret;
+}
+
+// 发送方仍保留的最小序号
+static uint32_t first_held_seq(const rm_send_stream_t* st) {
+    return SEQ_DIFF(st->next_seq, 1) > RMCAST_HISTORY_SIZE ? st->next_seq - RMCAST_HISTORY_SIZE : 1;
+}
+
+// 发送心跳，dest为NULL时发往组播地址，调用者需持有send_mutex
+static void send_heartbeat_locked(rmcast_t* rm, rm_send_stream_t* st, const struct sockaddr_in* dest, uint64_t now) {
+    uint8_t buf[SOFTBUS_WIRE_HDR_SIZE + 17];
+    encode_control_hdr(rm, buf);
+    uint8_t* p = buf + SOFTBUS_WIRE_HDR_SIZE;
+    p[0] = SOFTBUS_WIRE_CTRL_HEARTBEAT;
+    softbus_wire_put_u32(p + 1, st->dest.sin_addr.s_addr);
+    softbus_wire_put_u32(p + 5, st->next_seq - 1);
+    softbus_wire_put_u32(p + 9, first_held_seq(st));
+    softbus_wire_put_u32(p + 13, st->retx_epoch);
+    rm->output(rm->output_ctx, dest ? dest : &st->dest, buf, sizeof(buf));
+    if (!dest) {
+        st->last_heartbeat_ns = now;
+    }
+    RM_STAT_INC(rm, heartbeats);
+}
+
+// NACK中接收方发出请求时的进度，用来判断请求是否早于上次重传到达
+typedef struct {
+    bool valid;                     // 旧格式NACK不带进度
+    uint32_t seen;                  // 接收方见过的最大序号
+    uint32_t epoch;                 // 接收方从心跳得知的最新重传轮次
+} rm_nack_marks_t;
+
+// 按序号把重传请求并入待重传集合，返回是否新安排了一次重传，调用者需持有send_mutex。
+// 重传过的数据报，只有接收方已收到重传之后发出的数据或心跳仍缺它时才再重传，否则这个NACK是在重传到达之前发出的；
+// 拥塞时修复时延变长，这样判断不依赖固定的时间间隔。*stale表示请求因此被忽略且重传已过去较久，标记可能丢了
+static bool retx_request_locked(rm_send_stream_t* st, uint32_t seq, const rm_nack_marks_t* marks, uint64_t now,
+                                bool* stale) {
+    rm_history_t* h = &st->history[seq % RMCAST_HISTORY_SIZE];
+    if (h->len == 0 || h->seq != seq) {
+        return false;
+    }
+    if (h->last_retx_ns != 0) {
+        bool recent = now - h->last_retx_ns < MS_TO_NS(RMCAST_RETX_HOLDOFF_MS);
+        if (!marks->valid) {
+            if (recent) {
+                return false;
+            }
+        } else if (SEQ_DIFF(marks->seen, h->retx_next_seq) < 0 && SEQ_DIFF(marks->epoch, h->retx_epoch) < 0) {
+            *stale = *stale || !recent;
+            return false;
+        }
+    }
+    uint32_t idx = seq % RMCAST_HISTORY_SIZE;
+    st->retx_pending[idx >> 3] |= (uint8_t)(1u << (idx & 7));
+    if (st->retx_due_ns == 0) {
+        st->retx_lo = seq;
+        st->retx_hi = seq + 1;
+        st->retx_due_ns = now + MS_TO_NS(RMCAST_RETX_DELAY_MS);
+        return true;
+    }
+    if (SEQ_DIFF(seq, st->retx_lo) < 0) {
+        st->retx_lo = seq;
+    }
+    if (SEQ_DIFF(seq + 1, st->retx_hi) > 0) {
+        st->retx_hi = seq + 1;
+    }
+    return false;
+}
+
+// 重传汇总的全部请求，每个数据报只发一次，调用者需持有send_mutex。
+// 最近没有发新数据时随后发一个心跳，让接收方得知新的重传轮次，否则之后的请求无法与重传前的区分
+static void retx_flush_locked(rmcast_t* rm, rm_send_stream_t* st, uint64_t now) {
+    uint32_t first = first_held_seq(st);
+    st->retx_epoch++;
+    for (uint32_t seq = st->retx_lo; seq != st->retx_hi; seq++) {
+        uint32_t idx = seq % RMCAST_HISTORY_SIZE;
+        uint8_t mask = (uint8_t)(1u << (idx & 7));
+        if (!(st->retx_pending[idx >> 3] & mask)) {
+            continue;
+        }
+        st->retx_pending[idx >> 3] &= (uint8_t)~mask;
+        // 汇总期间发送方可能已覆盖了这个数据报，接收方下一轮NACK会收到心跳
+        rm_history_t* h = &st->history[idx];
+        if (SEQ_DIFF(seq, first) < 0 || h->len == 0 || h->seq != seq) {
+            continue;
+        }
+        h->last_retx_ns = now;
+        h->retx_next_seq = st->next_seq;
+        h->retx_epoch = st->retx_epoch;
+        rm->output(rm->output_ctx, &st->dest, h->buf, h->len);
+        RM_STAT_INC(rm, retransmits);
+    }
+    st->retx_due_ns = 0;
+    if (now - st->last_send_ns >= MS_TO_NS(RMCAST_TICK_MS)) {
+        send_heartbeat_locked(rm, st, NULL, now);
+    }
+}
+
+static void note_peer_nack(rmcast_t* rm, uint32_t node_id, uint32_t stream, const uint8_t* ranges_buf, int ranges);
+
+// 处理NACK：发给本节点的把缺失区间并入待重传集合，汇总一段时间后统一重传；
+// 请求的数据已被覆盖时单播回一个心跳，告知接收方可以放弃到哪里。发给其他发送方的NACK用于抑制本节点的重复请求
+static void handle_nack(rmcast_t* rm, const uint8_t* body, size_t len, const struct sockaddr_in* sender) {
+    if (len < 6) {
+        return;
+    }
+    uint32_t stream = softbus_wire_get_u32(body + 1);
+    int ranges = body[5];
+    size_t ranges_end = 6 + (size_t)ranges * 6;
+    if (len < ranges_end) {
+        return;
+    }
+    // 区间之后是NACK所针对的发送方和接收方的进度；不带这些字段的旧格式NACK只会单播给发送方本身
+    uint32_t target = len >= ranges_end + 4 ? softbus_wire_get_u32(body + ranges_end) : rm->node_id;
+    rm_nack_marks_t marks = {.valid = len >= ranges_end + 12};
+    if (marks.valid) {
+        marks.seen = softbus_wire_get_u32(body + ranges_end + 4);
+        marks.epoch = softbus_wire_get_u32(body + ranges_end + 8);
+    }
+    if (target != rm->node_id) {
+        note_peer_nack(rm, target, stream, body + 6, ranges);
+        return;
+    }
+    RM_STAT_INC(rm, nacks_received);
+
+    pthread_mutex_lock(&rm->send_mutex);
+    uint64_t now = softbus_io_now_ns();
+    rm_send_stream_t* st = NULL;
+    for (int i = 0; i < RMCAST_MAX_SEND_STREAMS; i++) {
+        if (rm->send_streams[i].in_use && rm->send_streams[i].dest.sin_addr.s_addr == stream) {
+            st = &rm->send_streams[i];
+            break;
+        }
+    }
+    if (!st) {
+        pthread_mutex_unlock(&rm->send_mutex);
+        return;
+    }
+
+    uint32_t first = first_held_seq(st);
+    bool expired = false;
+    bool stale = false;
+    bool scheduled = false;
+    for (int r = 0; r < ranges; r++) {
+        uint32_t start = softbus_wire_get_u32(body + 6 + r * 6);
+        uint16_t count = softbus_wire_get_u16(body + 6 + r * 6 + 4);
+        for (uint32_t seq = start; seq != start + count; seq++) {
+            if (SEQ_DIFF(seq, first) < 0) {
+                expired = true;
+                continue;
+            }
+            if (SEQ_DIFF(seq, st->next_seq) >= 0) {
+                break;
+            }
+            scheduled = retx_request_locked(st, seq, &marks, now, &stale) || scheduled;
+        }
+    }
+    // 心跳同时告知接收方可以放弃到哪里和最新的重传轮次
+    if (expired || stale) {
+        send_heartbeat_locked(rm, st, sender, now);
+    }
+    pthread_mutex_unlock(&rm->send_mutex);
+
+    if (scheduled) {
+        rm_arm_timer();
+    }
+}
+
+// ---- 接收方 ----
+
+static bool bit_test(const rm_recv_stream_t* st, uint32_t seq) {
+    uint32_t idx = seq % RMCAST_WINDOW;
+    return (st->bitmap[idx >> 3] >> (idx & 7)) & 1;
+}
+
+static void bit_set(rm_recv_stream_t* st, uint32_t seq) {
+    uint32_t idx = seq % RMCAST_WINDOW;
+    st->bitmap[idx >> 3] |= (uint8_t)(1u << (idx & 7));
+}
+
+static void bit_clear(rm_recv_stream_t* st, uint32_t seq) {
+    uint32_t idx = seq % RMCAST_WINDOW;
+    st->bitmap[idx >> 3] &= (uint8_t)~(1u << (idx & 7));
+    st->requested[idx >> 3] &= (uint8_t)~(1u << (idx & 7));
+}
+
+static bool requested_test(const rm_recv_stream_t* st, uint32_t seq) {
+    uint32_t idx = seq % RMCAST_WINDOW;
+    return (st->requested[idx >> 3] >> (idx & 7)) & 1;
+}
+
+// 本轮NACK前的随机等待，调用者需持有recv_mutex
+static uint64_t nack_jitter_ns_locked(rmcast_t* rm) {
+    uint32_t x = rm->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rm->rng = x;
+    return (uint64_t)x % MS_TO_NS(RMCAST_NACK_JITTER_MS);
+}
+
+// 出现新的空洞时安排NACK：等待乱序数据和随机时间，已安排的更早一轮保持不变
+static void nack_schedule_locked(rmcast_t* rm, rm_recv_stream_t* st, uint64_t now) {
+    uint64_t due = now + MS_TO_NS(RMCAST_NACK_DELAY_MS) + nack_jitter_ns_locked(rm);
+    if (st->nack_due_ns == 0 || due < st->nack_due_ns) {
+        st->nack_due_ns = due;
+    }
+}
+
+// 把base推进到new_base，未收到的序号计为丢失
+static void advance_base(rmcast_t* rm, rm_recv_stream_t* st, uint32_t new_base) {
+    while (SEQ_DIFF(new_base, st->base) > 0) {
+        if (!bit_test(st, st->base)) {
+            RM_STAT_INC(rm, rx_lost);
+        }
+        bit_clear(st, st->base);
+        st->base++;
+    }
+    // 滑过已连续收到的部分
+    while (SEQ_DIFF(st->highest, st->base) > 0 && bit_test(st, st->base)) {
+        bit_clear(st, st->base);
+        st->base++;
+    }
+    if (SEQ_DIFF(st->highest, st->base) <= 0) {
+        st->highest = st->base;
+        st->gap_since_ns = 0;
+        st->nack_due_ns = 0;
+        st->nack_backoff = 0;
+    }
+}
+
+static void stream_reset(rm_recv_stream_t* st, uint32_t base) {
+    memset(st->bitmap, 0, sizeof(st->bitmap));
+    memset(st->requested, 0, sizeof(st->requested));
+    st->base = base;
+    st->highest = base;
+    st->gap_since_ns = 0;
+    st->nack_due_ns = 0;
+    st->nack_backoff = 0;
+    st->retx_epoch = 0;
+}
+
+static rm_recv_stream_t* recv_stream_find_locked(rmcast_t* rm, uint32_t node_id, uint32_t stream) {
+    for (int i = 0; i < RMCAST_MAX_RECV_STREAMS; i++) {
+        rm_recv_stream_t* st = &rm->recv_streams[i];
+        if (st->in_use && st->node_id == node_id && st->stream == stream) {
+            return st;
+        }
+    }
+    return NULL;
+}
+
+static rm_recv_stream_t* recv_stream_get_locked(rmcast_t* rm, uint32_t node_id, uint32_t stream, uint32_t start_seq, bool* created) {
+    rm_recv_stream_t* free_stream = NULL;
+    rm_recv_stream_t* idlest = NULL;
+    *created = false;
+    for (int i = 0; i < RMCAST_MAX_RECV_STREAMS; i++) {
+        rm_recv_stream_t* st = &rm->recv_streams[i];
+        if (!st->in_use) {
+            if (!free_stream) {
+                free_stream = st;
+            }
+            continue;
+        }
+        if (st->node_id == node_id && st->stream == stream) {
+            return st;
+        }
+        if (!idlest || st->last_active_ns < idlest->last_active_ns) {
+            idlest = st;
+        }
+    }
+
+    rm_recv_stream_t* st = free_stream ? free_stream : idlest;
+    memset(st, 0, sizeof(*st));
+    st->in_use = true;
+    st->node_id = node_id;
+    st->stream = stream;
+    st->created_ns = softbus_io_now_ns();
+    // 从第一次见到的序号开始跟踪，不追讨加入之前的数据
+    stream_reset(st, start_seq);
+    *created = true;
+    return st;
+}
+
+// 记录新获知的最大序号，超出窗口的部分直接放弃
+static void note_highest(rmcast_t* rm, rm_recv_stream_t* st, uint32_t highest, uint64_t now) {
+    if (SEQ_DIFF(highest, st->highest) <= 0) {
+        return;
+    }
+    if (SEQ_DIFF(highest, st->base) > 4 * RMCAST_WINDOW) {
+        // 相差过大，多半是发送方重启或长时间分区，重新同步
+        stream_reset(st, highest);
+        return;
+    }
+    st->highest = highest;
+    if (SEQ_DIFF(highest, st->base) > RMCAST_WINDOW) {
+        advance_base(rm, st, highest - RMCAST_WINDOW);
+    }
+    if (SEQ_DIFF(st->highest, st->base) > 0 && st->gap_since_ns == 0) {
+        st->gap_since_ns = now;
+    }
+}
+
+bool rmcast_accept(rmcast_t* rm, const softbus_wire_hdr_t* hdr, const struct sockaddr_in* sender) {
+    uint64_t now = softbus_io_now_ns();
+    bool has_gap;
+
+    pthread_mutex_lock(&rm->recv_mutex);
+    bool created;
+    rm_recv_stream_t* st = recv_stream_get_locked(rm, hdr->node_id, hdr->stream, hdr->seq, &created);
+    st->sender = *sender;
+    st->last_active_ns = now;
+
+    // 流刚建立时，比首个数据报发得早但乱序晚到的数据报不是重复，把base退回到它
+    if (!created && SEQ_DIFF(hdr->seq, st->base) < 0 && SEQ_DIFF(st->highest, hdr->seq) < RMCAST_WINDOW &&
+        now - st->created_ns < MS_TO_NS(RMCAST_NACK_INTERVAL_MS)) {
+        st->base = hdr->seq;
+        if (st->gap_since_ns == 0) {
+            st->gap_since_ns = now;
+        }
+        nack_schedule_locked(rm, st, now);
+    }
+
+    if (SEQ_DIFF(hdr->seq, st->base) < 0 || (SEQ_DIFF(hdr->seq, st->highest) < 0 && bit_test(st, hdr->seq))) {
+        pthread_mutex_unlock(&rm->recv_mutex);
+        RM_STAT_INC(rm, rx_duplicates);
+        return false;
+    }
+
+    bool fills_gap = SEQ_DIFF(hdr->seq, st->highest) < 0;
+    bool new_hole = SEQ_DIFF(hdr->seq, st->highest) > 0;
+    note_highest(rm, st, hdr->seq + 1, now);
+    if (SEQ_DIFF(hdr->seq, st->base) >= 0) {
+        bit_set(st, hdr->seq);
+        advance_base(rm, st, st->base);
+    }
+    has_gap = st->gap_since_ns != 0;
+    if (has_gap && new_hole) {
+        nack_schedule_locked(rm, st, now);
+    } else if (has_gap && fills_gap) {
+        // 发送方正在重传，同一批重传的其余数据报多半随后就到，推迟本节点的下一轮NACK
+        uint64_t due = now + MS_TO_NS(RMCAST_NACK_DELAY_MS);
+        if (st->nack_due_ns < due) {
+            st->nack_due_ns = due;
+        }
+    }
+    pthread_mutex_unlock(&rm->recv_mutex);
+
+    if (fills_gap && !created) {
+        RM_STAT_INC(rm, rx_recovered);
+    }
+    if (has_gap) {
+        rm_arm_timer();
+    }
+    return true;
+}
+
+static void handle_heartbeat(rmcast_t* rm, const softbus_wire_hdr_t* hdr, const uint8_t* body, size_t len,
+                             const struct sockaddr_in* sender) {
+    if (len < 9) {
+        return;
+    }
+    uint32_t stream = softbus_wire_get_u32(body + 1);
+    uint32_t last_seq = softbus_wire_get_u32(body + 5);
+    // 不带first_seq的心跳视为发送方仍保留全部数据
+    uint32_t first_seq = len >= 13 ? softbus_wire_get_u32(body + 9) : 0;
+    bool has_epoch = len >= 17;
+    uint32_t epoch = has_epoch ? softbus_wire_get_u32(body + 13) : 0;
+    uint64_t now = softbus_io_now_ns();
+
+    pthread_mutex_lock(&rm->recv_mutex);
+    bool created;
+    rm_recv_stream_t* st = recv_stream_get_locked(rm, hdr->node_id, stream, last_seq + 1, &created);
+    st->sender = *sender;
+    st->last_active_ns = now;
+    if (has_epoch && SEQ_DIFF(epoch, st->retx_epoch) > 0) {
+        st->retx_epoch = epoch;
+    }
+    bool new_hole = SEQ_DIFF(last_seq + 1, st->highest) > 0;
+    note_highest(rm, st, last_seq + 1, now);
+    // 发送方已不再保留的部分无法恢复
+    if (first_seq != 0 && SEQ_DIFF(first_seq, st->base) > 0 && SEQ_DIFF(st->highest, first_seq) >= 0) {
+        advance_base(rm, st, first_seq);
+    }
+    bool has_gap = st->gap_since_ns != 0;
+    if (has_gap && new_hole) {
+        nack_schedule_locked(rm, st, now);
+    }
+    pthread_mutex_unlock(&rm->recv_mutex);
+
+    if (has_gap) {
+        rm_arm_timer();
+    }
+}
+
+// 为一个有空洞的流发送一轮NACK，只请求还没有其他接收方请求过的序号，并安排下一轮，调用者需持有recv_mutex
+static void send_nack_locked(rmcast_t* rm, rm_recv_stream_t* st, uint64_t now) {
+    uint8_t buf[SOFTBUS_WIRE_HDR_SIZE + 6 + RMCAST_NACK_MAX_RANGES * 6 + 12];
+    encode_control_hdr(rm, buf);
+    uint8_t* p = buf + SOFTBUS_WIRE_HDR_SIZE;
+    p[0] = SOFTBUS_WIRE_CTRL_NACK;
+    softbus_wire_put_u32(p + 1, st->stream);
+
+    int ranges = 0;
+    uint64_t suppressed = 0;
+    uint32_t seq = st->base;
+    while (SEQ_DIFF(st->highest, seq) > 0 && ranges < RMCAST_NACK_MAX_RANGES) {
+        if (bit_test(st, seq)) {
+            seq++;
+            continue;
+        }
+        if (requested_test(st, seq)) {
+            suppressed++;
+            seq++;
+            continue;
+        }
+        uint32_t start = seq;
+        while (SEQ_DIFF(st->highest, seq) > 0 && !bit_test(st, seq) && !requested_test(st, seq) && seq - start < 0xffff) {
+            seq++;
+        }
+        softbus_wire_put_u32(p + 6 + ranges * 6, start);
+        softbus_wire_put_u16(p + 6 + ranges * 6 + 4, (uint16_t)(seq - start));
+        ranges++;
+    }
+
+    // 本轮之后其他接收方的请求重新计算；一直没有进展时加倍间隔
+    memset(st->requested, 0, sizeof(st->requested));
+    st->nack_due_ns = now + (MS_TO_NS(RMCAST_NACK_INTERVAL_MS) << st->nack_backoff) + nack_jitter_ns_locked(rm);
+    if (st->nack_backoff < RMCAST_NACK_MAX_BACKOFF) {
+        st->nack_backoff++;
+    }
+    if (suppressed) {
+        atomic_fetch_add_explicit(&rm->stats.nacks_suppressed, suppressed, memory_order_relaxed);
+    }
+    if (ranges == 0) {
+        return;
+    }
+    p[5] = (uint8_t)ranges;
+    softbus_wire_put_u32(p + 6 + ranges * 6, st->node_id);
+    softbus_wire_put_u32(p + 6 + ranges * 6 + 4, st->highest - 1);
+    softbus_wire_put_u32(p + 6 + ranges * 6 + 8, st->retx_epoch);
+    size_t len = SOFTBUS_WIRE_HDR_SIZE + 6 + ranges * 6 + 12;
+
+    // 单播保证发送方收到（它不一定加入了组），组播让其他接收方看到并抑制同样的请求
+    rm->output(rm->output_ctx, &st->sender, buf, len);
+    if (rm->group_port) {
+        struct sockaddr_in group = {.sin_family = AF_INET, .sin_port = rm->group_port};
+        group.sin_addr.s_addr = st->stream;
+        rm->output(rm->output_ctx, &group, buf, len);
+    }
+    RM_STAT_INC(rm, nacks_sent);
+}
+
+// 其他接收方对同一个流的NACK：记下它请求的序号，本节点下一轮不再重复请求
+static void note_peer_nack(rmcast_t* rm, uint32_t node_id, uint32_t stream, const uint8_t* ranges_buf, int ranges) {
+    pthread_mutex_lock(&rm->recv_mutex);
+    rm_recv_stream_t* st = recv_stream_find_locked(rm, node_id, stream);
+    for (int r = 0; st && st->gap_since_ns != 0 && r < ranges; r++) {
+        uint32_t start = softbus_wire_get_u32(ranges_buf + r * 6);
+        uint16_t count = softbus_wire_get_u16(ranges_buf + r * 6 + 4);
+        for (uint32_t seq = start; seq != start + count; seq++) {
+            if (SEQ_DIFF(seq, st->base) < 0) {
+                continue;
+            }
+            if (SEQ_DIFF(seq, st->highest) >= 0) {
+                break;
+            }
+            uint32_t idx = seq % RMCAST_WINDOW;
+            st->requested[idx >> 3] |= (uint8_t)(1u << (idx & 7));
+        }
+    }
+    pthread_mutex_unlock(&rm->recv_mutex);
+}
+
+void rmcast_handle_control(rmcast_t* rm, const softbus_wire_hdr_t* hdr, const uint8_t* body, size_t len,
+                           const struct sockaddr_in* sender) {
+    if (!rm || !hdr || !body || len < 1 || !sender) {
+        return;
+    }
+    switch (body[0]) {
+        case SOFTBUS_WIRE_CTRL_HEARTBEAT:
+            handle_heartbeat(rm, hdr, body, len, sender);
+            break;
+        case SOFTBUS_WIRE_CTRL_NACK:
+            handle_nack(rm, body, len, sender);
+            break;
+        default:
+            break;
+    }
+}
+
+// 定时处理所有实例，仍有待处理的空洞或心跳时再次启动定时器
+static void rm_tick_all(void* ctx) {
+    (void)ctx;
+    bool pending = false;
+
+    pthread_mutex_lock(&g_rmcast.mutex);
+    g_rmcast.timer_id = 0;
+    for (rmcast_t* rm = g_rmcast.instances; rm; rm = rm->next) {
+        pending = rm_tick(rm) || pending;
+    }
+    if (pending) {
+        int id = softbus_io_timer_add((uint64_t)RMCAST_TICK_MS * 1000ULL, 0, rm_tick_all, NULL);
+        g_rmcast.timer_id = id > 0 ? id : 0;
+    }
+    pthread_mutex_unlock(&g_rmcast.mutex);
+}
+
+// 定时处理一个实例：接收方到时的流发一轮NACK，发送方长时间无响应时放弃；发送方重传汇总的请求，在空闲期发心跳。
+// 返回是否仍有待处理的工作。时间在加锁后读取，不会早于锁内记录的各时间戳
+static bool rm_tick(rmcast_t* rm) {
+    bool pending = false;
+
+    pthread_mutex_lock(&rm->recv_mutex);
+    uint64_t now = softbus_io_now_ns();
+    for (int i = 0; i < RMCAST_MAX_RECV_STREAMS; i++) {
+        rm_recv_stream_t* st = &rm->recv_streams[i];
+        if (!st->in_use || st->gap_since_ns == 0) {
+            continue;
+        }
+        pending = true;
+        if (st->nack_due_ns == 0) {
+            nack_schedule_locked(rm, st, st->gap_since_ns);
+        }
+        if (now < st->nack_due_ns) {
+            continue;
+        }
+        if (now - st->last_active_ns >= MS_TO_NS(RMCAST_SENDER_TIMEOUT_MS)) {
+            // 发送方仍保留数据时会回应重传或心跳，这么久没有任何回应说明已离开
+            advance_base(rm, st, st->highest);
+            continue;
+        }
+        send_nack_locked(rm, st, now);
+    }
+    pthread_mutex_unlock(&rm->recv_mutex);
+
+    pthread_mutex_lock(&rm->send_mutex);
+    now = softbus_io_now_ns();
+    for (int i = 0; i < RMCAST_MAX_SEND_STREAMS; i++) {
+        rm_send_stream_t* st = &rm->send_streams[i];
+        if (st->in_use && st->retx_due_ns != 0) {
+            pending = true;
+            if (now >= st->retx_due_ns) {
+                retx_flush_locked(rm, st, now);
+            }
+        }
+        if (!st->in_use || st->last_send_ns == 0) {
+            continue;
+        }
+        if (now - st->last_send_ns > MS_TO_NS(RMCAST_HEARTBEAT_LINGER_MS)) {
+            st->last_send_ns = 0;  // 空闲足够久，停止心跳直到下次发送
+            continue;
+        }
+        pending = true;
+        if (now - st->last_heartbeat_ns >= MS_TO_NS(RMCAST_HEARTBEAT_MS) &&
+            now - st->last_send_ns >= MS_TO_NS(RMCAST_HEARTBEAT_MS)) {
+            send_heartbeat_locked(rm, st, NULL, now);
+        }
+    }
+    pthread_mutex_unlock(&rm->send_mutex);
+    return pending;
+}
+
+void rmcast_get_stats(rmcast_t* rm, rmcast_stats_t* stats) {
+    if (!rm || !stats) {
+        return;
+    }
+    stats->tx_sequenced = atomic_load_explicit(&rm->stats.tx_sequenced, memory_order_relaxed);
+    stats->retransmits = atomic_load_explicit(&rm->stats.retransmits, memory_order_relaxed);
+    stats->heartbeats = atomic_load_explicit(&rm->stats.heartbeats, memory_order_relaxed);
+    stats->nacks_sent = atomic_load_explicit(&rm->stats.nacks_sent, memory_order_relaxed);
+    stats->nacks_received = atomic_load_explicit(&rm->stats.nacks_received, memory_order_relaxed);
+    stats->nacks_suppressed = atomic_load_explicit(&rm->stats.nacks_suppressed, memory_order_relaxed);
+    stats->rx_duplicates = atomic_load_explicit(&rm->stats.rx_duplicates, memory_order_relaxed);
+    stats->rx_recovered = atomic_load_explicit(&rm->stats.rx_recovered, memory_order_relaxed);
+    stats->rx_lost = atomic_load_explicit(&rm->stats.rx_lost, memory_order_relaxed);
+}
+
+void rmcast_reset_stats(rmcast_t* rm) {
+    if (!rm) {
+        return;
+    }
+    atomic_store_explicit(&rm->stats.tx_sequenced, 0, memory_order_relaxed);
+    atomic_store_explicit(&rm->stats.retransmits, 0, memory_order_relaxed);
+    atomic_store_explicit(&rm->stats.heartbeats, 0, memory_order_relaxed);
+    atomic_store_explicit(&rm->stats.nacks_sent, 0, memory_order_relaxed);
+    atomic_store_explicit(&rm->stats.nacks_received, 0, memory_order_relaxed);
+    atomic_store_explicit(&rm->stats.nacks_suppressed, 0, memory_order_relaxed);
+    atomic_store_explicit(&rm->stats.rx_duplicates, 0, memory_order_relaxed);
+    atomic_store_explicit(&rm->stats.rx_recovered, 0, memory_order_relaxed);
+    atomic_store_explicit(&rm->stats.rx_lost, 0, memory_order_relaxed);
+}
@@ -0,0 +1,579 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "softbus_shm.h"
+
+#if ENABLE_SHM_TRANSPORT
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <time.h>
+#include "message_queue.h"
+#include "softbus_log.h"
+
+#define SHM_MAGIC   0x53425348  // "SBSH"
+#define SHM_VERSION 2
+#define SHM_CACHE_LINE 64
+
+// init_state：0未初始化，SHM_INIT_READY已完成，带SHM_INIT_OWNER标志时低位是正在初始化的进程pid
+#define SHM_INIT_READY 2u
+#define SHM_INIT_OWNER 0x80000000u
+#define SHM_INIT_TIMEOUT_NS (1000ULL * 1000000ULL)  // 等待其他进程完成初始化的上限
+
+#define SHM_STATE_EMPTY 0
+#define SHM_STATE_BUSY  1
+#define SHM_STATE_READY 2
+
+#define SHM_LIVENESS_CHECK_NS (10ULL * 1000000ULL)  // 同一目标进程两次kill探测的最小间隔
+#define SHM_STALL_TIMEOUT_NS (500ULL * 1000000ULL)  // 已占用未发布的槽位挡住队列多久后检查占用者
+
+// 环形队列槽位（Vyukov有界队列，seq标识槽位状态）
+typedef struct {
+    _Atomic uint64_t seq;
+    _Atomic int32_t writer;  // 占用槽位的生产者pid，消费者释放槽位时清零
+    uint32_t len;
+    uint8_t type;
+    uint8_t priority;
+    char target[MAX_NAME_LENGTH];
+    uint8_t data[SHM_MAX_PAYLOAD];
+} shm_cell_t;
+
+// 每个进程一个收件环：多个进程写入，本进程单线程读取
+typedef struct {
+    _Atomic uint64_t head __attribute__((aligned(SHM_CACHE_LINE)));
+    _Atomic uint64_t tail __attribute__((aligned(SHM_CACHE_LINE)));
+    _Atomic uint32_t doorbell __attribute__((aligned(SHM_CACHE_LINE)));  // futex字
+    _Atomic uint32_t sleeping;                                            // 接收方是否在futex上等待
+    shm_cell_t cells[SHM_RING_SLOTS] __attribute__((aligned(SHM_CACHE_LINE)));
+} shm_ring_t;
+
+// 进程槽位
+typedef struct {
+    _Atomic int32_t pid;
+} shm_proc_t;
+
+// 设备目录项：设备名 -> 进程槽位
+typedef struct {
+    _Atomic uint32_t state;
+    int32_t proc;
+    char name[MAX_NAME_LENGTH];
+} shm_dir_entry_t;
+
+// 共享内存段布局
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    _Atomic uint32_t init_state;
+    shm_proc_t procs[SHM_MAX_PROCS];
+    shm_dir_entry_t directory[SHM_MAX_DEVICES];
+    shm_ring_t rings[SHM_MAX_PROCS];
+} shm_segment_t;
+
+// 本进程状态
+static struct {
+    shm_segment_t* seg;
+    int self;
+    pthread_t thread;
+    _Atomic int running;
+    int spin_count;
+    shm_receive_handler_t handler;
+    void* user_data;
+    int32_t pid;
+    // 收件环队头被占用未发布的槽位挡住时，开始等待的位置和时间
+    uint64_t stall_pos;
+    uint64_t stall_since_ns;
+    // 各进程槽位上次确认存活的pid和时间，发送路径据此限制kill探测频率
+    _Atomic int32_t live_pid[SHM_MAX_PROCS];
+    _Atomic uint64_t live_checked_ns[SHM_MAX_PROCS];
+} g_shm = {.seg = NULL, .self = -1};
+
+// 内部函数声明
+static bool proc_is_dead(int32_t pid);
+static uint64_t coarse_now_ns(void);
+static void default_receive_handler(const char* target, message_type_t type, softbus_priority_t priority,
+                                    const void* data, size_t len, void* user_data);
+
+static long futex_wait(_Atomic uint32_t* addr, uint32_t expected, const struct timespec* timeout) {
+    return syscall(SYS_futex, (uint32_t*)addr, FUTEX_WAIT, expected, timeout, NULL, 0);
+}
+
+static long futex_wake(_Atomic uint32_t* addr) {
+    return syscall(SYS_futex, (uint32_t*)addr, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+static void ring_reset(shm_ring_t* ring) {
+    for (uint64_t i = 0; i < SHM_RING_SLOTS; i++) {
+        atomic_store_explicit(&ring->cells[i].seq, i, memory_order_relaxed);
+        atomic_store_explicit(&ring->cells[i].writer, 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&ring->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->doorbell, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->sleeping, 0, memory_order_release);
+}
+
+// 多生产者入队，队列满时返回SOFTBUS_BUSY
+static int ring_push(shm_ring_t* ring, const char* target, message_type_t type, softbus_priority_t priority,
+                     const void* data, size_t len) {
+    uint64_t pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    shm_cell_t* cell;
+
+    for (;;) {
+        cell = &ring->cells[pos & (SHM_RING_SLOTS - 1)];
+        uint64_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        int64_t diff = (int64_t)seq - (int64_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring->head, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return SOFTBUS_BUSY;
+        } else {
+            pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        }
+    }
+
+    // 占用后立即登记，崩溃在发布前时消费者据此确认占用者已退出
+    atomic_store_explicit(&cell->writer, g_shm.pid, memory_order_relaxed);
+    strncpy(cell->target, target, MAX_NAME_LENGTH - 1);
+    cell->target[MAX_NAME_LENGTH - 1] = '\0';
+    cell->type = (uint8_t)type;
+    cell->priority = (uint8_t)priority;
+    cell->len = (uint32_t)len;
+    memcpy(cell->data, data, len);
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+
+    // 只有接收方已经睡眠时才需要系统调用唤醒。发布槽位与读取sleeping之间需要全屏障，
+    // 否则读取可能提前到发布之前，与接收方"置sleeping后检查队列为空"交错而漏掉唤醒
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&ring->sleeping, memory_order_relaxed)) {
+        atomic_fetch_add_explicit(&ring->doorbell, 1, memory_order_seq_cst);
+        futex_wake(&ring->doorbell);
+    }
+    return SOFTBUS_OK;
+}
+
+// 释放队头槽位给生产者
+static void ring_release(shm_ring_t* ring, shm_cell_t* cell, uint64_t pos) {
+    atomic_store_explicit(&cell->writer, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, pos + 1, memory_order_relaxed);
+    atomic_store_explicit(&cell->seq, pos + SHM_RING_SLOTS, memory_order_release);
+}
+
+// 队头槽位已被占用（head越过它）但未发布时，后面已发布的消息都被挡住。
+// 持续超过SHM_STALL_TIMEOUT_NS且占用者已退出时跳过该槽位；占用者仍在（如被调试器暂停）则继续等待。
+// writer为0表示占用者在占用与登记之间就停止了，超时后同样视为已退出
+static bool ring_skip_stale(shm_ring_t* ring, shm_cell_t* cell, uint64_t pos) {
+    if (atomic_load_explicit(&ring->head, memory_order_relaxed) <= pos) {
+        return false;
+    }
+    uint64_t now = coarse_now_ns();
+    if (g_shm.stall_pos != pos) {
+        g_shm.stall_pos = pos;
+        g_shm.stall_since_ns = now;
+        return false;
+    }
+    if (now - g_shm.stall_since_ns < SHM_STALL_TIMEOUT_NS) {
+        return false;
+    }
+    int32_t writer = atomic_load_explicit(&cell->writer, memory_order_relaxed);
+    if (writer != 0 && !proc_is_dead(writer)) {
+        return false;
+    }
+    SOFTBUS_LOGW("Skipping shm ring slot %llu left unpublished by exited process %d\n",
+                 (unsigned long long)pos, (int)writer);
+    ring_release(ring, cell, pos);
+    return true;
+}
+
+// 单消费者出队，取到的槽位在回调返回后才释放
+static bool ring_pop(shm_ring_t* ring) {
+    uint64_t pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    shm_cell_t* cell = &ring->cells[pos & (SHM_RING_SLOTS - 1)];
+    uint64_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+    if ((int64_t)seq - (int64_t)(pos + 1) < 0) {
+        return ring_skip_stale(ring, cell, pos);
+    }
+
+    size_t len = cell->len <= SHM_MAX_PAYLOAD ? cell->len : SHM_MAX_PAYLOAD;
+    g_shm.handler(cell->target, (message_type_t)cell->type, (softbus_priority_t)cell->priority,
+                  cell->data, len, g_shm.user_data);
+
+    ring_release(ring, cell, pos);
+    return true;
+}
+
+static bool ring_empty(shm_ring_t* ring) {
+    uint64_t pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    shm_cell_t* cell = &ring->cells[pos & (SHM_RING_SLOTS - 1)];
+    uint64_t seq = atomic_load_explicit(&cell->seq, memory_order_seq_cst);
+    return (int64_t)seq - (int64_t)(pos + 1) < 0;
+}
+
+// 接收线程：先自旋，空闲后在门铃futex上等待
+static void* shm_receiver_thread(void* arg) {
+    (void)arg;
+    shm_ring_t* ring = &g_shm.seg->rings[g_shm.self];
+    struct timespec timeout = {0, 100 * 1000 * 1000};
+
+    while (g_shm.running) {
+        bool got = false;
+        for (int spin = 0; spin <= g_shm.spin_count && g_shm.running; spin++) {
+            if (ring_pop(ring)) {
+                got = true;
+                break;
+            }
+        }
+        if (got) {
+            while (ring_pop(ring)) {
+            }
+            continue;
+        }
+
+        uint32_t bell = atomic_load_explicit(&ring->doorbell, memory_order_seq_cst);
+        atomic_store_explicit(&ring->sleeping, 1, memory_order_seq_cst);
+        // 与ring_push中的屏障配对：要么发送方看到sleeping，要么这里看到新槽位
+        atomic_thread_fence(memory_order_seq_cst);
+        if (ring_empty(ring) && g_shm.running) {
+            // 超时用于检查停止标志
+            futex_wait(&ring->doorbell, bell, &timeout);
+        }
+        atomic_store_explicit(&ring->sleeping, 0, memory_order_relaxed);
+    }
+
+    return NULL;
+}
+
+// 进程槽位对应的进程是否已退出
+static bool proc_is_dead(int32_t pid) {
+    return pid > 0 && kill(pid, 0) < 0 && errno == ESRCH;
+}
+
+static uint64_t coarse_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// 发送路径上的存活检查：kill是系统调用，同一槽位的同一pid在SHM_LIVENESS_CHECK_NS内只探测一次
+static bool proc_is_alive_cached(int proc, int32_t pid) {
+    uint64_t now = coarse_now_ns();
+    if (atomic_load_explicit(&g_shm.live_pid[proc], memory_order_relaxed) == pid &&
+        now - atomic_load_explicit(&g_shm.live_checked_ns[proc], memory_order_relaxed) < SHM_LIVENESS_CHECK_NS) {
+        return true;
+    }
+    if (proc_is_dead(pid)) {
+        return false;
+    }
+    atomic_store_explicit(&g_shm.live_checked_ns[proc], now, memory_order_relaxed);
+    atomic_store_explicit(&g_shm.live_pid[proc], pid, memory_order_relaxed);
+    return true;
+}
+
+// 等待其他进程完成段初始化。初始化者已退出时接管初始化，返回本进程的标记；
+// 超时仍未完成时返回当前状态（不是SHM_INIT_READY）
+static uint32_t wait_segment_init(shm_segment_t* seg, uint32_t self_mark) {
+    uint64_t deadline = coarse_now_ns() + SHM_INIT_TIMEOUT_NS;
+    uint32_t state;
+    while ((state = atomic_load_explicit(&seg->init_state, memory_order_acquire)) != SHM_INIT_READY) {
+        if ((state & SHM_INIT_OWNER) && proc_is_dead((int32_t)(state & ~SHM_INIT_OWNER)) &&
+            atomic_compare_exchange_strong(&seg->init_state, &state, self_mark)) {
+            return self_mark;
+        }
+        if (coarse_now_ns() >= deadline) {
+            return state;
+        }
+        sched_yield();
+    }
+    return state;
+}
+
+static void release_proc_devices(int proc) {
+    for (int i = 0; i < SHM_MAX_DEVICES; i++) {
+        shm_dir_entry_t* entry = &g_shm.seg->directory[i];
+        if (atomic_load_explicit(&entry->state, memory_order_acquire) == SHM_STATE_READY && entry->proc == proc) {
+            atomic_store_explicit(&entry->state, SHM_STATE_EMPTY, memory_order_release);
+        }
+    }
+}
+
+int shm_transport_init(const char* bus_name) {
+    if (g_shm.seg) {
+        return SOFTBUS_OK;
+    }
+    if (!bus_name) {
+        bus_name = SHM_DEFAULT_BUS_NAME;
+    }
+
+    int fd = shm_open(bus_name, O_CREAT | O_RDWR | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        perror("Failed to open shared memory segment");
+        return SOFTBUS_ERROR;
+    }
+
+    // 所有进程设置相同大小，先到者的ftruncate生效
+    if (ftruncate(fd, sizeof(shm_segment_t)) < 0) {
+        perror("Failed to size shared memory segment");
+        close(fd);
+        return SOFTBUS_ERROR;
+    }
+
+    void* addr = mmap(NULL, sizeof(shm_segment_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        perror("Failed to map shared memory segment");
+        return SOFTBUS_ERROR;
+    }
+    shm_segment_t* seg = (shm_segment_t*)addr;
+
+    // 第一个进程负责初始化，其余进程等待初始化完成；初始化者中途退出时由等待者接管
+    int32_t pid = (int32_t)getpid();
+    uint32_t self_mark = SHM_INIT_OWNER | (uint32_t)pid;
+    uint32_t state = 0;
+    if (atomic_compare_exchange_strong(&seg->init_state, &state, self_mark)) {
+        state = self_mark;
+    } else {
+        state = wait_segment_init(seg, self_mark);
+    }
+    if (state == self_mark) {
+        seg->magic = SHM_MAGIC;
+        seg->version = SHM_VERSION;
+        for (int i = 0; i < SHM_MAX_PROCS; i++) {
+            atomic_store_explicit(&seg->procs[i].pid, 0, memory_order_relaxed);
+            ring_reset(&seg->rings[i]);
+        }
+        for (int i = 0; i < SHM_MAX_DEVICES; i++) {
+            atomic_store_explicit(&seg->directory[i].state, SHM_STATE_EMPTY, memory_order_relaxed);
+        }
+        atomic_store_explicit(&seg->init_state, SHM_INIT_READY, memory_order_release);
+    } else if (state != SHM_INIT_READY) {
+        SOFTBUS_LOGW("Shared memory segment %s is still being initialized, giving up\n", bus_name);
+        munmap(seg, sizeof(shm_segment_t));
+        return SOFTBUS_BUSY;
+    }
+
+    if (seg->magic != SHM_MAGIC || seg->version != SHM_VERSION) {
+        SOFTBUS_LOGW("Shared memory segment %s has incompatible layout\n", bus_name);
+        munmap(seg, sizeof(shm_segment_t));
+        return SOFTBUS_ERROR;
+    }
+
+    g_shm.seg = seg;
+    g_shm.pid = pid;
+    g_shm.stall_pos = UINT64_MAX;
+
+    // 占用进程槽位，回收已退出进程留下的槽位
+    for (int i = 0; i < SHM_MAX_PROCS && g_shm.self < 0; i++) {
+        int32_t owner = atomic_load_explicit(&seg->procs[i].pid, memory_order_acquire);
+        if (owner != 0 && !proc_is_dead(owner)) {
+            continue;
+        }
+        if (atomic_compare_exchange_strong(&seg->procs[i].pid, &owner, -pid)) {
+            release_proc_devices(i);
+            ring_reset(&seg->rings[i]);
+            atomic_store_explicit(&seg->procs[i].pid, pid, memory_order_release);
+            g_shm.self = i;
+        }
+    }
+
+    if (g_shm.self < 0) {
+        SOFTBUS_LOGW("No free process slot on shared memory bus %s\n", bus_name);
+        munmap(seg, sizeof(shm_segment_t));
+        g_shm.seg = NULL;
+        return SOFTBUS_BUSY;
+    }
+
+    if (!g_shm.handler) {
+        g_shm.handler = default_receive_handler;
+    }
+
+    // 单核上自旋只会抢占发送方，直接进入futex等待
+    g_shm.spin_count = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? SHM_SPIN_COUNT : 0;
+    return SOFTBUS_OK;
+}
+
+void shm_transport_deinit(void) {
+    if (!g_shm.seg) {
+        return;
+    }
+
+    shm_transport_stop();
+    release_proc_devices(g_shm.self);
+    atomic_store_explicit(&g_shm.seg->procs[g_shm.self].pid, 0, memory_order_release);
+    munmap(g_shm.seg, sizeof(shm_segment_t));
+    g_shm.seg = NULL;
+    g_shm.self = -1;
+}
+
+int shm_transport_unlink(const char* bus_name) {
+    if (shm_unlink(bus_name ? bus_name : SHM_DEFAULT_BUS_NAME) < 0 && errno != ENOENT) {
+        return SOFTBUS_ERROR;
+    }
+    return SOFTBUS_OK;
+}
+
+int shm_transport_start(void) {
+    if (!g_shm.seg) {
+        return SOFTBUS_ERROR;
+    }
+    if (g_shm.running) {
+        return SOFTBUS_OK;  // 已经在运行
+    }
+
+    g_shm.running = 1;
+    if (pthread_create(&g_shm.thread, NULL, shm_receiver_thread, NULL) != 0) {
+        perror("Failed to create shm receiver thread");
+        g_shm.running = 0;
+        return SOFTBUS_ERROR;
+    }
+    return SOFTBUS_OK;
+}
+
+void shm_transport_stop(void) {
+    if (!g_shm.running) {
+        return;
+    }
+
+    g_shm.running = 0;
+    shm_ring_t* ring = &g_shm.seg->rings[g_shm.self];
+    atomic_fetch_add_explicit(&ring->doorbell, 1, memory_order_seq_cst);
+    futex_wake(&ring->doorbell);
+    pthread_join(g_shm.thread, NULL);
+}
+
+int shm_transport_poll(int max_count) {
+    if (!g_shm.seg || max_count <= 0) {
+        return SOFTBUS_INVALID_ARG;
+    }
+    if (g_shm.running) {
+        return SOFTBUS_BUSY;  // 收件环只有一个消费者
+    }
+
+    shm_ring_t* ring = &g_shm.seg->rings[g_shm.self];
+    int count = 0;
+    while (count < max_count && ring_pop(ring)) {
+        count++;
+    }
+    return count;
+}
+
+int shm_transport_register_device(const char* device_name) {
+    if (!device_name) {
+        return SOFTBUS_INVALID_ARG;
+    }
+    if (!g_shm.seg) {
+        return SOFTBUS_ERROR;
+    }
+
+    for (int i = 0; i < SHM_MAX_DEVICES; i++) {
+        shm_dir_entry_t* entry = &g_shm.seg->directory[i];
+        uint32_t expected = SHM_STATE_EMPTY;
+        if (atomic_compare_exchange_strong(&entry->state, &expected, SHM_STATE_BUSY)) {
+            strncpy(entry->name, device_name, MAX_NAME_LENGTH - 1);
+            entry->name[MAX_NAME_LENGTH - 1] = '\0';
+            entry->proc = g_shm.self;
+            atomic_store_explicit(&entry->state, SHM_STATE_READY, memory_order_release);
+            return SOFTBUS_OK;
+        }
+    }
+    return SOFTBUS_BUSY;
+}
+
+int shm_transport_unregister_device(const char* device_name) {
+    if (!device_name || !g_shm.seg) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    for (int i = 0; i < SHM_MAX_DEVICES; i++) {
+        shm_dir_entry_t* entry = &g_shm.seg->directory[i];
+        if (atomic_load_explicit(&entry->state, memory_order_acquire) == SHM_STATE_READY &&
+            entry->proc == g_shm.self && strcmp(entry->name, device_name) == 0) {
+            atomic_store_explicit(&entry->state, SHM_STATE_EMPTY, memory_order_release);
+            return SOFTBUS_OK;
+        }
+    }
+    return SOFTBUS_NOT_FOUND;
+}
+
+int shm_transport_lookup(const char* device_name) {
+    if (!device_name || !g_shm.seg) {
+        return -1;
+    }
+
+    for (int i = 0; i < SHM_MAX_DEVICES; i++) {
+        shm_dir_entry_t* entry = &g_shm.seg->directory[i];
+        if (atomic_load_explicit(&entry->state, memory_order_acquire) != SHM_STATE_READY) {
+            continue;
+        }
+        int proc = entry->proc;
+        if (strcmp(entry->name, device_name) == 0 &&
+            atomic_load_explicit(&entry->state, memory_order_acquire) == SHM_STATE_READY) {
+            if (proc == g_shm.self || proc < 0 || proc >= SHM_MAX_PROCS) {
+                return -1;
+            }
+            // 目标进程已退出，包括未来得及清理槽位就崩溃的进程
+            int32_t pid = atomic_load_explicit(&g_shm.seg->procs[proc].pid, memory_order_acquire);
+            if (pid <= 0 || !proc_is_alive_cached(proc, pid)) {
+                return -1;
+            }
+            return proc;
+        }
+    }
+    return -1;
+}
+
+int shm_transport_lookup_pid(const char* device_name) {
+    int proc = shm_transport_lookup(device_name);
+    if (proc < 0) {
+        return -1;
+    }
+    int32_t pid = atomic_load_explicit(&g_shm.seg->procs[proc].pid, memory_order_acquire);
+    return pid > 0 ? pid : -1;
+}
+
+int shm_transport_send(const char* target, message_type_t type, softbus_priority_t priority,
+                       const void* data, size_t len) {
+    if (!target || (!data && len > 0) || len > SHM_MAX_PAYLOAD) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    int proc = shm_transport_lookup(target);
+    if (proc < 0) {
+        return SOFTBUS_NOT_FOUND;
+    }
+
+    return ring_push(&g_shm.seg->rings[proc], target, type, priority, data, len);
+}
+
+void shm_transport_set_receive_handler(shm_receive_handler_t handler, void* user_data) {
+    g_shm.handler = handler ? handler : default_receive_handler;
+    g_shm.user_data = user_data;
+}
+
+// 默认接收处理：投递到目标设备的消息队列。在接收线程中执行，
+// message_queue_send在目标设备的队列锁内入队，与处理线程的出队互斥
+static void default_receive_handler(const char* target, message_type_t type, softbus_priority_t priority,
+                                    const void* data, size_t len, void* user_data) {
+    (void)user_data;
+    message_t msg = {0};
+    strncpy(msg.target, target, sizeof(msg.target) - 1);
+    msg.type = type;
+    msg.priority = priority;
+    size_t copy_len = len < sizeof(msg.content) - 1 ? len : sizeof(msg.content) - 1;
+    memcpy(msg.content, data, copy_len);
+    msg.content[copy_len] = '\0';
+    msg.data = (void*)data;  // message_queue_send会复制数据
+    msg.data_len = len;
+    message_queue_send(&msg);
+}
+
+#endif // ENABLE_SHM_TRANSPORT
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #ifdef _WIN32
 #include <winsock2.h>
@@ -8,70 +9,919 @@
 #define close closesocket
 #define sleep(x) Sleep((x)*1000)
 #define usleep(x) Sleep((x)/1000)
+#define poll WSAPoll
+#define getpid() ((int)GetCurrentProcessId())
 #pragma comment(lib, "ws2_32.lib")
 #else
 #include <unistd.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <poll.h>
 #endif
 #include <pthread.h>
 #include <errno.h>
+#include <stdatomic.h>
 #include "softbus_socket.h"
+#include "softbus_io.h"
+#include "softbus_wire.h"
+#include "softbus_rmcast.h"
 #include "softbus_types.h"
+#include "device_ops.h"
 #include "message_queue.h"
+#include "softbus_log.h"
 
 #if ENABLE_SOCKET_MULTICAST
 
 static int g_socket_fd = -1;
+static int g_unicast_fd = -1;
 static struct sockaddr_in g_multicast_addr;
-static volatile int g_receiver_running = 0;
-static pthread_t g_receiver_thread;
+static uint32_t g_node_id;                      // 本节点标识，随数据报发出
+static socket_target_handler_t g_target_handler;
+static socket_control_handler_t g_control_handler;
+static bool g_reliable_multicast = true;        // 组播数据报是否带序号并支持NACK重传
+static rmcast_t* g_rmcast;
 
-// 组播接收线程函数
-static void* multicast_receiver_thread(void* arg) {
-    char buffer[MAX_MSG_SIZE];
+// 合并发送缓冲区，每个目的地址一个
+typedef struct {
+    int fd;
+    struct sockaddr_in dest;
+    uint8_t buf[SOCKET_MAX_DATAGRAM];
+    size_t len;
+    uint16_t count;
+    uint64_t first_ns;  // 批次中第一条消息的入队时间
+    bool in_use;
+} coalesce_slot_t;
+
+static struct {
+    bool enabled;
+    uint32_t delay_us;
+    size_t mtu;
+    int timer_id;
+    coalesce_slot_t slots[SOCKET_COALESCE_MAX_DESTS];
+    pthread_mutex_t mutex;
+} g_coalesce = {
+    .enabled = false,
+    .delay_us = SOCKET_DEFAULT_COALESCE_DELAY_US,
+    .mtu = SOCKET_DEFAULT_MTU,
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+};
+
+// 按组分配的组播地址成员关系，同一地址被多个组共用时按引用计数
+typedef struct {
+    uint32_t addr;      // 网络字节序，0表示空闲
+    int refcount;
+    int sock;           // 加入该地址的socket在fds中的下标
+} group_membership_t;
+
+static struct {
+    uint32_t pool_base;     // 主机字节序
+    uint32_t pool_size;
+    int fds[(SOCKET_GROUP_MAX_MEMBERSHIPS + SOCKET_MEMBERSHIPS_PER_SOCKET - 1) / SOCKET_MEMBERSHIPS_PER_SOCKET];
+    int fd_members[(SOCKET_GROUP_MAX_MEMBERSHIPS + SOCKET_MEMBERSHIPS_PER_SOCKET - 1) / SOCKET_MEMBERSHIPS_PER_SOCKET];
+    int fd_count;
+    group_membership_t memberships[SOCKET_GROUP_MAX_MEMBERSHIPS];
+    pthread_mutex_t mutex;
+} g_group_mcast = {
+    .pool_size = SOCKET_GROUP_POOL_SIZE,
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+};
+
+#define GROUP_SOCKET_COUNT ((int)(sizeof(g_group_mcast.fds) / sizeof(g_group_mcast.fds[0])))
+
+// 重组缓冲区，按规格池化；数据区直接交给消息队列，释放时回到池中
+typedef struct reasm_buf {
+    struct reasm_buf* next;
+    int cls;
+    uint8_t data[];
+} reasm_buf_t;
+
+#define REASM_POOL_CLASSES 5
+#define REASM_CLASS_SIZE(cls) ((size_t)4096 << (2 * (cls)))  // 4K, 16K, 64K, 256K, 1M
+
+static struct {
+    reasm_buf_t* free_list[REASM_POOL_CLASSES];
+    int free_count[REASM_POOL_CLASSES];
+    pthread_mutex_t mutex;
+} g_reasm_pool = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+};
+
+// 一条正在重组的消息
+typedef struct {
+    bool in_use;
+    uint32_t node_id;
+    uint32_t msg_id;
+    uint32_t total_len;
+    uint16_t count;
+    uint16_t received;
+    softbus_wire_rec_t rec;         // 类型、优先级和目标信息，len无意义
+    char target[MAX_NAME_LENGTH];
+    uint64_t deadline_ns;
+    reasm_buf_t* buf;
+    uint8_t bitmap[SOCKET_REASM_MAX_FRAGMENTS / 8];
+} reasm_entry_t;
+
+static struct {
+    reasm_entry_t entries[SOCKET_REASM_SLOTS];
+    size_t held_bytes;              // 未完成消息占用的缓冲区总量
+    int timer_id;
+    pthread_mutex_t mutex;
+} g_reasm = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static atomic_uint_fast32_t g_next_msg_id;
+
+// 收发统计
+static struct {
+    atomic_uint_fast64_t tx_messages;
+    atomic_uint_fast64_t tx_datagrams;
+    atomic_uint_fast64_t rx_messages;
+    atomic_uint_fast64_t rx_datagrams;
+    atomic_uint_fast64_t rx_loopback_dropped;
+    atomic_uint_fast64_t tx_fragments;
+    atomic_uint_fast64_t rx_fragments;
+    atomic_uint_fast64_t reasm_completed;
+    atomic_uint_fast64_t reasm_timeouts;
+    atomic_uint_fast64_t reasm_evicted;
+} g_stats;
+
+// 内部函数声明
+static void coalesce_flush_due(void* ctx);
+static void reasm_expire_due(void* ctx);
+
+// 将一条记录投递到本地消息队列
+static void deliver_record(const char* target, const uint8_t* payload, size_t len,
+                           message_type_t type, softbus_priority_t priority) {
+    message_t msg = {0};
+    strncpy(msg.target, target, sizeof(msg.target) - 1);
+    msg.type = type;
+    msg.priority = priority;
+    size_t copy_len = len < sizeof(msg.content) - 1 ? len : sizeof(msg.content) - 1;
+    memcpy(msg.content, payload, copy_len);
+    msg.content[copy_len] = '\0';
+    msg.data = (void*)payload;  // message_queue_send会复制数据
+    msg.data_len = len;
+    SOFTBUS_LOGD("Received multicast message: %s\n", msg.content);
+    message_queue_send(&msg);
+}
+
+// 按记录中的目标分发：无目标的旧格式投递给"multicast"，有目标的交给上层处理函数
+static void dispatch_record(const softbus_wire_rec_t* rec, const uint8_t* target, const uint8_t* payload) {
+    size_t target_len = rec->target_info & SOFTBUS_WIRE_TARGET_LEN_MASK;
+    if (target_len == 0) {
+        deliver_record("multicast", payload, rec->len, (message_type_t)rec->type, (softbus_priority_t)rec->priority);
+        return;
+    }
+    if (target_len >= MAX_NAME_LENGTH) {
+        return;
+    }
+
+    char name[MAX_NAME_LENGTH];
+    memcpy(name, target, target_len);
+    name[target_len] = '\0';
+    bool is_group = (rec->target_info & SOFTBUS_WIRE_TARGET_GROUP) != 0;
+
+    if (g_target_handler) {
+        g_target_handler(name, is_group, (message_type_t)rec->type, (softbus_priority_t)rec->priority,
+                         payload, rec->len);
+    } else if (!is_group) {
+        deliver_record(name, payload, rec->len, (message_type_t)rec->type, (softbus_priority_t)rec->priority);
+    }
+}
+
+static reasm_buf_t* reasm_buf_get(size_t len) {
+    int cls = 0;
+    while (cls < REASM_POOL_CLASSES && REASM_CLASS_SIZE(cls) < len) {
+        cls++;
+    }
+    if (cls == REASM_POOL_CLASSES) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&g_reasm_pool.mutex);
+    reasm_buf_t* buf = g_reasm_pool.free_list[cls];
+    if (buf) {
+        g_reasm_pool.free_list[cls] = buf->next;
+        g_reasm_pool.free_count[cls]--;
+    }
+    pthread_mutex_unlock(&g_reasm_pool.mutex);
+
+    if (!buf) {
+        buf = malloc(sizeof(reasm_buf_t) + REASM_CLASS_SIZE(cls));
+        if (!buf) {
+            return NULL;
+        }
+        buf->cls = cls;
+    }
+    buf->next = NULL;
+    return buf;
+}
+
+static void reasm_buf_put(reasm_buf_t* buf) {
+    pthread_mutex_lock(&g_reasm_pool.mutex);
+    if (g_reasm_pool.free_count[buf->cls] < SOCKET_REASM_POOL_KEEP) {
+        buf->next = g_reasm_pool.free_list[buf->cls];
+        g_reasm_pool.free_list[buf->cls] = buf;
+        g_reasm_pool.free_count[buf->cls]++;
+        buf = NULL;
+    }
+    pthread_mutex_unlock(&g_reasm_pool.mutex);
+    free(buf);
+}
+
+// 消息队列释放重组数据时调用
+static void reasm_data_release(void* data, size_t len) {
+    (void)len;
+    reasm_buf_put((reasm_buf_t*)((uint8_t*)data - offsetof(reasm_buf_t, data)));
+}
+
+static void reasm_pool_drain(void) {
+    pthread_mutex_lock(&g_reasm_pool.mutex);
+    for (int cls = 0; cls < REASM_POOL_CLASSES; cls++) {
+        while (g_reasm_pool.free_list[cls]) {
+            reasm_buf_t* buf = g_reasm_pool.free_list[cls];
+            g_reasm_pool.free_list[cls] = buf->next;
+            free(buf);
+        }
+        g_reasm_pool.free_count[cls] = 0;
+    }
+    pthread_mutex_unlock(&g_reasm_pool.mutex);
+}
+
+// 释放一个未完成的重组项，调用者需持有g_reasm.mutex
+static void reasm_drop_locked(reasm_entry_t* entry) {
+    g_reasm.held_bytes -= REASM_CLASS_SIZE(entry->buf->cls);
+    reasm_buf_put(entry->buf);
+    memset(entry, 0, sizeof(*entry));
+}
+
+// 淘汰最早开始的未完成消息，没有可淘汰项时返回false
+static bool reasm_evict_oldest_locked(void) {
+    reasm_entry_t* oldest = NULL;
+    for (int i = 0; i < SOCKET_REASM_SLOTS; i++) {
+        reasm_entry_t* entry = &g_reasm.entries[i];
+        if (entry->in_use && (!oldest || entry->deadline_ns < oldest->deadline_ns)) {
+            oldest = entry;
+        }
+    }
+    if (!oldest) {
+        return false;
+    }
+    reasm_drop_locked(oldest);
+    atomic_fetch_add_explicit(&g_stats.reasm_evicted, 1, memory_order_relaxed);
+    return true;
+}
+
+// 按最早的超时时间设置清理定时器，调用者需持有g_reasm.mutex
+static void reasm_arm_timer_locked(void) {
+    if (g_reasm.timer_id > 0) {
+        return;
+    }
+
+    uint64_t earliest = 0;
+    for (int i = 0; i < SOCKET_REASM_SLOTS; i++) {
+        reasm_entry_t* entry = &g_reasm.entries[i];
+        if (entry->in_use && (earliest == 0 || entry->deadline_ns < earliest)) {
+            earliest = entry->deadline_ns;
+        }
+    }
+    if (earliest == 0) {
+        return;
+    }
+
+    uint64_t now = softbus_io_now_ns();
+    uint64_t delay_us = earliest > now ? (earliest - now + 999) / 1000 : 0;
+    int id = softbus_io_timer_add(delay_us, 0, reasm_expire_due, NULL);
+    g_reasm.timer_id = id > 0 ? id : 0;
+}
+
+static void reasm_expire_due(void* ctx) {
+    (void)ctx;
+    pthread_mutex_lock(&g_reasm.mutex);
+    g_reasm.timer_id = 0;
+    uint64_t now = softbus_io_now_ns();
+    for (int i = 0; i < SOCKET_REASM_SLOTS; i++) {
+        reasm_entry_t* entry = &g_reasm.entries[i];
+        if (entry->in_use && entry->deadline_ns <= now) {
+            reasm_drop_locked(entry);
+            atomic_fetch_add_explicit(&g_stats.reasm_timeouts, 1, memory_order_relaxed);
+        }
+    }
+    reasm_arm_timer_locked();
+    pthread_mutex_unlock(&g_reasm.mutex);
+}
+
+// 查找或新建重组项；超出槽位或内存上限时淘汰最早的未完成消息
+static reasm_entry_t* reasm_lookup_locked(uint32_t node_id, const softbus_wire_frag_t* frag) {
+    reasm_entry_t* free_entry = NULL;
+    for (int i = 0; i < SOCKET_REASM_SLOTS; i++) {
+        reasm_entry_t* entry = &g_reasm.entries[i];
+        if (!entry->in_use) {
+            if (!free_entry) {
+                free_entry = entry;
+            }
+            continue;
+        }
+        if (entry->node_id == node_id && entry->msg_id == frag->msg_id) {
+            return entry;
+        }
+    }
+
+    size_t need = 0;
+    for (int cls = 0; cls < REASM_POOL_CLASSES; cls++) {
+        if (REASM_CLASS_SIZE(cls) >= frag->total_len) {
+            need = REASM_CLASS_SIZE(cls);
+            break;
+        }
+    }
+    if (need == 0 || need > SOCKET_REASM_MEMORY_CAP) {
+        return NULL;
+    }
+    while (g_reasm.held_bytes + need > SOCKET_REASM_MEMORY_CAP && reasm_evict_oldest_locked()) {
+    }
+    if (!free_entry) {
+        reasm_evict_oldest_locked();
+        for (int i = 0; i < SOCKET_REASM_SLOTS && !free_entry; i++) {
+            if (!g_reasm.entries[i].in_use) {
+                free_entry = &g_reasm.entries[i];
+            }
+        }
+    }
+
+    reasm_buf_t* buf = free_entry ? reasm_buf_get(frag->total_len) : NULL;
+    if (!buf) {
+        return NULL;
+    }
+
+    memset(free_entry, 0, sizeof(*free_entry));
+    free_entry->in_use = true;
+    free_entry->node_id = node_id;
+    free_entry->msg_id = frag->msg_id;
+    free_entry->total_len = frag->total_len;
+    free_entry->count = frag->count;
+    free_entry->deadline_ns = softbus_io_now_ns() + (uint64_t)SOCKET_REASM_TIMEOUT_MS * 1000000ULL;
+    free_entry->buf = buf;
+    g_reasm.held_bytes += REASM_CLASS_SIZE(buf->cls);
+    reasm_arm_timer_locked();
+    return free_entry;
+}
+
+// 投递重组完成的消息：缓冲区所有权直接转给消息队列，不再复制
+static void deliver_reassembled(const softbus_wire_rec_t* rec, const char* target, reasm_buf_t* buf, size_t len) {
+    size_t target_len = rec->target_info & SOFTBUS_WIRE_TARGET_LEN_MASK;
+    bool is_group = (rec->target_info & SOFTBUS_WIRE_TARGET_GROUP) != 0;
+
+    if (target_len > 0 && (g_target_handler || is_group)) {
+        if (g_target_handler) {
+            g_target_handler(target, is_group, (message_type_t)rec->type, (softbus_priority_t)rec->priority,
+                             buf->data, len);
+        }
+        reasm_buf_put(buf);
+        return;
+    }
+
+    message_t msg = {0};
+    strncpy(msg.target, target_len > 0 ? target : "multicast", sizeof(msg.target) - 1);
+    msg.type = (message_type_t)rec->type;
+    msg.priority = (softbus_priority_t)rec->priority;
+    size_t copy_len = len < sizeof(msg.content) - 1 ? len : sizeof(msg.content) - 1;
+    memcpy(msg.content, buf->data, copy_len);
+    msg.content[copy_len] = '\0';
+    msg.data = buf->data;
+    msg.data_len = len;
+    msg.data_release = reasm_data_release;
+    if (message_queue_send(&msg) != SOFTBUS_OK) {
+        reasm_buf_put(buf);
+    }
+}
+
+// 处理一个分片帧：分片数据直接写入重组缓冲区的对应位置
+static void handle_fragment(const softbus_wire_hdr_t* hdr, const uint8_t* buffer, size_t len) {
+    if (len < (size_t)hdr->hdr_len + SOFTBUS_WIRE_FRAG_SIZE + SOFTBUS_WIRE_REC_SIZE) {
+        return;
+    }
+    softbus_wire_frag_t frag;
+    softbus_wire_rec_t rec;
+    softbus_wire_decode_frag(buffer + hdr->hdr_len, &frag);
+    const uint8_t* p = buffer + hdr->hdr_len + SOFTBUS_WIRE_FRAG_SIZE;
+    softbus_wire_decode_rec(p, &rec);
+    const uint8_t* target = p + SOFTBUS_WIRE_REC_SIZE;
+    size_t target_len = rec.target_info & SOFTBUS_WIRE_TARGET_LEN_MASK;
+    const uint8_t* payload = p + softbus_wire_rec_hdr_size(&rec);
+
+    if (payload + rec.len > buffer + len || target_len >= MAX_NAME_LENGTH ||
+        frag.count == 0 || frag.count > SOCKET_REASM_MAX_FRAGMENTS || frag.index >= frag.count ||
+        frag.total_len == 0 || frag.total_len > SOCKET_MAX_MESSAGE_SIZE ||
+        (uint64_t)frag.offset + rec.len > frag.total_len) {
+        return;
+    }
+    atomic_fetch_add_explicit(&g_stats.rx_fragments, 1, memory_order_relaxed);
+
+    pthread_mutex_lock(&g_reasm.mutex);
+    reasm_entry_t* entry = reasm_lookup_locked(hdr->node_id, &frag);
+    if (!entry || entry->total_len != frag.total_len || entry->count != frag.count) {
+        pthread_mutex_unlock(&g_reasm.mutex);
+        return;
+    }
+
+    uint8_t bit = (uint8_t)(1u << (frag.index & 7));
+    if (entry->bitmap[frag.index >> 3] & bit) {
+        pthread_mutex_unlock(&g_reasm.mutex);
+        return;  // 重复分片
+    }
+    entry->bitmap[frag.index >> 3] |= bit;
+    memcpy(entry->buf->data + frag.offset, payload, rec.len);
+    if (frag.index == 0 || entry->received == 0) {
+        entry->rec = rec;
+        memcpy(entry->target, target, target_len);
+        entry->target[target_len] = '\0';
+    }
+
+    if (++entry->received < entry->count) {
+        pthread_mutex_unlock(&g_reasm.mutex);
+        return;
+    }
+
+    // 收齐后从表中摘下，缓冲区不再计入未完成内存
+    softbus_wire_rec_t done_rec = entry->rec;
+    char done_target[MAX_NAME_LENGTH];
+    memcpy(done_target, entry->target, sizeof(done_target));
+    reasm_buf_t* buf = entry->buf;
+    size_t total_len = entry->total_len;
+    g_reasm.held_bytes -= REASM_CLASS_SIZE(buf->cls);
+    memset(entry, 0, sizeof(*entry));
+    pthread_mutex_unlock(&g_reasm.mutex);
+
+    atomic_fetch_add_explicit(&g_stats.reasm_completed, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_stats.rx_messages, 1, memory_order_relaxed);
+    deliver_reassembled(&done_rec, done_target, buf, total_len);
+}
+
+static void reasm_reset(void) {
+    pthread_mutex_lock(&g_reasm.mutex);
+    for (int i = 0; i < SOCKET_REASM_SLOTS; i++) {
+        if (g_reasm.entries[i].in_use) {
+            reasm_drop_locked(&g_reasm.entries[i]);
+        }
+    }
+    int timer_id = g_reasm.timer_id;
+    g_reasm.timer_id = 0;
+    pthread_mutex_unlock(&g_reasm.mutex);
+    // 没有未完成的消息，进行中的超时回调不会再启动定时器；回调需要重组锁，在锁外取消
+    softbus_io_timer_cancel(timer_id);
+    reasm_pool_drain();
+}
+
+// 控制帧和可靠组播的接收处理：心跳和NACK交给rmcast，其余控制帧交给上层，带序号的数据报去重，返回false表示不再继续处理
+static bool reliable_filter(const softbus_wire_hdr_t* hdr, const uint8_t* buffer, size_t len,
+                            const struct sockaddr_in* sender_addr) {
+    if (hdr->flags & SOFTBUS_WIRE_FLAG_CONTROL) {
+        const uint8_t* body = buffer + hdr->hdr_len;
+        size_t body_len = len - hdr->hdr_len;
+        if (body_len == 0) {
+            return false;
+        }
+        if (body[0] == SOFTBUS_WIRE_CTRL_HEARTBEAT || body[0] == SOFTBUS_WIRE_CTRL_NACK) {
+            rmcast_handle_control(g_rmcast, hdr, body, body_len, sender_addr);
+        } else if (g_control_handler) {
+            softbus_node_addr_t sender = {sender_addr->sin_addr.s_addr, sender_addr->sin_port};
+            g_control_handler(hdr->node_id, &sender, body, body_len);
+        }
+        return false;
+    }
+    if (hdr->flags & SOFTBUS_WIRE_FLAG_SEQ) {
+        return g_rmcast ? rmcast_accept(g_rmcast, hdr, sender_addr) : true;
+    }
+    return true;
+}
+
+// 处理收到的一个数据报，一次遍历拆出所有合并的消息
+static void handle_datagram(const uint8_t* buffer, size_t len, const struct sockaddr_in* sender_addr) {
+    atomic_fetch_add_explicit(&g_stats.rx_datagrams, 1, memory_order_relaxed);
+
+    softbus_wire_hdr_t hdr;
+    if (softbus_wire_decode_hdr(buffer, len, &hdr) != 0) {
+        // 未分帧的旧格式数据报，整个作为一条命令消息
+        atomic_fetch_add_explicit(&g_stats.rx_messages, 1, memory_order_relaxed);
+        deliver_record("multicast", buffer, len, MESSAGE_TYPE_COMMAND, PRIORITY_NORMAL);
+        return;
+    }
+
+    // 自己发出的组播被回环收到，本地成员已在进程内投递过
+    if (hdr.node_id == g_node_id) {
+        atomic_fetch_add_explicit(&g_stats.rx_loopback_dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    if (!reliable_filter(&hdr, buffer, len, sender_addr)) {
+        return;
+    }
+
+    if (hdr.flags & SOFTBUS_WIRE_FLAG_FRAGMENT) {
+        handle_fragment(&hdr, buffer, len);
+        return;
+    }
+
+    size_t offset = hdr.hdr_len;
+    for (uint16_t i = 0; i < hdr.count; i++) {
+        if (offset + SOFTBUS_WIRE_REC_SIZE > len) {
+            break;
+        }
+        softbus_wire_rec_t rec;
+        softbus_wire_decode_rec(buffer + offset, &rec);
+        const uint8_t* target = buffer + offset + SOFTBUS_WIRE_REC_SIZE;
+        offset += softbus_wire_rec_hdr_size(&rec);
+        if (offset + rec.len > len) {
+            SOFTBUS_LOGW("Truncated record in datagram, dropping remainder\n");
+            break;
+        }
+        atomic_fetch_add_explicit(&g_stats.rx_messages, 1, memory_order_relaxed);
+        dispatch_record(&rec, target, buffer + offset);
+        offset += rec.len;
+    }
+}
+
+// socket可读回调：在IO线程中执行，非阻塞读取直到EAGAIN
+static void socket_readable(int fd, uint32_t events, void* ctx) {
+    (void)events;
+    (void)ctx;
+    uint8_t buffer[SOCKET_MAX_DATAGRAM];
     struct sockaddr_in sender_addr;
-    socklen_t sender_addr_len = sizeof(sender_addr);
 
-    while (g_receiver_running) {
-        // 接收组播消息
-        ssize_t recv_len = recvfrom(g_socket_fd, buffer, sizeof(buffer) - 1, 0,
-                                  (struct sockaddr*)&sender_addr, &sender_addr_len);
-        
-        if (recv_len > 0) {
-            buffer[recv_len] = '\0';
-            printf("Received multicast message: %s\n", buffer);
+    for (;;) {
+        socklen_t sender_addr_len = sizeof(sender_addr);
+        ssize_t recv_len = recvfrom(fd, (char*)buffer, sizeof(buffer), 0,
+                                    (struct sockaddr*)&sender_addr, &sender_addr_len);
+        if (recv_len < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                perror("Failed to receive datagram");
+            }
+            break;
+        }
+        if (recv_len == 0) {
+            continue;
+        }
+        handle_datagram(buffer, (size_t)recv_len, &sender_addr);
+    }
+}
 
-            // 创建消息并发送到消息队列
-            message_t msg = {0};
-            strncpy(msg.target, "multicast", sizeof(msg.target) - 1);
-            msg.type = MESSAGE_TYPE_COMMAND;
-            msg.priority = PRIORITY_NORMAL;
-            strncpy(msg.content, buffer, sizeof(msg.content) - 1);
-            message_queue_send(&msg);
+// 直接发送一个数据报，也是可靠组播发送、重传和控制帧的出口
+static int socket_output(int fd, const struct sockaddr_in* dest, const uint8_t* buf, size_t len) {
+    ssize_t sent_len = sendto(fd, (const char*)buf, len, 0, (const struct sockaddr*)dest, sizeof(*dest));
+    if (sent_len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        // 连续发送分片时发送缓冲区可能暂时写满，等待可写后重试一次
+        struct pollfd pfd = {.fd = fd, .events = POLLOUT, .revents = 0};
+        if (poll(&pfd, 1, 100) > 0) {
+            sent_len = sendto(fd, (const char*)buf, len, 0, (const struct sockaddr*)dest, sizeof(*dest));
         }
     }
+    if (sent_len < 0) {
+        perror("Failed to send datagram");
+        return SOFTBUS_ERROR;
+    }
+    atomic_fetch_add_explicit(&g_stats.tx_datagrams, 1, memory_order_relaxed);
+    return SOFTBUS_OK;
+}
+
+// 发往组播地址的数据报交给rmcast分配序号并保留以便重传
+static int send_datagram(int fd, const struct sockaddr_in* dest, const uint8_t* buf, size_t len) {
+    if (g_reliable_multicast && g_rmcast && IN_MULTICAST(ntohl(dest->sin_addr.s_addr))) {
+        return rmcast_send(g_rmcast, dest, buf, len);
+    }
+    return socket_output(fd, dest, buf, len);
+}
+
+// rmcast的输出：重传、心跳和NACK都从单播socket发出
+static int rmcast_output(void* ctx, const struct sockaddr_in* dest, const uint8_t* buf, size_t len) {
+    (void)ctx;
+    return socket_output(g_unicast_fd, dest, buf, len);
+}
+
+// 发送缓冲区中已合并的消息，调用者需持有g_coalesce.mutex
+static int coalesce_flush_slot_locked(coalesce_slot_t* slot) {
+    if (!slot->in_use || slot->count == 0) {
+        return SOFTBUS_OK;
+    }
+
+    softbus_wire_hdr_t hdr = {.magic = SOFTBUS_WIRE_MAGIC, .version = SOFTBUS_WIRE_VERSION,
+                              .count = slot->count, .node_id = g_node_id};
+    softbus_wire_encode_hdr(slot->buf, &hdr);
+    int ret = send_datagram(slot->fd, &slot->dest, slot->buf, slot->len);
+
+    slot->len = SOFTBUS_WIRE_HDR_SIZE;
+    slot->count = 0;
+    slot->first_ns = 0;
+    return ret;
+}
+
+static coalesce_slot_t* coalesce_get_slot_locked(int fd, const struct sockaddr_in* dest) {
+    coalesce_slot_t* free_slot = NULL;
+    for (int i = 0; i < SOCKET_COALESCE_MAX_DESTS; i++) {
+        coalesce_slot_t* slot = &g_coalesce.slots[i];
+        if (!slot->in_use) {
+            if (!free_slot) {
+                free_slot = slot;
+            }
+            continue;
+        }
+        if (slot->fd == fd && slot->dest.sin_addr.s_addr == dest->sin_addr.s_addr &&
+            slot->dest.sin_port == dest->sin_port) {
+            return slot;
+        }
+    }
+
+    // 没有空闲槽位时刷新并复用第一个
+    if (!free_slot) {
+        free_slot = &g_coalesce.slots[0];
+        coalesce_flush_slot_locked(free_slot);
+    }
+
+    free_slot->fd = fd;
+    free_slot->dest = *dest;
+    free_slot->len = SOFTBUS_WIRE_HDR_SIZE;
+    free_slot->count = 0;
+    free_slot->first_ns = 0;
+    free_slot->in_use = true;
+    return free_slot;
+}
+
+// 按最早的待发批次设置刷新定时器，调用者需持有g_coalesce.mutex
+static void coalesce_arm_timer_locked(void) {
+    if (g_coalesce.timer_id > 0) {
+        return;
+    }
+
+    uint64_t earliest = 0;
+    for (int i = 0; i < SOCKET_COALESCE_MAX_DESTS; i++) {
+        coalesce_slot_t* slot = &g_coalesce.slots[i];
+        if (slot->in_use && slot->count > 0 && (earliest == 0 || slot->first_ns < earliest)) {
+            earliest = slot->first_ns;
+        }
+    }
+    if (earliest == 0) {
+        return;
+    }
+
+    uint64_t deadline = earliest + (uint64_t)g_coalesce.delay_us * 1000ULL;
+    uint64_t now = softbus_io_now_ns();
+    uint64_t delay_us = deadline > now ? (deadline - now + 999) / 1000 : 0;
+    int id = softbus_io_timer_add(delay_us, 0, coalesce_flush_due, NULL);
+    g_coalesce.timer_id = id > 0 ? id : 0;
+}
+
+// 定时器回调：刷新等待时间达到延迟的批次
+static void coalesce_flush_due(void* ctx) {
+    (void)ctx;
+    pthread_mutex_lock(&g_coalesce.mutex);
+    g_coalesce.timer_id = 0;
+    uint64_t now = softbus_io_now_ns();
+    for (int i = 0; i < SOCKET_COALESCE_MAX_DESTS; i++) {
+        coalesce_slot_t* slot = &g_coalesce.slots[i];
+        if (slot->in_use && slot->count > 0 &&
+            now - slot->first_ns >= (uint64_t)g_coalesce.delay_us * 1000ULL) {
+            coalesce_flush_slot_locked(slot);
+        }
+    }
+    coalesce_arm_timer_locked();
+    pthread_mutex_unlock(&g_coalesce.mutex);
+}
+
+// 编码一条记录（记录头、目标名、负载），返回写入的字节数
+static size_t encode_record(uint8_t* p, const softbus_wire_rec_t* rec, const char* target,
+                            const void* data) {
+    size_t target_len = rec->target_info & SOFTBUS_WIRE_TARGET_LEN_MASK;
+    softbus_wire_encode_rec(p, rec);
+    memcpy(p + SOFTBUS_WIRE_REC_SIZE, target, target_len);
+    memcpy(p + SOFTBUS_WIRE_REC_SIZE + target_len, data, rec->len);
+    return SOFTBUS_WIRE_REC_SIZE + target_len + rec->len;
+}
+
+// 超过MAX_MSG_SIZE的消息按MTU分片，每片单独成帧发送
+static int socket_send_fragmented(int fd, const struct sockaddr_in* dest, const softbus_wire_rec_t* proto,
+                                  const char* target, const uint8_t* data, size_t len) {
+    size_t target_len = proto->target_info & SOFTBUS_WIRE_TARGET_LEN_MASK;
+
+    // 先发出发往同一地址的待合并消息，保持发送顺序
+    pthread_mutex_lock(&g_coalesce.mutex);
+    size_t mtu = g_coalesce.mtu;
+    for (int i = 0; i < SOCKET_COALESCE_MAX_DESTS; i++) {
+        coalesce_slot_t* slot = &g_coalesce.slots[i];
+        if (slot->in_use && slot->fd == fd && slot->dest.sin_addr.s_addr == dest->sin_addr.s_addr &&
+            slot->dest.sin_port == dest->sin_port) {
+            coalesce_flush_slot_locked(slot);
+        }
+    }
+    pthread_mutex_unlock(&g_coalesce.mutex);
+
+    // 预留序号扩展，可靠组播发送时帧头会变长
+    size_t chunk = mtu - SOFTBUS_WIRE_HDR_SIZE - SOFTBUS_WIRE_SEQ_SIZE - SOFTBUS_WIRE_FRAG_SIZE -
+                   SOFTBUS_WIRE_REC_SIZE - target_len;
+    size_t count = (len + chunk - 1) / chunk;
+    if (count > SOCKET_REASM_MAX_FRAGMENTS) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    softbus_wire_hdr_t hdr = {.magic = SOFTBUS_WIRE_MAGIC, .version = SOFTBUS_WIRE_VERSION,
+                              .flags = SOFTBUS_WIRE_FLAG_FRAGMENT, .count = 1, .node_id = g_node_id};
+    softbus_wire_frag_t frag = {0};
+    frag.msg_id = (uint32_t)atomic_fetch_add_explicit(&g_next_msg_id, 1, memory_order_relaxed) + 1;
+    frag.count = (uint16_t)count;
+    frag.total_len = (uint32_t)len;
+
+    uint8_t buf[SOCKET_MAX_DATAGRAM];
+    softbus_wire_encode_hdr(buf, &hdr);
+    for (size_t i = 0; i < count; i++) {
+        size_t offset = i * chunk;
+        size_t n = len - offset < chunk ? len - offset : chunk;
+        softbus_wire_rec_t rec = *proto;
+        rec.len = (uint16_t)n;
+        frag.index = (uint16_t)i;
+        frag.offset = (uint32_t)offset;
+        softbus_wire_encode_frag(buf + SOFTBUS_WIRE_HDR_SIZE, &frag);
+        size_t rec_size = encode_record(buf + SOFTBUS_WIRE_HDR_SIZE + SOFTBUS_WIRE_FRAG_SIZE, &rec, target,
+                                        data + offset);
+        int ret = send_datagram(fd, dest, buf, SOFTBUS_WIRE_HDR_SIZE + SOFTBUS_WIRE_FRAG_SIZE + rec_size);
+        if (ret != SOFTBUS_OK) {
+            return ret;
+        }
+        atomic_fetch_add_explicit(&g_stats.tx_fragments, 1, memory_order_relaxed);
+    }
+    return SOFTBUS_OK;
+}
+
+// 发送一条消息记录；合并模式下先写入目的地址的缓冲区
+// target为NULL时不带目标，接收方按旧方式投递给"multicast"
+static int socket_send_record(int fd, const struct sockaddr_in* dest, const char* target, bool is_group,
+                              const void* data, size_t len, message_type_t type, softbus_priority_t priority) {
+    size_t target_len = target ? strlen(target) : 0;
+    if (target_len >= MAX_NAME_LENGTH) {
+        return SOFTBUS_INVALID_ARG;
+    }
+    softbus_wire_rec_t rec = {(uint16_t)len, (uint8_t)type, (uint8_t)priority,
+                              (uint8_t)(target_len | (is_group ? SOFTBUS_WIRE_TARGET_GROUP : 0))};
+    size_t rec_size = softbus_wire_rec_hdr_size(&rec) + len;
+    atomic_fetch_add_explicit(&g_stats.tx_messages, 1, memory_order_relaxed);
+
+    if (len > MAX_MSG_SIZE) {
+        return socket_send_fragmented(fd, dest, &rec, target, (const uint8_t*)data, len);
+    }
+
+    pthread_mutex_lock(&g_coalesce.mutex);
+
+    if (!g_coalesce.enabled) {
+        pthread_mutex_unlock(&g_coalesce.mutex);
+
+        uint8_t buf[SOFTBUS_WIRE_HDR_SIZE + SOFTBUS_WIRE_REC_SIZE + MAX_NAME_LENGTH + MAX_MSG_SIZE];
+        softbus_wire_hdr_t hdr = {.magic = SOFTBUS_WIRE_MAGIC, .version = SOFTBUS_WIRE_VERSION,
+                                  .count = 1, .node_id = g_node_id};
+        softbus_wire_encode_hdr(buf, &hdr);
+        encode_record(buf + SOFTBUS_WIRE_HDR_SIZE, &rec, target, data);
+        return send_datagram(fd, dest, buf, SOFTBUS_WIRE_HDR_SIZE + rec_size);
+    }
+
+    int ret = SOFTBUS_OK;
+    coalesce_slot_t* slot = coalesce_get_slot_locked(fd, dest);
+
+    // 超过路径MTU时先发出当前批次
+    if (slot->len + rec_size + SOFTBUS_WIRE_SEQ_SIZE > g_coalesce.mtu) {
+        ret = coalesce_flush_slot_locked(slot);
+    }
+
+    slot->len += encode_record(slot->buf + slot->len, &rec, target, data);
+    slot->count++;
+
+    if (priority == PRIORITY_URGENT || g_coalesce.delay_us == 0) {
+        // 紧急消息立即发送，连同之前排队的消息
+        int flush_ret = coalesce_flush_slot_locked(slot);
+        if (ret == SOFTBUS_OK) {
+            ret = flush_ret;
+        }
+    } else if (slot->count == 1) {
+        slot->first_ns = softbus_io_now_ns();
+        coalesce_arm_timer_locked();
+    }
+
+    pthread_mutex_unlock(&g_coalesce.mutex);
+    return ret;
+}
+
+// 创建单播socket，绑定临时端口，用于点对点发送和接收
+static int unicast_socket_init(void) {
+    g_unicast_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (g_unicast_fd < 0) {
+        perror("Failed to create unicast socket");
+        return SOFTBUS_ERROR;
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(0);
+    if (bind(g_unicast_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        perror("Failed to bind unicast socket");
+        close(g_unicast_fd);
+        g_unicast_fd = -1;
+        return SOFTBUS_ERROR;
+    }
 
-    return NULL;
+    return SOFTBUS_OK;
+}
+
+// 生成本节点标识，同一主机上的多个进程也互不相同
+static uint32_t generate_node_id(void) {
+    uint64_t now = softbus_io_now_ns();
+    uint32_t id = (uint32_t)getpid() * 2654435761u ^ (uint32_t)now ^ (uint32_t)(now >> 32);
+    return id ? id : 1;
+}
+
+// 创建接收组消息的socket：绑定组播端口，只接收自己加入的组播地址
+static int group_socket_create(void) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        perror("Failed to create group socket");
+        return -1;
+    }
+
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+#ifdef IP_MULTICAST_ALL
+    // 默认情况下绑定INADDR_ANY的socket会收到本机任一socket加入的组播
+    int all = 0;
+    setsockopt(fd, IPPROTO_IP, IP_MULTICAST_ALL, (const char*)&all, sizeof(all));
+#endif
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(MULTICAST_PORT);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        perror("Failed to bind group socket");
+        close(fd);
+        return -1;
+    }
+
+    if (softbus_io_add_fd(fd, SOFTBUS_IO_READ, socket_readable, NULL) != SOFTBUS_OK) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void group_sockets_close(void) {
+    int fds[GROUP_SOCKET_COUNT];
+    pthread_mutex_lock(&g_group_mcast.mutex);
+    int count = g_group_mcast.fd_count;
+    memcpy(fds, g_group_mcast.fds, sizeof(fds[0]) * (size_t)count);
+    memset(g_group_mcast.fd_members, 0, sizeof(g_group_mcast.fd_members));
+    g_group_mcast.fd_count = 0;
+    memset(g_group_mcast.memberships, 0, sizeof(g_group_mcast.memberships));
+    pthread_mutex_unlock(&g_group_mcast.mutex);
+
+    // 删除fd会等待进行中的接收回调，回调中可能加入或退出组，不能持有组锁
+    for (int i = 0; i < count; i++) {
+        softbus_io_del_fd(fds[i]);
+        close(fds[i]);
+    }
 }
 
 int socket_multicast_init(void) {
+    // 初始化IO引擎
+    if (softbus_io_init() != SOFTBUS_OK) {
+        return SOFTBUS_ERROR;
+    }
+    g_node_id = generate_node_id();
+    if (g_group_mcast.pool_base == 0) {
+        g_group_mcast.pool_base = ntohl(inet_addr(SOCKET_GROUP_POOL_BASE));
+    }
+
     // 创建UDP socket
     g_socket_fd = socket(AF_INET, SOCK_DGRAM, 0);
     if (g_socket_fd < 0) {
         perror("Failed to create socket");
+        softbus_io_deinit();
         return SOFTBUS_ERROR;
     }
 
     // 设置地址重用
     int reuse = 1;
-    if (setsockopt(g_socket_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0) {
+    if (setsockopt(g_socket_fd, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse)) < 0) {
         perror("Failed to set SO_REUSEADDR");
-        close(g_socket_fd);
-        return SOFTBUS_ERROR;
+        goto fail;
     }
 
+#ifdef IP_MULTICAST_ALL
+    // 只接收默认组播组，各组的流量由单独加入的组socket接收
+    int all = 0;
+    setsockopt(g_socket_fd, IPPROTO_IP, IP_MULTICAST_ALL, (const char*)&all, sizeof(all));
+#endif
+
     // 设置组播地址
     memset(&g_multicast_addr, 0, sizeof(g_multicast_addr));
     g_multicast_addr.sin_family = AF_INET;
@@ -81,34 +931,91 @@ int socket_multicast_init(void) {
     // 绑定socket
     if (bind(g_socket_fd, (struct sockaddr*)&g_multicast_addr, sizeof(g_multicast_addr)) < 0) {
         perror("Failed to bind socket");
-        close(g_socket_fd);
-        return SOFTBUS_ERROR;
+        goto fail;
     }
 
     // 加入组播组
     struct ip_mreq mreq;
     mreq.imr_multiaddr.s_addr = inet_addr(MULTICAST_GROUP);
     mreq.imr_interface.s_addr = htonl(INADDR_ANY);
-    if (setsockopt(g_socket_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+    if (setsockopt(g_socket_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, (const char*)&mreq, sizeof(mreq)) < 0) {
         perror("Failed to join multicast group");
-        close(g_socket_fd);
-        return SOFTBUS_ERROR;
+        goto fail;
+    }
+
+    if (unicast_socket_init() != SOFTBUS_OK) {
+        goto fail;
+    }
+
+    // 注册到IO引擎，由同一个IO线程服务
+    if (softbus_io_add_fd(g_socket_fd, SOFTBUS_IO_READ, socket_readable, NULL) != SOFTBUS_OK ||
+        softbus_io_add_fd(g_unicast_fd, SOFTBUS_IO_READ, socket_readable, NULL) != SOFTBUS_OK) {
+        goto fail;
+    }
+
+    // 组播从单播socket发出，接收方可以把NACK直接发回源地址，NACK的组播副本经各组socket送达其他接收方
+    g_rmcast = rmcast_create(g_node_id, MULTICAST_PORT, rmcast_output, NULL);
+    if (!g_rmcast) {
+        goto fail;
     }
 
     return SOFTBUS_OK;
+
+fail:
+    socket_multicast_deinit();
+    return SOFTBUS_ERROR;
 }
 
 void socket_multicast_deinit(void) {
+    // 发出所有待合并的消息
+    socket_flush();
+
+    // IO线程可能仍在为其他传输运行，不能在这里停止。先删除fd，返回时接收回调已经结束，
+    // 之后不再有回调访问rmcast和重组状态
+    if (g_socket_fd >= 0) {
+        softbus_io_del_fd(g_socket_fd);
+    }
+    if (g_unicast_fd >= 0) {
+        softbus_io_del_fd(g_unicast_fd);
+    }
+    group_sockets_close();
+
+    // 清空批次后进行中的定时回调不会再启动定时器；取消在锁外进行，回调需要这把锁
+    pthread_mutex_lock(&g_coalesce.mutex);
+    memset(g_coalesce.slots, 0, sizeof(g_coalesce.slots));
+    int coalesce_timer = g_coalesce.timer_id;
+    g_coalesce.timer_id = 0;
+    pthread_mutex_unlock(&g_coalesce.mutex);
+    softbus_io_timer_cancel(coalesce_timer);
+
+    // rmcast的重传和心跳经单播socket发出，先于关闭socket销毁
+    rmcast_destroy(g_rmcast);
+    g_rmcast = NULL;
+
     if (g_socket_fd >= 0) {
         close(g_socket_fd);
         g_socket_fd = -1;
     }
+    if (g_unicast_fd >= 0) {
+        close(g_unicast_fd);
+        g_unicast_fd = -1;
+    }
+    reasm_reset();
+
+    softbus_io_deinit();
 }
 
 int socket_multicast_send(const char* message, size_t len) {
-    if (!message || len == 0 || len > MAX_MSG_SIZE) {
+    return socket_multicast_send_ex(message, len, MESSAGE_TYPE_COMMAND, PRIORITY_NORMAL);
+}
+
+int socket_multicast_send_ex(const void* data, size_t len, message_type_t type, softbus_priority_t priority) {
+    if (!data || len == 0 || len > SOCKET_MAX_MESSAGE_SIZE) {
         return SOFTBUS_INVALID_ARG;
     }
+    if (g_unicast_fd < 0) {
+        return SOFTBUS_ERROR;
+    }
 
     // 设置目标地址
     struct sockaddr_in dest_addr;
@@ -117,70 +1024,439 @@ int socket_multicast_send(const char* message, size_t len) {
     dest_addr.sin_addr.s_addr = inet_addr(MULTICAST_GROUP);
     dest_addr.sin_port = htons(MULTICAST_PORT);
 
-    // 发送消息
-    ssize_t sent_len = sendto(g_socket_fd, message, len, 0,
-                             (struct sockaddr*)&dest_addr, sizeof(dest_addr));
-    
-    if (sent_len < 0) {
-        perror("Failed to send multicast message");
+    return socket_send_record(g_unicast_fd, &dest_addr, NULL, false, data, len, type, priority);
+}
+
+int socket_send_to_node(const softbus_node_addr_t* node, const char* target, bool is_group,
+                        const void* data, size_t len, message_type_t type, softbus_priority_t priority) {
+    if (!node || node->addr == 0 || !target || !data || len == 0 || len > SOCKET_MAX_MESSAGE_SIZE) {
+        return SOFTBUS_INVALID_ARG;
+    }
+    if (g_unicast_fd < 0) {
         return SOFTBUS_ERROR;
     }
 
-    return SOFTBUS_OK;
+    struct sockaddr_in dest_addr;
+    memset(&dest_addr, 0, sizeof(dest_addr));
+    dest_addr.sin_family = AF_INET;
+    dest_addr.sin_addr.s_addr = node->addr;
+    dest_addr.sin_port = node->port;
+
+    return socket_send_record(g_unicast_fd, &dest_addr, target, is_group, data, len, type, priority);
 }
 
-int socket_multicast_receive(char* buffer, size_t buffer_size, int timeout_ms) {
-    if (!buffer || buffer_size == 0) {
+int socket_set_group_pool(const char* base, uint32_t size) {
+    if (!base || size == 0) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    struct in_addr addr;
+    if (inet_pton(AF_INET, base, &addr) != 1) {
+        return SOFTBUS_INVALID_ARG;
+    }
+    uint32_t first = ntohl(addr.s_addr);
+    uint32_t last = first + size - 1;
+    if (last < first || !IN_MULTICAST(first) || !IN_MULTICAST(last)) {
         return SOFTBUS_INVALID_ARG;
     }
 
-    // 设置接收超时
-    struct timeval tv;
-    tv.tv_sec = timeout_ms / 1000;
-    tv.tv_usec = (timeout_ms % 1000) * 1000;
-    if (setsockopt(g_socket_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) < 0) {
-        perror("Failed to set receive timeout");
+    pthread_mutex_lock(&g_group_mcast.mutex);
+    for (int i = 0; i < SOCKET_GROUP_MAX_MEMBERSHIPS; i++) {
+        if (g_group_mcast.memberships[i].addr != 0) {
+            pthread_mutex_unlock(&g_group_mcast.mutex);
+            return SOFTBUS_BUSY;
+        }
+    }
+    g_group_mcast.pool_base = first;
+    g_group_mcast.pool_size = size;
+    pthread_mutex_unlock(&g_group_mcast.mutex);
+    return SOFTBUS_OK;
+}
+
+uint32_t socket_group_address(const char* group) {
+    // FNV-1a，不依赖进程内状态，保证各节点映射一致
+    uint32_t hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)group; p && *p; p++) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    uint32_t base = g_group_mcast.pool_base ? g_group_mcast.pool_base : ntohl(inet_addr(SOCKET_GROUP_POOL_BASE));
+    return htonl(base + hash % g_group_mcast.pool_size);
+}
+
+static int group_membership_change(int fd, uint32_t addr, int option) {
+    struct ip_mreq mreq;
+    mreq.imr_multiaddr.s_addr = addr;
+    mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+    if (setsockopt(fd, IPPROTO_IP, option, (const char*)&mreq, sizeof(mreq)) < 0) {
+        perror(option == IP_ADD_MEMBERSHIP ? "Failed to join group address" : "Failed to leave group address");
         return SOFTBUS_ERROR;
     }
+    return SOFTBUS_OK;
+}
 
-    // 接收消息
-    struct sockaddr_in sender_addr;
-    socklen_t sender_addr_len = sizeof(sender_addr);
-    ssize_t recv_len = recvfrom(g_socket_fd, buffer, buffer_size - 1, 0,
-                               (struct sockaddr*)&sender_addr, &sender_addr_len);
+int socket_group_join(const char* group) {
+    if (!group) {
+        return SOFTBUS_INVALID_ARG;
+    }
+    if (g_socket_fd < 0) {
+        return SOFTBUS_ERROR;
+    }
 
-    if (recv_len < 0) {
-        if (errno == EAGAIN || errno == EWOULDBLOCK) {
-            return SOFTBUS_TIMEOUT;
+    uint32_t addr = socket_group_address(group);
+    pthread_mutex_lock(&g_group_mcast.mutex);
+
+    group_membership_t* free_entry = NULL;
+    for (int i = 0; i < SOCKET_GROUP_MAX_MEMBERSHIPS; i++) {
+        group_membership_t* m = &g_group_mcast.memberships[i];
+        if (m->addr == addr) {
+            m->refcount++;
+            pthread_mutex_unlock(&g_group_mcast.mutex);
+            return SOFTBUS_OK;
+        }
+        if (m->addr == 0 && !free_entry) {
+            free_entry = m;
+        }
+    }
+    if (!free_entry) {
+        pthread_mutex_unlock(&g_group_mcast.mutex);
+        return SOFTBUS_NO_MEM;
+    }
+
+    // 每个socket的成员关系数量受内核限制，满了再创建新的
+    int sock = -1;
+    for (int i = 0; i < g_group_mcast.fd_count; i++) {
+        if (g_group_mcast.fd_members[i] < SOCKET_MEMBERSHIPS_PER_SOCKET) {
+            sock = i;
+            break;
+        }
+    }
+    if (sock < 0 && g_group_mcast.fd_count < GROUP_SOCKET_COUNT) {
+        int fd = group_socket_create();
+        if (fd >= 0) {
+            sock = g_group_mcast.fd_count++;
+            g_group_mcast.fds[sock] = fd;
+            g_group_mcast.fd_members[sock] = 0;
         }
-        perror("Failed to receive multicast message");
+    }
+    if (sock < 0 || group_membership_change(g_group_mcast.fds[sock], addr, IP_ADD_MEMBERSHIP) != SOFTBUS_OK) {
+        pthread_mutex_unlock(&g_group_mcast.mutex);
         return SOFTBUS_ERROR;
     }
 
-    buffer[recv_len] = '\0';
+    free_entry->addr = addr;
+    free_entry->refcount = 1;
+    free_entry->sock = sock;
+    g_group_mcast.fd_members[sock]++;
+    pthread_mutex_unlock(&g_group_mcast.mutex);
     return SOFTBUS_OK;
 }
 
-int socket_multicast_start_receiver(void) {
-    if (g_receiver_running) {
-        return SOFTBUS_OK;  // 已经在运行
+int socket_group_leave(const char* group) {
+    if (!group) {
+        return SOFTBUS_INVALID_ARG;
     }
 
-    g_receiver_running = 1;
-    if (pthread_create(&g_receiver_thread, NULL, multicast_receiver_thread, NULL) != 0) {
-        perror("Failed to create receiver thread");
-        g_receiver_running = 0;
+    uint32_t addr = socket_group_address(group);
+    pthread_mutex_lock(&g_group_mcast.mutex);
+
+    for (int i = 0; i < SOCKET_GROUP_MAX_MEMBERSHIPS; i++) {
+        group_membership_t* m = &g_group_mcast.memberships[i];
+        if (m->addr != addr) {
+            continue;
+        }
+        if (--m->refcount == 0) {
+            group_membership_change(g_group_mcast.fds[m->sock], addr, IP_DROP_MEMBERSHIP);
+            g_group_mcast.fd_members[m->sock]--;
+            memset(m, 0, sizeof(*m));
+        }
+        pthread_mutex_unlock(&g_group_mcast.mutex);
+        return SOFTBUS_OK;
+    }
+
+    pthread_mutex_unlock(&g_group_mcast.mutex);
+    return SOFTBUS_NOT_FOUND;
+}
+
+int socket_multicast_send_group(const char* group, const void* data, size_t len,
+                                message_type_t type, softbus_priority_t priority) {
+    if (!group || !data || len == 0 || len > SOCKET_MAX_MESSAGE_SIZE) {
+        return SOFTBUS_INVALID_ARG;
+    }
+    if (g_unicast_fd < 0) {
         return SOFTBUS_ERROR;
     }
 
+    struct sockaddr_in dest_addr;
+    memset(&dest_addr, 0, sizeof(dest_addr));
+    dest_addr.sin_family = AF_INET;
+    dest_addr.sin_addr.s_addr = socket_group_address(group);
+    dest_addr.sin_port = htons(MULTICAST_PORT);
+
+    return socket_send_record(g_unicast_fd, &dest_addr, group, true, data, len, type, priority);
+}
+
+int socket_node_addr_parse(const char* ip, uint16_t port, softbus_node_addr_t* node) {
+    if (!ip || !node || port == 0) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    struct in_addr addr;
+    if (inet_pton(AF_INET, ip, &addr) != 1 || addr.s_addr == 0) {
+        return SOFTBUS_INVALID_ARG;
+    }
+    node->addr = addr.s_addr;
+    node->port = htons(port);
     return SOFTBUS_OK;
 }
 
-void socket_multicast_stop_receiver(void) {
-    if (g_receiver_running) {
-        g_receiver_running = 0;
-        pthread_join(g_receiver_thread, NULL);
+void socket_set_target_handler(socket_target_handler_t handler) {
+    g_target_handler = handler;
+}
+
+void socket_set_control_handler(socket_control_handler_t handler) {
+    g_control_handler = handler;
+}
+
+int socket_send_control(const softbus_node_addr_t* node, const void* body, size_t len) {
+    if (!body || len == 0 || len > SOCKET_MAX_DATAGRAM - SOFTBUS_WIRE_HDR_SIZE) {
+        return SOFTBUS_INVALID_ARG;
+    }
+    if (g_unicast_fd < 0) {
+        return SOFTBUS_ERROR;
+    }
+
+    struct sockaddr_in dest_addr;
+    memset(&dest_addr, 0, sizeof(dest_addr));
+    dest_addr.sin_family = AF_INET;
+    if (node) {
+        dest_addr.sin_addr.s_addr = node->addr;
+        dest_addr.sin_port = node->port;
+    } else {
+        dest_addr.sin_addr.s_addr = inet_addr(MULTICAST_GROUP);
+        dest_addr.sin_port = htons(MULTICAST_PORT);
+    }
+
+    uint8_t buf[SOCKET_MAX_DATAGRAM];
+    softbus_wire_hdr_t hdr = {.magic = SOFTBUS_WIRE_MAGIC, .version = SOFTBUS_WIRE_VERSION,
+                              .flags = SOFTBUS_WIRE_FLAG_CONTROL, .node_id = g_node_id};
+    softbus_wire_encode_hdr(buf, &hdr);
+    memcpy(buf + SOFTBUS_WIRE_HDR_SIZE, body, len);
+    return socket_output(g_unicast_fd, &dest_addr, buf, SOFTBUS_WIRE_HDR_SIZE + len);
+}
+
+void socket_set_reliable(bool enable) {
+    socket_flush();
+    g_reliable_multicast = enable;
+}
+
+uint32_t socket_get_node_id(void) {
+    return g_node_id;
+}
+
+int socket_set_coalescing(bool enable, uint32_t delay_us, size_t mtu) {
+    if (mtu == 0) {
+        mtu = SOCKET_DEFAULT_MTU;
+    }
+    // 至少能容纳一条带目标名的最大长度消息
+    if (mtu > SOCKET_MAX_DATAGRAM ||
+        mtu < SOFTBUS_WIRE_HDR_SIZE + SOFTBUS_WIRE_SEQ_SIZE + SOFTBUS_WIRE_REC_SIZE + MAX_NAME_LENGTH + MAX_MSG_SIZE) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&g_coalesce.mutex);
+    for (int i = 0; i < SOCKET_COALESCE_MAX_DESTS; i++) {
+        coalesce_flush_slot_locked(&g_coalesce.slots[i]);
     }
+    g_coalesce.enabled = enable;
+    g_coalesce.delay_us = delay_us;
+    g_coalesce.mtu = mtu;
+    pthread_mutex_unlock(&g_coalesce.mutex);
+    return SOFTBUS_OK;
+}
+
+int socket_flush(void) {
+    int ret = SOFTBUS_OK;
+    pthread_mutex_lock(&g_coalesce.mutex);
+    for (int i = 0; i < SOCKET_COALESCE_MAX_DESTS; i++) {
+        if (coalesce_flush_slot_locked(&g_coalesce.slots[i]) != SOFTBUS_OK) {
+            ret = SOFTBUS_ERROR;
+        }
+    }
+    pthread_mutex_unlock(&g_coalesce.mutex);
+    return ret;
+}
+
+void socket_get_stats(socket_stats_t* stats) {
+    if (!stats) {
+        return;
+    }
+    stats->tx_messages = atomic_load_explicit(&g_stats.tx_messages, memory_order_relaxed);
+    stats->tx_datagrams = atomic_load_explicit(&g_stats.tx_datagrams, memory_order_relaxed);
+    stats->rx_messages = atomic_load_explicit(&g_stats.rx_messages, memory_order_relaxed);
+    stats->rx_datagrams = atomic_load_explicit(&g_stats.rx_datagrams, memory_order_relaxed);
+    stats->rx_loopback_dropped = atomic_load_explicit(&g_stats.rx_loopback_dropped, memory_order_relaxed);
+    stats->tx_fragments = atomic_load_explicit(&g_stats.tx_fragments, memory_order_relaxed);
+    stats->rx_fragments = atomic_load_explicit(&g_stats.rx_fragments, memory_order_relaxed);
+    stats->reasm_completed = atomic_load_explicit(&g_stats.reasm_completed, memory_order_relaxed);
+    stats->reasm_timeouts = atomic_load_explicit(&g_stats.reasm_timeouts, memory_order_relaxed);
+    stats->reasm_evicted = atomic_load_explicit(&g_stats.reasm_evicted, memory_order_relaxed);
+
+    rmcast_stats_t rm = {0};
+    rmcast_get_stats(g_rmcast, &rm);
+    stats->rm_retransmits = rm.retransmits;
+    stats->rm_heartbeats = rm.heartbeats;
+    stats->rm_nacks_sent = rm.nacks_sent;
+    stats->rm_nacks_received = rm.nacks_received;
+    stats->rm_nacks_suppressed = rm.nacks_suppressed;
+    stats->rm_duplicates = rm.rx_duplicates;
+    stats->rm_recovered = rm.rx_recovered;
+    stats->rm_lost = rm.rx_lost;
+
+    stats->tx_packets_per_msg = stats->tx_messages ? (double)stats->tx_datagrams / stats->tx_messages : 0.0;
+    stats->rx_packets_per_msg = stats->rx_messages ? (double)stats->rx_datagrams / stats->rx_messages : 0.0;
+}
+
+void socket_reset_stats(void) {
+    atomic_store_explicit(&g_stats.tx_messages, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_stats.tx_datagrams, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_stats.rx_messages, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_stats.rx_datagrams, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_stats.rx_loopback_dropped, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_stats.tx_fragments, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_stats.rx_fragments, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_stats.reasm_completed, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_stats.reasm_timeouts, 0, memory_order_relaxed);
+    atomic_store_explicit(&g_stats.reasm_evicted, 0, memory_order_relaxed);
+    rmcast_reset_stats(g_rmcast);
+}
+
+int socket_multicast_receive(char* buffer, size_t buffer_size, int timeout_ms) {
+    if (!buffer || buffer_size == 0) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    // 超时前收到的回环帧、被可靠层过滤的帧和分片都不是可返回的消息，继续等待下一个数据报
+    uint64_t deadline = timeout_ms >= 0 ? softbus_io_now_ns() + (uint64_t)timeout_ms * 1000000ULL : 0;
+    // 数据报先落在调用者缓冲区，合并的记录再复制到栈上解析，收取长度不能超过栈缓冲区
+    size_t max_len = buffer_size - 1 < SOCKET_MAX_DATAGRAM ? buffer_size - 1 : SOCKET_MAX_DATAGRAM;
+    struct sockaddr_in sender_addr;
+    ssize_t recv_len;
+    softbus_wire_hdr_t hdr;
+    int framed;
+    for (;;) {
+        int wait_ms = -1;
+        if (timeout_ms >= 0) {
+            uint64_t now = softbus_io_now_ns();
+            if (now >= deadline && timeout_ms > 0) {
+                return SOFTBUS_TIMEOUT;
+            }
+            wait_ms = now >= deadline ? 0 : (int)((deadline - now + 999999) / 1000000);
+        }
+
+        // socket为非阻塞模式，使用poll等待数据
+        struct pollfd pfd;
+        pfd.fd = g_socket_fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        int ready = poll(&pfd, 1, wait_ms);
+        if (ready == 0) {
+            return SOFTBUS_TIMEOUT;
+        }
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("Failed to poll multicast socket");
+            return SOFTBUS_ERROR;
+        }
+
+        // 接收消息
+        socklen_t sender_addr_len = sizeof(sender_addr);
+        recv_len = recvfrom(g_socket_fd, buffer, max_len, 0,
+                            (struct sockaddr*)&sender_addr, &sender_addr_len);
+
+        if (recv_len < 0) {
+            // IO线程可能已经取走了这个数据报
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                if (timeout_ms == 0) {
+                    return SOFTBUS_TIMEOUT;
+                }
+                continue;
+            }
+            perror("Failed to receive multicast message");
+            return SOFTBUS_ERROR;
+        }
+
+        buffer[recv_len] = '\0';
+
+        framed = softbus_wire_decode_hdr((const uint8_t*)buffer, (size_t)recv_len, &hdr) == 0;
+        if (!framed) {
+            break;
+        }
+        if (hdr.node_id == g_node_id) {
+            atomic_fetch_add_explicit(&g_stats.rx_loopback_dropped, 1, memory_order_relaxed);
+        } else if (!reliable_filter(&hdr, (const uint8_t*)buffer, (size_t)recv_len, &sender_addr)) {
+            // 重复或乱序缓存的帧由可靠层处理
+        } else if (hdr.flags & SOFTBUS_WIRE_FLAG_FRAGMENT) {
+            // 分片进入重组表，收齐后按正常路径投递
+            handle_fragment(&hdr, (const uint8_t*)buffer, (size_t)recv_len);
+        } else {
+            break;
+        }
+        buffer[0] = '\0';
+        if (timeout_ms == 0) {
+            return SOFTBUS_TIMEOUT;
+        }
+    }
+
+    // 分帧的数据报：返回第一条消息，其余合并的消息按正常路径投递
+    if (framed) {
+        uint8_t datagram[SOCKET_MAX_DATAGRAM];
+        memcpy(datagram, buffer, (size_t)recv_len);
+        buffer[0] = '\0';
+
+        size_t offset = hdr.hdr_len;
+        for (uint16_t i = 0; i < hdr.count && offset + SOFTBUS_WIRE_REC_SIZE <= (size_t)recv_len; i++) {
+            softbus_wire_rec_t rec;
+            softbus_wire_decode_rec(datagram + offset, &rec);
+            const uint8_t* target = datagram + offset + SOFTBUS_WIRE_REC_SIZE;
+            offset += softbus_wire_rec_hdr_size(&rec);
+            if (offset + rec.len > (size_t)recv_len) {
+                break;
+            }
+            if (i == 0) {
+                size_t copy_len = rec.len < buffer_size - 1 ? rec.len : buffer_size - 1;
+                memcpy(buffer, datagram + offset, copy_len);
+                buffer[copy_len] = '\0';
+            } else {
+                dispatch_record(&rec, target, datagram + offset);
+            }
+            offset += rec.len;
+        }
+    }
+    return SOFTBUS_OK;
+}
+
+int socket_unicast_get_port(void) {
+    if (g_unicast_fd < 0) {
+        return -1;
+    }
+
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    if (getsockname(g_unicast_fd, (struct sockaddr*)&addr, &addr_len) < 0) {
+        return -1;
+    }
+    return ntohs(addr.sin_port);
+}
+
+int socket_multicast_start_receiver(void) {
+    return softbus_io_start();
+}
+
+void socket_multicast_stop_receiver(void) {
+    // 通过eventfd唤醒IO线程，不会阻塞在recvfrom上
+    softbus_io_stop();
 }
 
-#endif // ENABLE_SOCKET_MULTICAST 
\ No newline at end of file
+#endif // ENABLE_SOCKET_MULTICAST
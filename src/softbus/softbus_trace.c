@@ -0,0 +1,196 @@
+#include "softbus_trace.h"
+
+#if ENABLE_TRACE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include "softbus_types.h"
+
+#define TRACE_TARGET_LEN 32         // 与message_t.target一致，更长的名称截断
+
+typedef struct {
+    uint64_t ts_ns;
+    uint64_t msg_id;
+    uint8_t point;
+    char target[TRACE_TARGET_LEN];
+} trace_event_t;
+
+// 单生产者环：只有所属线程写入，导出时只读；线程退出后环保留，供事后导出
+typedef struct trace_ring {
+    _Atomic uint64_t head;
+    _Atomic uint64_t base;      // 清空时的head，导出从此处开始
+    int tid;
+    struct trace_ring* next;
+    trace_event_t events[SOFTBUS_TRACE_RING_SIZE];
+} trace_ring_t;
+
+static struct {
+    trace_ring_t* rings;
+    pthread_mutex_t mutex;
+    _Atomic bool enabled;
+} g_trace = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .enabled = true,
+};
+
+static __thread trace_ring_t* t_ring;
+static __thread uint64_t t_current;
+
+// 追踪点在Chrome trace中的表示：成对的阶段映射为同一个异步span的开始和结束
+static const struct {
+    const char* name;
+    char phase;
+} g_point_info[] = {
+    [TRACE_API_ENTRY] = {"request", 'b'},
+    [TRACE_ENQUEUE] = {"queued", 'b'},
+    [TRACE_DEQUEUE] = {"queued", 'e'},
+    [TRACE_HANDLER_BEGIN] = {"handler", 'b'},
+    [TRACE_HANDLER_END] = {"handler", 'e'},
+    [TRACE_RESPONSE_ENQUEUE] = {"response_enqueue", 'n'},
+    [TRACE_COMPLETE] = {"complete", 'n'},
+    [TRACE_API_EXIT] = {"request", 'e'},
+};
+
+static uint64_t trace_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static trace_ring_t* ring_get(void) {
+    if (t_ring) {
+        return t_ring;
+    }
+    trace_ring_t* ring = calloc(1, sizeof(*ring));
+    if (!ring) {
+        return NULL;
+    }
+    ring->tid = (int)syscall(SYS_gettid);
+    pthread_mutex_lock(&g_trace.mutex);
+    ring->next = g_trace.rings;
+    g_trace.rings = ring;
+    pthread_mutex_unlock(&g_trace.mutex);
+    t_ring = ring;
+    return ring;
+}
+
+void softbus_trace_record(trace_point_t point, uint64_t msg_id, const char* target) {
+    if (msg_id == 0 || !atomic_load_explicit(&g_trace.enabled, memory_order_relaxed)) {
+        return;
+    }
+    trace_ring_t* ring = ring_get();
+    if (!ring) {
+        return;
+    }
+
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    trace_event_t* ev = &ring->events[head & (SOFTBUS_TRACE_RING_SIZE - 1)];
+    ev->ts_ns = trace_now_ns();
+    ev->msg_id = msg_id;
+    ev->point = (uint8_t)point;
+    if (target) {
+        strncpy(ev->target, target, sizeof(ev->target) - 1);
+        ev->target[sizeof(ev->target) - 1] = '\0';
+    } else {
+        ev->target[0] = '\0';
+    }
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+void softbus_trace_set_current(uint64_t msg_id) {
+    t_current = msg_id;
+}
+
+uint64_t softbus_trace_current(void) {
+    return t_current;
+}
+
+void softbus_trace_set_enabled(bool enabled) {
+    atomic_store_explicit(&g_trace.enabled, enabled, memory_order_relaxed);
+}
+
+static void write_json_string(FILE* fp, const char* s) {
+    fputc('"', fp);
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            fprintf(fp, "\\%c", c);
+        } else if (c < 0x20) {
+            fprintf(fp, "\\u%04x", c);
+        } else {
+            fputc(c, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+// 导出时其他线程可能仍在写入：读取前后两次head，可能已被覆盖的事件跳过
+int softbus_trace_dump(const char* path) {
+    if (!path) {
+        return SOFTBUS_INVALID_ARG;
+    }
+    FILE* fp = fopen(path, "w");
+    if (!fp) {
+        perror("fopen");
+        return SOFTBUS_ERROR;
+    }
+
+    int pid = (int)getpid();
+    bool first = true;
+    fprintf(fp, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+
+    pthread_mutex_lock(&g_trace.mutex);
+    for (trace_ring_t* ring = g_trace.rings; ring; ring = ring->next) {
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint64_t start = head > SOFTBUS_TRACE_RING_SIZE ? head - SOFTBUS_TRACE_RING_SIZE : 0;
+        uint64_t base = atomic_load_explicit(&ring->base, memory_order_relaxed);
+        if (start < base) {
+            start = base;
+        }
+        for (uint64_t i = start; i < head; i++) {
+            trace_event_t ev = ring->events[i & (SOFTBUS_TRACE_RING_SIZE - 1)];
+            uint64_t now_head = atomic_load_explicit(&ring->head, memory_order_acquire);
+            if (now_head >= i + SOFTBUS_TRACE_RING_SIZE) {  // 复制期间该槽位已开始被覆盖
+                continue;
+            }
+            if (ev.point >= sizeof(g_point_info) / sizeof(g_point_info[0])) {
+                continue;
+            }
+            fprintf(fp, "%s{\"name\": \"%s\", \"cat\": \"softbus\", \"ph\": \"%c\", \"id\": \"0x%llx\", "
+                    "\"pid\": %d, \"tid\": %d, \"ts\": %llu.%03llu",
+                    first ? "" : ",\n", g_point_info[ev.point].name, g_point_info[ev.point].phase,
+                    (unsigned long long)ev.msg_id, pid, ring->tid,
+                    (unsigned long long)(ev.ts_ns / 1000), (unsigned long long)(ev.ts_ns % 1000));
+            if (ev.target[0]) {
+                fprintf(fp, ", \"args\": {\"target\": ");
+                write_json_string(fp, ev.target);
+                fputc('}', fp);
+            }
+            fputc('}', fp);
+            first = false;
+        }
+    }
+    pthread_mutex_unlock(&g_trace.mutex);
+
+    fprintf(fp, "\n]}\n");
+    fclose(fp);
+    return SOFTBUS_OK;
+}
+
+// 不修改写入位置，只记录导出的起点，写入线程无需同步
+void softbus_trace_clear(void) {
+    pthread_mutex_lock(&g_trace.mutex);
+    for (trace_ring_t* ring = g_trace.rings; ring; ring = ring->next) {
+        atomic_store_explicit(&ring->base, atomic_load_explicit(&ring->head, memory_order_acquire),
+                              memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&g_trace.mutex);
+}
+
+#endif // ENABLE_TRACE
@@ -0,0 +1,438 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "softbus_uds.h"
+
+#if ENABLE_UDS_TRANSPORT
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include "softbus_io.h"
+#include "message_queue.h"
+#include "softbus_log.h"
+
+#define UDS_MAGIC 0x53425544  // "SBUD"
+#define UDS_FLAG_MEMFD 0x01
+
+// memfd必须具备的密封，保证接收方映射期间内容和大小不再变化
+#define UDS_REQUIRED_SEALS (F_SEAL_WRITE | F_SEAL_SHRINK)
+#define UDS_SEND_TIMEOUT_MS 1000
+
+// 数据报头，同主机通信使用本机字节序
+typedef struct {
+    uint32_t magic;
+    uint16_t flags;
+    uint8_t type;
+    uint8_t priority;
+    uint64_t len;
+    char target[MAX_NAME_LENGTH];
+} uds_hdr_t;
+
+static struct {
+    int recv_fd;
+    int send_fd;
+    char node_name[UDS_MAX_NODE_NAME];
+    uds_receive_handler_t handler;
+    void* user_data;
+} g_uds = {.recv_fd = -1, .send_fd = -1};
+
+// 内部函数声明
+static void default_receive_handler(const char* target, message_type_t type, softbus_priority_t priority,
+                                    void* data, size_t len, void (*release)(void* data, size_t len),
+                                    void* user_data);
+
+static socklen_t make_addr(const char* node_name, struct sockaddr_un* addr) {
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    // 抽象命名空间：sun_path[0]为'\0'，无需清理文件
+    int n = snprintf(addr->sun_path + 1, sizeof(addr->sun_path) - 1, "%s%s", UDS_ADDR_PREFIX, node_name);
+    if (n < 0 || (size_t)n >= sizeof(addr->sun_path) - 1) {
+        n = (int)sizeof(addr->sun_path) - 2;
+    }
+    return (socklen_t)(offsetof(struct sockaddr_un, sun_path) + 1 + n);
+}
+
+static void release_mapping(void* data, size_t len) {
+    munmap(data, len);
+}
+
+static void release_heap(void* data, size_t len) {
+    (void)len;
+    free(data);
+}
+
+// 映射收到的memfd；检查密封，确保发送方不能再修改或截断
+static void* map_sealed_memfd(int fd, size_t len) {
+    int seals = fcntl(fd, F_GET_SEALS);
+    if (seals < 0 || (seals & UDS_REQUIRED_SEALS) != UDS_REQUIRED_SEALS) {
+        SOFTBUS_LOGW("Rejected unsealed memfd payload\n");
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < len) {
+        SOFTBUS_LOGW("Rejected truncated memfd payload\n");
+        return NULL;
+    }
+
+    void* addr = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+    return addr == MAP_FAILED ? NULL : addr;
+}
+
+// socket可读回调：在IO线程中执行，非阻塞读取直到EAGAIN
+static void uds_readable(int fd, uint32_t events, void* ctx) {
+    (void)events;
+    (void)ctx;
+    static uint8_t buffer[sizeof(uds_hdr_t) + UDS_INLINE_MAX];
+
+    for (;;) {
+        struct iovec iov = {buffer, sizeof(buffer)};
+        union {
+            struct cmsghdr align;
+            char buf[CMSG_SPACE(sizeof(int))];
+        } control;
+        struct msghdr mh;
+        memset(&mh, 0, sizeof(mh));
+        mh.msg_iov = &iov;
+        mh.msg_iovlen = 1;
+        mh.msg_control = control.buf;
+        mh.msg_controllen = sizeof(control.buf);
+
+        ssize_t n = recvmsg(fd, &mh, MSG_CMSG_CLOEXEC);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                perror("Failed to receive unix datagram");
+            }
+            break;
+        }
+
+        int passed_fd = -1;
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&mh); cmsg; cmsg = CMSG_NXTHDR(&mh, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+                memcpy(&passed_fd, CMSG_DATA(cmsg), sizeof(int));
+            }
+        }
+
+        uds_hdr_t hdr;
+        if ((size_t)n < sizeof(hdr) || (mh.msg_flags & (MSG_TRUNC | MSG_CTRUNC))) {
+            SOFTBUS_LOGW("Dropped malformed unix datagram\n");
+            if (passed_fd >= 0) {
+                close(passed_fd);
+            }
+            continue;
+        }
+        memcpy(&hdr, buffer, sizeof(hdr));
+        hdr.target[MAX_NAME_LENGTH - 1] = '\0';
+        if (hdr.magic != UDS_MAGIC) {
+            if (passed_fd >= 0) {
+                close(passed_fd);
+            }
+            continue;
+        }
+
+        void* data = NULL;
+        void (*release)(void*, size_t) = NULL;
+        size_t len = 0;
+        if (hdr.flags & UDS_FLAG_MEMFD) {
+            // 大负载：映射发送方写好的页面，不经过socket缓冲区复制
+            if (passed_fd < 0 || hdr.len == 0 || hdr.len > UDS_MAX_PAYLOAD) {
+                if (passed_fd >= 0) {
+                    close(passed_fd);
+                }
+                continue;
+            }
+            len = (size_t)hdr.len;
+            data = map_sealed_memfd(passed_fd, len);
+            close(passed_fd);
+            if (!data) {
+                continue;
+            }
+            release = release_mapping;
+        } else {
+            if (passed_fd >= 0) {
+                close(passed_fd);
+            }
+            len = (size_t)n - sizeof(hdr);
+            if (hdr.len != len) {
+                continue;
+            }
+            data = malloc(len ? len : 1);
+            if (!data) {
+                continue;
+            }
+            memcpy(data, buffer + sizeof(hdr), len);
+            release = release_heap;
+        }
+
+        g_uds.handler(hdr.target, (message_type_t)hdr.type, (softbus_priority_t)hdr.priority,
+                      data, len, release, g_uds.user_data);
+    }
+}
+
+int uds_transport_init(const char* node_name) {
+    if (g_uds.recv_fd >= 0) {
+        return SOFTBUS_OK;
+    }
+
+    if (node_name) {
+        strncpy(g_uds.node_name, node_name, UDS_MAX_NODE_NAME - 1);
+        g_uds.node_name[UDS_MAX_NODE_NAME - 1] = '\0';
+    } else {
+        snprintf(g_uds.node_name, sizeof(g_uds.node_name), "%d", (int)getpid());
+    }
+    if (!g_uds.handler) {
+        g_uds.handler = default_receive_handler;
+    }
+
+    if (softbus_io_init() != SOFTBUS_OK) {
+        return SOFTBUS_ERROR;
+    }
+
+    g_uds.recv_fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    g_uds.send_fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (g_uds.recv_fd < 0 || g_uds.send_fd < 0) {
+        perror("Failed to create unix socket");
+        goto fail;
+    }
+
+    struct sockaddr_un addr;
+    socklen_t addr_len = make_addr(g_uds.node_name, &addr);
+    if (bind(g_uds.recv_fd, (struct sockaddr*)&addr, addr_len) < 0) {
+        perror("Failed to bind unix socket");
+        goto fail;
+    }
+
+    // 发送socket保持阻塞，对端队列满时最多等待UDS_SEND_TIMEOUT_MS
+    struct timeval tv = {UDS_SEND_TIMEOUT_MS / 1000, (UDS_SEND_TIMEOUT_MS % 1000) * 1000};
+    setsockopt(g_uds.send_fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    if (softbus_io_add_fd(g_uds.recv_fd, SOFTBUS_IO_READ, uds_readable, NULL) != SOFTBUS_OK) {
+        goto fail;
+    }
+    if (softbus_io_start() != SOFTBUS_OK) {
+        softbus_io_del_fd(g_uds.recv_fd);
+        goto fail;
+    }
+
+    return SOFTBUS_OK;
+
+fail:
+    if (g_uds.recv_fd >= 0) {
+        close(g_uds.recv_fd);
+        g_uds.recv_fd = -1;
+    }
+    if (g_uds.send_fd >= 0) {
+        close(g_uds.send_fd);
+        g_uds.send_fd = -1;
+    }
+    softbus_io_deinit();
+    return SOFTBUS_ERROR;
+}
+
+void uds_transport_deinit(void) {
+    if (g_uds.recv_fd < 0) {
+        return;
+    }
+
+    // 返回时接收回调已经结束，IO线程可能仍为其他传输运行
+    softbus_io_del_fd(g_uds.recv_fd);
+    softbus_io_stop();
+    close(g_uds.recv_fd);
+    close(g_uds.send_fd);
+    g_uds.recv_fd = -1;
+    g_uds.send_fd = -1;
+    softbus_io_deinit();
+}
+
+const char* uds_transport_node_name(void) {
+    return g_uds.node_name;
+}
+
+static int send_datagram(const char* peer, const uds_hdr_t* hdr, const void* data, size_t len, int fd) {
+    struct sockaddr_un addr;
+    socklen_t addr_len = make_addr(peer, &addr);
+
+    struct iovec iov[2] = {
+        {(void*)hdr, sizeof(*hdr)},
+        {(void*)data, len},
+    };
+    union {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(sizeof(int))];
+    } control;
+
+    struct msghdr mh;
+    memset(&mh, 0, sizeof(mh));
+    mh.msg_name = &addr;
+    mh.msg_namelen = addr_len;
+    mh.msg_iov = iov;
+    mh.msg_iovlen = len > 0 ? 2 : 1;
+
+    if (fd >= 0) {
+        memset(&control, 0, sizeof(control));
+        mh.msg_control = control.buf;
+        mh.msg_controllen = sizeof(control.buf);
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&mh);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+    }
+
+    if (sendmsg(g_uds.send_fd, &mh, MSG_NOSIGNAL) < 0) {
+        if (errno == ECONNREFUSED || errno == ENOENT) {
+            return SOFTBUS_NOT_FOUND;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return SOFTBUS_TIMEOUT;
+        }
+        perror("Failed to send unix datagram");
+        return SOFTBUS_ERROR;
+    }
+    return SOFTBUS_OK;
+}
+
+static void fill_hdr(uds_hdr_t* hdr, const char* target, message_type_t type, softbus_priority_t priority,
+                     size_t len, uint16_t flags) {
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->magic = UDS_MAGIC;
+    hdr->flags = flags;
+    hdr->type = (uint8_t)type;
+    hdr->priority = (uint8_t)priority;
+    hdr->len = len;
+    strncpy(hdr->target, target, MAX_NAME_LENGTH - 1);
+}
+
+int uds_transport_send(const char* peer, const char* target, message_type_t type, softbus_priority_t priority,
+                       const void* data, size_t len) {
+    if (!peer || !target || (!data && len > 0) || len > UDS_MAX_PAYLOAD) {
+        return SOFTBUS_INVALID_ARG;
+    }
+    if (g_uds.send_fd < 0) {
+        return SOFTBUS_ERROR;
+    }
+
+    if (len <= UDS_INLINE_MAX) {
+        uds_hdr_t hdr;
+        fill_hdr(&hdr, target, type, priority, len, 0);
+        return send_datagram(peer, &hdr, data, len, -1);
+    }
+
+    uds_buffer_t buf;
+    int ret = uds_transport_alloc(len, &buf);
+    if (ret != SOFTBUS_OK) {
+        return ret;
+    }
+    memcpy(buf.addr, data, len);
+    return uds_transport_send_buffer(peer, target, type, priority, &buf);
+}
+
+int uds_transport_alloc(size_t len, uds_buffer_t* buf) {
+    if (!buf || len == 0 || len > UDS_MAX_PAYLOAD) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    buf->fd = memfd_create("softbus_payload", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (buf->fd < 0) {
+        perror("Failed to create memfd");
+        return SOFTBUS_ERROR;
+    }
+    if (ftruncate(buf->fd, (off_t)len) < 0) {
+        perror("Failed to size memfd");
+        close(buf->fd);
+        buf->fd = -1;
+        return SOFTBUS_NO_MEM;
+    }
+
+    buf->addr = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, buf->fd, 0);
+    if (buf->addr == MAP_FAILED) {
+        perror("Failed to map memfd");
+        close(buf->fd);
+        buf->fd = -1;
+        buf->addr = NULL;
+        return SOFTBUS_NO_MEM;
+    }
+    buf->len = len;
+    return SOFTBUS_OK;
+}
+
+int uds_transport_send_buffer(const char* peer, const char* target, message_type_t type, softbus_priority_t priority,
+                              uds_buffer_t* buf) {
+    if (!peer || !target || !buf || buf->fd < 0) {
+        return SOFTBUS_INVALID_ARG;
+    }
+
+    // 可写映射存在时无法添加写密封，先解除映射
+    if (buf->addr) {
+        munmap(buf->addr, buf->len);
+        buf->addr = NULL;
+    }
+
+    int ret = SOFTBUS_OK;
+    if (fcntl(buf->fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) < 0) {
+        perror("Failed to seal memfd");
+        ret = SOFTBUS_ERROR;
+    } else {
+        uds_hdr_t hdr;
+        fill_hdr(&hdr, target, type, priority, buf->len, UDS_FLAG_MEMFD);
+        ret = send_datagram(peer, &hdr, NULL, 0, buf->fd);
+    }
+
+    uds_transport_free_buffer(buf);
+    return ret;
+}
+
+void uds_transport_free_buffer(uds_buffer_t* buf) {
+    if (!buf) {
+        return;
+    }
+    if (buf->addr) {
+        munmap(buf->addr, buf->len);
+        buf->addr = NULL;
+    }
+    if (buf->fd >= 0) {
+        close(buf->fd);
+        buf->fd = -1;
+    }
+    buf->len = 0;
+}
+
+void uds_transport_set_receive_handler(uds_receive_handler_t handler, void* user_data) {
+    g_uds.handler = handler ? handler : default_receive_handler;
+    g_uds.user_data = user_data;
+}
+
+// 默认接收处理：数据所有权交给目标设备的消息队列，不再复制。在IO线程中执行，
+// message_queue_send在目标设备的队列锁内入队，与处理线程的出队互斥
+static void default_receive_handler(const char* target, message_type_t type, softbus_priority_t priority,
+                                    void* data, size_t len, void (*release)(void* data, size_t len),
+                                    void* user_data) {
+    (void)user_data;
+    message_t msg = {0};
+    strncpy(msg.target, target, sizeof(msg.target) - 1);
+    msg.type = type;
+    msg.priority = priority;
+    size_t copy_len = len < sizeof(msg.content) - 1 ? len : sizeof(msg.content) - 1;
+    memcpy(msg.content, data, copy_len);
+    msg.content[copy_len] = '\0';
+    msg.data = data;
+    msg.data_len = len;
+    msg.data_release = release;
+    if (message_queue_send(&msg) != SOFTBUS_OK) {
+        release(data, len);
+    }
+}
+
+#endif // ENABLE_UDS_TRANSPORT
@@ -0,0 +1,212 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include "softbus_watchdog.h"
+#include "softbus_log.h"
+#include "softbus_cacheline.h"
+
+struct device_watchdog {
+    char name[MAX_NAME_LENGTH];
+    device_metrics_t* metrics;
+    _Atomic uint32_t wall_budget_us;
+    _Atomic uint32_t cpu_budget_us;
+
+    // 正在执行的处理函数，running_since_ns为0表示空闲
+    _Atomic uint64_t running_since_ns;
+    _Atomic int running_type;
+    _Atomic bool flagged;       // 本次调用已由看门狗告警
+
+    _Atomic uint32_t strikes;   // 连续超时次数
+    _Atomic uint64_t quarantined_until_ns;
+
+    struct device_watchdog* next;
+} SOFTBUS_CACHE_ALIGNED;
+
+static struct {
+    device_watchdog_t* devices;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    pthread_t thread;
+    bool running;
+    _Atomic bool quarantine;
+} g_watchdog = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+};
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t thread_cpu_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void watchdog_scan_locked(void) {
+    uint64_t now = now_ns();
+    for (device_watchdog_t* wd = g_watchdog.devices; wd; wd = wd->next) {
+        uint64_t since = atomic_load_explicit(&wd->running_since_ns, memory_order_acquire);
+        if (since == 0 || since > now || atomic_load_explicit(&wd->flagged, memory_order_relaxed)) {
+            continue;
+        }
+        uint64_t budget_ns = (uint64_t)atomic_load_explicit(&wd->wall_budget_us, memory_order_relaxed) * 1000;
+        if (now - since > budget_ns) {
+            atomic_store_explicit(&wd->flagged, true, memory_order_relaxed);
+            SOFTBUS_LOGW("Slow handler: device %s, message type %d, running for %llu ms\n",
+                         wd->name, atomic_load_explicit(&wd->running_type, memory_order_relaxed),
+                         (unsigned long long)((now - since) / 1000000));
+        }
+    }
+}
+
+static void* watchdog_thread(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&g_watchdog.mutex);
+    while (g_watchdog.running) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += WATCHDOG_SCAN_INTERVAL_MS * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec += 1;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&g_watchdog.cond, &g_watchdog.mutex, &deadline);
+        if (g_watchdog.running) {
+            watchdog_scan_locked();
+        }
+    }
+    pthread_mutex_unlock(&g_watchdog.mutex);
+    return NULL;
+}
+
+int watchdog_init(void) {
+    pthread_mutex_lock(&g_watchdog.mutex);
+    if (g_watchdog.running) {
+        pthread_mutex_unlock(&g_watchdog.mutex);
+        return SOFTBUS_OK;
+    }
+    g_watchdog.running = true;
+    if (pthread_create(&g_watchdog.thread, NULL, watchdog_thread, NULL) != 0) {
+        g_watchdog.running = false;
+        pthread_mutex_unlock(&g_watchdog.mutex);
+        return SOFTBUS_ERROR;
+    }
+    pthread_mutex_unlock(&g_watchdog.mutex);
+    return SOFTBUS_OK;
+}
+
+void watchdog_deinit(void) {
+    pthread_mutex_lock(&g_watchdog.mutex);
+    if (!g_watchdog.running) {
+        pthread_mutex_unlock(&g_watchdog.mutex);
+        return;
+    }
+    g_watchdog.running = false;
+    pthread_cond_signal(&g_watchdog.cond);
+    pthread_mutex_unlock(&g_watchdog.mutex);
+    pthread_join(g_watchdog.thread, NULL);
+}
+
+void watchdog_set_quarantine(bool enable) {
+    atomic_store_explicit(&g_watchdog.quarantine, enable, memory_order_relaxed);
+}
+
+device_watchdog_t* watchdog_device_create(const char* device_name, device_metrics_t* metrics) {
+    device_watchdog_t* wd = softbus_cacheline_alloc(sizeof(*wd));
+    if (!wd) {
+        return NULL;
+    }
+    strncpy(wd->name, device_name, sizeof(wd->name) - 1);
+    wd->metrics = metrics;
+    atomic_store(&wd->wall_budget_us, WATCHDOG_DEFAULT_WALL_BUDGET_US);
+
+    pthread_mutex_lock(&g_watchdog.mutex);
+    wd->next = g_watchdog.devices;
+    g_watchdog.devices = wd;
+    pthread_mutex_unlock(&g_watchdog.mutex);
+    return wd;
+}
+
+void watchdog_device_destroy(device_watchdog_t* wd) {
+    if (!wd) {
+        return;
+    }
+    pthread_mutex_lock(&g_watchdog.mutex);
+    for (device_watchdog_t** link = &g_watchdog.devices; *link; link = &(*link)->next) {
+        if (*link == wd) {
+            *link = wd->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_watchdog.mutex);
+    softbus_cacheline_free(wd);
+}
+
+void watchdog_set_budget(device_watchdog_t* wd, uint32_t wall_us, uint32_t cpu_us) {
+    if (!wd) {
+        return;
+    }
+    atomic_store_explicit(&wd->wall_budget_us, wall_us ? wall_us : WATCHDOG_DEFAULT_WALL_BUDGET_US,
+                          memory_order_relaxed);
+    atomic_store_explicit(&wd->cpu_budget_us, cpu_us, memory_order_relaxed);
+}
+
+bool watchdog_dispatch_allowed(device_watchdog_t* wd) {
+    if (!wd || !atomic_load_explicit(&g_watchdog.quarantine, memory_order_relaxed)) {
+        return true;
+    }
+    uint64_t until = atomic_load_explicit(&wd->quarantined_until_ns, memory_order_relaxed);
+    return until == 0 || now_ns() >= until;
+}
+
+void watchdog_handler_begin(device_watchdog_t* wd, message_type_t type, watchdog_call_t* call) {
+    call->start_ns = now_ns();
+    call->start_cpu_ns = 0;
+    if (!wd) {
+        return;
+    }
+    if (atomic_load_explicit(&wd->cpu_budget_us, memory_order_relaxed)) {
+        call->start_cpu_ns = thread_cpu_ns();
+    }
+    atomic_store_explicit(&wd->running_type, (int)type, memory_order_relaxed);
+    atomic_store_explicit(&wd->flagged, false, memory_order_relaxed);
+    atomic_store_explicit(&wd->running_since_ns, call->start_ns, memory_order_release);
+}
+
+void watchdog_handler_end(device_watchdog_t* wd, watchdog_call_t* call) {
+    uint64_t end = now_ns();
+    call->wall_ns = end - call->start_ns;
+    call->cpu_ns = call->start_cpu_ns ? thread_cpu_ns() - call->start_cpu_ns : 0;
+    if (!wd) {
+        return;
+    }
+    atomic_store_explicit(&wd->running_since_ns, 0, memory_order_release);
+
+    uint64_t wall_budget_ns = (uint64_t)atomic_load_explicit(&wd->wall_budget_us, memory_order_relaxed) * 1000;
+    uint64_t cpu_budget_ns = (uint64_t)atomic_load_explicit(&wd->cpu_budget_us, memory_order_relaxed) * 1000;
+    bool over = call->wall_ns > wall_budget_ns || (cpu_budget_ns && call->cpu_ns > cpu_budget_ns);
+    if (!over) {
+        atomic_store_explicit(&wd->strikes, 0, memory_order_relaxed);
+        return;
+    }
+
+    device_metrics_overrun(wd->metrics);
+    SOFTBUS_LOGW("Handler over budget: device %s, message type %d, wall %llu us, cpu %llu us\n",
+                 wd->name, atomic_load_explicit(&wd->running_type, memory_order_relaxed),
+                 (unsigned long long)(call->wall_ns / 1000), (unsigned long long)(call->cpu_ns / 1000));
+
+    uint32_t strikes = atomic_fetch_add_explicit(&wd->strikes, 1, memory_order_relaxed) + 1;
+    if (strikes >= WATCHDOG_QUARANTINE_STRIKES && atomic_load_explicit(&g_watchdog.quarantine, memory_order_relaxed)) {
+        atomic_store_explicit(&wd->quarantined_until_ns, end + (uint64_t)WATCHDOG_QUARANTINE_MS * 1000000,
+                              memory_order_relaxed);
+        device_metrics_quarantined(wd->metrics);
+        SOFTBUS_LOGW("Device %s quarantined for %d ms after %u handler overruns\n",
+                     wd->name, WATCHDOG_QUARANTINE_MS, strikes);
+    }
+}
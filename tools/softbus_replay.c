@@ -0,0 +1,292 @@
+// 抓包回放工具
+//
+// 用法: softbus_replay <capture_file> [speed] [output.json]
+//
+// 读取softbus_capture_start写出的二进制日志，为其中出现的每个目标设备注册接收设备，
+// 再按记录的时间间隔把消息重新注入本进程的总线。speed为回放倍率：1为原始节奏（默认），
+// N为N倍速，max为不等待、尽快注入。结束后打印实际吞吐、相对计划时间的注入滞后，
+// 以及从发送调用到处理函数收到消息的投递时延分布；指定output.json时同时写出JSON。
+// 抓包时被截断的负载按截断后的长度回放。
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <errno.h>
+#include "softbus.h"
+#include "softbus_capture.h"
+
+#define MAX_TARGETS 32          // 与设备管理器的MAX_DEVICES一致
+
+typedef struct {
+    softbus_capture_record_t rec;
+    char target[MAX_NAME_LENGTH];
+    const uint8_t* payload;
+} replay_msg_t;
+
+static uint64_t g_inject_ns;        // 正在注入的消息的发送时间，本地投递在发送调用内完成
+static uint64_t* g_latency;
+static int g_latency_count;
+static uint64_t g_handled;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void sleep_until(uint64_t deadline_ns) {
+    struct timespec ts = {
+        .tv_sec = (time_t)(deadline_ns / 1000000000ULL),
+        .tv_nsec = (long)(deadline_ns % 1000000000ULL),
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+static int cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static uint64_t percentile(const uint64_t* sorted, int count, double p) {
+    if (count <= 0) {
+        return 0;
+    }
+    int idx = (int)(p / 100.0 * count);
+    return sorted[idx < count ? idx : count - 1];
+}
+
+static int replay_handler(const void* data, size_t len, message_type_t type) {
+    (void)data;
+    (void)len;
+    (void)type;
+    if (g_inject_ns) {
+        g_latency[g_latency_count++] = now_ns() - g_inject_ns;
+        g_inject_ns = 0;
+    }
+    g_handled++;
+    return SOFTBUS_OK;
+}
+
+// 整个日志读入内存，回放时不受磁盘IO影响；返回消息数，失败返回-1
+static int load_capture(const char* path, uint8_t** buf_out, replay_msg_t** msgs_out) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp) {
+        perror("fopen");
+        return -1;
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (size < (long)sizeof(softbus_capture_file_header_t)) {
+        fprintf(stderr, "%s: not a capture file\n", path);
+        fclose(fp);
+        return -1;
+    }
+    uint8_t* buf = malloc((size_t)size);
+    if (!buf || fread(buf, 1, (size_t)size, fp) != (size_t)size) {
+        fprintf(stderr, "%s: read failed\n", path);
+        free(buf);
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+
+    softbus_capture_file_header_t header;
+    memcpy(&header, buf, sizeof(header));
+    if (memcmp(header.magic, SOFTBUS_CAPTURE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SOFTBUS_CAPTURE_VERSION ||
+        header.record_header_size != sizeof(softbus_capture_record_t)) {
+        fprintf(stderr, "%s: unsupported capture format\n", path);
+        free(buf);
+        return -1;
+    }
+
+    // 先数记录数，再建立索引
+    int count = 0;
+    size_t pos = sizeof(header);
+    for (int pass = 0; pass < 2; pass++) {
+        replay_msg_t* msgs = pass ? *msgs_out : NULL;
+        int n = 0;
+        pos = sizeof(header);
+        while (pos + sizeof(softbus_capture_record_t) <= (size_t)size) {
+            softbus_capture_record_t rec;
+            memcpy(&rec, buf + pos, sizeof(rec));
+            size_t total = sizeof(rec) + rec.target_len + rec.payload_len;
+            if (pos + total > (size_t)size) {
+                fprintf(stderr, "%s: truncated record at offset %zu, ignored\n", path, pos);
+                break;
+            }
+            if (msgs) {
+                msgs[n].rec = rec;
+                size_t name_len = rec.target_len < MAX_NAME_LENGTH - 1 ? rec.target_len : MAX_NAME_LENGTH - 1;
+                memcpy(msgs[n].target, buf + pos + sizeof(rec), name_len);
+                msgs[n].target[name_len] = '\0';
+                msgs[n].payload = buf + pos + sizeof(rec) + rec.target_len;
+            }
+            n++;
+            pos += total;
+        }
+        if (!pass) {
+            count = n;
+            *msgs_out = calloc(count ? (size_t)count : 1, sizeof(replay_msg_t));
+            if (!*msgs_out) {
+                free(buf);
+                return -1;
+            }
+        }
+    }
+
+    *buf_out = buf;
+    return count;
+}
+
+static int register_targets(const replay_msg_t* msgs, int count) {
+    char names[MAX_TARGETS][MAX_NAME_LENGTH];
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        bool seen = false;
+        for (int j = 0; j < n && !seen; j++) {
+            seen = strcmp(names[j], msgs[i].target) == 0;
+        }
+        if (seen) {
+            continue;
+        }
+        if (n >= MAX_TARGETS) {
+            fprintf(stderr, "too many targets, %s not registered\n", msgs[i].target);
+            continue;
+        }
+        memcpy(names[n], msgs[i].target, MAX_NAME_LENGTH);
+        if (softbus_api_register_device_raw(DEVICE_TYPE_OTHER, names[n], replay_handler) != SOFTBUS_OK) {
+            fprintf(stderr, "failed to register %s\n", names[n]);
+            return -1;
+        }
+        n++;
+    }
+    return n;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 4) {
+        fprintf(stderr, "usage: %s <capture_file> [speed|max] [output.json]\n", argv[0]);
+        return 1;
+    }
+    double speed = 1.0;
+    if (argc > 2) {
+        speed = strcmp(argv[2], "max") == 0 ? 0.0 : atof(argv[2]);
+        if (strcmp(argv[2], "max") != 0 && speed <= 0.0) {
+            fprintf(stderr, "speed must be > 0 or \"max\"\n");
+            return 1;
+        }
+    }
+    const char* output = argc > 3 ? argv[3] : NULL;
+
+    uint8_t* buf = NULL;
+    replay_msg_t* msgs = NULL;
+    int count = load_capture(argv[1], &buf, &msgs);
+    if (count < 0) {
+        return 1;
+    }
+
+    if (softbus_api_init() != SOFTBUS_OK) {
+        fprintf(stderr, "failed to initialize softbus\n");
+        return 1;
+    }
+    int targets = register_targets(msgs, count);
+    g_latency = calloc(count ? (size_t)count : 1, sizeof(uint64_t));
+    uint64_t* lag = calloc(count ? (size_t)count : 1, sizeof(uint64_t));
+    if (targets < 0 || !g_latency || !lag) {
+        softbus_api_deinit();
+        return 1;
+    }
+
+    uint64_t bytes = 0;
+    int errors = 0;
+    int truncated = 0;
+    uint64_t start = now_ns();
+    for (int i = 0; i < count; i++) {
+        const replay_msg_t* m = &msgs[i];
+        uint64_t due = 0;
+        if (speed > 0.0) {
+            due = start + (uint64_t)((double)m->rec.ts_ns / speed);
+            if (now_ns() < due) {
+                sleep_until(due);
+            }
+        }
+        uint64_t sent = now_ns();
+        lag[i] = due ? sent - due : 0;     // 最快速度回放没有计划时间
+        g_inject_ns = sent;
+        int ret = softbus_api_send_data_ex(m->target, (message_type_t)m->rec.type, m->payload,
+                                           m->rec.payload_len, (softbus_priority_t)m->rec.priority);
+        g_inject_ns = 0;
+        if (ret != SOFTBUS_OK) {
+            errors++;
+        }
+        bytes += m->rec.payload_len;
+        truncated += (m->rec.flags & SOFTBUS_CAPTURE_FLAG_TRUNCATED) != 0;
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    qsort(g_latency, (size_t)g_latency_count, sizeof(uint64_t), cmp_u64);
+    qsort(lag, (size_t)count, sizeof(uint64_t), cmp_u64);
+    double secs = elapsed / 1e9;
+    double captured = count ? msgs[count - 1].rec.ts_ns / 1e9 : 0.0;
+    double rate = secs > 0 ? count / secs : 0.0;
+    double mbps = secs > 0 ? bytes / secs / (1024.0 * 1024.0) : 0.0;
+
+    char speed_label[32];
+    if (speed > 0.0) {
+        snprintf(speed_label, sizeof(speed_label), "%gx", speed);
+    } else {
+        snprintf(speed_label, sizeof(speed_label), "max");
+    }
+    printf("replayed %d messages to %d devices in %.3f s (captured span %.3f s, speed %s)\n",
+           count, targets, secs, captured, speed_label);
+    printf("  throughput  %.0f msg/s, %.2f MiB/s, %d send errors, %d truncated payloads\n",
+           rate, mbps, errors, truncated);
+    printf("  delivery    p50 %llu ns, p99 %llu ns, p999 %llu ns, max %llu ns (%d samples)\n",
+           (unsigned long long)percentile(g_latency, g_latency_count, 50),
+           (unsigned long long)percentile(g_latency, g_latency_count, 99),
+           (unsigned long long)percentile(g_latency, g_latency_count, 99.9),
+           (unsigned long long)(g_latency_count ? g_latency[g_latency_count - 1] : 0), g_latency_count);
+    if (speed > 0.0) {
+        printf("  inject lag  p50 %llu ns, p99 %llu ns, max %llu ns\n",
+               (unsigned long long)percentile(lag, count, 50), (unsigned long long)percentile(lag, count, 99),
+               (unsigned long long)(count ? lag[count - 1] : 0));
+    }
+
+    if (output) {
+        FILE* fp = fopen(output, "w");
+        if (fp) {
+            fprintf(fp,
+                    "{\n  \"capture\": \"%s\",\n  \"messages\": %d,\n  \"devices\": %d,\n"
+                    "  \"speed\": %.3f,\n  \"elapsed_s\": %.6f,\n  \"captured_s\": %.6f,\n"
+                    "  \"msgs_per_sec\": %.1f,\n  \"mib_per_sec\": %.3f,\n  \"errors\": %d,\n"
+                    "  \"handled\": %llu,\n"
+                    "  \"delivery_ns\": {\"p50\": %llu, \"p99\": %llu, \"p999\": %llu, \"max\": %llu},\n"
+                    "  \"inject_lag_ns\": {\"p50\": %llu, \"p99\": %llu, \"max\": %llu}\n}\n",
+                    argv[1], count, targets, speed, secs, captured, rate, mbps, errors,
+                    (unsigned long long)g_handled,
+                    (unsigned long long)percentile(g_latency, g_latency_count, 50),
+                    (unsigned long long)percentile(g_latency, g_latency_count, 99),
+                    (unsigned long long)percentile(g_latency, g_latency_count, 99.9),
+                    (unsigned long long)(g_latency_count ? g_latency[g_latency_count - 1] : 0),
+                    (unsigned long long)percentile(lag, count, 50), (unsigned long long)percentile(lag, count, 99),
+                    (unsigned long long)(count ? lag[count - 1] : 0));
+            fclose(fp);
+            printf("results written to %s\n", output);
+        } else {
+            perror("fopen");
+        }
+    }
+
+    softbus_api_deinit();
+    free(lag);
+    free(g_latency);
+    free(msgs);
+    free(buf);
+    return errors ? 1 : 0;
+}